@@ -11,7 +11,8 @@ if( NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES )
   set( CMAKE_BUILD_TYPE Debug CACHE STRING "Choose the type of build." FORCE )
 
   # set the possible values of build type
-  set_property( CACHE CMAKE_BUILD_TYPE PROPERTY STRINGS "Debug" "Release" )
+  set_property( CACHE CMAKE_BUILD_TYPE PROPERTY STRINGS 
+    "Debug" "Release" "RelWithDebInfo" )
 
 endif()
 
@@ -72,15 +73,52 @@ if( CMAKE_BUILD_TYPE STREQUAL "Debug" )
 endif()
 
 
+################################################################################
+# Options of optimised builds                                                  #
+################################################################################
+
+# tune for the build machine - binaries may not run on other CPUs
+option( INCOMFLOW_NATIVE "Compile with -march=native" OFF )
+
+# link-time optimisation across the static incomflow library
+option( INCOMFLOW_LTO "Enable link-time optimisation in optimised builds" ON )
+
+# profile-guided optimisation:
+#   GENERATE - instrument the build, then run the target pgo_train
+#   USE      - optimise with the profiles in INCOMFLOW_PGO_DIR
+set( INCOMFLOW_PGO "OFF" CACHE STRING 
+  "Profile-guided optimisation: OFF, GENERATE or USE" )
+set_property( CACHE INCOMFLOW_PGO PROPERTY STRINGS "OFF" "GENERATE" "USE" )
+
+set( INCOMFLOW_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH 
+  "Directory of the profiles for profile-guided optimisation" )
+
+if( CMAKE_BUILD_TYPE STREQUAL "Release" OR 
+    CMAKE_BUILD_TYPE STREQUAL "RelWithDebInfo" )
+  set( INCOMFLOW_OPTIMISED ON )
+else()
+  set( INCOMFLOW_OPTIMISED OFF )
+endif()
+
+
 #################################
 # Compiler Flags (Release Mode) #
 #################################
 
 # set release compiler flags
-if( CMAKE_BUILD_TYPE STREQUAL "Release" )
+if( INCOMFLOW_OPTIMISED )
 
   # enable optimization
-  string( APPEND MY_CMAKE_C_FLAGS " -O3" )
+  string( APPEND MY_CMAKE_C_FLAGS " -O3 -DNDEBUG" )
+
+  # keep debugging information and frame pointers for profilers
+  if( CMAKE_BUILD_TYPE STREQUAL "RelWithDebInfo" )
+    string( APPEND MY_CMAKE_C_FLAGS " -g -fno-omit-frame-pointer" )
+  endif()
+
+  if( INCOMFLOW_NATIVE )
+    string( APPEND MY_CMAKE_C_FLAGS " -march=native" )
+  endif()
 
   if( CMAKE_C_COMPILER_ID STREQUAL "GNU" )
    
@@ -97,8 +135,84 @@ if( CMAKE_BUILD_TYPE STREQUAL "Release" )
   # overwrite compiler flags
   set(
     CMAKE_C_FLAGS_RELEASE ${MY_CMAKE_C_FLAGS}
-    CACHE STRING "Flags used by the compiler during debug builds." FORCE
+    CACHE STRING "Flags used by the compiler during release builds." FORCE
   )
+  set(
+    CMAKE_C_FLAGS_RELWITHDEBINFO ${MY_CMAKE_C_FLAGS}
+    CACHE STRING "Flags used by the compiler during release builds." FORCE
+  )
+
+endif()
+
+
+#################################
+# Link-time optimisation        #
+#################################
+
+# IPO support is checked by CMake >= 3.9, which also uses 
+# the LTO-aware archiver for the static library 
+# (policy CMP0069 is set in the top-level CMakeLists.txt)
+if( INCOMFLOW_OPTIMISED AND INCOMFLOW_LTO )
+
+  if( POLICY CMP0069 )
+    include( CheckIPOSupported )
+    check_ipo_supported( RESULT IPO_SUPPORTED OUTPUT IPO_OUTPUT 
+                         LANGUAGES C )
+  else()
+    set( IPO_SUPPORTED FALSE )
+  endif()
+
+  if( IPO_SUPPORTED )
+    message( STATUS "Link-time optimisation enabled" )
+    set( CMAKE_INTERPROCEDURAL_OPTIMIZATION ON )
+  else()
+    message( WARNING "Link-time optimisation is not supported" )
+  endif()
+
+endif()
+
+
+#################################
+# Profile-guided optimisation   #
+#################################
+
+if( NOT INCOMFLOW_PGO STREQUAL "OFF" )
+
+  # Clang profiles need an extra merge step (llvm-profdata)
+  if( NOT CMAKE_C_COMPILER_ID STREQUAL "GNU" )
+    message( FATAL_ERROR "INCOMFLOW_PGO requires GCC" )
+  endif()
+
+  if( NOT INCOMFLOW_OPTIMISED )
+    message( WARNING "INCOMFLOW_PGO is meant for optimised builds" )
+  endif()
+
+  if( INCOMFLOW_PGO STREQUAL "GENERATE" )
+
+    # counters are updated atomically, since the training 
+    # workload runs the OpenMP kernels
+    set( PGO_FLAGS 
+      "-fprofile-generate=${INCOMFLOW_PGO_DIR} -fprofile-update=atomic" )
+
+  elseif( INCOMFLOW_PGO STREQUAL "USE" )
+
+    if( NOT EXISTS ${INCOMFLOW_PGO_DIR} )
+      message( FATAL_ERROR 
+        "No profiles in ${INCOMFLOW_PGO_DIR} - "
+        "build with INCOMFLOW_PGO=GENERATE and run pgo_train first" )
+    endif()
+
+    # profiles of threaded runs may be slightly inconsistent
+    set( PGO_FLAGS "-fprofile-use=${INCOMFLOW_PGO_DIR}" )
+    string( APPEND PGO_FLAGS " -fprofile-correction -Wno-missing-profile" )
+
+  else()
+    message( FATAL_ERROR "Unknown INCOMFLOW_PGO mode ${INCOMFLOW_PGO}" )
+  endif()
+
+  message( STATUS "Profile-guided optimisation: ${INCOMFLOW_PGO}" )
+  string( APPEND CMAKE_C_FLAGS          " ${PGO_FLAGS}" )
+  string( APPEND CMAKE_EXE_LINKER_FLAGS " ${PGO_FLAGS}" )
 
 endif()
 
@@ -1,118 +1,181 @@
 '''
     Small function to plot the mesh structure
 
+    Supports the binary leaf mesh dumps of icfOutput_dumpMesh()
+    and of binary output writers, as well as the text output
+    of icfMesh_printMesh()
+
 '''
 from matplotlib import pyplot as plt
-from matplotlib.patches import Polygon
-from matplotlib.collections import PatchCollection
+from matplotlib.collections import PolyCollection
 import numpy as np
 import sys, os
 
-TRI_PATCH = {'edgecolors' : ['k'],
+TRI_PATCH = {'edgecolors' : 'k',
              'linewidths' : 0.9,
-             'facecolors' : ['w'],
+             'facecolors' : 'w',
              'joinstyle'  : 'round',
              'capstyle'   : 'round',
              'alpha'      : 1.0,
              'cmap'       : 'coolwarm'}
 
-def read_meshdata(mesh_file):
+BIN_MAGIC   = b'ICFMESH\x00'
+BIN_VERSION = 2
+BIN_NAMELEN = 32
+
+BIN_HEADER  = np.dtype([('magic',        'S8'),
+                        ('version',      '=i4'),
+                        ('real_size',    '=i4'),
+                        ('index_size',   '=i4'),
+                        ('n_node_fields','=i4'),
+                        ('n_cell_fields','=i4'),
+                        ('reserved_0',   '=i4'),
+                        ('step',         '=i8'),
+                        ('n_nodes',      '=i8'),
+                        ('n_tris',       '=i8'),
+                        ('reserved_1',   '=i8')])
+
+
+def is_binary(mesh_file):
     '''
-    Function to read the raw mesh data
+    Check if a file is a binary leaf mesh dump
     '''
-    with open(mesh_file, 'r') as reader:
-        lines   = reader.readlines()
+    with open(mesh_file, 'rb') as reader:
+        return reader.read(len(BIN_MAGIC)) == BIN_MAGIC
 
-        # Filter out comments
-        for i in range(len(lines)-1, -1, -1):
-            identifier = lines[i].split(' ')[0]
-            if (identifier == '>'):
-                lines.pop(i)
 
-        n_nodes = int(lines[0].split(' ')[1])
+def read_binary(mesh_file):
+    '''
+    Function to read a binary leaf mesh dump
+    All arrays are memory mapped and are only loaded
+    from disk when they are accessed
+    The sizes of reals and indices depend on the build 
+    configuration of incomflow and are taken from the header
+    '''
+    header = np.fromfile(mesh_file, dtype=BIN_HEADER, count=1)[0]
 
-        nodes       = np.zeros( (n_nodes, 2) )
-        edges       = []
-        tris        = []
-        tri_index   = []
+    if header['version'] != BIN_VERSION:
+        raise ValueError('{:s}: unsupported dump version {:d}'.format(
+            mesh_file, int(header['version'])))
 
-        # Get node coordinates
-        #----------------------------------------------------
-        for i in range(1, n_nodes+1):
-            line = lines[i].replace('\n','').split('\t')
-            nodes[i-1][0] = float(line[1])
-            nodes[i-1][1] = float(line[2])
+    for key in ('real_size', 'index_size'):
+        if header[key] not in (4, 8):
+            raise ValueError('{:s}: unsupported {:s} {:d}'.format(
+                mesh_file, key, int(header[key])))
 
-        # Get triangle data
-        #----------------------------------------------------
-        lines = lines[n_nodes+1:]
-        n_tris = int(lines[0].split(' ')[1])
+    real  = np.dtype('=f{:d}'.format(header['real_size']))
+    index = np.dtype('=i{:d}'.format(header['index_size']))
 
-        for i in range(1, n_tris+1):
-            line = lines[i].replace('\n','').split('\t')
-            tri = (int(line[1]), int(line[2]), int(line[3]))
-            tris.append(tri)
-            tri_index.append(int(line[0]))
+    n_nodes  = int(header['n_nodes'])
+    n_tris   = int(header['n_tris'])
+    n_nfield = int(header['n_node_fields'])
+    n_cfield = int(header['n_cell_fields'])
 
-        # Get edge data
-        #----------------------------------------------------
-        lines = lines[n_tris+1:]
-        n_edges = int(lines[0].split(' ')[1])
+    names = np.fromfile(mesh_file, dtype='S{:d}'.format(BIN_NAMELEN),
+                        count=n_nfield+n_cfield,
+                        offset=BIN_HEADER.itemsize)
+    names = [n.decode() for n in names]
 
-        for i in range(1, n_edges+1):
-            line = lines[i].replace('\n','').split('\t')
-            edge = (int(line[1]), int(line[2]))
-            edges.append(edge)
+    offset = BIN_HEADER.itemsize + BIN_NAMELEN * len(names)
 
-    return nodes, edges, tris, tri_index
+    def section(dtype, shape):
+        nonlocal offset
+        data = np.memmap(mesh_file, dtype=dtype, mode='r',
+                         offset=offset, shape=shape)
+        offset += data.nbytes
+        return data
 
+    nodes     = section(real,  (n_nodes, 2))
+    tris      = section(index, (n_tris, 3))
+    tri_nbrs  = section(index, (n_tris, 3))
 
-def main():
-    ''' The main function '''
-    if len(sys.argv) < 3:
-        print("plot_boundary.py <mesh>.dat <export_path>")
-        sys.exit(1)
+    node_fields = {n: section(real, (n_nodes,)) for n in names[:n_nfield]}
+    cell_fields = {n: section(real, (n_tris,))  for n in names[n_nfield:]}
 
-    nodes, edges, tris, tri_index = read_meshdata(sys.argv[1])
-    export_path                   = sys.argv[2]
+    return {'step'        : int(header['step']),
+            'nodes'       : nodes,
+            'tris'        : tris,
+            'tri_nbrs'    : tri_nbrs,
+            'node_fields' : node_fields,
+            'cell_fields' : cell_fields}
 
-    i_plts = 0
 
-    for step in range(len(tris), len(tris)-1-i_plts, -1):
+def read_meshdata(mesh_file):
+    '''
+    Function to read the raw mesh data of icfMesh_printMesh()
+    '''
+    with open(mesh_file, 'r') as reader:
+        lines = [l for l in reader.readlines()
+                 if l.split(' ')[0] != '>']
 
-        fig, ax = plt.subplots(1,1,figsize=(8,4))
-        ax.set_aspect('equal')
+    n_nodes = int(lines[0].split(' ')[1])
+    nodes   = np.loadtxt(lines[1:n_nodes+1], usecols=(1,2), ndmin=2)
 
-        #for i_bdry, edges in boundaries.items():
-        #    for e in edges:
-        #        ax.plot(nodes[e,0], nodes[e,1], c='k',
-        #                lw=2.0, ls='-',marker='o')
+    lines   = lines[n_nodes+1:]
+    n_tris  = int(lines[0].split(' ')[1])
+    tris    = np.loadtxt(lines[1:n_tris+1], usecols=(1,2,3),
+                         dtype=int, ndmin=2)
 
-        #for i, n in enumerate(nodes):
-        #    ax.text(n[0],n[1],i, color='b')
+    return {'step'        : 0,
+            'nodes'       : nodes,
+            'tris'        : tris,
+            'node_fields' : {},
+            'cell_fields' : {}}
 
 
-        tri_patches = []
-        for i_tri, tri in enumerate(tris[:step]):
-            tri_patches.append(Polygon([nodes[tri[i]] for i in range(3)]))
-            tri_centr = np.mean([nodes[tri[i]] for i in range(3)], axis=0)
-        #    ax.text(tri_centr[0], tri_centr[1], tri_index[i_tri], color='k')
+def plot_mesh(mesh, field=None):
+    '''
+    Plot all triangles of a mesh with a single PolyCollection
+    The triangles are colored by a cell field, if given
+    '''
+    nodes = np.asarray(mesh['nodes'])
+    tris  = np.asarray(mesh['tris'])
+
+    fig, ax = plt.subplots(1,1,figsize=(8,4))
+    ax.set_aspect('equal')
+
+    tri_col = PolyCollection(nodes[tris], **TRI_PATCH)
 
-        tri_col = PatchCollection(tri_patches, **TRI_PATCH)
-        ax.add_collection(tri_col)
+    if field is not None:
+        tri_col.set_array(np.asarray(mesh['cell_fields'][field]))
+        fig.colorbar(tri_col, ax=ax, label=field)
 
-        ax.set_xlim((nodes[:,0].min(),nodes[:,0].max()))
-        ax.set_ylim((nodes[:,1].min(),nodes[:,1].max()))
-        #ax.set_axis_off()
+    ax.add_collection(tri_col)
 
-        fig_path = os.path.join( export_path, 'mesh_step_{:}'.format(len(tris)-step))
-        print("Exporting {:}".format(fig_path))
-        plt.tight_layout()
-        fig.savefig(fig_path + '.png', dpi=280, transparent=True)
-        plt.close(fig)
-        print("Done")
+    ax.set_xlim((nodes[:,0].min(),nodes[:,0].max()))
+    ax.set_ylim((nodes[:,1].min(),nodes[:,1].max()))
+
+    return fig, ax
+
+
+def main():
+    ''' The main function '''
+    if len(sys.argv) < 3:
+        print("plot_mesh.py <mesh>.(bin|dat) <export_path> [cell field]")
+        sys.exit(1)
+
+    mesh_file   = sys.argv[1]
+    export_path = sys.argv[2]
+    field       = sys.argv[3] if len(sys.argv) > 3 else None
+
+    if is_binary(mesh_file):
+        mesh = read_binary(mesh_file)
+    else:
+        mesh = read_meshdata(mesh_file)
+
+    if field is not None and field not in mesh['cell_fields']:
+        print("Unknown cell field {:}".format(field))
+        sys.exit(1)
 
+    fig, ax = plot_mesh(mesh, field)
 
+    name     = os.path.splitext(os.path.basename(mesh_file))[0]
+    fig_path = os.path.join( export_path, name )
+    print("Exporting {:}".format(fig_path))
+    plt.tight_layout()
+    fig.savefig(fig_path + '.png', dpi=280, transparent=True)
+    plt.close(fig)
+    print("Done")
 
 
 if __name__ == '__main__': main()
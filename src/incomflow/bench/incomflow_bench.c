@@ -0,0 +1,1203 @@
+/*
+ * This source file is part of the incomflow library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfIO.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfMeshOrder.h"
+#include "incomflow/icfEdgeIndex.h"
+#include "incomflow/icfLocator.h"
+#include "incomflow/icfTree.h"
+#include "incomflow/icfMeshSnapshot.h"
+#include "incomflow/icfProf.h"
+#include "incomflow/icfTrace.h"
+
+/**********************************************************
+* Benchmark configuration
+**********************************************************/
+typedef struct benchConfig {
+  int         nx;        /* Number of grid cells in x      */
+  int         ny;        /* Number of grid cells in y      */
+  int         levels;    /* Number of refinement levels    */
+  int         cycles;    /* Number of front cycles         */
+  int         repeats;   /* Repetitions of every scenario  */
+  const char *scenarios; /* Comma separated scenario list  */
+  const char *output;    /* JSON output file or NULL       */
+  const char *tmpDir;    /* Directory for mesh files       */
+} benchConfig;
+
+/**********************************************************
+* Results of a single scenario run
+**********************************************************/
+typedef struct benchResult {
+  long    elements;      /* Processed elements             */
+  double  seconds;       /* Wall clock time                */
+  long    allocs;        /* Number of allocations          */
+  long    allocBytes;    /* Requested bytes                */
+
+  int64_t hw[ICF_PROF_NHW];   /* Hardware counters, -1 if n/a */
+
+  struct timespec t0;
+  long    allocs0;
+  long    allocBytes0;
+  int64_t hw0[ICF_PROF_NHW];
+} benchResult;
+
+/**********************************************************
+* Scenario definition
+**********************************************************/
+typedef int (*benchFun)(const benchConfig *cfg, benchResult *res);
+
+typedef struct benchScenario {
+  const char *name;
+  benchFun    fun;
+} benchScenario;
+
+/**********************************************************
+* Allocation counters
+*----------------------------------------------------------
+* If the benchmark is linked with 
+*   -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+* all allocations of the benchmark and the (static) 
+* incomflow library are counted.
+**********************************************************/
+static long benchAllocs     = 0;
+static long benchAllocBytes = 0;
+
+/**********************************************************
+* Hardware counters of the timed regions (option -H)
+**********************************************************/
+static icfBool benchHW = FALSE;
+
+/**********************************************************
+* Ordering of the edge leafs of all grids (option -e)
+**********************************************************/
+static icfEdgeOrder benchEdgeOrder = ICF_EDGEORDER_STACK;
+
+#ifdef ICF_BENCH_COUNT_ALLOCS
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+  __atomic_add_fetch(&benchAllocs, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&benchAllocBytes, (long) size, __ATOMIC_RELAXED);
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+  __atomic_add_fetch(&benchAllocs, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&benchAllocBytes, (long)(n*size), __ATOMIC_RELAXED);
+  return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+  __atomic_add_fetch(&benchAllocs, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&benchAllocBytes, (long) size, __ATOMIC_RELAXED);
+  return __real_realloc(ptr, size);
+}
+#endif
+
+/**********************************************************
+* Function: bench_start / bench_stop
+*----------------------------------------------------------
+* Mark the begin and end of the timed region of a 
+* scenario
+**********************************************************/
+static void bench_start(benchResult *res)
+{
+  res->allocs0     = __atomic_load_n(&benchAllocs, __ATOMIC_RELAXED);
+  res->allocBytes0 = __atomic_load_n(&benchAllocBytes, __ATOMIC_RELAXED);
+
+  if (benchHW == TRUE)
+    icfProf_readHW(res->hw0);
+
+  clock_gettime(CLOCK_MONOTONIC, &res->t0);
+}
+
+static void bench_stop(benchResult *res)
+{
+  struct timespec t1;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  res->seconds    += (double)(t1.tv_sec - res->t0.tv_sec) 
+                   + 1.0e-9 * (double)(t1.tv_nsec - res->t0.tv_nsec);
+  res->allocs     += __atomic_load_n(&benchAllocs, __ATOMIC_RELAXED)
+                   - res->allocs0;
+  res->allocBytes += __atomic_load_n(&benchAllocBytes, __ATOMIC_RELAXED)
+                   - res->allocBytes0;
+
+  if (benchHW == TRUE)
+  {
+    int64_t hw[ICF_PROF_NHW];
+    int     i;
+
+    icfProf_readHW(hw);
+
+    for (i = 0; i < ICF_PROF_NHW; i++)
+    {
+      if (hw[i] < 0 || res->hw0[i] < 0)
+        res->hw[i] = -1;
+      else
+        res->hw[i] = ((res->hw[i] > 0) ? res->hw[i] : 0) 
+                   + hw[i] - res->hw0[i];
+    }
+  }
+}
+
+/**********************************************************
+* Function: bench_jsonHW
+*----------------------------------------------------------
+* Writes hardware counter values as JSON members, 
+* unavailable events are written as null
+**********************************************************/
+static void bench_jsonHW(FILE *json, const int64_t hw[ICF_PROF_NHW])
+{
+  int i;
+
+  for (i = 0; i < ICF_PROF_NHW; i++)
+  {
+    if (hw[i] >= 0)
+      fprintf(json, ", \"%s\": %lld", icfProf_hwName(i), (long long) hw[i]);
+    else
+      fprintf(json, ", \"%s\": null", icfProf_hwName(i));
+  }
+
+  if (hw[ICF_PROF_HW_CYCLES] > 0 && hw[ICF_PROF_HW_INSTRUCTIONS] >= 0)
+    fprintf(json, ", \"ipc\": %.4f", (double) hw[ICF_PROF_HW_INSTRUCTIONS] 
+                                     / hw[ICF_PROF_HW_CYCLES]);
+  else
+    fprintf(json, ", \"ipc\": null");
+}
+
+/**********************************************************
+* Function: bench_jsonRegions
+*----------------------------------------------------------
+* Writes the library timers of a scenario with their 
+* hardware counters as JSON array. 
+* The timers are given relative to a snapshot, which 
+* was taken before the scenario.
+**********************************************************/
+static void bench_jsonRegions(FILE               *json, 
+                              const icfProfTimer *before, 
+                              int                 nBefore)
+{
+  icfProfTimer timers[ICF_PROF_MAXTIMERS];
+  int i, j, n = icfProf_getTimers(timers, ICF_PROF_MAXTIMERS);
+  int nOut = 0;
+
+  fprintf(json, ", \"regions\": [");
+
+  for (i = 0; i < n && i < nBefore; i++)
+  {
+    timers[i].calls   -= before[i].calls;
+    timers[i].totalNs -= before[i].totalNs;
+    timers[i].selfNs  -= before[i].selfNs;
+
+    for (j = 0; j < ICF_PROF_NHW; j++)
+      if (timers[i].hw[j] >= 0 && before[i].hw[j] >= 0)
+        timers[i].hw[j] -= before[i].hw[j];
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    if (timers[i].calls < 1)
+      continue;
+
+    fprintf(json, "%s\n        { \"name\": \"%s\", \"calls\": %lld, "
+                  "\"seconds\": %.6e, \"self_seconds\": %.6e",
+            (nOut > 0) ? "," : "", timers[i].name, 
+            (long long) timers[i].calls, 
+            1.0e-9 * timers[i].totalNs, 1.0e-9 * timers[i].selfNs);
+    bench_jsonHW(json, timers[i].hw);
+    fprintf(json, " }");
+    nOut++;
+  }
+
+  fprintf(json, " ]");
+}
+
+/**********************************************************
+* Function: bench_resetPeakRSS
+*----------------------------------------------------------
+* Resets the peak resident set size of the process 
+* (Linux only), such that every scenario reports 
+* its own high-water mark
+**********************************************************/
+static void bench_resetPeakRSS(void)
+{
+  FILE *fptr = fopen("/proc/self/clear_refs", "w");
+  if (fptr != NULL)
+  {
+    fputs("5", fptr);
+    fclose(fptr);
+  }
+}
+
+/**********************************************************
+* Function: bench_peakRSS
+*----------------------------------------------------------
+* Returns the peak resident set size in kB
+**********************************************************/
+static long bench_peakRSS(void)
+{
+  char  line[256];
+  long  peak = -1;
+  FILE *fptr = fopen("/proc/self/status", "r");
+
+  if (fptr != NULL)
+  {
+    while (fgets(line, 256, fptr) != NULL)
+      if (strncmp(line, "VmHWM:", 6) == 0)
+        peak = atol(line + 6);
+    fclose(fptr);
+  }
+
+  if (peak < 0)
+  {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    peak = usage.ru_maxrss;
+  }
+
+  return peak;
+}
+
+/**********************************************************
+* Function: bench_createGrid
+*----------------------------------------------------------
+* Creates a unit square with nx x ny cells, which are 
+* split into triangles with alternating diagonals.
+* The boundaries SOUTH, EAST, NORTH and WEST have the
+* markers 1-4.
+**********************************************************/
+static icfMesh *bench_createGrid(int nx, int ny)
+{
+  icfMeshGenParams params;
+  icfMesh *mesh = icfMesh_create();
+
+  icfMeshGen_initParams(&params);
+  params.nx = nx;
+  params.ny = ny;
+
+  mesh->edgeOrder = benchEdgeOrder;
+
+  if (icfMeshGen_rectangle(mesh, &params) != 0)
+  {
+    icfMesh_destroy(mesh);
+    return NULL;
+  }
+
+  icfMesh_update(mesh);
+
+  return mesh;
+}
+
+/**********************************************************
+* Refinement and coarsening criteria
+**********************************************************/
+static int       benchMaxLevel = 0;
+static icfDouble benchFrontPos = 0.0;
+static icfDouble benchFrontWidth = 0.0;
+
+static icfBool bench_refineAll(icfFlowData *flowData, icfTri *tri)
+{
+  return TRUE;
+}
+
+static icfDouble bench_frontDist(icfTri *tri)
+{
+  icfDouble dx = tri->xy[0] - 0.5;
+  icfDouble dy = tri->xy[1] - 0.5;
+  return fabs(sqrt(dx*dx + dy*dy) - benchFrontPos);
+}
+
+static icfBool bench_refineFront(icfFlowData *flowData, icfTri *tri)
+{
+  return ( tri->cold->treeLevel < benchMaxLevel 
+        && bench_frontDist(tri) < benchFrontWidth );
+}
+
+static icfBool bench_coarsenFront(icfFlowData *flowData, icfTri *tri)
+{
+  return ( tri->cold->treeParent >= 0 
+        && bench_frontDist(tri) > 2.0 * benchFrontWidth );
+}
+
+/**********************************************************
+* Creates a uniformly refined grid
+**********************************************************/
+static icfFlowData *bench_createRefined(const benchConfig *cfg)
+{
+  int i;
+  icfFlowData *flowData = icfFlowData_create();
+
+  flowData->mesh      = bench_createGrid(cfg->nx, cfg->ny);
+  flowData->refineFun = bench_refineAll;
+  flowData->coarseFun = bench_refineAll;
+
+  for (i = 0; i < cfg->levels; i++)
+    icfMesh_refine(flowData, flowData->mesh);
+
+  return flowData;
+}
+
+/**********************************************************
+* Scenario: uniform_refine
+*----------------------------------------------------------
+* Refines all triangles of the grid <levels> times
+* Elements: triangle leafs of all levels
+**********************************************************/
+static int bench_uniformRefine(const benchConfig *cfg, benchResult *res)
+{
+  int i;
+  icfFlowData *flowData = icfFlowData_create();
+
+  flowData->mesh      = bench_createGrid(cfg->nx, cfg->ny);
+  flowData->refineFun = bench_refineAll;
+  flowData->coarseFun = bench_refineAll;
+
+  bench_start(res);
+  for (i = 0; i < cfg->levels; i++)
+  {
+    icfMesh_refine(flowData, flowData->mesh);
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return 0;
+}
+
+/**********************************************************
+* Scenario: front_cycles
+*----------------------------------------------------------
+* A circular front moves through the domain. In every 
+* cycle, triangles near the front are refined and 
+* triangles far away from the front are coarsened.
+* Elements: triangle leafs after every cycle
+**********************************************************/
+static int bench_frontCycles(const benchConfig *cfg, benchResult *res)
+{
+  int i, j;
+  icfFlowData *flowData = icfFlowData_create();
+
+  flowData->mesh      = bench_createGrid(cfg->nx, cfg->ny);
+  flowData->refineFun = bench_refineFront;
+  flowData->coarseFun = bench_coarsenFront;
+
+  benchMaxLevel   = cfg->levels;
+  benchFrontWidth = 2.0 / cfg->nx;
+
+  bench_start(res);
+  for (i = 0; i < cfg->cycles; i++)
+  {
+    benchFrontPos = 0.1 + 0.3 * i / cfg->cycles;
+
+    for (j = 0; j < cfg->levels; j++)
+      icfMesh_refine(flowData, flowData->mesh);
+
+    icfMesh_coarsen(flowData, flowData->mesh);
+
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return 0;
+}
+
+/**********************************************************
+* Scenario: compact
+*----------------------------------------------------------
+* Runs the front cycles untimed to scatter the entities
+* over the heap and calls icfMesh_compact() afterwards
+* Elements: triangle leafs per call
+**********************************************************/
+static int bench_compact(const benchConfig *cfg, benchResult *res)
+{
+  int i, j;
+  int nErrors = 0;
+  icfFlowData *flowData = icfFlowData_create();
+
+  flowData->mesh      = bench_createGrid(cfg->nx, cfg->ny);
+  flowData->refineFun = bench_refineFront;
+  flowData->coarseFun = bench_coarsenFront;
+
+  benchMaxLevel   = cfg->levels;
+  benchFrontWidth = 2.0 / cfg->nx;
+
+  for (i = 0; i < cfg->cycles; i++)
+  {
+    benchFrontPos = 0.1 + 0.3 * i / cfg->cycles;
+
+    for (j = 0; j < cfg->levels; j++)
+      icfMesh_refine(flowData, flowData->mesh);
+
+    icfMesh_coarsen(flowData, flowData->mesh);
+  }
+
+  bench_start(res);
+  for (i = 0; i < 10; i++)
+  {
+    nErrors += (icfMesh_compact(flowData->mesh) != 0);
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return (nErrors > 0) ? -1 : 0;
+}
+
+/**********************************************************
+* Scenario: update
+*----------------------------------------------------------
+* Calls icfMesh_update() on the refined grid
+* Elements: triangle leafs per call
+**********************************************************/
+static int bench_update(const benchConfig *cfg, benchResult *res)
+{
+  int i;
+  icfFlowData *flowData = bench_createRefined(cfg);
+
+  bench_start(res);
+  for (i = 0; i < 10; i++)
+  {
+    icfMesh_update(flowData->mesh);
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return 0;
+}
+
+/**********************************************************
+* Scenario: dual_metrics
+*----------------------------------------------------------
+* Calls icfMesh_calcDualMetrics() on the refined grid
+* Elements: triangle leafs per call
+**********************************************************/
+static int bench_dualMetrics(const benchConfig *cfg, benchResult *res)
+{
+  int i;
+  icfFlowData *flowData = bench_createRefined(cfg);
+
+  bench_start(res);
+  for (i = 0; i < 10; i++)
+  {
+    icfMesh_calcDualMetrics(flowData->mesh);
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return 0;
+}
+
+/**********************************************************
+* Scenario: edge_flux
+*----------------------------------------------------------
+* Gathers a node field and scatters a flux to both nodes
+* of every edge leaf of the compacted refined grid, as 
+* the flux kernels of the solver do. The cost depends on
+* the ordering of the nodes and edge leafs (option -e).
+* Elements: edge leafs per sweep
+**********************************************************/
+static int bench_edgeFlux(const benchConfig *cfg, benchResult *res)
+{
+  int i, k;
+  icfFlowData *flowData = bench_createRefined(cfg);
+  icfMesh     *mesh     = flowData->mesh;
+
+  icfDouble *u = (icfDouble*) malloc(mesh->nNodes * sizeof(icfDouble));
+  icfDouble *r = (icfDouble*) calloc(mesh->nNodes, sizeof(icfDouble));
+
+  if (u == NULL || r == NULL || icfMesh_compact(mesh) != 0)
+  {
+    free(u);
+    free(r);
+    icfFlowData_destroy(flowData);
+    return -1;
+  }
+
+  for (i = 0; i < mesh->nNodes; i++)
+    u[i] = mesh->nodes[i]->xy[0];
+
+  bench_start(res);
+  for (k = 0; k < 20; k++)
+  {
+    for (i = 0; i < mesh->nEdgeLeafs; i++)
+    {
+      const icfEdge *e  = mesh->edgeLeafs[i];
+      const icfIndex i0 = e->n[0]->index;
+      const icfIndex i1 = e->n[1]->index;
+      const icfDouble f = 0.5 * (u[i0] + u[i1]) * e->len;
+
+      r[i0] += f;
+      r[i1] -= f;
+    }
+    res->elements += mesh->nEdgeLeafs;
+  }
+  bench_stop(res);
+
+  free(u);
+  free(r);
+  icfFlowData_destroy(flowData);
+
+  return 0;
+}
+
+/**********************************************************
+* Scenario: edge_lookup
+*----------------------------------------------------------
+* Enables the edge index of the refined grid and looks
+* up every edge leaf by its node indices
+* Elements: lookups
+**********************************************************/
+static int bench_edgeLookup(const benchConfig *cfg, benchResult *res)
+{
+  int i, k;
+  icfIndex nFound = 0;
+  icfFlowData *flowData = bench_createRefined(cfg);
+  icfMesh     *mesh     = flowData->mesh;
+
+  if (icfEdgeIndex_enable(mesh) != 0)
+  {
+    icfFlowData_destroy(flowData);
+    return -1;
+  }
+
+  bench_start(res);
+  for (k = 0; k < 10; k++)
+  {
+    for (i = 0; i < mesh->nEdgeLeafs; i++)
+    {
+      const icfEdge *e = mesh->edgeLeafs[i];
+      nFound += icfEdgeIndex_findByIndex(mesh, e->n[1]->index, 
+                                         e->n[0]->index) == e;
+    }
+    res->elements += mesh->nEdgeLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return (nFound == res->elements) ? 0 : -1;
+}
+
+/**********************************************************
+* Function: bench_locate()
+*----------------------------------------------------------
+* Locates points in the refined grid: random points in
+* parallel batches or points along a diagonal path one 
+* by one, which start from the previous result
+**********************************************************/
+#define BENCH_NLOCATE 200000
+
+static int bench_locate(const benchConfig *cfg, benchResult *res,
+                        icfBool path)
+{
+  int i, k;
+  unsigned seed = 12345;
+  icfIndex nFound = 0;
+  icfFlowData *flowData = bench_createRefined(cfg);
+  icfMesh     *mesh     = flowData->mesh;
+  icfLocator  *loc      = icfLocator_create(mesh);
+
+  icfDouble (*xy)[2] = malloc(BENCH_NLOCATE * sizeof(*xy));
+  icfTri    **tris   = malloc(BENCH_NLOCATE * sizeof(icfTri*));
+
+  if (loc == NULL || xy == NULL || tris == NULL)
+  {
+    free(xy);
+    free(tris);
+    icfLocator_destroy(loc);
+    icfFlowData_destroy(flowData);
+    return -1;
+  }
+
+  for (i = 0; i < BENCH_NLOCATE; i++)
+  {
+    icfDouble s0, s1;
+
+    if (path)
+    {
+      s0 = (i + 0.5) / BENCH_NLOCATE;
+      s1 = 0.5 + 0.4 * sin(20.0 * s0);
+    }
+    else
+    {
+      seed = seed * 1103515245u + 12345u;
+      s0   = (icfDouble)(seed >> 8) / (1u << 24);
+      seed = seed * 1103515245u + 12345u;
+      s1   = (icfDouble)(seed >> 8) / (1u << 24);
+    }
+
+    xy[i][0] = loc->xyMin[0] + s0 * (loc->xyMax[0] - loc->xyMin[0]);
+    xy[i][1] = loc->xyMin[1] + s1 * (loc->xyMax[1] - loc->xyMin[1]);
+  }
+
+  bench_start(res);
+  for (k = 0; k < 5; k++)
+  {
+    if (path)
+    {
+      for (i = 0; i < BENCH_NLOCATE; i++)
+        nFound += icfLocator_locate(loc, xy[i], NULL) != NULL;
+    }
+    else
+      nFound += icfLocator_locateBatch(loc, BENCH_NLOCATE, xy, 
+                                       tris, NULL);
+    res->elements += BENCH_NLOCATE;
+  }
+  bench_stop(res);
+
+  free(xy);
+  free(tris);
+  icfLocator_destroy(loc);
+  icfFlowData_destroy(flowData);
+
+  return (nFound == res->elements) ? 0 : -1;
+}
+
+/**********************************************************
+* Scenario: locate_batch
+*----------------------------------------------------------
+* Locates random points in parallel batches
+* Elements: queries
+**********************************************************/
+static int bench_locateBatch(const benchConfig *cfg, benchResult *res)
+{
+  return bench_locate(cfg, res, FALSE);
+}
+
+/**********************************************************
+* Scenario: locate_path
+*----------------------------------------------------------
+* Locates successive points along a path, as done for 
+* particle tracking
+* Elements: queries
+**********************************************************/
+static int bench_locatePath(const benchConfig *cfg, benchResult *res)
+{
+  return bench_locate(cfg, res, TRUE);
+}
+
+/**********************************************************
+* Scenario: tree_traverse
+*----------------------------------------------------------
+* Visits all triangles and edges of the refinement trees
+* of the refined grid in post-order, with the roots 
+* distributed across the threads. The visitors only read 
+* the tree level and never count, such that the threads
+* do not share any written data.
+* Elements: visited entities
+**********************************************************/
+static void bench_treeTri(icfTri *tri, void *data)
+{
+  if (tri->cold->treeLevel < 0)
+    __atomic_fetch_add((icfIndex*) data, 1, __ATOMIC_RELAXED);
+}
+
+static void bench_treeEdge(icfEdge *edge, void *data)
+{
+  if (edge->cold->treeLevel < 0)
+    __atomic_fetch_add((icfIndex*) data, 1, __ATOMIC_RELAXED);
+}
+
+static int bench_treeTraverse(const benchConfig *cfg, benchResult *res)
+{
+  int k;
+  icfIndex nVisited = 0;
+  icfIndex nInvalid = 0;
+  icfFlowData *flowData = bench_createRefined(cfg);
+  icfMesh     *mesh     = flowData->mesh;
+
+  bench_start(res);
+  for (k = 0; k < 10; k++)
+  {
+    nVisited += icfTree_forEachTri(mesh, ICF_TREE_POSTORDER, 
+                                   bench_treeTri, &nInvalid);
+    nVisited += icfTree_forEachEdge(mesh, ICF_TREE_POSTORDER, 
+                                    bench_treeEdge, &nInvalid);
+    res->elements += mesh->nTris + mesh->nEdges;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return (nVisited == res->elements && nInvalid == 0) ? 0 : -1;
+}
+
+/**********************************************************
+* Scenario: snapshot
+*----------------------------------------------------------
+* Runs the front cycles and captures a snapshot of the 
+* mesh after every cycle, which shares the chunks of the
+* previous snapshot outside of the front. Only the 
+* captures are timed.
+* Elements: triangle leafs per capture
+**********************************************************/
+static int bench_snapshot(const benchConfig *cfg, benchResult *res)
+{
+  int i, j;
+  int status = 0;
+  icfMeshSnapshot *snap     = NULL;
+  icfFlowData     *flowData = icfFlowData_create();
+
+  flowData->mesh      = bench_createGrid(cfg->nx, cfg->ny);
+  flowData->refineFun = bench_refineFront;
+  flowData->coarseFun = bench_coarsenFront;
+
+  benchMaxLevel   = cfg->levels;
+  benchFrontWidth = 2.0 / cfg->nx;
+
+  for (i = 0; i < cfg->cycles; i++)
+  {
+    icfMeshSnapshot *next;
+
+    benchFrontPos = 0.1 + 0.3 * i / cfg->cycles;
+
+    for (j = 0; j < cfg->levels; j++)
+      icfMesh_refine(flowData, flowData->mesh);
+
+    icfMesh_coarsen(flowData, flowData->mesh);
+
+    bench_start(res);
+    next = icfMeshSnapshot_capture(flowData->mesh, snap);
+    bench_stop(res);
+
+    icfMeshSnapshot_release(snap);
+    snap = next;
+
+    if (snap == NULL)
+    {
+      status = -1;
+      break;
+    }
+
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+
+  icfMeshSnapshot_release(snap);
+  icfFlowData_destroy(flowData);
+
+  return status;
+}
+
+/**********************************************************
+* Scenario: validate
+*----------------------------------------------------------
+* Calls icfMesh_validate() on the refined grid
+* Elements: triangle leafs per call
+**********************************************************/
+static int bench_validate(const benchConfig *cfg, benchResult *res)
+{
+  int i;
+  int nErrors = 0;
+  icfFlowData *flowData = bench_createRefined(cfg);
+
+  bench_start(res);
+  for (i = 0; i < 10; i++)
+  {
+    nErrors += icfMesh_validate(flowData->mesh);
+    res->elements += flowData->mesh->nTriLeafs;
+  }
+  bench_stop(res);
+
+  icfFlowData_destroy(flowData);
+
+  return (nErrors > 0) ? -1 : 0;
+}
+
+/**********************************************************
+* Scenarios: mesh_write / mesh_read / mesh_dump
+*----------------------------------------------------------
+* Writes the refined grid as text mesh file, reads it 
+* again and writes a binary leaf mesh dump
+* Elements: triangle leafs
+**********************************************************/
+static int bench_meshIO(const benchConfig *cfg, 
+                        benchResult       *res, 
+                        int                mode)
+{
+  char path[1024];
+  icfOutputFrame frame;
+  icfFlowData *flowData = bench_createRefined(cfg);
+  icfMesh     *mesh     = flowData->mesh;
+  int          status   = 0;
+
+  memset(&frame, 0, sizeof(icfOutputFrame));
+
+  snprintf(path, 1024, "%s/incomflow_bench_mesh.%s", cfg->tmpDir,
+           (mode == 2) ? "bin" : "dat");
+
+  if (mode == 0)
+  {
+    bench_start(res);
+    status |= icfOutput_captureFrame(&frame, mesh);
+    status |= icfOutput_writeFrame(&frame, path);
+    bench_stop(res);
+  }
+  else if (mode == 1)
+  {
+    status |= icfOutput_captureFrame(&frame, mesh);
+    status |= icfOutput_writeFrame(&frame, path);
+
+    icfMesh *meshIn = icfMesh_create();
+    icfBdry_create(meshIn, 0, 1, "SOUTH");
+    icfBdry_create(meshIn, 0, 2, "EAST");
+    icfBdry_create(meshIn, 0, 3, "NORTH");
+    icfBdry_create(meshIn, 0, 4, "WEST");
+
+    bench_start(res);
+    icfIO_readMesh(path, meshIn);
+    icfMesh_update(meshIn);
+    bench_stop(res);
+
+    if (meshIn->nTriLeafs != mesh->nTriLeafs)
+      status = -1;
+
+    icfMesh_destroy(meshIn);
+  }
+  else
+  {
+    bench_start(res);
+    status |= icfOutput_dumpMesh(mesh, path);
+    bench_stop(res);
+  }
+
+  res->elements += mesh->nTriLeafs;
+
+  remove(path);
+  icfOutput_clearFrame(&frame);
+  icfFlowData_destroy(flowData);
+
+  return status;
+}
+
+/**********************************************************
+* Scenario: mesh_generate
+*----------------------------------------------------------
+* Generates a perturbed grid with the resolution of the
+* refined grid, including the mesh update
+* Elements: triangle leafs
+**********************************************************/
+static int bench_meshGenerate(const benchConfig *cfg, benchResult *res)
+{
+  icfMeshGenParams params;
+  icfMesh *mesh = icfMesh_create();
+  int      status;
+
+  icfMeshGen_initParams(&params);
+  params.nx     = cfg->nx << (cfg->levels / 2);
+  params.ny     = cfg->ny << (cfg->levels / 2);
+  params.jitter = 0.1;
+
+  bench_start(res);
+  status = icfMeshGen_rectangle(mesh, &params);
+  icfMesh_update(mesh);
+  bench_stop(res);
+
+  res->elements += mesh->nTriLeafs;
+
+  icfMesh_destroy(mesh);
+
+  return status;
+}
+
+static int bench_meshWrite(const benchConfig *cfg, benchResult *res)
+{ return bench_meshIO(cfg, res, 0); }
+
+static int bench_meshRead(const benchConfig *cfg, benchResult *res)
+{ return bench_meshIO(cfg, res, 1); }
+
+static int bench_meshDump(const benchConfig *cfg, benchResult *res)
+{ return bench_meshIO(cfg, res, 2); }
+
+/**********************************************************
+* All available scenarios
+**********************************************************/
+static const benchScenario benchScenarios[] = {
+  { "uniform_refine", bench_uniformRefine },
+  { "front_cycles",   bench_frontCycles   },
+  { "compact",        bench_compact       },
+  { "update",         bench_update        },
+  { "dual_metrics",   bench_dualMetrics   },
+  { "edge_flux",      bench_edgeFlux      },
+  { "edge_lookup",    bench_edgeLookup    },
+  { "locate_batch",   bench_locateBatch   },
+  { "locate_path",    bench_locatePath    },
+  { "tree_traverse",  bench_treeTraverse  },
+  { "snapshot",       bench_snapshot      },
+  { "validate",       bench_validate      },
+  { "mesh_write",     bench_meshWrite     },
+  { "mesh_read",      bench_meshRead      },
+  { "mesh_dump",      bench_meshDump      },
+  { "mesh_generate",  bench_meshGenerate  },
+  { NULL,             NULL                }
+};
+
+/**********************************************************
+* Function: bench_selected
+*----------------------------------------------------------
+* Checks if a scenario is contained in a comma separated
+* list of scenarios
+**********************************************************/
+static icfBool bench_selected(const char *list, const char *name)
+{
+  size_t      len = strlen(name);
+  const char *c   = list;
+
+  if (list == NULL)
+    return TRUE;
+
+  while ((c = strstr(c, name)) != NULL)
+  {
+    if ( (c == list || c[-1] == ',') 
+        && (c[len] == ',' || c[len] == '\0') )
+      return TRUE;
+    c += len;
+  }
+
+  return FALSE;
+}
+
+/**********************************************************
+* Function: bench_usage
+**********************************************************/
+static void bench_usage(const char *exe)
+{
+  int i;
+
+  fprintf(stderr, 
+      "Usage: %s [options]\n"
+      "  -n <cells>     grid cells per direction   (default 32)\n"
+      "  -l <levels>    refinement levels          (default 3)\n"
+      "  -c <cycles>    front refine/coarsen cycles(default 8)\n"
+      "  -r <repeats>   repetitions per scenario   (default 3)\n"
+      "  -s <list>      comma separated scenarios  (default all)\n"
+      "  -d <dir>       directory for mesh files   (default .)\n"
+      "  -o <file>      JSON output file           (default stdout)\n"
+      "  -p             print profiling report to stderr at exit\n"
+      "  -t <file>      write Chrome trace JSON of all scenarios\n"
+      "  -H             report hardware counters of scenarios and\n"
+      "                 library regions (perf_event_open)\n"
+      "  -e <order>     ordering of the edge leafs (default stack)\n"
+      "                 stack, minnode or rcm (see icfMeshOrder.h)\n"
+      "Scenarios:", exe);
+
+  for (i = 0; benchScenarios[i].name != NULL; i++)
+    fprintf(stderr, " %s", benchScenarios[i].name);
+  fprintf(stderr, "\n");
+}
+
+/**********************************************************
+* Main function of the benchmark
+**********************************************************/
+int main(int argc, char *argv[])
+{
+  int   i, r;
+  int   nFailed = 0;
+  FILE *json    = stdout;
+  const char *tracePath = NULL;
+
+  benchConfig cfg = { 32, 32, 3, 8, 3, NULL, NULL, "." };
+
+  icfLog_configure(getenv("ICF_LOG"));
+
+  /*-------------------------------------------------------
+  | Parse arguments
+  -------------------------------------------------------*/
+  for (i = 1; i < argc; i++)
+  {
+    if (i+1 < argc && strcmp(argv[i], "-n") == 0)
+      cfg.nx = cfg.ny = atoi(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "-l") == 0)
+      cfg.levels = atoi(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "-c") == 0)
+      cfg.cycles = atoi(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "-r") == 0)
+      cfg.repeats = atoi(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "-s") == 0)
+      cfg.scenarios = argv[++i];
+    else if (i+1 < argc && strcmp(argv[i], "-d") == 0)
+      cfg.tmpDir = argv[++i];
+    else if (i+1 < argc && strcmp(argv[i], "-o") == 0)
+      cfg.output = argv[++i];
+    else if (strcmp(argv[i], "-p") == 0)
+      icfProf_enable(TRUE);
+    else if (i+1 < argc && strcmp(argv[i], "-t") == 0)
+      tracePath = argv[++i];
+    else if (strcmp(argv[i], "-H") == 0)
+      benchHW = TRUE;
+    else if (i+1 < argc && strcmp(argv[i], "-e") == 0
+          && icfMeshOrder_fromName(argv[i+1]) >= 0)
+      benchEdgeOrder = icfMeshOrder_fromName(argv[++i]);
+    else
+    {
+      bench_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (cfg.nx < 1 || cfg.levels < 0 || cfg.cycles < 1 || cfg.repeats < 1)
+  {
+    bench_usage(argv[0]);
+    return 1;
+  }
+
+  if (benchHW == TRUE)
+  {
+    if (icfProf_enableHW() < 0)
+      fprintf(stderr, "Hardware counters are not available.\n");
+    icfProf_setFlags(ICF_PROF_TIMERS, TRUE);
+  }
+
+  if (cfg.output != NULL)
+  {
+    json = fopen(cfg.output, "w");
+    if (json == NULL)
+    {
+      fprintf(stderr, "Failed to open %s\n", cfg.output);
+      return 1;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Run all scenarios - every scenario is repeated and 
+  | the fastest run is reported
+  -------------------------------------------------------*/
+  fprintf(json, "{\n");
+  fprintf(json, "  \"benchmark\": \"incomflow_bench\",\n");
+  fprintf(json, "  \"config\": { \"nx\": %d, \"ny\": %d, "
+                "\"levels\": %d, \"cycles\": %d, \"repeats\": %d, "
+                "\"edge_order\": \"%s\", "
+                "\"count_allocations\": %s, \"hw_counters\": %s },\n",
+          cfg.nx, cfg.ny, cfg.levels, cfg.cycles, cfg.repeats,
+          icfMeshOrder_name(benchEdgeOrder),
+#ifdef ICF_BENCH_COUNT_ALLOCS
+          "true",
+#else
+          "false",
+#endif
+          (benchHW == TRUE) ? "true" : "false");
+  fprintf(json, "  \"scenarios\": [");
+
+  int nRun = 0;
+
+  if (tracePath != NULL)
+    icfTrace_start(0);
+
+  for (i = 0; benchScenarios[i].name != NULL; i++)
+  {
+    benchResult best;
+    double      total  = 0.0;
+    int         status = 0;
+
+    if (bench_selected(cfg.scenarios, benchScenarios[i].name) == FALSE)
+      continue;
+
+    bench_resetPeakRSS();
+    icfMem_resetPeak();
+
+    icfProfTimer timers[ICF_PROF_MAXTIMERS];
+    int nTimers = icfProf_getTimers(timers, ICF_PROF_MAXTIMERS);
+
+    for (r = 0; r < cfg.repeats; r++)
+    {
+      benchResult res;
+      memset(&res, 0, sizeof(benchResult));
+
+      int64_t t0 = icfProf_now();
+      status |= benchScenarios[i].fun(&cfg, &res);
+
+      if (tracePath != NULL)
+        icfTrace_record(benchScenarios[i].name, t0, icfProf_now() - t0);
+      total  += res.seconds;
+
+      if (r == 0 || res.seconds < best.seconds)
+        best = res;
+    }
+
+    if (status != 0)
+      nFailed++;
+
+    fprintf(json, "%s\n    { \"name\": \"%s\", \"status\": \"%s\", "
+                  "\"elements\": %ld, \"seconds\": %.6e, "
+                  "\"seconds_mean\": %.6e, "
+                  "\"elements_per_second\": %.6e, "
+                  "\"allocations\": %ld, \"allocated_bytes\": %ld, "
+                  "\"peak_rss_kb\": %ld, \"mesh_peak_bytes\": %ld",
+            (nRun > 0) ? "," : "",
+            benchScenarios[i].name, (status == 0) ? "ok" : "failed",
+            best.elements, best.seconds, total / cfg.repeats,
+            (best.seconds > 0.0) ? best.elements / best.seconds : 0.0,
+#ifdef ICF_BENCH_COUNT_ALLOCS
+            best.allocs, best.allocBytes,
+#else
+            -1L, -1L,
+#endif
+            bench_peakRSS(), (long) icfMem_peak());
+
+    /*-----------------------------------------------------
+    | Hardware counters of the fastest run and of the 
+    | library regions over all runs
+    -----------------------------------------------------*/
+    if (benchHW == TRUE)
+    {
+      bench_jsonHW(json, best.hw);
+      bench_jsonRegions(json, timers, nTimers);
+    }
+
+    fprintf(json, " }");
+    fflush(json);
+    nRun++;
+  }
+
+  fprintf(json, "\n  ]\n}\n");
+
+  if (json != stdout)
+    fclose(json);
+
+  if (tracePath != NULL)
+  {
+    icfTrace_stop();
+    if (icfTrace_write(tracePath) != 0)
+      nFailed++;
+    icfTrace_clear();
+  }
+
+  return (nFailed > 0);
+
+} /* main() */
@@ -23,22 +23,42 @@ typedef struct icfBdry {
   /*-------------------------------------------------------
   | Boundary nodes
   -------------------------------------------------------*/
-  int       nNodes;
+  icfIndex  nNodes;
   icfList  *nodeStack;
   icfNode **bdryNodes;
+  icfIndex  nNodesAlloc;  /* Length of the bdryNodes array */
 
   /*-------------------------------------------------------
   | Boundary edges
   -------------------------------------------------------*/
-  int       nEdges;
+  icfIndex  nEdges;
   icfList  *edgeStack;
 
   /*-------------------------------------------------------
   | Boundary edges leafs
   -------------------------------------------------------*/
-  int       nEdgeLeafs;
+  icfIndex  nEdgeLeafs;
   icfEdge **edgeLeafs;
 
+  /*-------------------------------------------------------
+  | Boundary faces: face i belongs to edgeLeafs[i]
+  | All arrays are stored in a single buffer, such that 
+  | boundary kernels stream through one block
+  |
+  |   faceNodes[0] ----o----> faceNodes[1]
+  |               |         |
+  |               V         V
+  |         faceNorm[0]   faceNorm[1]
+  |
+  | faceNorm[k][0/1]: x/y components of the outward 
+  | normal of the half face adjacent to faceNodes[k]
+  -------------------------------------------------------*/
+  icfIndex   nFaces;
+  icfReal   *faceLen;        /* Length of the faces      */
+  icfReal   *faceNorm[2][2]; /* Half face normals        */
+  icfIndex  *faceNodes[2];   /* Node indices             */
+  icfIndex  *faceTri;        /* Leaf index of inner tri  */
+
   /*-------------------------------------------------------
   | Boundary properties
   -------------------------------------------------------*/
@@ -53,18 +73,29 @@ typedef struct icfBdry {
 
 } icfBdry;
 
+/**********************************************************
+* Bytes of the face buffer of <n> faces: length and four 
+* normal components, padded to 8 bytes, followed by two
+* node indices and the triangle index of every face
+**********************************************************/
+#define ICF_BDRY_REALBYTES(n) \
+  ( (5*(size_t)(n)*sizeof(icfReal) + 7) & ~(size_t)7 )
+#define ICF_BDRY_FACEBYTES(n) \
+  ( ICF_BDRY_REALBYTES(n) + 3*(size_t)(n)*sizeof(icfIndex) )
+
 /**********************************************************
 * Function: icfBdry_create
 *----------------------------------------------------------
 * Create a new boundary structure and return a pointer 
 * to it                                            
+* The boundary keeps its own copy of <name>
 *----------------------------------------------------------
 * @return: pointer to new bdry structure
 **********************************************************/
-icfBdry *icfBdry_create(icfMesh *mesh, 
-                        icfIndex type, 
-                        icfIndex marker,
-                        char    *name);
+icfBdry *icfBdry_create(icfMesh    *mesh, 
+                        icfIndex    type, 
+                        icfIndex    marker,
+                        const char *name);
 
 /**********************************************************
 * Function: icfBdry_destroy
@@ -76,6 +107,20 @@ icfBdry *icfBdry_create(icfMesh *mesh,
 **********************************************************/
 int icfBdry_destroy(icfBdry *bdry);
 
+/**********************************************************
+* Function: icfBdry_updateFaces
+*----------------------------------------------------------
+* Resizes the face arrays of a boundary to its edge leafs
+* and sets the face connectivity. Called by 
+* icfMesh_update(), after the leaf arrays have been 
+* rebuilt. The face geometry is computed by 
+* icfMesh_calcDualMetrics().
+* @param: bdry - pointer to bdry structure 
+*----------------------------------------------------------
+* @return: returns 0 on success
+**********************************************************/
+int icfBdry_updateFaces(icfBdry *bdry);
+
 /**********************************************************
 * Function: icfBdry_addNode
 *----------------------------------------------------------
@@ -11,45 +11,23 @@
 #include "incomflow/icfTypes.h"
 
 /**********************************************************
-* icfEdge:  
-*
-*                  t[0]
-*
-*
-*     n[0]-----------(n_c)--------->n[1]
-*            e_c[0]         e_c[1]
-*
-*                  t[1]
-*
+* icfEdgeCold: Refinement tree and bookkeeping state of 
+* an edge, which is not needed by loops over the leafs
 **********************************************************/
-typedef struct icfEdge {
+typedef struct icfEdgeCold {
 
   /*-------------------------------------------------------
   | Parents
   -------------------------------------------------------*/
   icfMesh *mesh;
-  icfEdge *parent;
 
   /*-------------------------------------------------------
-  | Children
+  | Refinement forest (see icfSplit.h): the split, that 
+  | created this edge and its siblings, and the split of 
+  | this edge into its children, -1 if not existing
   -------------------------------------------------------*/
-  icfEdge *e_c[4];
-
-  /*-------------------------------------------------------
-  | Node that connects this edge to all its
-  | trianlge/edge siblings in the refinement tree 
-  -------------------------------------------------------*/
-  icfNode *n_c;
-
-  /*-------------------------------------------------------
-  | Edge nodes: edge points from n[0] to n[1] 
-  -------------------------------------------------------*/
-  icfNode *n[2];
-
-  /*-------------------------------------------------------
-  | Adjacent triangles: t0 is left, t1 is right
-  -------------------------------------------------------*/
-  icfTri *t[2];
+  icfIndex  treeParent;
+  icfIndex  treeSplit;
 
   /*-------------------------------------------------------
   | Boundary properties
@@ -67,29 +45,69 @@ typedef struct icfEdge {
   icfBool   isLeaf;
   icfIndex  treeLevel;
 
-  /*-------------------------------------------------------
-  | Geometric edge properties
-  -------------------------------------------------------*/
-  icfDouble xy[2]; /*                      Edge centroid */
-  icfDouble len;   /*                      Edge length   */
-
   /*-------------------------------------------------------
   | Position in mesh's edge stack
   -------------------------------------------------------*/
   icfListNode *stackPos;
   icfIndex     leafPos;
 
+} icfEdgeCold;
+
+/**********************************************************
+* icfEdge:  
+*
+*                  t[0]
+*
+*
+*     n[0]------------(n)---------->n[1]
+*            child 0        child 2
+*
+*                  t[1]
+*
+*----------------------------------------------------------
+* The edge itself only holds the data of edge loops,
+* the tree state is kept in a separate cold record
+**********************************************************/
+typedef struct icfEdge {
+
+  /*-------------------------------------------------------
+  | Edge nodes: edge points from n[0] to n[1] 
+  -------------------------------------------------------*/
+  icfNode *n[2];
+
+  /*-------------------------------------------------------
+  | Adjacent triangles: t0 is left, t1 is right
+  -------------------------------------------------------*/
+  icfTri *t[2];
+
+  /*-------------------------------------------------------
+  | Geometric edge properties
+  -------------------------------------------------------*/
+  icfReal   xy[2]; /*                      Edge centroid */
+  icfReal   len;   /*                      Edge length   */
+
   /*-------------------------------------------------------
   | Median-dual grid metrics
+  | Boundary face normals are stored in the face arrays 
+  | of the edge's boundary
   -------------------------------------------------------*/
   /* Normals of associated median-dual faces             */
-  icfDouble intrNorm[2];   
-  /* Normals of associated boundary edges, adjacent to   */
-  /* this node --> icfDouble[2][2]                       */
-  icfDouble (*bdryNorm)[2];      
+  icfReal   intrNorm[2];   
+
+  /*-------------------------------------------------------
+  | Refinement tree and bookkeeping state
+  -------------------------------------------------------*/
+  icfEdgeCold *cold;
 
 } icfEdge;
 
+/**********************************************************
+* ICF_EDGE_BLOCKSIZE: Size of the single allocation of an 
+* individually created edge, whose cold record directly 
+* follows the edge itself
+**********************************************************/
+#define ICF_EDGE_BLOCKSIZE (sizeof(icfEdge) + sizeof(icfEdgeCold))
+
 
 /**********************************************************
 * Function: icfEdge_create
@@ -137,6 +155,30 @@ void icfEdge_setTris(icfEdge *edge,
                      icfTri  *t0,
                      icfTri  *t1);
 
+/**********************************************************
+* Function: icfEdge_getParent
+*----------------------------------------------------------
+* @param: edge - edge structure
+* @return: parent edge in the refinement tree, 
+*          NULL for edges of the initial mesh
+**********************************************************/
+icfEdge *icfEdge_getParent(const icfEdge *edge);
+
+/**********************************************************
+* Function: icfEdge_getChild
+*----------------------------------------------------------
+* Children are ordered as e_c of the edge's split 
+* (see icfSplit.h): 0 and 2 are the halves of the edge, 
+* 1 and 3 connect the split node to the right and left 
+* triangle
+*----------------------------------------------------------
+* @param: edge - edge structure
+* @param: i    - child number (0-3)
+* @return: child edge, NULL if edge is not split or if 
+*          the respective triangle does not exist
+**********************************************************/
+icfEdge *icfEdge_getChild(const icfEdge *edge, int i);
+
 /**********************************************************
 * Function: icfEdge_split
 *----------------------------------------------------------
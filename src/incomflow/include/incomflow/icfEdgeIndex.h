@@ -0,0 +1,127 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFEDGEINDEX_H
+#define INCOMFLOW_ICFEDGEINDEX_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* icfEdgeIndex: Lookup of the edges of a mesh by their
+* unordered node pair
+*----------------------------------------------------------
+* The index is an open-addressing hash table with linear
+* probing, whose slots only hold the edge pointers. The
+* key of a slot is recomputed from the nodes of its edge,
+* such that the table needs a single pointer per slot.
+* Removed edges are shifted out of the probe sequence,
+* the table is free of tombstones.
+*
+* The index is optional and disabled by default. Once it
+* is enabled by icfEdgeIndex_enable(), it holds all edges
+* of the mesh, including the split edges of the
+* refinement tree, and it is maintained by
+* icfEdge_setNodes() and icfEdge_destroy().
+**********************************************************/
+struct icfEdgeIndex {
+
+  icfIndex  nEdges;   /* Number of stored edges          */
+  icfIndex  nSlots;   /* Number of slots, a power of two */
+  icfEdge **slots;    /* Edges, NULL for empty slots     */
+
+};
+
+/**********************************************************
+* Largest fill ratio of the table in tenths, before the
+* number of slots is doubled
+**********************************************************/
+#define ICF_EDGEINDEX_MAXLOAD 7
+
+/**********************************************************
+* Function: icfEdgeIndex_enable
+*----------------------------------------------------------
+* Creates the edge index of a mesh from all its edges,
+* which have their nodes set. Nothing is done, if the
+* index is already enabled.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfEdgeIndex_enable(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfEdgeIndex_disable
+*----------------------------------------------------------
+* Releases the edge index of a mesh
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+**********************************************************/
+void icfEdgeIndex_disable(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfEdgeIndex_rebuild
+*----------------------------------------------------------
+* Refills the edge index of a mesh from its edge stack,
+* which is required after the nodes or edges have been
+* moved in memory (see icfMesh_compact()). The table is
+* not reallocated.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+**********************************************************/
+void icfEdgeIndex_rebuild(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfEdgeIndex_insert
+*----------------------------------------------------------
+* Adds an edge with set nodes to an edge index and
+* doubles the table, if its fill ratio gets too high
+*----------------------------------------------------------
+* @param: index - edge index
+* @param: edge  - edge to add
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfEdgeIndex_insert(icfEdgeIndex *index, icfEdge *edge);
+
+/**********************************************************
+* Function: icfEdgeIndex_remove
+*----------------------------------------------------------
+* Removes an edge from an edge index. The nodes of the
+* edge must not have changed since its insertion.
+*----------------------------------------------------------
+* @param: index - edge index
+* @param: edge  - edge to remove
+**********************************************************/
+void icfEdgeIndex_remove(icfEdgeIndex *index, icfEdge *edge);
+
+/**********************************************************
+* Function: icfEdgeIndex_find
+*----------------------------------------------------------
+* @param: mesh   - pointer to mesh structure
+* @param: n0, n1 - nodes of the edge in any order
+* @return: edge connecting both nodes, NULL if there is
+*          no such edge or if the index is disabled
+**********************************************************/
+icfEdge *icfEdgeIndex_find(const icfMesh *mesh,
+                           const icfNode *n0,
+                           const icfNode *n1);
+
+/**********************************************************
+* Function: icfEdgeIndex_findByIndex
+*----------------------------------------------------------
+* Lookup by node indices, which are only valid after
+* icfMesh_update()
+*----------------------------------------------------------
+* @param: mesh   - pointer to mesh structure
+* @param: i0, i1 - node indices of the edge in any order
+* @return: edge connecting both nodes, NULL if there is
+*          no such edge or if the index is disabled
+**********************************************************/
+icfEdge *icfEdgeIndex_findByIndex(const icfMesh *mesh,
+                                  icfIndex       i0,
+                                  icfIndex       i1);
+
+#endif
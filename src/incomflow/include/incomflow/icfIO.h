@@ -38,6 +38,12 @@ typedef struct icfIOReader {
 *************************************************************/
 icfIOReader *icfIO_createReader(const char *file_path);
 
+/*************************************************************
+* Function to create a new mesh file reader, which keeps 
+* the file data only as a single string
+*************************************************************/
+icfIOReader *icfIO_createMeshReader(const char *file_path);
+
 /*************************************************************
 * Function to destroy a file reader structure
 *************************************************************/
@@ -101,28 +107,32 @@ int icfIO_extractArray(struct bstrList *txtlist,
 *----------------------------------------------------------
 * Function to read the mesh nodes from a mesh file
 * and writes them into an array of doubles
+* The lines of the section are parsed in parallel and
+* stored by the node ID in the first column.
 *----------------------------------------------------------
-* @param:  txtlist  - text file
+* @param:  file     - mesh file reader
 * @param:  xyNodes_ - array to write node coordinates
 * @param:  nNodes_  - integer to write number of nodes
+* @return: 0 on success, -1 on errors
 **********************************************************/
-void icfIO_readMeshNodes(struct bstrList *txtlist,
-                         icfDouble      (**xyNodes_)[2], 
-                         int             *nNodes_);
+int icfIO_readMeshNodes(icfIOReader     *file,
+                        icfDouble      (**xyNodes_)[2], 
+                        icfIndex        *nNodes_);
 
 /**********************************************************
-* Function: icfIO_readMeshNodes
+* Function: icfIO_readMeshTriangles
 *----------------------------------------------------------
-* Function to read the mesh nodes from a mesh file
-* and writes them into an array of doubles
+* Function to read the mesh triangles from a mesh file
+* and writes them into an array of ints
 *----------------------------------------------------------
-* @param:  txtlist  - text file
-* @param:  xyNodes_ - array to write node coordinates
-* @param:  nNodes_  - integer to write number of nodes
+* @param:  file     - mesh file reader
+* @param:  idxTris_ - array to write triangle node indices
+* @param:  nTris_   - integer to write number of triangles
+* @return: 0 on success, -1 on errors
 **********************************************************/
-void icfIO_readMeshTriangles(struct bstrList *txtlist,
-                             icfIndex      (**idxTris_)[3], 
-                             int             *nTris_);
+int icfIO_readMeshTriangles(icfIOReader     *file,
+                            icfIndex      (**idxTris_)[3], 
+                            icfIndex        *nTris_);
 
 /**********************************************************
 * Function: icfIO_readMeshNeighbors
@@ -130,19 +140,41 @@ void icfIO_readMeshTriangles(struct bstrList *txtlist,
 * Function to read the mesh triangle neighbor connectivity
 * from a mesh file and writes them into an array of ints
 *----------------------------------------------------------
-* @param:  txtlist  - text file
+* @param:  file     - mesh file reader
 * @param:  idxTriNbrs_ - array to write tri-neighbor indices 
-* @param:  nNbrs_   - integer to write number of triangles
+* @param:  nTris_   - integer to write number of triangles
+* @return: 0 on success, -1 on errors
 **********************************************************/
-void icfIO_readMeshTriNbrs(struct bstrList *txtlist,
-                           icfIndex      (**idxTriNbrs_)[3], 
-                           int             *nTris_);
+int icfIO_readMeshTriNbrs(icfIOReader     *file,
+                          icfIndex      (**idxTriNbrs_)[3], 
+                          icfIndex        *nTris_);
+
+/**********************************************************
+* Function: icfIO_readMeshBdryEdges
+*----------------------------------------------------------
+* Function to read the boundary edges from a mesh file
+* and writes them into an array of ints
+* Every boundary edge is defined by its two node indices
+* and its boundary marker
+*----------------------------------------------------------
+* @param:  file     - mesh file reader
+* @param:  idxBdryEdges_ - array to write boundary edges
+* @param:  nBdryEdges_   - integer to write number of edges
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfIO_readMeshBdryEdges(icfIOReader     *file,
+                            icfIndex      (**idxBdryEdges_)[3], 
+                            icfIndex        *nBdryEdges_);
 
 /**********************************************************
 * Function: icfIO_readMesh
 *----------------------------------------------------------
 * Function to read a mesh file an create a mesh structure
 * from it
+* If the file contains no NEIGHBORS section, the edges 
+* and triangle neighbors are computed from the triangles.
+* Boundary edges are then taken from an optional 
+* BOUNDARIES section.
 *----------------------------------------------------------
 * @param : meshFile - string with path to a mesh file
 * @param : mesh - pointer to mesh structure
@@ -150,4 +182,19 @@ void icfIO_readMeshTriNbrs(struct bstrList *txtlist,
 **********************************************************/
 void icfIO_readMesh(const char *meshFile, icfMesh *mesh);
 
+/**********************************************************
+* Function: icfIO_readGmsh
+*----------------------------------------------------------
+* Function to read a mesh in the Gmsh format 4.1 
+* (ASCII or binary) and to create a mesh structure from it.
+* Lines of physical curves are assigned to the boundary
+* with the physical tag as marker. Boundaries, that are 
+* not yet defined in the mesh, are created with the 
+* name of the physical group.
+*----------------------------------------------------------
+* @param : meshFile - string with path to a gmsh file
+* @param : mesh - pointer to mesh structure
+**********************************************************/
+void icfIO_readGmsh(const char *meshFile, icfMesh *mesh);
+
 #endif
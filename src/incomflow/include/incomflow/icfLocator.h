@@ -0,0 +1,138 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFLOCATOR_H
+#define INCOMFLOW_ICFLOCATOR_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Point location
+*----------------------------------------------------------
+* A query point is located in three stages:
+*
+* 1) The cached result of the previous query is taken 
+*    as start of a neighbor walk over the triangle leafs
+*    (see 3), if the point lies in the same cell of the
+*    seed grid. Successive queries along probe lines or 
+*    particle paths are thus found within a few steps.
+* 2) Otherwise, or if the walk leaves the domain, the 
+*    seed grid yields the root triangles of the initial
+*    mesh, whose bounding boxes overlap the cell of the
+*    point. The root triangle containing the point is 
+*    descended through the refinement tree (icfSplit.t_c)
+*    down to its leaf.
+* 3) A walk over the leaf neighbors tri->t[] moves 
+*    through the edge, whose outer side contains the 
+*    point, until the containing leaf is reached. This 
+*    resolves points, which are assigned to the wrong 
+*    child on the bisecting edges due to round-off.
+*
+* The seed grid holds about ICF_LOCATOR_ROOTSPERCELL root
+* triangles per cell. It is rebuilt automatically, once 
+* the mesh revision changes.
+**********************************************************/
+#define ICF_LOCATOR_ROOTSPERCELL 2
+
+/**********************************************************
+* Relative tolerance of the barycentric coordinates of 
+* points, which are accepted to lie inside a triangle.
+* It is raised to the round-off of the compute precision.
+**********************************************************/
+#define ICF_LOCATOR_EPS (1.0E-10 + 1.0E2 * ICF_DOUBLE_EPS)
+
+/**********************************************************
+* icfLocator: Point location service of a mesh
+**********************************************************/
+typedef struct icfLocator {
+
+  /*-------------------------------------------------------
+  | Located mesh and its revision at the last build
+  -------------------------------------------------------*/
+  icfMesh  *mesh;
+  uint64_t  revision;
+
+  /*-------------------------------------------------------
+  | Seed grid over the root triangles: the roots of cell 
+  | (i,j) are cellTris[cellStart[c]..cellStart[c+1]-1]
+  | with c = j*nx + i
+  -------------------------------------------------------*/
+  icfIndex   nx, ny;
+  icfDouble  xyMin[2];
+  icfDouble  xyMax[2];
+  icfDouble  cellSize[2];
+  icfIndex  *cellStart;
+  icfIndex   nCellTris;
+  icfTri   **cellTris;  /* With one spare entry          */
+
+  /*-------------------------------------------------------
+  | Result of the last query
+  -------------------------------------------------------*/
+  icfTri   *last;
+
+} icfLocator;
+
+/**********************************************************
+* Function: icfLocator_create
+*----------------------------------------------------------
+* Creates a locator for an updated mesh. The locator 
+* must be destroyed before its mesh.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+* @return: pointer to new locator, NULL on errors
+**********************************************************/
+icfLocator *icfLocator_create(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfLocator_destroy
+*----------------------------------------------------------
+* @param: loc - pointer to locator
+**********************************************************/
+void icfLocator_destroy(icfLocator *loc);
+
+/**********************************************************
+* Function: icfLocator_locate
+*----------------------------------------------------------
+* Finds the triangle leaf, which contains a point. 
+* The mesh must be updated (see icfMesh_update()).
+*----------------------------------------------------------
+* @param: loc - pointer to locator
+* @param: xy  - coordinates of the point
+* @param: w   - optional barycentric coordinates of the 
+*               point with respect to the nodes n[0..2] 
+*               of the triangle, may be NULL
+* @return: triangle leaf, NULL if the point lies outside
+*          of the mesh
+**********************************************************/
+icfTri *icfLocator_locate(icfLocator      *loc,
+                          const icfDouble  xy[2],
+                          icfDouble        w[3]);
+
+/**********************************************************
+* Function: icfLocator_locateBatch
+*----------------------------------------------------------
+* Locates an array of points in parallel with OpenMP, if
+* available. Every thread starts its walks from its 
+* previous result, hence neighboring points should be 
+* stored next to each other.
+*----------------------------------------------------------
+* @param: loc  - pointer to locator
+* @param: n    - number of points
+* @param: xy   - coordinates of the points
+* @param: tris - array to write the triangle leafs to,
+*                NULL for points outside of the mesh
+* @param: w    - optional array to write the barycentric 
+*                coordinates to, may be NULL
+* @return: number of located points, -1 on errors
+**********************************************************/
+icfIndex icfLocator_locateBatch(icfLocator  *loc,
+                                icfIndex     n,
+                                icfDouble  (*xy)[2],
+                                icfTri     **tris,
+                                icfDouble  (*w)[3]);
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFLOG_H
+#define INCOMFLOW_ICFLOG_H
+
+#include <stdio.h>
+
+/**********************************************************
+* Runtime levelled logging
+*----------------------------------------------------------
+* Every module has its own log level, which is checked 
+* before any argument is evaluated. Disabled messages
+* thus only cost a single, predicted branch:
+*
+*   icfLog(ICF_LOG_EDGE, ICF_LOG_DEBUG, 
+*          "SPLIT EDGE (%d,%d)", i0, i1);
+*
+* Levels are set with icfLog_setLevel() or with a 
+* specification string, e.g. from the environment:
+*
+*   ICF_LOG="info,edge=trace,io=off"
+*
+* Messages above ICF_LOG_MAXLEVEL are removed at
+* compile time.
+**********************************************************/
+#define ICF_LOG_OFF    0
+#define ICF_LOG_ERROR  1
+#define ICF_LOG_WARN   2
+#define ICF_LOG_INFO   3
+#define ICF_LOG_DEBUG  4
+#define ICF_LOG_TRACE  5
+
+#ifndef ICF_LOG_MAXLEVEL
+#define ICF_LOG_MAXLEVEL ICF_LOG_TRACE
+#endif
+
+#define ICF_LOG_DEFAULT_LEVEL ICF_LOG_WARN
+
+/**********************************************************
+* Modules
+**********************************************************/
+#define ICF_LOG_ALL      -1
+#define ICF_LOG_APP       0   /* Applications and tests    */
+#define ICF_LOG_MESH      1
+#define ICF_LOG_EDGE      2
+#define ICF_LOG_TRI       3
+#define ICF_LOG_IO        4
+#define ICF_LOG_OUTPUT    5
+#define ICF_LOG_NMODULES  6
+
+/**********************************************************
+* Current levels of all modules - read by icfLog()
+**********************************************************/
+extern int icfLog_levels[ICF_LOG_NMODULES];
+
+/**********************************************************
+* Function: icfLog_setLevel
+*----------------------------------------------------------
+* Sets the log level of a module
+*----------------------------------------------------------
+* @param: module - module or ICF_LOG_ALL
+* @param: level  - ICF_LOG_OFF ... ICF_LOG_TRACE
+**********************************************************/
+void icfLog_setLevel(int module, int level);
+
+/**********************************************************
+* Function: icfLog_configure
+*----------------------------------------------------------
+* Sets log levels from a comma separated specification.
+* Entries without module name apply to all modules:
+*   "debug"  or  "warn,mesh=debug,edge=trace"
+* Known names: off, error, warn, info, debug, trace and
+* app, mesh, edge, tri, io, output
+*----------------------------------------------------------
+* @param: spec - specification or NULL (no changes)
+* @return: 0 on success, -1 for invalid entries
+**********************************************************/
+int icfLog_configure(const char *spec);
+
+/**********************************************************
+* Function: icfLog_setStream
+*----------------------------------------------------------
+* Sets the output stream of all messages (default stderr)
+**********************************************************/
+void icfLog_setStream(FILE *stream);
+
+/**********************************************************
+* Function: icfLog_startAsync
+*----------------------------------------------------------
+* Starts a background thread, which writes the messages.
+* Logging threads only copy their messages into a ring
+* buffer and never wait for I/O. Messages are dropped, 
+* if the buffer is full.
+*----------------------------------------------------------
+* @param: nMessages - ring buffer size
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfLog_startAsync(int nMessages);
+
+/**********************************************************
+* Function: icfLog_stopAsync
+*----------------------------------------------------------
+* Writes all buffered messages and stops the background
+* thread. Messages are written directly afterwards.
+**********************************************************/
+void icfLog_stopAsync(void);
+
+/**********************************************************
+* Function: icfLog_flush
+*----------------------------------------------------------
+* Blocks until all buffered messages are written
+**********************************************************/
+void icfLog_flush(void);
+
+/**********************************************************
+* Function: icfLog_nDropped
+*----------------------------------------------------------
+* @return: number of messages dropped by the async logger
+**********************************************************/
+long icfLog_nDropped(void);
+
+/**********************************************************
+* Function: icfLog_write
+*----------------------------------------------------------
+* Formats and writes a message - use icfLog() instead
+**********************************************************/
+void icfLog_write(int module, int level, const char *fmt, ...)
+#if defined(__GNUC__)
+  __attribute__((format(printf, 3, 4)))
+#endif
+  ;
+
+/**********************************************************
+* Logging macro
+**********************************************************/
+#if defined(__GNUC__)
+#define icfLog_unlikely(x) __builtin_expect(!!(x), 0)
+#else
+#define icfLog_unlikely(x) (x)
+#endif
+
+#define icfLog(module, level, M, ...)                          \
+  do {                                                         \
+    if ( (level) <= ICF_LOG_MAXLEVEL                           \
+        && icfLog_unlikely(icfLog_levels[module] >= (level)) ) \
+      icfLog_write((module), (level), M, ##__VA_ARGS__);       \
+  } while (0)
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFMEM_H
+#define INCOMFLOW_ICFMEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**********************************************************
+* Instrumented allocator
+*----------------------------------------------------------
+* All long-lived library structures are allocated
+* through these wrappers, which keep the number of live
+* bytes per category and the high-water mark of all
+* categories. The bookkeeping is process-wide and
+* thread-safe.
+*
+* C does not report the size of a block on free(), so
+* the caller passes it back:
+*
+*   node = icfMem_calloc(ICF_MEM_NODES, 1, sizeof(icfNode));
+*   ...
+*   icfMem_free(ICF_MEM_NODES, node, sizeof(icfNode));
+**********************************************************/
+typedef enum icfMemCategory {
+  ICF_MEM_MESH,       /* Mesh and boundary structures  */
+  ICF_MEM_NODES,
+  ICF_MEM_EDGES,
+  ICF_MEM_TRIS,
+  ICF_MEM_LISTS,      /* icfList and icfListNode       */
+  ICF_MEM_LEAFS,      /* Node and leaf arrays of meshes*/
+  ICF_MEM_BDRY,       /* Node and leaf arrays of bdrys */
+  ICF_MEM_BDRYFACES,  /* Face arrays of boundaries    */
+  ICF_MEM_TREE,       /* Split records of meshes      */
+  ICF_MEM_EDGEINDEX,  /* Edge lookup tables of meshes */
+  ICF_MEM_LOCATOR,    /* Point locators (seed grids)  */
+  ICF_MEM_SNAPSHOT,   /* Mesh snapshots and chunks    */
+  ICF_MEM_NCATEGORIES
+} icfMemCategory;
+
+/**********************************************************
+* icfMemStats: Snapshot of the allocator bookkeeping
+**********************************************************/
+typedef struct icfMemStats {
+  int64_t bytes[ICF_MEM_NCATEGORIES];  /* Live bytes    */
+  int64_t blocks[ICF_MEM_NCATEGORIES]; /* Live blocks   */
+  int64_t totalBytes;                  /* Sum of bytes  */
+  int64_t peakBytes;                   /* High-water    */
+  int64_t nAllocs;                     /* Allocations   */
+} icfMemStats;
+
+/**********************************************************
+* Function: icfMem_malloc
+*----------------------------------------------------------
+* @param: category - accounting category
+* @param: size     - size of the block in bytes
+* @return: pointer to the block, NULL on failure
+**********************************************************/
+void *icfMem_malloc(icfMemCategory category, size_t size);
+
+/**********************************************************
+* Function: icfMem_calloc
+*----------------------------------------------------------
+* @param: category - accounting category
+* @param: n, size  - number and size of the elements
+* @return: pointer to the zeroed block, NULL on failure
+**********************************************************/
+void *icfMem_calloc(icfMemCategory category, size_t n, size_t size);
+
+/**********************************************************
+* Function: icfMem_realloc
+*----------------------------------------------------------
+* Resizes a block. A new size of zero releases the old
+* block and returns an empty allocation, such that the
+* result can always be stored and freed again.
+*----------------------------------------------------------
+* @param: category - accounting category
+* @param: ptr      - block to resize
+* @param: oldSize  - current size of the block in bytes
+* @param: newSize  - new size of the block in bytes
+* @return: pointer to the resized block, NULL on failure
+*          (the old block is left untouched)
+**********************************************************/
+void *icfMem_realloc(icfMemCategory category, void *ptr,
+                     size_t oldSize, size_t newSize);
+
+/**********************************************************
+* Function: icfMem_free
+*----------------------------------------------------------
+* @param: category - accounting category of the block
+* @param: ptr      - block to free, may be NULL
+* @param: size     - size of the block in bytes
+**********************************************************/
+void icfMem_free(icfMemCategory category, void *ptr, size_t size);
+
+/**********************************************************
+* Function: icfMem_getStats
+*----------------------------------------------------------
+* @param: stats - structure to copy the bookkeeping to
+**********************************************************/
+void icfMem_getStats(icfMemStats *stats);
+
+/**********************************************************
+* Function: icfMem_allocated
+*----------------------------------------------------------
+* @return: live bytes of all categories
+**********************************************************/
+int64_t icfMem_allocated(void);
+
+/**********************************************************
+* Function: icfMem_peak
+*----------------------------------------------------------
+* @return: high-water mark of the live bytes
+**********************************************************/
+int64_t icfMem_peak(void);
+
+/**********************************************************
+* Function: icfMem_nAllocs
+*----------------------------------------------------------
+* @return: number of allocations and reallocations 
+*          since program start
+**********************************************************/
+int64_t icfMem_nAllocs(void);
+
+/**********************************************************
+* Function: icfMem_resetPeak
+*----------------------------------------------------------
+* Sets the high-water mark to the current live bytes
+**********************************************************/
+void icfMem_resetPeak(void);
+
+/**********************************************************
+* Function: icfMem_categoryName
+*----------------------------------------------------------
+* @return: name of an accounting category
+**********************************************************/
+const char *icfMem_categoryName(icfMemCategory category);
+
+#endif
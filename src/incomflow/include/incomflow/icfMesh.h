@@ -16,20 +16,27 @@ typedef struct icfMesh {
   /*-------------------------------------------------------
   | Mesh nodes 
   -------------------------------------------------------*/
-  int       nNodes;
+  icfIndex  nNodes;
   icfList  *nodeStack;
   icfNode **nodes;
+  icfIndex  nNodesAlloc;  /* Length of the nodes array */
 
   /*-------------------------------------------------------
   | Mesh edges 
   -------------------------------------------------------*/
-  int      nEdges;
+  icfIndex nEdges;
   icfList *edgeStack;
 
+  /*-------------------------------------------------------
+  | Lookup of edges by their node pair, NULL if disabled
+  | (see icfEdgeIndex.h)
+  -------------------------------------------------------*/
+  icfEdgeIndex *edgeIndex;
+
   /*-------------------------------------------------------
   | Mesh triangles 
   -------------------------------------------------------*/
-  int      nTris;
+  icfIndex nTris;
   icfList *triStack;
 
   /*-------------------------------------------------------
@@ -39,20 +46,96 @@ typedef struct icfMesh {
   icfList *bdryStack;
 
   /*-------------------------------------------------------
-  | Mesh edge leafs 
+  | Mesh edge leafs and their ordering, which is applied
+  | by icfMesh_update() (see icfMeshOrder.h)
   -------------------------------------------------------*/
-  int        nEdgeLeafs;
-  icfEdge  **edgeLeafs;
+  icfIndex      nEdgeLeafs;
+  icfEdge     **edgeLeafs;
+  icfEdgeOrder  edgeOrder;
 
   /*-------------------------------------------------------
   | Mesh triangle leafs 
   -------------------------------------------------------*/
-  int       nTriLeafs;
+  icfIndex  nTriLeafs;
   icfTri  **triLeafs;
 
+  /*-------------------------------------------------------
+  | Refinement forest: one record for every split edge
+  | (see icfSplit.h)
+  -------------------------------------------------------*/
+  icfIndex   nSplits;
+  icfIndex   nSplitsAlloc; /* Length of the splits array */
+  icfIndex   splitFree;    /* First unused split         */
+  icfSplit  *splits;
+
+  /*-------------------------------------------------------
+  | Contiguous entity blocks of the last compaction 
+  | (see icfMesh_compact()). Entities inside these 
+  | blocks are released with their block, entities 
+  | created afterwards are allocated individually.
+  -------------------------------------------------------*/
+  icfIndex            nNodeSlab;
+  icfNode            *nodeSlab;
+  icfIndex            nEdgeSlab;
+  icfEdge            *edgeSlab;
+  struct icfEdgeCold *edgeColdSlab;
+  icfIndex            nTriSlab;
+  icfTri             *triSlab;
+  struct icfTriCold  *triColdSlab;
+
+  /*-------------------------------------------------------
+  | Revision of the mesh entities, which is incremented 
+  | by icfMesh_update() and icfMesh_compact(). Structures,
+  | which hold entities of the mesh, compare it to detect
+  | stale pointers.
+  -------------------------------------------------------*/
+  uint64_t            revision;
 
 } icfMesh;
 
+/**********************************************************
+* ICF_MESH_INSLAB: TRUE, if an entity is located in a 
+* contiguous block of n entities
+**********************************************************/
+#define ICF_MESH_INSLAB(p, slab, n)                          \
+  (  (uintptr_t)(p) >= (uintptr_t)(slab)                     \
+  && (uintptr_t)(p) <  (uintptr_t)(slab) + (n)*sizeof(*(slab)) )
+
+/**********************************************************
+* icfMeshMemStats: Memory held by a mesh
+*----------------------------------------------------------
+* Entities of deeper tree levels are counted in the 
+* last level.
+**********************************************************/
+#define ICF_MESH_MAXLEVELS 32
+
+typedef struct icfMeshMemStats {
+
+  /*-------------------------------------------------------
+  | Bytes held by the mesh per allocator category 
+  -------------------------------------------------------*/
+  int64_t bytes[ICF_MEM_NCATEGORIES];
+  int64_t totalBytes;
+
+  /*-------------------------------------------------------
+  | Entity counts per refinement tree level 
+  -------------------------------------------------------*/
+  int      nLevels;
+  icfIndex nEdges[ICF_MESH_MAXLEVELS];
+  icfIndex nTris[ICF_MESH_MAXLEVELS];
+  icfIndex nEdgeLeafs[ICF_MESH_MAXLEVELS];
+  icfIndex nTriLeafs[ICF_MESH_MAXLEVELS];
+  icfIndex nNodes;
+  icfIndex nListNodes;
+
+  /*-------------------------------------------------------
+  | Process-wide allocator state (see icfMem.h)
+  -------------------------------------------------------*/
+  int64_t allocatedBytes;
+  int64_t peakBytes;
+
+} icfMeshMemStats;
+
 
 /**********************************************************
 * Function: icfMesh_create
@@ -146,6 +229,78 @@ void icfMesh_remTri(icfMesh *mesh, icfTri *tri);
 **********************************************************/
 void icfMesh_remBdry(icfMesh *mesh, icfBdry *bdry);
 
+/**********************************************************
+* Function: icfMesh_buildFromNbrs()
+*----------------------------------------------------------
+* Function to create the entities of an empty mesh from
+* arrays of node coordinates, triangle node indices and
+* triangle neighbor indices.
+* The neighbor tris[i][j] is located opposite of the 
+* node tris[i][j]. Negative neighbor indices denote 
+* boundary edges with the marker -triNbrs[i][j], 
+* ICF_OUTPUT_NOBDRY denotes boundary edges, that are not
+* assigned to any boundary.
+* All boundaries must be defined in the mesh beforehand.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param nNodes, xyNodes: node coordinates
+* @param nTris, idxTris: triangle node indices
+* @param idxTriNbrs: triangle neighbor indices
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMesh_buildFromNbrs(icfMesh   *mesh,
+                          icfIndex   nNodes,
+                          icfDouble (*xyNodes)[2],
+                          icfIndex   nTris,
+                          icfIndex  (*idxTris)[3],
+                          icfIndex  (*idxTriNbrs)[3]);
+
+/**********************************************************
+* Function: icfMesh_pairTris()
+*----------------------------------------------------------
+* Function to compute the triangle neighbor indices 
+* from the triangle node indices alone.
+* Edges are identified by their sorted node pair in 
+* an open-addressing hash table, such that the pairing
+* runs in linear time. The pairing loop is parallelised
+* with OpenMP, if available.
+* Unpaired triangle sides get the neighbor index -1.
+*----------------------------------------------------------
+* @param nTris, idxTris: triangle node indices
+* @param idxTriNbrs: array to write neighbor indices to
+* @return: 0 on success, -1 for non-manifold or 
+*          inconsistently oriented triangles
+**********************************************************/
+int icfMesh_pairTris(icfIndex   nTris,
+                     icfIndex (*idxTris)[3],
+                     icfIndex (*idxTriNbrs)[3]);
+
+/**********************************************************
+* Function: icfMesh_buildFromTris()
+*----------------------------------------------------------
+* Function to create the entities of an empty mesh from
+* arrays of node coordinates and triangle node indices.
+* Edges and triangle neighbors are computed with 
+* icfMesh_pairTris(). 
+* Boundary edges are assigned to the boundaries via 
+* an optional list of boundary edges (n0, n1, marker).
+* Boundary edges, that are not listed, are not assigned
+* to any boundary.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param nNodes, xyNodes: node coordinates
+* @param nTris, idxTris: triangle node indices
+* @param nBdryEdges, idxBdryEdges: boundary edges 
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMesh_buildFromTris(icfMesh   *mesh,
+                          icfIndex   nNodes,
+                          icfDouble (*xyNodes)[2],
+                          icfIndex   nTris,
+                          icfIndex  (*idxTris)[3],
+                          icfIndex   nBdryEdges,
+                          icfIndex  (*idxBdryEdges)[3]);
+
 /**********************************************************
 * Function: icfMesh_refine()
 *----------------------------------------------------------
@@ -169,7 +324,9 @@ void icfMesh_coarsen(icfFlowData *flowData, icfMesh *mesh);
 *----------------------------------------------------------
 * Function to update all mesh leafs structures and 
 * the mesh arrays.
-* The entities get their global indices here.
+* The entities get their global indices here and the
+* nodes and edge leafs are reordered according to the 
+* edgeOrder of the mesh.
 * Furthermore, the mesh normals and volumes for the 
 * flow solver are calculated.
 * This is mandatory after refining the mesh or setting
@@ -179,6 +336,31 @@ void icfMesh_coarsen(icfFlowData *flowData, icfMesh *mesh);
 **********************************************************/
 void icfMesh_update(icfMesh *mesh);
 
+/**********************************************************
+* Function: icfMesh_compact()
+*----------------------------------------------------------
+* Function to relocate all nodes, edges and triangles of
+* an updated mesh into one contiguous block per entity 
+* type and to pack the split records of the refinement
+* forest.
+* Edge and triangle leafs are placed first in the order 
+* of the leaf arrays, followed by the non-leaf entities 
+* in the order of their splits. Nodes are placed in the
+* order of their indices.
+* Indices, leaf positions and stack order are not 
+* changed, only the addresses of the entities and the 
+* indices of the split records. Pointers to entities, 
+* which are held outside of the mesh, are invalidated.
+* The previous blocks and all individually allocated 
+* entities are released and free heap memory is 
+* returned to the operating system, where supported.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors (the mesh is left
+*          unchanged)
+**********************************************************/
+int icfMesh_compact(icfMesh *mesh);
+
 /**********************************************************
 * Function: icfMesh_calcDualMetrics()
 *----------------------------------------------------------
@@ -204,6 +386,47 @@ void icfMesh_update(icfMesh *mesh);
 **********************************************************/
 void icfMesh_calcDualMetrics(icfMesh *mesh);
 
+/**********************************************************
+* Function: icfMesh_memoryStats()
+*----------------------------------------------------------
+* Function to compute the memory held by a mesh, 
+* including non-leaf tree entities, list nodes, leaf 
+* arrays, boundary arrays, boundary normals and the 
+* edge index.
+* The byte counts match the bookkeeping of the 
+* instrumented allocator for the blocks of this mesh.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param stats: structure to write the statistics to
+**********************************************************/
+void icfMesh_memoryStats(icfMesh *mesh, icfMeshMemStats *stats);
+
+/**********************************************************
+* Function: icfMesh_validate()
+*----------------------------------------------------------
+* Function to check the consistency of an updated mesh:
+* - edge <-> triangle <-> node connectivity of all leafs
+* - counter-clockwise triangles, edges with the left 
+*   triangle in t[0]
+* - symmetric triangle neighbors
+* - leaf flags and leaf positions
+* - parent / child symmetry of the refinement tree
+* - positive median-dual volumes, which sum up to the
+*   mesh area
+* - closed and consistently oriented boundaries, which 
+*   contain all edges with a single triangle and whose
+*   face arrays match their edge leafs
+* The leaf loops run in parallel with OpenMP, if 
+* available. The first ICF_MESH_MAXREPORTS errors are 
+* logged.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: number of inconsistencies, 0 for a valid mesh
+**********************************************************/
+#define ICF_MESH_MAXREPORTS 10
+
+int icfMesh_validate(icfMesh *mesh);
+
 /**********************************************************
 * Function: icfMesh_printMesh()
 *----------------------------------------------------------
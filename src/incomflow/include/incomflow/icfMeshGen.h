@@ -0,0 +1,89 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFMESHGEN_H
+#define INCOMFLOW_ICFMESHGEN_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Boundary markers of generated meshes
+**********************************************************/
+#define ICF_MESHGEN_SOUTH 1
+#define ICF_MESHGEN_EAST  2
+#define ICF_MESHGEN_NORTH 3
+#define ICF_MESHGEN_WEST  4
+#define ICF_MESHGEN_HOLE  5
+
+/**********************************************************
+* icfMeshGenParams:
+*----------------------------------------------------------
+* Parameters for the generation of a triangulated 
+* rectangle. The rectangle is divided into nx x ny cells,
+* which are split into two triangles with alternating
+* diagonals.
+**********************************************************/
+typedef struct icfMeshGenParams {
+
+  /*-------------------------------------------------------
+  | Domain and resolution
+  -------------------------------------------------------*/
+  icfDouble   xy0[2];     /* Lower left corner            */
+  icfDouble   xy1[2];     /* Upper right corner           */
+  int         nx;         /* Number of cells in x         */
+  int         ny;         /* Number of cells in y         */
+
+  /*-------------------------------------------------------
+  | Random displacement of interior nodes as fraction of
+  | the cell size (0 <= jitter < 1/6 keeps all 
+  | triangles valid)
+  -------------------------------------------------------*/
+  icfDouble   jitter;
+  unsigned    seed;
+
+  /*-------------------------------------------------------
+  | Rectangular holes (x0, y0, x1, y1)
+  | All cells with their center inside a hole are 
+  | removed. Hole edges get the marker ICF_MESHGEN_HOLE.
+  -------------------------------------------------------*/
+  int         nHoles;
+  icfDouble (*holes)[4];
+
+} icfMeshGenParams;
+
+/**********************************************************
+* Function: icfMeshGen_initParams
+*----------------------------------------------------------
+* Sets default parameters: the unit square with 
+* 1 x 1 cells, without jitter and without holes
+*----------------------------------------------------------
+* @param: params - parameters to initialize
+**********************************************************/
+void icfMeshGen_initParams(icfMeshGenParams *params);
+
+/**********************************************************
+* Function: icfMeshGen_rectangle
+*----------------------------------------------------------
+* Creates the entities of a triangulated rectangle 
+* in an empty mesh. 
+* The boundaries SOUTH, EAST, NORTH, WEST and HOLE 
+* (only if holes are defined) are created, if the mesh 
+* does not contain boundaries with the respective 
+* markers.
+* Node coordinates, triangles and triangle neighbors 
+* are computed in parallel in linear time - no search 
+* for edges is required.
+* icfMesh_update() must be called afterwards.
+*----------------------------------------------------------
+* @param: mesh   - pointer to an empty mesh structure
+* @param: params - generator parameters
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshGen_rectangle(icfMesh                *mesh,
+                         const icfMeshGenParams *params);
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFMESHORDER_H
+#define INCOMFLOW_ICFMESHORDER_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Leaf orderings
+*----------------------------------------------------------
+* Edge loops gather and scatter node data through both
+* edge nodes. The order of the edge leafs decides, how 
+* often these accesses miss the cache:
+*
+* ICF_EDGEORDER_STACK   - creation order, refined edges
+*                         are appended at the end
+* ICF_EDGEORDER_MINNODE - edge leafs sorted by their 
+*                         lower and then by their higher
+*                         node index, such that the edges 
+*                         of a node are visited together
+* ICF_EDGEORDER_RCM     - nodes numbered by the reverse 
+*                         Cuthill-McKee ordering of the 
+*                         leaf edge graph, which keeps the
+*                         indices of neighboring nodes 
+*                         close, then MINNODE
+*
+* The ordering of a mesh is chosen by its edgeOrder and 
+* applied by icfMesh_update().
+**********************************************************/
+
+/**********************************************************
+* Function: icfMeshOrder_apply()
+*----------------------------------------------------------
+* Function to reorder the nodes and edge leafs of a mesh
+* with freshly built leaf and node arrays according to
+* its edgeOrder. Node indices and edge leaf positions 
+* are updated.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshOrder_apply(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfMeshOrder_nodesRCM()
+*----------------------------------------------------------
+* Function to number the nodes of a mesh by the reverse 
+* Cuthill-McKee ordering of its leaf edges. Every 
+* connected component starts at a pseudo-peripheral 
+* node.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshOrder_nodesRCM(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfMeshOrder_edgeLeafs()
+*----------------------------------------------------------
+* Function to sort the edge leafs of a mesh by their 
+* lower and then by their higher node index. The sort 
+* is stable and runs in linear time.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshOrder_edgeLeafs(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfMeshOrder_bandwidth()
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: largest index difference of the nodes of an
+*          edge leaf
+**********************************************************/
+icfIndex icfMeshOrder_bandwidth(const icfMesh *mesh);
+
+/**********************************************************
+* Function: icfMeshOrder_name()
+*----------------------------------------------------------
+* @return: name of an edge ordering ("stack", "minnode",
+*          "rcm")
+**********************************************************/
+const char *icfMeshOrder_name(icfEdgeOrder order);
+
+/**********************************************************
+* Function: icfMeshOrder_fromName()
+*----------------------------------------------------------
+* @return: edge ordering of a name, -1 if unknown
+**********************************************************/
+int icfMeshOrder_fromName(const char *name);
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFMESHSNAPSHOT_H
+#define INCOMFLOW_ICFMESHSNAPSHOT_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Mesh snapshots
+*----------------------------------------------------------
+* A snapshot is an immutable copy of the leaf data of an
+* updated mesh: node coordinates and dual volumes, the
+* nodes, neighbors, centroids, areas and levels of the
+* triangle leafs. It is taken by the thread, that adapts
+* the mesh, and it can be read by any number of threads
+* (output, diagnostics, point probes), while the mesh is
+* adapted further.
+*
+* Every array of a snapshot is stored in chunks of
+* ICF_SNAPSHOT_CHUNKLEN entries. A snapshot is captured
+* with respect to the previous snapshot of the same mesh:
+* chunks, whose content has not changed, are shared with
+* the previous snapshot, only changed chunks are copied.
+* Snapshots and chunks are reference counted, such that
+* a snapshot stays valid until its last holder releases
+* it, independently of the snapshots taken afterwards.
+*
+*   snap = icfMeshSnapshot_capture(mesh, NULL);
+*   ...
+*   icfMesh_refine(flowData, mesh);
+*   next = icfMeshSnapshot_capture(mesh, snap);
+*   icfMeshSnapshot_release(snap);
+**********************************************************/
+#define ICF_SNAPSHOT_CHUNKSHIFT 10
+#define ICF_SNAPSHOT_CHUNKLEN   (1 << ICF_SNAPSHOT_CHUNKSHIFT)
+#define ICF_SNAPSHOT_CHUNKMASK  (ICF_SNAPSHOT_CHUNKLEN - 1)
+
+/**********************************************************
+* icfSnapshotArray: Arrays of a snapshot
+*----------------------------------------------------------
+* Triangle data is ordered as mesh->triLeafs, node data
+* as mesh->nodes. Boundary neighbors are denoted by the
+* negative marker of the respective boundary or by 
+* ICF_OUTPUT_NOBDRY (see icfOutputFrame).
+**********************************************************/
+typedef enum icfSnapshotArray {
+  ICF_SNAPSHOT_NODEXY,    /* icfDouble[2] per node       */
+  ICF_SNAPSHOT_NODEVOL,   /* icfDouble per node          */
+  ICF_SNAPSHOT_TRINODES,  /* icfIndex[3] per triangle    */
+  ICF_SNAPSHOT_TRINBRS,   /* icfIndex[3] per triangle    */
+  ICF_SNAPSHOT_TRIXY,     /* icfDouble[2] per triangle   */
+  ICF_SNAPSHOT_TRIAREA,   /* icfDouble per triangle      */
+  ICF_SNAPSHOT_TRILEVEL,  /* icfIndex per triangle       */
+  ICF_SNAPSHOT_NARRAYS
+} icfSnapshotArray;
+
+/**********************************************************
+* icfSnapshotChunk: Reference counted block of entries
+**********************************************************/
+typedef struct icfSnapshotChunk {
+
+  int            refs;   /* Number of holding snapshots */
+  icfIndex       size;   /* Size of the data in bytes   */
+  unsigned char  data[]; /* Entries of the chunk        */
+
+} icfSnapshotChunk;
+
+/**********************************************************
+* icfMeshSnapshot
+**********************************************************/
+struct icfMeshSnapshot {
+
+  /*-------------------------------------------------------
+  | Number of holders and the mesh revision at capture
+  -------------------------------------------------------*/
+  int                 refs;
+  uint64_t            revision;
+
+  /*-------------------------------------------------------
+  | Leaf data: the entry i of an array is stored in
+  | chunk i >> ICF_SNAPSHOT_CHUNKSHIFT
+  -------------------------------------------------------*/
+  icfIndex            nNodes;
+  icfIndex            nTris;
+  icfIndex            nChunks[ICF_SNAPSHOT_NARRAYS];
+  icfSnapshotChunk  **chunks[ICF_SNAPSHOT_NARRAYS];
+
+  /*-------------------------------------------------------
+  | Chunks taken over from the previous snapshot and
+  | chunks copied from the mesh at capture
+  -------------------------------------------------------*/
+  icfIndex            nShared;
+  icfIndex            nCopied;
+
+};
+
+/**********************************************************
+* ICF_SNAPSHOT_GET: Pointer to the <width> values of
+* type <type> of entry i in an array of a snapshot
+**********************************************************/
+#define ICF_SNAPSHOT_GET(snap, array, type, width, i)           \
+  ( (const type*) (const void*) (snap)->chunks[array]            \
+                  [(i) >> ICF_SNAPSHOT_CHUNKSHIFT]->data         \
+  + (width) * ((i) & ICF_SNAPSHOT_CHUNKMASK) )
+
+#define icfMeshSnapshot_nodeXY(snap, i)                         \
+  ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_NODEXY, icfDouble, 2, i)
+#define icfMeshSnapshot_nodeVol(snap, i)                        \
+  (*ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_NODEVOL, icfDouble, 1, i))
+#define icfMeshSnapshot_triNodes(snap, i)                       \
+  ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_TRINODES, icfIndex, 3, i)
+#define icfMeshSnapshot_triNbrs(snap, i)                        \
+  ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_TRINBRS, icfIndex, 3, i)
+#define icfMeshSnapshot_triXY(snap, i)                          \
+  ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_TRIXY, icfDouble, 2, i)
+#define icfMeshSnapshot_triArea(snap, i)                        \
+  (*ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_TRIAREA, icfDouble, 1, i))
+#define icfMeshSnapshot_triLevel(snap, i)                       \
+  (*ICF_SNAPSHOT_GET(snap, ICF_SNAPSHOT_TRILEVEL, icfIndex, 1, i))
+
+/**********************************************************
+* Function: icfMeshSnapshot_capture
+*----------------------------------------------------------
+* Captures the leaf data of an updated mesh. The chunks
+* are filled in parallel with OpenMP, if available.
+* The returned snapshot is held once by the caller.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+* @param: prev - previous snapshot of the mesh, whose
+*                unchanged chunks are shared, may be NULL
+* @return: pointer to new snapshot, NULL on errors
+**********************************************************/
+icfMeshSnapshot *icfMeshSnapshot_capture(icfMesh         *mesh,
+                                         icfMeshSnapshot *prev);
+
+/**********************************************************
+* Function: icfMeshSnapshot_retain
+*----------------------------------------------------------
+* Adds a holder to a snapshot, which may be called from
+* any thread
+*----------------------------------------------------------
+* @param: snap - pointer to snapshot
+* @return: snap
+**********************************************************/
+icfMeshSnapshot *icfMeshSnapshot_retain(icfMeshSnapshot *snap);
+
+/**********************************************************
+* Function: icfMeshSnapshot_release
+*----------------------------------------------------------
+* Removes a holder from a snapshot, which may be called
+* from any thread. The snapshot is destroyed with its
+* last holder, chunks are freed with their last snapshot.
+*----------------------------------------------------------
+* @param: snap - pointer to snapshot, may be NULL
+**********************************************************/
+void icfMeshSnapshot_release(icfMeshSnapshot *snap);
+
+#endif
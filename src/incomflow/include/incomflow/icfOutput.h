@@ -0,0 +1,302 @@
+/*
+ * This header file is part of the incomflow library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFOUTPUT_H
+#define INCOMFLOW_ICFOUTPUT_H
+
+#include <pthread.h>
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Binary leaf mesh dump
+*----------------------------------------------------------
+* All values are stored in the native byte order.
+* Reals are stored as icfDouble and indices as icfIndex,
+* so their sizes depend on the build configuration: 
+* 4 or 8 bytes with INCOMFLOW_REAL_COMPUTE float or 
+* double and with INCOMFLOW_INDEX_BITS 32 or 64. Readers
+* must take both sizes from the header.
+*
+* Header (64 bytes):
+*   char[8]  magic         "ICFMESH"
+*   int32    version       ICF_OUTPUT_BINVERSION
+*   int32    real size     sizeof(icfDouble)
+*   int32    index size    sizeof(icfIndex)
+*   int32    nNodeFields
+*   int32    nCellFields
+*   int32    reserved
+*   int64    step
+*   int64    nNodes
+*   int64    nTris
+*   int64    reserved
+*
+* Field names:
+*   char[ICF_OUTPUT_NAMELEN] for every node field and 
+*   every cell field
+*
+* Data:
+*   real [nNodes][2]  node coordinates
+*   index[nTris][3]   triangle node indices
+*   index[nTris][3]   triangle neighbors (see icfOutputFrame)
+*   real [nNodes]     for every node field
+*   real [nTris]      for every cell field
+**********************************************************/
+#define ICF_OUTPUT_MAGIC      "ICFMESH"
+#define ICF_OUTPUT_BINVERSION 2
+#define ICF_OUTPUT_NAMELEN    32
+
+/**********************************************************
+* Neighbor of a triangle side on a boundary edge, that is
+* not assigned to any boundary. No negative marker of a
+* boundary equals this value.
+**********************************************************/
+#define ICF_OUTPUT_NOBDRY     (-ICF_INDEX_MAX - 1)
+
+/**********************************************************
+* icfOutputFrame:
+*----------------------------------------------------------
+* Staging buffer for one mesh snapshot.
+* The leaf data of a mesh is copied into a frame by the
+* solver thread, such that the frame can be serialised
+* independently of the mesh.
+* The buffers of a frame are re-used between snapshots
+* and only grow if the mesh grows.
+**********************************************************/
+typedef struct icfOutputFrame {
+
+  /*-------------------------------------------------------
+  | Snapshot properties
+  -------------------------------------------------------*/
+  icfIndex   step;
+  char      *path;
+
+  /*-------------------------------------------------------
+  | Node data
+  -------------------------------------------------------*/
+  icfIndex    nNodes;
+  icfIndex    nNodesAlloc;
+  icfDouble (*xy)[2];
+  icfDouble  *vol;
+
+  /*-------------------------------------------------------
+  | Triangle data: node indices and neighbor indices
+  | Boundary neighbors are denoted by the negative
+  | marker of the respective boundary, boundary edges 
+  | without a boundary by ICF_OUTPUT_NOBDRY
+  -------------------------------------------------------*/
+  icfIndex    nTris;
+  icfIndex    nTrisAlloc;
+  icfIndex  (*tris)[3];
+  icfIndex  (*triNbrs)[3];
+
+  /*-------------------------------------------------------
+  | Cell fields, ordered as the triangle data
+  | The field "level" with the refinement level of the
+  | triangles is always captured
+  -------------------------------------------------------*/
+  int         nCellFields;
+  char      (*cellFieldNames)[ICF_OUTPUT_NAMELEN];
+  icfDouble **cellFields;
+
+} icfOutputFrame;
+
+/**********************************************************
+* icfOutputWriter:
+*----------------------------------------------------------
+* Asynchronous snapshot writer.
+* The writer owns a bounded ring of <nSlots> frames.
+* The solver thread fills free frames and a background
+* thread writes queued frames to disk.
+* If all frames are in use, the solver thread blocks
+* until the writer thread has released a frame.
+**********************************************************/
+typedef struct icfOutputWriter {
+
+  /*-------------------------------------------------------
+  | Output file prefix
+  -------------------------------------------------------*/
+  char           *prefix;
+
+  /*-------------------------------------------------------
+  | Ring buffer of frames
+  | Queued frames are frames[head] ... frames[head+count-1]
+  -------------------------------------------------------*/
+  int             nSlots;
+  icfOutputFrame *frames;
+  int             head;
+  int             count;
+
+  /*-------------------------------------------------------
+  | Writer thread and synchronisation
+  -------------------------------------------------------*/
+  pthread_t       thread;
+  pthread_mutex_t lock;
+  pthread_cond_t  notEmpty;
+  pthread_cond_t  notFull;
+  icfBool         stop;
+
+  /*-------------------------------------------------------
+  | Write binary dumps "<prefix>_<step>.bin" instead of
+  | text files - must be set before the first push
+  -------------------------------------------------------*/
+  icfBool         binary;
+
+  /*-------------------------------------------------------
+  | Statistics
+  -------------------------------------------------------*/
+  int             nQueued;  /* Number of queued frames     */
+  int             nWritten; /* Number of written frames    */
+  int             nStalls;  /* Number of blocked pushes    */
+
+} icfOutputWriter;
+
+
+/**********************************************************
+* Function: icfOutput_captureFrame
+*----------------------------------------------------------
+* Copies the leaf data of a mesh into a frame
+* The mesh must have been updated before.
+*----------------------------------------------------------
+* @param: frame - frame to write data to
+* @param: mesh  - mesh to capture
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_captureFrame(icfOutputFrame *frame,
+                           icfMesh        *mesh);
+
+/**********************************************************
+* Function: icfOutput_captureSnapshot
+*----------------------------------------------------------
+* Copies the data of a mesh snapshot into a frame, which
+* yields the same frame as icfOutput_captureFrame() at
+* the time of the snapshot. The mesh may be modified 
+* meanwhile.
+*----------------------------------------------------------
+* @param: frame - frame to write data to
+* @param: snap  - snapshot to capture
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_captureSnapshot(icfOutputFrame        *frame,
+                              const icfMeshSnapshot *snap);
+
+/**********************************************************
+* Function: icfOutput_writeFrame
+*----------------------------------------------------------
+* Writes a frame to a text file, that can be read with
+* icfIO_readMesh()
+*----------------------------------------------------------
+* @param: frame - frame to write
+* @param: path  - output file path
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_writeFrame(const icfOutputFrame *frame,
+                         const char           *path);
+
+/**********************************************************
+* Function: icfOutput_addCellField
+*----------------------------------------------------------
+* Adds a copy of a cell field to a captured frame
+*----------------------------------------------------------
+* @param: frame  - captured frame
+* @param: name   - field name (truncated to 
+*                  ICF_OUTPUT_NAMELEN-1 characters)
+* @param: values - one value for every triangle leaf,
+*                  ordered as mesh->triLeafs
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_addCellField(icfOutputFrame  *frame,
+                           const char      *name,
+                           const icfDouble *values);
+
+/**********************************************************
+* Function: icfOutput_writeFrameBinary
+*----------------------------------------------------------
+* Writes a frame to a binary leaf mesh dump 
+*----------------------------------------------------------
+* @param: frame - frame to write
+* @param: path  - output file path
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_writeFrameBinary(const icfOutputFrame *frame,
+                               const char           *path);
+
+/**********************************************************
+* Function: icfOutput_dumpMesh
+*----------------------------------------------------------
+* Writes the leaf data of a mesh to a binary leaf mesh 
+* dump. The mesh must have been updated before.
+*----------------------------------------------------------
+* @param: mesh - mesh to write
+* @param: path - output file path
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_dumpMesh(icfMesh    *mesh,
+                       const char *path);
+
+/**********************************************************
+* Function: icfOutput_clearFrame
+*----------------------------------------------------------
+* Frees all buffers of a frame
+*----------------------------------------------------------
+* @param: frame - frame to clear
+**********************************************************/
+void icfOutput_clearFrame(icfOutputFrame *frame);
+
+/**********************************************************
+* Function: icfOutput_createWriter
+*----------------------------------------------------------
+* Create a new asynchronous writer and start its
+* background thread.
+* Snapshots are written to "<prefix>_<step>.dat" or to 
+* "<prefix>_<step>.bin" for binary writers
+*----------------------------------------------------------
+* @param: prefix - prefix of output files
+* @param: nSlots - number of staging frames (>= 1)
+*                  2 gives a double-buffered writer
+* @return: pointer to new writer structure
+**********************************************************/
+icfOutputWriter *icfOutput_createWriter(const char *prefix,
+                                        int         nSlots);
+
+/**********************************************************
+* Function: icfOutput_destroyWriter
+*----------------------------------------------------------
+* Writes all queued frames, stops the writer thread
+* and frees the writer
+*----------------------------------------------------------
+* @param: writer - pointer to writer structure
+* @return: returns 0 on success
+**********************************************************/
+int icfOutput_destroyWriter(icfOutputWriter *writer);
+
+/**********************************************************
+* Function: icfOutput_pushMesh
+*----------------------------------------------------------
+* Stages the leaf data of a mesh in a free frame and
+* queues it for writing.
+* Blocks if all frames of the writer are queued.
+*----------------------------------------------------------
+* @param: writer - pointer to writer structure
+* @param: mesh   - mesh to write
+* @param: step   - time step of the snapshot
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_pushMesh(icfOutputWriter *writer,
+                       icfMesh         *mesh,
+                       icfIndex         step);
+
+/**********************************************************
+* Function: icfOutput_flush
+*----------------------------------------------------------
+* Blocks until all queued frames have been written
+*----------------------------------------------------------
+* @param: writer - pointer to writer structure
+**********************************************************/
+void icfOutput_flush(icfOutputWriter *writer);
+
+#endif
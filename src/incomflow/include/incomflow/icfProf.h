@@ -0,0 +1,309 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFPROF_H
+#define INCOMFLOW_ICFPROF_H
+
+#include <stdint.h>
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Lightweight instrumentation of the library hot paths
+*----------------------------------------------------------
+* Timers are identified by name and can be nested. 
+* Each timer accumulates its number of calls, its total 
+* (inclusive) time and its self time, which excludes 
+* the time spent in nested timers of the same thread.
+*
+*   ICF_PROF_BEGIN(refine, "icfMesh_refine");
+*   ...
+*   ICF_PROF_END(refine);
+*
+* Profiling is compiled in by default (ICF_PROFILE) 
+* and switched off at runtime. Disabled timers and 
+* counters only cost a single branch.
+* The same hooks feed the event tracer (icfTrace.h).
+* Compile with -DICF_PROFILE=0 to remove all hooks.
+**********************************************************/
+#ifndef ICF_PROFILE
+#define ICF_PROFILE 1
+#endif
+
+#define ICF_PROF_MAXTIMERS  64  /* Number of distinct timers */
+#define ICF_PROF_MAXDEPTH   32  /* Nesting depth per thread  */
+#define ICF_PROF_NAMELEN    48
+
+/**********************************************************
+* Counters
+**********************************************************/
+typedef enum icfProfCounter {
+  ICF_PROF_EDGE_SPLITS,       /* Number of edge splits     */
+  ICF_PROF_EDGE_MERGES,       /* Number of edge merges     */
+  ICF_PROF_NODES_CREATED,
+  ICF_PROF_NODES_FREED,
+  ICF_PROF_EDGES_CREATED,
+  ICF_PROF_EDGES_FREED,
+  ICF_PROF_TRIS_CREATED,
+  ICF_PROF_TRIS_FREED,
+  ICF_PROF_BYTES_ALLOCATED,   /* Bytes of mesh entities    */
+  ICF_PROF_BYTES_FREED,
+  ICF_PROF_TRI_LEAFS,         /* Leafs of the last update  */
+  ICF_PROF_EDGE_LEAFS,
+  ICF_PROF_NCOUNTERS
+} icfProfCounter;
+
+/**********************************************************
+* Hardware performance counters (Linux perf_event_open)
+*----------------------------------------------------------
+* Every event is opened separately for each thread, such
+* that the available events are used, if the PMU or the
+* permissions only allow a subset. Counts are scaled 
+* for multiplexing and only include user space.
+**********************************************************/
+typedef enum icfProfHWEvent {
+  ICF_PROF_HW_CYCLES,
+  ICF_PROF_HW_INSTRUCTIONS,
+  ICF_PROF_HW_CACHE_MISSES,
+  ICF_PROF_HW_BRANCH_MISSES,
+  ICF_PROF_HW_PAGE_FAULTS,
+  ICF_PROF_NHW
+} icfProfHWEvent;
+
+/**********************************************************
+* icfProfTimer: Accumulated timer data
+**********************************************************/
+typedef struct icfProfTimer {
+  char      name[ICF_PROF_NAMELEN];
+  int64_t   calls;
+  int64_t   totalNs;          /* Inclusive time            */
+  int64_t   selfNs;           /* Without nested timers     */
+  int64_t   hw[ICF_PROF_NHW]; /* Inclusive event counts,   */
+                              /* -1 if not available       */
+} icfProfTimer;
+
+/**********************************************************
+* Runtime switches - read by the profiling macros
+**********************************************************/
+#define ICF_PROF_TIMERS  1    /* Accumulate timers/counters */
+#define ICF_PROF_TRACE   2    /* Record trace events        */
+#define ICF_PROF_HW      4    /* Hardware counters in timers*/
+
+extern int icfProf_active;
+
+/**********************************************************
+* Function: icfProf_enable
+*----------------------------------------------------------
+* Enables the profiling hooks
+*----------------------------------------------------------
+* @param: reportAtExit - if TRUE, a report is printed to 
+*                        stderr when the program exits
+**********************************************************/
+void icfProf_enable(icfBool reportAtExit);
+
+/**********************************************************
+* Function: icfProf_disable
+*----------------------------------------------------------
+* Disables the profiling hooks. Accumulated data is kept.
+**********************************************************/
+void icfProf_disable(void);
+
+/**********************************************************
+* Function: icfProf_setFlags
+*----------------------------------------------------------
+* Sets or clears runtime switches ICF_PROF_TIMERS 
+* and ICF_PROF_TRACE
+*----------------------------------------------------------
+* @param: flags - switches to modify
+* @param: on    - TRUE to set, FALSE to clear
+**********************************************************/
+void icfProf_setFlags(int flags, icfBool on);
+
+/**********************************************************
+* Function: icfProf_reset
+*----------------------------------------------------------
+* Resets all timers and counters to zero. 
+* Registered timer names are kept.
+**********************************************************/
+void icfProf_reset(void);
+
+/**********************************************************
+* Function: icfProf_now
+*----------------------------------------------------------
+* @return: monotonic time stamp in nanoseconds
+**********************************************************/
+int64_t icfProf_now(void);
+
+/**********************************************************
+* Function: icfProf_register
+*----------------------------------------------------------
+* Returns the timer id for a name and registers the 
+* timer, if it does not exist yet
+*----------------------------------------------------------
+* @param: name - timer name
+* @return: timer id, -1 if all timer slots are in use
+**********************************************************/
+int icfProf_register(const char *name);
+
+/**********************************************************
+* Function: icfProf_begin / icfProf_end
+*----------------------------------------------------------
+* Starts and stops a timer in the calling thread. 
+* Timers must be stopped in reverse order of their start.
+* Unmatched calls to icfProf_end() are ignored, such 
+* that profiling may be switched on inside a timed scope.
+*----------------------------------------------------------
+* @param: id - timer id of icfProf_register()
+* @return: TRUE, if a timer frame was pushed
+**********************************************************/
+int icfProf_begin(int id);
+void icfProf_end(int id);
+
+/**********************************************************
+* Function: icfProf_add / icfProf_set
+*----------------------------------------------------------
+* Adds a value to a counter or overwrites it
+**********************************************************/
+void icfProf_add(icfProfCounter counter, int64_t value);
+void icfProf_set(icfProfCounter counter, int64_t value);
+
+/**********************************************************
+* Function: icfProf_getCounter
+*----------------------------------------------------------
+* @return: current value of a counter
+**********************************************************/
+int64_t icfProf_getCounter(icfProfCounter counter);
+
+/**********************************************************
+* Function: icfProf_getTimer
+*----------------------------------------------------------
+* Copies the accumulated data of a named timer
+*----------------------------------------------------------
+* @param: name  - timer name
+* @param: timer - structure to copy the data to
+* @return: 0 on success, -1 if the timer does not exist
+**********************************************************/
+int icfProf_getTimer(const char *name, icfProfTimer *timer);
+
+/**********************************************************
+* Function: icfProf_getTimers
+*----------------------------------------------------------
+* Copies the data of all registered timers
+*----------------------------------------------------------
+* @param: timers    - array to copy the data to
+* @param: maxTimers - size of the array
+* @return: number of copied timers
+**********************************************************/
+int icfProf_getTimers(icfProfTimer *timers, int maxTimers);
+
+/**********************************************************
+* Function: icfProf_enableHW
+*----------------------------------------------------------
+* Attaches hardware counters to all timers. 
+* Reading the counters costs a few system calls per 
+* timer, so this is meant for kernel benchmarks.
+*----------------------------------------------------------
+* @return: number of available events for the calling 
+*          thread, -1 if none is available
+**********************************************************/
+int icfProf_enableHW(void);
+
+/**********************************************************
+* Function: icfProf_disableHW
+*----------------------------------------------------------
+* Detaches the hardware counters from the timers
+**********************************************************/
+void icfProf_disableHW(void);
+
+/**********************************************************
+* Function: icfProf_readHW
+*----------------------------------------------------------
+* Reads the hardware counters of the calling thread. 
+* The counters are opened on the first call in a thread.
+*----------------------------------------------------------
+* @param: values - event counts, -1 for unavailable events
+* @return: number of available events, -1 if none
+**********************************************************/
+int icfProf_readHW(int64_t values[ICF_PROF_NHW]);
+
+/**********************************************************
+* Function: icfProf_hwName
+*----------------------------------------------------------
+* @return: name of a hardware event
+**********************************************************/
+const char *icfProf_hwName(icfProfHWEvent event);
+
+/**********************************************************
+* Function: icfProf_counterName
+*----------------------------------------------------------
+* @return: name of a counter
+**********************************************************/
+const char *icfProf_counterName(icfProfCounter counter);
+
+/**********************************************************
+* Function: icfProf_report
+*----------------------------------------------------------
+* Prints all timers with at least one call and all 
+* non-zero counters
+*----------------------------------------------------------
+* @param: fptr - output stream
+**********************************************************/
+void icfProf_report(FILE *fptr);
+
+/**********************************************************
+* Profiling macros
+*----------------------------------------------------------
+* ICF_PROF_BEGIN() caches the timer id in a static 
+* variable, which is local to the calling function, and 
+* declares a flag, whether it pushed a timer frame. 
+* ICF_PROF_END() pops the frame based on this flag, such 
+* that switching profiling on or off inside a timed 
+* scope does not unbalance the timer stack.
+**********************************************************/
+#if (ICF_PROFILE)
+
+#define ICF_PROF_BEGIN(tag, name)                              \
+  static int icfProfId_##tag = -1;                             \
+  int icfProfPushed_##tag = FALSE;                             \
+  do {                                                         \
+    if (icfProf_active)                                        \
+    {                                                          \
+      if (__atomic_load_n(&icfProfId_##tag, __ATOMIC_RELAXED) < 0) \
+        __atomic_store_n(&icfProfId_##tag,                     \
+                         icfProf_register(name), __ATOMIC_RELAXED); \
+      icfProfPushed_##tag = icfProf_begin(icfProfId_##tag);    \
+    }                                                          \
+  } while (0)
+
+#define ICF_PROF_END(tag)                                      \
+  do {                                                         \
+    if (icfProfPushed_##tag)                                   \
+      icfProf_end(icfProfId_##tag);                            \
+  } while (0)
+
+#define ICF_PROF_ADD(counter, value)                           \
+  do {                                                         \
+    if (icfProf_active & ICF_PROF_TIMERS)                      \
+      icfProf_add((counter), (value));                         \
+  } while (0)
+
+#define ICF_PROF_SET(counter, value)                           \
+  do {                                                         \
+    if (icfProf_active & ICF_PROF_TIMERS)                      \
+      icfProf_set((counter), (value));                         \
+  } while (0)
+
+#else
+
+#define ICF_PROF_BEGIN(tag, name)
+#define ICF_PROF_END(tag)
+#define ICF_PROF_ADD(counter, value)
+#define ICF_PROF_SET(counter, value)
+
+#endif
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFSPLIT_H
+#define INCOMFLOW_ICFSPLIT_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* icfSplit: Record of a single edge split in the 
+* refinement forest of a mesh
+*
+*             n3
+*            /^\
+*          /  |  \
+*        /   eV1   \ 
+*      /  tL0 | tL1  \        t_p[1] = tL
+*    /        |        \
+*  /          |          \
+* n0---eH0--->n---eH1--->n2   e = n0->n2
+*  \          ^          /
+*    \        |        /
+*      \  tR0 | tR1  /        t_p[0] = tR
+*        \    |    / 
+*          \ eV0 /
+*            \|/
+*             n1
+*
+* e_c = [eH0, eV0, eH1, eV1]
+* t_c = [tR0, tR1, tL1, tL0]
+*
+*----------------------------------------------------------
+* Edges and triangles do not point to their parents, 
+* children or siblings. They store the index of the 
+* split, that created them (treeParent), and of the 
+* split, that refined them (treeSplit), in the split 
+* array of their mesh. The entities of a missing side 
+* of a boundary edge are NULL.
+* Unused splits have no parent edge and are chained 
+* by their nextFree index.
+**********************************************************/
+struct icfSplit {
+
+  icfEdge *e;        /* Parent edge                      */
+  icfNode *n;        /* Refinement node                  */
+  icfEdge *e_c[4];   /* Child edges                      */
+  icfTri  *t_c[4];   /* Child triangles                  */
+  icfTri  *t_p[2];   /* Parent triangles                 */
+
+  icfIndex nextFree;
+
+};
+
+/**********************************************************
+* Access to a split of a mesh by its index
+* The pointer is only valid until the next call of
+* icfSplit_create(), which may move the split array
+**********************************************************/
+#define ICF_SPLIT(mesh, iSplit) (&(mesh)->splits[(iSplit)])
+
+/**********************************************************
+* Function: icfSplit_create
+*----------------------------------------------------------
+* Takes an unused split from the split array of a mesh
+* and grows the array if required
+*----------------------------------------------------------
+* @param: mesh - mesh to add the split to
+* @return: index of the new split, -1 on failure
+**********************************************************/
+icfIndex icfSplit_create(icfMesh *mesh);
+
+/**********************************************************
+* Function: icfSplit_destroy
+*----------------------------------------------------------
+* Returns a split to the unused splits of its mesh
+*----------------------------------------------------------
+* @param: mesh   - mesh of the split
+* @param: iSplit - index of the split
+**********************************************************/
+void icfSplit_destroy(icfMesh *mesh, icfIndex iSplit);
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFTRACE_H
+#define INCOMFLOW_ICFTRACE_H
+
+#include <stdint.h>
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Event tracer
+*----------------------------------------------------------
+* Records the scopes of the profiling hooks (icfProf.h) 
+* as timeline events and exports them in the Chrome 
+* trace event format, which can be opened in 
+* chrome://tracing or ui.perfetto.dev.
+*
+* Every thread records into its own ring buffer, such 
+* that recording requires no locks. If a buffer is full,
+* the oldest events of this thread are overwritten.
+* Each event contains the begin time and the duration 
+* of a scope ("complete" events), thus overwritten 
+* events never leave unmatched begin or end markers.
+*
+* Tracing is switched on at runtime - no special build
+* is required:
+*
+*   icfTrace_start(0);
+*   ... adaptation, solver, output ...
+*   icfTrace_stop();
+*   icfTrace_write("incomflow.trace.json");
+*
+* icfTrace_start(), icfTrace_write() and icfTrace_clear()
+* must not run concurrently to traced code.
+**********************************************************/
+#define ICF_TRACE_DEFAULT_EVENTS  65536  /* Events per thread */
+
+/**********************************************************
+* icfTraceEvent: A single timed scope
+**********************************************************/
+typedef struct icfTraceEvent {
+  const char *name;       /* Static or registered name    */
+  int64_t     start;      /* Begin time stamp in ns       */
+  int64_t     duration;   /* Duration in ns               */
+} icfTraceEvent;
+
+/**********************************************************
+* Function: icfTrace_start
+*----------------------------------------------------------
+* Discards all recorded events and starts tracing
+*----------------------------------------------------------
+* @param: nEvents - ring buffer size per thread 
+*                   (0 for ICF_TRACE_DEFAULT_EVENTS)
+**********************************************************/
+void icfTrace_start(int nEvents);
+
+/**********************************************************
+* Function: icfTrace_stop
+*----------------------------------------------------------
+* Stops tracing. Recorded events are kept.
+**********************************************************/
+void icfTrace_stop(void);
+
+/**********************************************************
+* Function: icfTrace_clear
+*----------------------------------------------------------
+* Stops tracing and frees all event buffers
+**********************************************************/
+void icfTrace_clear(void);
+
+/**********************************************************
+* Function: icfTrace_record
+*----------------------------------------------------------
+* Records a scope in the ring buffer of the calling 
+* thread. This is called by the profiling hooks, but 
+* can also be used to record custom phases.
+*----------------------------------------------------------
+* @param: name     - event name, must stay valid until 
+*                    the trace is written
+* @param: start    - begin time stamp (icfProf_now())
+* @param: duration - duration in ns
+**********************************************************/
+void icfTrace_record(const char *name, 
+                     int64_t     start, 
+                     int64_t     duration);
+
+/**********************************************************
+* Function: icfTrace_nEvents / icfTrace_nDropped
+*----------------------------------------------------------
+* @return: number of buffered events or of events,
+*          which were overwritten, summed over all threads
+**********************************************************/
+long icfTrace_nEvents(void);
+long icfTrace_nDropped(void);
+
+/**********************************************************
+* Function: icfTrace_write
+*----------------------------------------------------------
+* Writes all buffered events as Chrome trace JSON
+*----------------------------------------------------------
+* @param: path - output file
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfTrace_write(const char *path);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * This header file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef INCOMFLOW_ICFTREE_H
+#define INCOMFLOW_ICFTREE_H
+
+#include "incomflow/icfTypes.h"
+
+/**********************************************************
+* Refinement tree traversal
+*----------------------------------------------------------
+* The iterators walk the subtree of a triangle or edge in
+* the refinement forest (see icfSplit.h) without 
+* recursion and without heap allocations. The path from
+* the root to the current entity is kept in a fixed 
+* stack inside of the iterator:
+*
+*   icfTreeIter it;
+*   icfTri *t;
+*
+*   icfTreeIter_initTri(&it, root, ICF_TREE_POSTORDER);
+*   while ((t = icfTreeIter_nextTri(&it)) != NULL)
+*     ...
+*
+* ICF_TREE_PREORDER   - parents before their children
+* ICF_TREE_POSTORDER  - children before their parents, 
+*                       e.g. to restrict fields to the 
+*                       parents
+* ICF_TREE_LEVELORDER - all entities of a tree level 
+*                       before the next level. Without a
+*                       queue, every level is reached by
+*                       a depth-limited pre-order pass, 
+*                       which re-visits the upper levels.
+*                       For bisection trees this costs 
+*                       about twice a pre-order pass.
+*
+* Children are visited in the order of icfTri_getChild()
+* and icfEdge_getChild(), missing edge children are 
+* skipped. Subtrees deeper than ICF_TREE_MAXDEPTH levels
+* below the root are cut off and flagged as truncated.
+* The tree must not be changed during the traversal.
+**********************************************************/
+#define ICF_TREE_MAXDEPTH 64
+
+typedef enum icfTreeOrder {
+  ICF_TREE_PREORDER,
+  ICF_TREE_POSTORDER,
+  ICF_TREE_LEVELORDER
+} icfTreeOrder;
+
+/**********************************************************
+* icfTreeIter: State of a subtree traversal
+**********************************************************/
+typedef struct icfTreeIter {
+
+  icfMesh      *mesh;
+  icfTreeOrder  order;
+  icfBool       isTri;     /* Triangle or edge tree      */
+  int           nChildren; /* 2 for triangles, 4 for edges */
+
+  /*-------------------------------------------------------
+  | Path from the root to the current entity, the split
+  | records along the path (read once on entering) and
+  | the next child to visit on every level, -1 if the 
+  | entity has just been entered
+  -------------------------------------------------------*/
+  int           depth;
+  int           curDepth;  /* Of the last returned entity */
+  void         *path[ICF_TREE_MAXDEPTH];
+  icfSplit     *split[ICF_TREE_MAXDEPTH];
+  signed char   next[ICF_TREE_MAXDEPTH];
+
+  /*-------------------------------------------------------
+  | Level of the current level-order pass and whether
+  | deeper levels exist
+  -------------------------------------------------------*/
+  void         *root;
+  int           level;
+  icfBool       deeper;
+
+  icfBool       truncated;
+
+} icfTreeIter;
+
+/**********************************************************
+* Function pointers for the traversal of whole forests
+**********************************************************/
+typedef void (*icfTreeTriFun)  (icfTri  *tri,  void *data);
+typedef void (*icfTreeEdgeFun) (icfEdge *edge, void *data);
+
+/**********************************************************
+* Function: icfTreeIter_initTri
+*----------------------------------------------------------
+* @param: it    - iterator to initialize
+* @param: root  - root of the subtree, which is visited 
+*                 as well
+* @param: order - traversal order
+**********************************************************/
+void icfTreeIter_initTri(icfTreeIter  *it, 
+                         icfTri       *root, 
+                         icfTreeOrder  order);
+
+/**********************************************************
+* Function: icfTreeIter_initEdge
+*----------------------------------------------------------
+* @param: it    - iterator to initialize
+* @param: root  - root of the subtree, which is visited 
+*                 as well
+* @param: order - traversal order
+**********************************************************/
+void icfTreeIter_initEdge(icfTreeIter  *it, 
+                          icfEdge      *root, 
+                          icfTreeOrder  order);
+
+/**********************************************************
+* Function: icfTreeIter_next
+*----------------------------------------------------------
+* @param: it - iterator
+* @return: next entity of the traversal, NULL at the end
+**********************************************************/
+void *icfTreeIter_next(icfTreeIter *it);
+
+/**********************************************************
+* Function: icfTreeIter_depth
+*----------------------------------------------------------
+* @param: it - iterator
+* @return: depth of the last returned entity below the 
+*          root of the traversal
+**********************************************************/
+int icfTreeIter_depth(const icfTreeIter *it);
+
+/**********************************************************
+* Typed access to the next entity 
+**********************************************************/
+#define icfTreeIter_nextTri(it)  ((icfTri*)  icfTreeIter_next(it))
+#define icfTreeIter_nextEdge(it) ((icfEdge*) icfTreeIter_next(it))
+
+/**********************************************************
+* Function: icfTree_forEachTri
+*----------------------------------------------------------
+* Visits all triangles of a mesh tree by tree. The root 
+* triangles of the initial mesh are distributed across 
+* the threads with OpenMP, if available, hence the 
+* function must only modify the data of its own tree.
+* Every tree is traversed in the given order.
+*----------------------------------------------------------
+* @param: mesh  - pointer to mesh structure
+* @param: order - traversal order within every tree
+* @param: fun   - function to call for every triangle
+* @param: data  - user data passed to fun
+* @return: number of visited triangles, -1 on errors
+**********************************************************/
+icfIndex icfTree_forEachTri(icfMesh       *mesh,
+                            icfTreeOrder   order,
+                            icfTreeTriFun  fun,
+                            void          *data);
+
+/**********************************************************
+* Function: icfTree_forEachEdge
+*----------------------------------------------------------
+* Visits all edges of a mesh tree by tree, analogous to
+* icfTree_forEachTri()
+*----------------------------------------------------------
+* @param: mesh  - pointer to mesh structure
+* @param: order - traversal order within every tree
+* @param: fun   - function to call for every edge
+* @param: data  - user data passed to fun
+* @return: number of visited edges, -1 on errors
+**********************************************************/
+icfIndex icfTree_forEachEdge(icfMesh        *mesh,
+                             icfTreeOrder    order,
+                             icfTreeEdgeFun  fun,
+                             void           *data);
+
+#endif
@@ -10,6 +10,48 @@
 
 #include "incomflow/icfTypes.h"
 
+/**********************************************************
+* icfTriCold: Refinement tree and bookkeeping state of 
+* a triangle, which is not needed by loops over the leafs
+**********************************************************/
+typedef struct icfTriCold {
+
+  /*-------------------------------------------------------
+  | Parents
+  -------------------------------------------------------*/
+  icfMesh *mesh;
+
+  /*-------------------------------------------------------
+  | Refinement forest (see icfSplit.h): the split, that 
+  | created this triangle and its siblings, and the split
+  | of this triangle into its children, -1 if not existing
+  -------------------------------------------------------*/
+  icfIndex  treeParent;
+  icfIndex  treeSplit;
+
+  /*-------------------------------------------------------
+  | Edge to split for the refinement
+  -------------------------------------------------------*/
+  icfEdge *e_split;
+
+  /*-------------------------------------------------------
+  | Triangle properties
+  -------------------------------------------------------*/
+  icfIndex  index; 
+  icfBool   split;
+  icfBool   merge;
+  icfBool   isSplit;
+  icfIndex  treeLevel;
+  icfBool   isLeaf;
+
+  /*-------------------------------------------------------
+  | Position of this triangle in mesh stack 
+  -------------------------------------------------------*/
+  icfListNode *stackPos;
+  icfIndex     leafPos;
+
+} icfTriCold;
+
 /**********************************************************
 * icfTri:  
 *                   n[2]
@@ -21,35 +63,21 @@
 *         e[2] /     |      \ e[1]
 *             /      |       \
 *            /       |        \
-*           / t_c[0] | t_c[1]  \
+*           / child 0| child 1 \
 *          /         |          \
-*         /          n_c         \
+*         /         (n)          \
 *       n[0]-------------------->n[1]
 *                   e[0]
 *
 *                  (t[2])
 *
 *
+*----------------------------------------------------------
+* The triangle itself only holds the data of leaf loops,
+* the tree state is kept in a separate cold record
 **********************************************************/
 typedef struct icfTri {
 
-  /*-------------------------------------------------------
-  | Parents
-  -------------------------------------------------------*/
-  icfMesh *mesh;
-  icfTri  *parent;
-
-  /*-------------------------------------------------------
-  | Children
-  -------------------------------------------------------*/
-  icfTri  *t_c[2];
-
-  /*-------------------------------------------------------
-  | Node that connects this triangle to all its
-  | trianlge/edge siblings in the refinement tree 
-  -------------------------------------------------------*/
-  icfNode *n_c;
-
   /*-------------------------------------------------------
   | Defining nodes: 
   -------------------------------------------------------*/
@@ -59,38 +87,33 @@ typedef struct icfTri {
   | Defining edges: 
   -------------------------------------------------------*/
   icfEdge *e[3];
-  icfEdge *e_split;
 
   /*-------------------------------------------------------
   | Adjacent triangles: 
   -------------------------------------------------------*/
   icfTri *t[3];
 
-  /*-------------------------------------------------------
-  | Triangle properties
-  -------------------------------------------------------*/
-  icfIndex  index; 
-  icfBool   split;
-  icfBool   merge;
-  icfBool   isSplit;
-  icfIndex  treeLevel;
-  icfBool   isLeaf;
-
   /*-------------------------------------------------------
   | Geometric triangle properties
   -------------------------------------------------------*/
-  icfDouble xy[2];       /*            Triangle centroid */
-  icfDouble aspectRatio; /*                 Aspect ratio */
-  icfDouble area;        /*                         Area */
+  icfReal   xy[2];       /*            Triangle centroid */
+  icfReal   aspectRatio; /*                 Aspect ratio */
+  icfReal   area;        /*                         Area */
 
   /*-------------------------------------------------------
-  | Position of this triangle in mesh stack 
+  | Refinement tree and bookkeeping state
   -------------------------------------------------------*/
-  icfListNode *stackPos;
-  icfIndex     leafPos;
+  icfTriCold *cold;
 
 } icfTri;
 
+/**********************************************************
+* ICF_TRI_BLOCKSIZE: Size of the single allocation of an 
+* individually created triangle, whose cold record 
+* directly follows the triangle itself
+**********************************************************/
+#define ICF_TRI_BLOCKSIZE (sizeof(icfTri) + sizeof(icfTriCold))
+
 
 /**********************************************************
 * Function: icfTri_create
@@ -154,6 +177,25 @@ void icfTri_setTris(icfTri *tri,
                     icfTri *t1,
                     icfTri *t2);
 
+/**********************************************************
+* Function: icfTri_getParent
+*----------------------------------------------------------
+* @param: tri - triangle structure
+* @return: parent triangle in the refinement tree, 
+*          NULL for triangles of the initial mesh
+**********************************************************/
+icfTri *icfTri_getParent(const icfTri *tri);
+
+/**********************************************************
+* Function: icfTri_getChild
+*----------------------------------------------------------
+* @param: tri - triangle structure
+* @param: i   - child number (0-1), child 0 contains
+*               the first node of the split edge
+* @return: child triangle, NULL if tri is not split
+**********************************************************/
+icfTri *icfTri_getChild(const icfTri *tri, int i);
+
 /**********************************************************
 * Function: icfTri_markToRefine
 *----------------------------------------------------------
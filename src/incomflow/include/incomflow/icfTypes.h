@@ -10,20 +10,83 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <float.h>
+#include <inttypes.h>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
 #include "incomflow/dbg.h"
+#include "incomflow/icfLog.h"
 #include "incomflow/icfList.h"
+#include "incomflow/icfMem.h"
 
 
 /***********************************************************
-* Own type definitions in order to allow to switch from 
-* switch to short and from double to long in case of 
-* special memory requirements
+* Own type definitions in order to allow to switch the 
+* index width and floating point precision in case of 
+* special memory requirements. The widths are set with 
+* the CMake options INCOMFLOW_INDEX_BITS, 
+* INCOMFLOW_REAL_STORAGE and INCOMFLOW_REAL_COMPUTE:
+*
+*   icfIndex  - indices and counts of mesh entities 
+*               (32 or 64 bit)
+*   icfReal   - storage precision of coordinates and 
+*               grid metrics in the mesh entities
+*   icfDouble - compute precision of all arithmetic 
+*               and accumulations 
+*
+* Values of type icfReal are converted to icfDouble, 
+* before any computation is done with them.
 ***********************************************************/
-#define icfDouble double
-#define icfIndex  int
+#ifndef ICF_INDEX_BITS
+#define ICF_INDEX_BITS 32
+#endif
+
+#ifndef ICF_REAL_BITS
+#define ICF_REAL_BITS 64
+#endif
+
+#ifndef ICF_DOUBLE_BITS
+#define ICF_DOUBLE_BITS 64
+#endif
+
+#if ICF_INDEX_BITS == 64
+#define icfIndex      int64_t
+#define ICF_INDEX_MAX INT64_MAX
+#define ICF_PRIdx     PRId64
+#elif ICF_INDEX_BITS == 32
+#define icfIndex      int
+#define ICF_INDEX_MAX INT_MAX
+#define ICF_PRIdx     "d"
+#else
+#error "ICF_INDEX_BITS must be 32 or 64"
+#endif
+
+#if ICF_REAL_BITS == 32
+#define icfReal      float
+#define ICF_REAL_EPS FLT_EPSILON
+#elif ICF_REAL_BITS == 64
+#define icfReal      double
+#define ICF_REAL_EPS DBL_EPSILON
+#else
+#error "ICF_REAL_BITS must be 32 or 64"
+#endif
+
+#if ICF_DOUBLE_BITS == 32
+#define icfDouble      float
+#define ICF_DOUBLE_EPS FLT_EPSILON
+#elif ICF_DOUBLE_BITS == 64
+#define icfDouble      double
+#define ICF_DOUBLE_EPS DBL_EPSILON
+#else
+#error "ICF_DOUBLE_BITS must be 32 or 64"
+#endif
+
+#if ICF_DOUBLE_BITS < ICF_REAL_BITS
+#error "The compute precision must not be below the storage precision"
+#endif
+
 #define icfBool   int
 #define TRUE      1
 #define FALSE     0
@@ -31,12 +94,26 @@
 /***********************************************************
 * Basic structure typedefs
 ***********************************************************/
-typedef struct icfNode      icfNode;
-typedef struct icfEdge      icfEdge;
-typedef struct icfTri       icfTri;
-typedef struct icfMesh      icfMesh;
-typedef struct icfBdry      icfBdry;
-typedef struct icfFlowData  icfFlowData;
+typedef struct icfNode         icfNode;
+typedef struct icfEdge         icfEdge;
+typedef struct icfTri          icfTri;
+typedef struct icfMesh         icfMesh;
+typedef struct icfBdry         icfBdry;
+typedef struct icfSplit        icfSplit;
+typedef struct icfEdgeIndex    icfEdgeIndex;
+typedef struct icfMeshSnapshot icfMeshSnapshot;
+typedef struct icfFlowData     icfFlowData;
+
+/***********************************************************
+* Orderings of the mesh edge leafs (see icfMeshOrder.h)
+***********************************************************/
+typedef enum icfEdgeOrder {
+  ICF_EDGEORDER_STACK,   /* Creation order of the edges     */
+  ICF_EDGEORDER_MINNODE, /* Sorted by their node indices    */
+  ICF_EDGEORDER_RCM,     /* Nodes numbered by reverse       */
+                         /* Cuthill-McKee, then MINNODE     */
+  ICF_EDGEORDER_N
+} icfEdgeOrder;
 
 /***********************************************************
 * Function pointers
@@ -45,17 +122,12 @@ typedef icfBool (*icfRefineFun) (icfFlowData *flowData, icfTri *tri);
 
 
 /***********************************************************
-* Debugging Layers
-* 0 -> No output
+* General messages of applications and tests
+* Library modules use icfLog() with their own module
+* (see icfLog.h)
 ***********************************************************/
-#define ICF_DEBUG 3
-
-#ifdef ICF_DEBUG 
-#define icfPrint(M, ...) fprintf(stdout, "> " M "\n",\
-    ##__VA_ARGS__)
-#else
-#define icfPrint(M, ...)
-#endif
+#define icfPrint(M, ...) \
+  icfLog(ICF_LOG_APP, ICF_LOG_INFO, M, ##__VA_ARGS__)
 
 /***********************************************************
 * Constants used in code
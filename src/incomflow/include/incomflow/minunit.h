@@ -7,7 +7,7 @@
 
 #include "incomflow/dbg.h"
 
-int tests_run;
+static int tests_run __attribute__((unused));
 
 #define mu_suite_start() char *message = NULL
 
@@ -5,6 +5,8 @@
  * Refer to the accompanying documentation for details
  * on usage and license.
  */
+#include <string.h>
+
 #include "incomflow/icfTypes.h"
 #include "incomflow/icfList.h"
 #include "incomflow/icfNode.h"
@@ -22,13 +24,14 @@
 *----------------------------------------------------------
 * @return: pointer to new bdry structure
 **********************************************************/
-icfBdry *icfBdry_create(icfMesh *mesh, 
-                        icfIndex type, 
-                        icfIndex marker,
-                        char    *name)
+icfBdry *icfBdry_create(icfMesh    *mesh, 
+                        icfIndex    type, 
+                        icfIndex    marker,
+                        const char *name)
 {
 
-  icfBdry *bdry = (icfBdry*) calloc(1, sizeof(icfBdry));
+  icfBdry *bdry = (icfBdry*) icfMem_calloc(ICF_MEM_MESH, 
+                                           1, sizeof(icfBdry));
   check_mem(bdry);
 
   /*-------------------------------------------------------
@@ -36,7 +39,9 @@ icfBdry *icfBdry_create(icfMesh *mesh,
   -------------------------------------------------------*/
   bdry->nNodes = 0;
   bdry->nodeStack = icfList_create();
-  bdry->bdryNodes = (icfNode**) calloc(0, sizeof(icfNode*));
+  bdry->bdryNodes = (icfNode**) icfMem_calloc(ICF_MEM_BDRY, 
+                                               0, sizeof(icfNode*));
+  bdry->nNodesAlloc = 0;
 
   /*-------------------------------------------------------
   | Bdry edges 
@@ -48,15 +53,29 @@ icfBdry *icfBdry_create(icfMesh *mesh,
   | Bdry edge leafs
   -------------------------------------------------------*/
   bdry->nEdgeLeafs = 0;
-  bdry->edgeLeafs = (icfEdge**) calloc(0, sizeof(icfEdge*));
+  bdry->edgeLeafs = (icfEdge**) icfMem_calloc(ICF_MEM_BDRY, 
+                                               0, sizeof(icfEdge*));
+
+  /*-------------------------------------------------------
+  | Bdry faces
+  -------------------------------------------------------*/
+  bdry->nFaces  = 0;
+  bdry->faceLen = NULL;
 
   /*-------------------------------------------------------
   | Boundary properties
   -------------------------------------------------------*/
   bdry->type   = type;
-  bdry->name   = name;
   bdry->marker = marker;
 
+  if (name != NULL)
+  {
+    bdry->name = (char*) icfMem_calloc(ICF_MEM_MESH, 
+                                       strlen(name)+1, sizeof(char));
+    check_mem(bdry->name);
+    strcpy(bdry->name, name);
+  }
+
   /*-------------------------------------------------------
   | Position in mesh's bdry stack
   -------------------------------------------------------*/
@@ -87,10 +106,16 @@ int icfBdry_destroy(icfBdry *bdry)
   /*-------------------------------------------------------
   | Free all arrays 
   -------------------------------------------------------*/
-  free(bdry->edgeLeafs);
-  free(bdry->bdryNodes);
+  icfMem_free(ICF_MEM_BDRY, bdry->edgeLeafs, 
+              bdry->nEdgeLeafs*sizeof(icfEdge*));
+  icfMem_free(ICF_MEM_BDRY, bdry->bdryNodes, 
+              bdry->nNodesAlloc*sizeof(icfNode*));
+  icfMem_free(ICF_MEM_BDRYFACES, bdry->faceLen, 
+              ICF_BDRY_FACEBYTES(bdry->nFaces));
+  if (bdry->name != NULL)
+    icfMem_free(ICF_MEM_MESH, bdry->name, strlen(bdry->name)+1);
 
-  free(bdry);
+  icfMem_free(ICF_MEM_MESH, bdry, sizeof(icfBdry));
 
   return 0;
 } /* icfBdry_destroy() */
@@ -142,8 +167,8 @@ void icfBdry_addEdge(icfBdry *bdry, icfEdge *edge)
   icfList_push(bdry->edgeStack, edge);
   icfListNode *edgePos = icfList_last_node(bdry->edgeStack);
 
-  edge->bdry         = bdry;
-  edge->bdryStackPos = edgePos;
+  edge->cold->bdry         = bdry;
+  edge->cold->bdryStackPos = edgePos;
 
 } /* icfBdry_addEdge() */
 
@@ -185,17 +210,74 @@ error:
 **********************************************************/
 void icfBdry_remEdge(icfBdry *bdry, icfEdge *edge)
 {
-  if (bdry != edge->bdry) /* edge not part of bdry */
+  if (bdry != edge->cold->bdry) /* edge not part of bdry */
     return;
 
-  icfList_remove(bdry->edgeStack, edge->bdryStackPos);
+  icfList_remove(bdry->edgeStack, edge->cold->bdryStackPos);
   bdry->nEdges -= 1;
 
-  edge->bdry         = NULL;
-  edge->bdryStackPos = NULL;
+  edge->cold->bdry         = NULL;
+  edge->cold->bdryStackPos = NULL;
 
   return;
 error:
   return;
 } /* tmBdrBdry_remEdge() */
 
+/**********************************************************
+* Function: icfBdry_updateFaces
+*----------------------------------------------------------
+* Resizes the face arrays of a boundary to its edge leafs
+* and sets the face connectivity
+* @param: bdry - pointer to bdry structure 
+*----------------------------------------------------------
+* @return: returns 0 on success
+**********************************************************/
+int icfBdry_updateFaces(icfBdry *bdry)
+{
+  icfIndex i;
+  icfIndex n = bdry->nEdgeLeafs;
+
+  /*-------------------------------------------------------
+  | The buffer is only resized, if the number of edge 
+  | leafs changed - its content is rebuilt anyway
+  -------------------------------------------------------*/
+  if (n != bdry->nFaces || bdry->faceLen == NULL)
+  {
+    char *buffer = (char*) icfMem_realloc(ICF_MEM_BDRYFACES, 
+        bdry->faceLen, ICF_BDRY_FACEBYTES(bdry->nFaces), 
+        ICF_BDRY_FACEBYTES(n));
+    check_mem(buffer);
+
+    bdry->nFaces  = n;
+    bdry->faceLen = (icfReal*) buffer;
+
+    bdry->faceNorm[0][0] = bdry->faceLen + 1*n;
+    bdry->faceNorm[0][1] = bdry->faceLen + 2*n;
+    bdry->faceNorm[1][0] = bdry->faceLen + 3*n;
+    bdry->faceNorm[1][1] = bdry->faceLen + 4*n;
+
+    bdry->faceNodes[0] = (icfIndex*) (buffer + ICF_BDRY_REALBYTES(n));
+    bdry->faceNodes[1] = bdry->faceNodes[0] + n;
+    bdry->faceTri      = bdry->faceNodes[1] + n;
+  }
+
+  /*-------------------------------------------------------
+  | Face connectivity: boundary edges have their inner
+  | triangle on the left
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+  {
+    icfEdge *e = bdry->edgeLeafs[i];
+    icfTri  *t = (e->t[0] != NULL) ? e->t[0] : e->t[1];
+
+    bdry->faceNodes[0][i] = e->n[0]->index;
+    bdry->faceNodes[1][i] = e->n[1]->index;
+    bdry->faceTri[i]      = (t != NULL) ? t->cold->leafPos : -1;
+  }
+
+  return 0;
+error:
+  return -1;
+
+} /* icfBdry_updateFaces() */
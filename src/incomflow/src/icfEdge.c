@@ -11,8 +11,14 @@
 #include "incomflow/icfEdge.h"
 #include "incomflow/icfBdry.h"
 #include "incomflow/icfTri.h"
+#include "incomflow/icfSplit.h"
+#include "incomflow/icfEdgeIndex.h"
 #include "incomflow/icfMesh.h"
 #include "incomflow/icfFlowData.h"
+#include "incomflow/icfProf.h"
+
+_Static_assert(sizeof(icfEdge) % _Alignof(icfEdgeCold) == 0,
+    "Cold records of edges are misaligned in their block.");
 
 /**********************************************************
 * Function: icfEdge_create
@@ -24,23 +30,22 @@
 **********************************************************/
 icfEdge *icfEdge_create(icfMesh *mesh) 
 {
-  icfEdge *edge = (icfEdge*) calloc(1, sizeof(icfEdge));
+  icfEdge *edge = (icfEdge*) icfMem_calloc(ICF_MEM_EDGES, 
+                                           1, ICF_EDGE_BLOCKSIZE);
   check_mem(edge);
 
+  edge->cold = (icfEdgeCold*) (edge + 1);
+
   /*-------------------------------------------------------
   | Parents
   -------------------------------------------------------*/
-  edge->mesh   = mesh;
-  edge->parent = NULL;
+  edge->cold->mesh   = mesh;
 
   /*-------------------------------------------------------
-  | Children
+  | Refinement forest
   -------------------------------------------------------*/
-  edge->e_c[0] = NULL;
-  edge->e_c[1] = NULL;
-  edge->e_c[2] = NULL;
-  edge->e_c[3] = NULL;
-  edge->n_c    = NULL;
+  edge->cold->treeParent = -1;
+  edge->cold->treeSplit  = -1;
 
   /*-------------------------------------------------------
   | Edge nodes: edge points from n[0] to n[1] 
@@ -57,31 +62,33 @@ icfEdge *icfEdge_create(icfMesh *mesh)
   /*-------------------------------------------------------
   | Boundary properties
   -------------------------------------------------------*/
-  edge->bdry         = NULL;
-  edge->bdryStackPos = NULL;
+  edge->cold->bdry         = NULL;
+  edge->cold->bdryStackPos = NULL;
 
   /*-------------------------------------------------------
   | Edge properties
   -------------------------------------------------------*/
-  edge->index     = -1;
-  edge->split     = FALSE;
-  edge->merge     = FALSE;
-  edge->isSplit   = FALSE;
-  edge->isLeaf    = FALSE;
-  edge->treeLevel = 0;
+  edge->cold->index     = -1;
+  edge->cold->split     = FALSE;
+  edge->cold->merge     = FALSE;
+  edge->cold->isSplit   = FALSE;
+  edge->cold->isLeaf    = FALSE;
+  edge->cold->treeLevel = 0;
 
   /*-------------------------------------------------------
   | Position in mesh's edge stack
   -------------------------------------------------------*/
-  edge->stackPos = icfMesh_addEdge(mesh, edge);
-  edge->leafPos  = -1;
+  edge->cold->stackPos = icfMesh_addEdge(mesh, edge);
+  edge->cold->leafPos  = -1;
 
   /*-------------------------------------------------------
   | Median-dual grid metrics
   -------------------------------------------------------*/
-  edge->intrNorm[0]    = 0.0;
-  edge->intrNorm[1]    = 0.0;
-  edge->bdryNorm       = NULL;
+  edge->intrNorm[0] = 0.0;
+  edge->intrNorm[1] = 0.0;
+
+  ICF_PROF_ADD(ICF_PROF_EDGES_CREATED, 1);
+  ICF_PROF_ADD(ICF_PROF_BYTES_ALLOCATED, ICF_EDGE_BLOCKSIZE);
 
   return edge;
 error:
@@ -99,11 +106,22 @@ error:
 **********************************************************/
 int icfEdge_destroy(icfEdge *edge)
 {
-  icfMesh_remEdge(edge->mesh, edge);
-  if (edge->bdry != NULL)
-    icfBdry_remEdge(edge->bdry, edge);
-  free(edge->bdryNorm);
-  free(edge);
+  icfMesh_remEdge(edge->cold->mesh, edge);
+  if (edge->cold->mesh->edgeIndex != NULL && edge->n[0] != NULL)
+    icfEdgeIndex_remove(edge->cold->mesh->edgeIndex, edge);
+  if (edge->cold->bdry != NULL)
+    icfBdry_remEdge(edge->cold->bdry, edge);
+  ICF_PROF_ADD(ICF_PROF_EDGES_FREED, 1);
+  ICF_PROF_ADD(ICF_PROF_BYTES_FREED, ICF_EDGE_BLOCKSIZE);
+
+  /*-------------------------------------------------------
+  | Edges in a contiguous block of the mesh are released 
+  | with the block, other edges with their cold record
+  -------------------------------------------------------*/
+  icfMesh *mesh = edge->cold->mesh;
+
+  if (!ICF_MESH_INSLAB(edge, mesh->edgeSlab, mesh->nEdgeSlab))
+    icfMem_free(ICF_MEM_EDGES, edge, ICF_EDGE_BLOCKSIZE);
   return 0;
 } /* icfEdge_destroy() */
 
@@ -112,6 +130,8 @@ int icfEdge_destroy(icfEdge *edge)
 *----------------------------------------------------------
 * Sets the nodes for an icfEdge and calculates the 
 * edge length.
+* The edge is moved to its new node pair in the edge 
+* index of the mesh, if enabled.
 * @param: edge - edge structure to define nodes for
 * @param: n0, n1 - pointer to edge nodes 
 *----------------------------------------------------------
@@ -121,6 +141,11 @@ void icfEdge_setNodes(icfEdge *edge,
                       icfNode *n0,
                       icfNode *n1)
 {
+  icfEdgeIndex *index = edge->cold->mesh->edgeIndex;
+
+  if (index != NULL && edge->n[0] != NULL)
+    icfEdgeIndex_remove(index, edge);
+
   edge->n[0] = n0;
   edge->n[1] = n1;
 
@@ -137,6 +162,13 @@ void icfEdge_setNodes(icfEdge *edge,
   edge->xy[0] = 0.5 * (n1->xy[0] + n0->xy[0]);
   edge->xy[1] = 0.5 * (n1->xy[1] + n0->xy[1]);
 
+  if (index != NULL)
+    check(icfEdgeIndex_insert(index, edge) == 0,
+        "Failed to add edge to the edge index.");
+
+error:
+  return;
+
 } /*icfEdge_setNodes() */
 
 /**********************************************************
@@ -156,6 +188,39 @@ void icfEdge_setTris(icfEdge *edge,
   edge->t[1] = t1;
 } /*icfEdge_setTris() */
 
+/**********************************************************
+* Function: icfEdge_getParent
+*----------------------------------------------------------
+* @param: edge - edge structure
+* @return: parent edge in the refinement tree, 
+*          NULL for edges of the initial mesh
+**********************************************************/
+icfEdge *icfEdge_getParent(const icfEdge *edge)
+{
+  if (edge->cold->treeParent < 0)
+    return NULL;
+
+  return ICF_SPLIT(edge->cold->mesh, edge->cold->treeParent)->e;
+
+} /* icfEdge_getParent() */
+
+/**********************************************************
+* Function: icfEdge_getChild
+*----------------------------------------------------------
+* @param: edge - edge structure
+* @param: i    - child number (0-3)
+* @return: child edge, NULL if edge is not split or if 
+*          the respective triangle does not exist
+**********************************************************/
+icfEdge *icfEdge_getChild(const icfEdge *edge, int i)
+{
+  if (edge->cold->treeSplit < 0)
+    return NULL;
+
+  return ICF_SPLIT(edge->cold->mesh, edge->cold->treeSplit)->e_c[i];
+
+} /* icfEdge_getChild() */
+
 /**********************************************************
 * Function: icfEdge_split
 *----------------------------------------------------------
@@ -166,10 +231,13 @@ void icfEdge_setTris(icfEdge *edge,
 **********************************************************/
 void icfEdge_split(icfEdge *e)
 {
-  if (e->split == FALSE)
+  if (e->cold->split == FALSE)
     return;
 
-  icfMesh *mesh = e->mesh;
+  ICF_PROF_BEGIN(split, "icfEdge_split");
+  ICF_PROF_ADD(ICF_PROF_EDGE_SPLITS, 1);
+
+  icfMesh *mesh = e->cold->mesh;
   
   icfTri  *t_L  = e->t[0];
   icfTri  *t_R  = e->t[1];
@@ -177,10 +245,12 @@ void icfEdge_split(icfEdge *e)
   check(t_L != NULL || t_R != NULL,
     "Can not split edge with undefined triangle neighbors.");
 
-#if (ICF_DEBUG > 2)
-  icfPrint("SPLIT EDGE (%d,%d)",
+  icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+      "SPLIT EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ")",
       e->n[0]->index, e->n[1]->index);
-#endif
+
+  const icfIndex iSplit = icfSplit_create(mesh);
+  check(iSplit >= 0, "Failed to create edge split.");
 
   /*-------------------------------------------------------
   | Create new objects 
@@ -211,18 +281,17 @@ void icfEdge_split(icfEdge *e)
   /*-------------------------------------------------------
   | Create new node at edge centroid
   -------------------------------------------------------*/
-  icfNode *n = icfNode_create(mesh, e->xy);
+  icfDouble xy_n[2] = { e->xy[0], e->xy[1] };
+  icfNode *n = icfNode_create(mesh, xy_n);
 
   /*-------------------------------------------------------
   | Create new horizontal edges 
   -------------------------------------------------------*/
   icfEdge *eH0 = icfEdge_create(mesh);
   icfEdge_setNodes(eH0, e->n[0], n);
-  eH0->n_c = n;
 
   icfEdge *eH1 = icfEdge_create(mesh);
   icfEdge_setNodes(eH1, n, e->n[1]);
-  eH1->n_c = n;
 
   icfTri  *tL0, *tL1, *tR0, *tR1;
   icfNode *n0,  *n1,  *n2,  *n3;
@@ -283,7 +352,9 @@ void icfEdge_split(icfEdge *e)
     | Determine triangle neighbors
     | and connect new sub-triangles to edges
     -----------------------------------------------------*/
-    icfPrint("t_L: (%d,%d,%d)", t_L->n[0]->index, t_L->n[1]->index, t_L->n[2]->index);
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "t_L: (%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ")",
+        t_L->n[0]->index, t_L->n[1]->index, t_L->n[2]->index);
     if ( e3->t[0] == t_L )
     { 
       t3 = e3->t[1];
@@ -421,12 +492,12 @@ void icfEdge_split(icfEdge *e)
   {
     icfTri_setTris(tL0, tL1, t3, tR0);
     icfTri_setTris(tL1, t2, tL0, tR1);
-    t_L->split   = FALSE;
-    t_L->isSplit = TRUE;
+    t_L->cold->split   = FALSE;
+    t_L->cold->isSplit = TRUE;
 
-    tL0->n_c     = n;
-    tL1->n_c     = n;
-    eV1->n_c     = n;
+    tL0->cold->treeParent = iSplit;
+    tL1->cold->treeParent = iSplit;
+    eV1->cold->treeParent = iSplit;
 
     if (t3 != NULL)
       if (e3 == t3->e[0])
@@ -448,13 +519,9 @@ void icfEdge_split(icfEdge *e)
       else
         log_err("Triangle connectivity seems to be incorrect.");
 
-    t_L->t_c[0]    = tL0;
-    tL0->parent    = t_L;
-    tL0->treeLevel = t_L->treeLevel + 1;
-
-    t_L->t_c[1]    = tL1;
-    tL1->parent    = t_L;
-    tL1->treeLevel = t_L->treeLevel + 1;
+    t_L->cold->treeSplit = iSplit;
+    tL0->cold->treeLevel = t_L->cold->treeLevel + 1;
+    tL1->cold->treeLevel = t_L->cold->treeLevel + 1;
 
   }
 
@@ -463,12 +530,12 @@ void icfEdge_split(icfEdge *e)
   {
     icfTri_setTris(tR0, tR1, tL0, t0);
     icfTri_setTris(tR1, t1, tL1, tR0);
-    t_R->split   = FALSE;
-    t_R->isSplit = TRUE;
+    t_R->cold->split   = FALSE;
+    t_R->cold->isSplit = TRUE;
 
-    tR0->n_c     = n;
-    tR1->n_c     = n;
-    eV0->n_c     = n;
+    tR0->cold->treeParent = iSplit;
+    tR1->cold->treeParent = iSplit;
+    eV0->cold->treeParent = iSplit;
 
     if (t0 != NULL)
       if (e0 == t0->e[0])
@@ -491,71 +558,67 @@ void icfEdge_split(icfEdge *e)
         log_err("Triangle connectivity seems to be incorrect.");
 
 
-    t_R->t_c[0]    = tR0;
-    tR0->parent    = t_R;
-    tR0->treeLevel = t_R->treeLevel + 1;
-
-    t_R->t_c[1]    = tR1;
-    tR1->parent    = t_R;
-    tR1->treeLevel = t_R->treeLevel + 1;
+    t_R->cold->treeSplit = iSplit;
+    tR0->cold->treeLevel = t_R->cold->treeLevel + 1;
+    tR1->cold->treeLevel = t_R->cold->treeLevel + 1;
 
   }
 
   /*-------------------------------------------------------
   | Mark edge as splitted and set its children
   -------------------------------------------------------*/
-  e->isSplit = TRUE;
-
-  e->e_c[0]      = eH0;
-  eH0->parent    = e;
-  eH0->treeLevel = e->treeLevel + 1;
+  e->cold->isSplit   = TRUE;
+  e->cold->treeSplit = iSplit;
 
-  e->e_c[1]      = eH1;
-  eH1->parent    = e;
-  eH1->treeLevel = e->treeLevel + 1;
+  eH0->cold->treeParent = iSplit;
+  eH0->cold->treeLevel  = e->cold->treeLevel + 1;
 
+  eH1->cold->treeParent = iSplit;
+  eH1->cold->treeLevel  = e->cold->treeLevel + 1;
 
-  e->e_c[2] = eV0;
   if (eV0 != NULL)
-  {
-    eV0->parent    = e;
-    eV0->treeLevel = e->treeLevel + 1;
-  }
+    eV0->cold->treeLevel = e->cold->treeLevel + 1;
 
-  e->e_c[3] = eV1;
   if (eV1 != NULL)
-  {
-    eV1->parent    = e;
-    eV1->treeLevel = e->treeLevel + 1;
-  }
+    eV1->cold->treeLevel = e->cold->treeLevel + 1;
 
   /*-------------------------------------------------------
-  | Set connectivity to new node n at edge centroid
+  | Store all entities of the split in its record
   -------------------------------------------------------*/
-  n->e_c[0] = eH0;
-  n->e_c[1] = eV0;
-  n->e_c[2] = eH1;
-  n->e_c[3] = eV1;
+  icfSplit *split = ICF_SPLIT(mesh, iSplit);
 
-  n->t_c[0] = tR0;
-  n->t_c[1] = tR1;
-  n->t_c[2] = tL1;
-  n->t_c[3] = tL0;
+  split->e = e;
+  split->n = n;
+
+  split->e_c[0] = eH0;
+  split->e_c[1] = eV0;
+  split->e_c[2] = eH1;
+  split->e_c[3] = eV1;
+
+  split->t_c[0] = tR0;
+  split->t_c[1] = tR1;
+  split->t_c[2] = tL1;
+  split->t_c[3] = tL0;
+
+  split->t_p[0] = t_R;
+  split->t_p[1] = t_L;
 
 
   /*-------------------------------------------------------
   | Set boundary properties for children
   -------------------------------------------------------*/
-  if (e->bdry != NULL)
+  if (e->cold->bdry != NULL)
   {
-    icfBdry_addEdge(e->bdry, eH0);
-    icfBdry_addEdge(e->bdry, eH1);
-    icfBdry_addNode(e->bdry, n, 0);
-    icfBdry_addNode(e->bdry, n, 1);
+    icfBdry_addEdge(e->cold->bdry, eH0);
+    icfBdry_addEdge(e->cold->bdry, eH1);
+    icfBdry_addNode(e->cold->bdry, n, 0);
+    icfBdry_addNode(e->cold->bdry, n, 1);
   }
 
+  ICF_PROF_END(split);
   return;
 error:
+  ICF_PROF_END(split);
   return;
 
 } /* icfEdge_split() */
@@ -571,41 +634,46 @@ error:
 **********************************************************/
 void icfEdge_merge(icfEdge *e)
 {
-  icfMesh *mesh = e->mesh;
+  icfMesh *mesh = e->cold->mesh;
 
   /*-------------------------------------------------------
   | Find siblings in refinement tree
   -------------------------------------------------------*/
-  icfNode *n = e->n_c;
-  check(n != NULL,
+  const icfIndex iSplit = e->cold->treeParent;
+  check(iSplit >= 0,
       "Can not merge unrefined edge");
 
-  icfEdge *eH0 = n->e_c[0];
-  icfEdge *eV0 = n->e_c[1];
-  icfEdge *eH1 = n->e_c[2];
-  icfEdge *eV1 = n->e_c[3];
+  icfSplit *split = ICF_SPLIT(mesh, iSplit);
+  icfNode  *n     = split->n;
 
-  icfTri  *tR0 = n->t_c[0];
-  icfTri  *tR1 = n->t_c[1];
-  icfTri  *tL1 = n->t_c[2];
-  icfTri  *tL0 = n->t_c[3];
+  icfEdge *eH0 = split->e_c[0];
+  icfEdge *eV0 = split->e_c[1];
+  icfEdge *eH1 = split->e_c[2];
+  icfEdge *eV1 = split->e_c[3];
+
+  icfTri  *tR0 = split->t_c[0];
+  icfTri  *tR1 = split->t_c[1];
+  icfTri  *tL1 = split->t_c[2];
+  icfTri  *tL0 = split->t_c[3];
 
   /*-------------------------------------------------------
   | Check that all siblings are leafs
   -------------------------------------------------------*/
-  if (tR0 != NULL && tR0->isLeaf == FALSE)
+  if (tR0 != NULL && tR0->cold->isLeaf == FALSE)
     return;
-  if (tR1 != NULL && tR1->isLeaf == FALSE)
+  if (tR1 != NULL && tR1->cold->isLeaf == FALSE)
     return;
-  if (tL0 != NULL && tL0->isLeaf == FALSE)
+  if (tL0 != NULL && tL0->cold->isLeaf == FALSE)
     return;
-  if (tL1 != NULL && tL1->isLeaf == FALSE)
+  if (tL1 != NULL && tL1->cold->isLeaf == FALSE)
     return;
 
-#if (ICF_DEBUG > 2)
-  icfPrint("MERGE EDGE (%d,%d)",
+  ICF_PROF_BEGIN(merge, "icfEdge_merge");
+  ICF_PROF_ADD(ICF_PROF_EDGE_MERGES, 1);
+
+  icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+      "MERGE EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ")",
       e->n[0]->index, e->n[1]->index);
-#endif
 
 
   /*-------------------------------------------------------
@@ -742,21 +810,9 @@ void icfEdge_merge(icfEdge *e)
   /*-------------------------------------------------------
   | Get parent entities
   -------------------------------------------------------*/
-  icfEdge *e_p = NULL;
-  icfTri *tL_p = NULL;
-  icfTri *tR_p = NULL;
-
-  if (tL0 != NULL && tL1 != NULL)
-  {
-    tL_p = tL0->parent;
-    e_p  = eV1->parent;
-  }
-
-  if (tR0 != NULL && tR1 != NULL)
-  {
-    tR_p = tR0->parent;
-    e_p  = eV0->parent;
-  }
+  icfEdge *e_p  = split->e;
+  icfTri  *tL_p = split->t_p[1];
+  icfTri  *tR_p = split->t_p[0];
 
   /*-------------------------------------------------------
   | Set neighbors for tL
@@ -907,85 +963,89 @@ void icfEdge_merge(icfEdge *e)
   -------------------------------------------------------*/
   if (tL_p != NULL)
   {
-#if (ICF_DEBUG > 2)
-    icfPrint("DESTROY TRI (%d,%d,%d)",
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "DESTROY TRI (%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ")",
         tL0->n[0]->index,tL0->n[1]->index,tL0->n[2]->index);
-    icfPrint("DESTROY TRI (%d,%d,%d)",
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "DESTROY TRI (%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ")",
         tL1->n[0]->index,tL1->n[1]->index,tL1->n[2]->index);
-    icfPrint("DESTROY EDGE (%d,%d)",
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "DESTROY EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ")",
         eV1->n[0]->index,eV1->n[1]->index);
-#endif
 
-    tL0->merge = FALSE;
-    mesh->triLeafs[tL0->leafPos] = NULL;
+    tL0->cold->merge = FALSE;
+    mesh->triLeafs[tL0->cold->leafPos] = NULL;
 
-    tL1->merge = FALSE;
-    mesh->triLeafs[tL1->leafPos] = NULL;
+    tL1->cold->merge = FALSE;
+    mesh->triLeafs[tL1->cold->leafPos] = NULL;
 
-    eV1->merge = FALSE;
-    mesh->edgeLeafs[eV1->leafPos] = NULL;
+    eV1->cold->merge = FALSE;
+    mesh->edgeLeafs[eV1->cold->leafPos] = NULL;
 
     icfTri_destroy(tL0);
     icfTri_destroy(tL1);
     icfEdge_destroy(eV1);
 
-    tL_p->t_c[0]  = NULL;
-    tL_p->t_c[1]  = NULL;
-    tL_p->isSplit = FALSE;
+    tL_p->cold->treeSplit = -1;
+    tL_p->cold->isSplit   = FALSE;
 
   }
 
   if (tR_p != NULL)
   {
-#if (ICF_DEBUG > 2)
-    icfPrint("DESTROY TRI (%d,%d,%d)",
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "DESTROY TRI (%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ")",
         tR0->n[0]->index,tR0->n[1]->index,tR0->n[2]->index);
-    icfPrint("DESTROY TRI (%d,%d,%d)",
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "DESTROY TRI (%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ")",
         tR1->n[0]->index,tR1->n[1]->index,tR1->n[2]->index);
-    icfPrint("DESTROY EDGE (%d,%d)",
+    icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+        "DESTROY EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ")",
         eV0->n[0]->index,eV0->n[1]->index);
-#endif
 
-    tR0->merge = FALSE;
-    mesh->triLeafs[tR0->leafPos] = NULL;
+    tR0->cold->merge = FALSE;
+    mesh->triLeafs[tR0->cold->leafPos] = NULL;
     
-    tR1->merge = FALSE;
-    mesh->triLeafs[tR1->leafPos] = NULL;
+    tR1->cold->merge = FALSE;
+    mesh->triLeafs[tR1->cold->leafPos] = NULL;
 
-    eV0->merge = FALSE;
-    mesh->edgeLeafs[eV0->leafPos] = NULL;
+    eV0->cold->merge = FALSE;
+    mesh->edgeLeafs[eV0->cold->leafPos] = NULL;
 
     icfTri_destroy(tR0);
     icfTri_destroy(tR1);
     icfEdge_destroy(eV0);
 
-    tR_p->t_c[0]  = NULL;
-    tR_p->t_c[1]  = NULL;
-    tR_p->isSplit = FALSE;
+    tR_p->cold->treeSplit = -1;
+    tR_p->cold->isSplit   = FALSE;
 
   }
 
-#if (ICF_DEBUG > 2)
-    icfPrint("DESTROY EDGE (%d,%d)",
-        eH0->n[0]->index,eH0->n[1]->index);
-    icfPrint("DESTROY EDGE (%d,%d)",
-        eH1->n[0]->index,eH1->n[1]->index);
-    icfPrint("DESTROY NODE %d",
-        n->index);
-#endif
+  icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+      "DESTROY EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ")",
+      eH0->n[0]->index,eH0->n[1]->index);
+  icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE,
+      "DESTROY EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ")",
+      eH1->n[0]->index,eH1->n[1]->index);
+  icfLog(ICF_LOG_EDGE, ICF_LOG_TRACE, "DESTROY NODE %" ICF_PRIdx,
+      n->index);
 
-  eH0->merge = FALSE;
-  mesh->edgeLeafs[eH0->leafPos] = NULL;
+  eH0->cold->merge = FALSE;
+  mesh->edgeLeafs[eH0->cold->leafPos] = NULL;
 
-  eH1->merge = FALSE;
-  mesh->edgeLeafs[eH1->leafPos] = NULL;
+  eH1->cold->merge = FALSE;
+  mesh->edgeLeafs[eH1->cold->leafPos] = NULL;
 
   icfEdge_destroy(eH0);
   icfEdge_destroy(eH1);
   icfNode_destroy(n);
 
-  e_p->isSplit = FALSE;
+  e_p->cold->isSplit   = FALSE;
+  e_p->cold->treeSplit = -1;
+
+  icfSplit_destroy(mesh, iSplit);
 
+  ICF_PROF_END(merge);
 
   return; 
 error:
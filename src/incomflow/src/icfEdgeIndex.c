@@ -0,0 +1,349 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfEdgeIndex.h"
+
+/**********************************************************
+* Function: icfEdgeIndex_slot()
+*----------------------------------------------------------
+* Returns the initial slot of an unordered node pair.
+* The node addresses are mixed, such that the hash does
+* not depend on the node order.
+**********************************************************/
+static inline icfIndex icfEdgeIndex_slot(const icfEdgeIndex *index,
+                                         const icfNode      *n0,
+                                         const icfNode      *n1)
+{
+  uint64_t a  = (uint64_t)(uintptr_t) n0;
+  uint64_t b  = (uint64_t)(uintptr_t) n1;
+  uint64_t lo = a < b ? a : b;
+  uint64_t hi = a < b ? b : a;
+  uint64_t h  = (lo * 0x9E3779B97F4A7C15ULL) ^ hi;
+
+  h *= 0xC2B2AE3D27D4EB4FULL;
+
+  return (icfIndex) ((h >> 32) & (uint64_t)(index->nSlots - 1));
+
+} /* icfEdgeIndex_slot() */
+
+/**********************************************************
+* Function: icfEdgeIndex_matches()
+*----------------------------------------------------------
+* Returns TRUE, if an edge connects both nodes
+**********************************************************/
+static inline icfBool icfEdgeIndex_matches(const icfEdge *edge,
+                                           const icfNode *n0,
+                                           const icfNode *n1)
+{
+  return (edge->n[0] == n0 && edge->n[1] == n1)
+      || (edge->n[0] == n1 && edge->n[1] == n0);
+} /* icfEdgeIndex_matches() */
+
+/**********************************************************
+* Function: icfEdgeIndex_place()
+*----------------------------------------------------------
+* Puts an edge into the first free slot of its probe
+* sequence, the table must not be full
+**********************************************************/
+static void icfEdgeIndex_place(icfEdgeIndex *index, icfEdge *edge)
+{
+  const icfIndex mask = index->nSlots - 1;
+  icfIndex slot = icfEdgeIndex_slot(index, edge->n[0], edge->n[1]);
+
+  while (index->slots[slot] != NULL)
+    slot = (slot + 1) & mask;
+
+  index->slots[slot] = edge;
+  index->nEdges += 1;
+
+} /* icfEdgeIndex_place() */
+
+/**********************************************************
+* Function: icfEdgeIndex_nSlots()
+*----------------------------------------------------------
+* Returns the smallest table size, which holds nEdges
+* below the maximum fill ratio
+**********************************************************/
+static icfIndex icfEdgeIndex_nSlots(icfIndex nEdges)
+{
+  icfIndex nSlots = 16;
+
+  while (10 * (int64_t) nEdges >= ICF_EDGEINDEX_MAXLOAD * (int64_t) nSlots)
+    nSlots *= 2;
+
+  return nSlots;
+
+} /* icfEdgeIndex_nSlots() */
+
+/**********************************************************
+* Function: icfEdgeIndex_resize()
+*----------------------------------------------------------
+* Moves all edges of an index into a new table
+*----------------------------------------------------------
+* @return: 0 on success, -1 on errors (the index is
+*          left unchanged)
+**********************************************************/
+static int icfEdgeIndex_resize(icfEdgeIndex *index, icfIndex nSlots)
+{
+  icfIndex  i;
+  icfIndex  nOld  = index->nSlots;
+  icfEdge **old   = index->slots;
+  icfEdge **slots = (icfEdge**) icfMem_calloc(ICF_MEM_EDGEINDEX,
+                                              nSlots, sizeof(icfEdge*));
+  check_mem(slots);
+
+  index->slots  = slots;
+  index->nSlots = nSlots;
+  index->nEdges = 0;
+
+  for (i = 0; i < nOld; i++)
+    if (old[i] != NULL)
+      icfEdgeIndex_place(index, old[i]);
+
+  icfMem_free(ICF_MEM_EDGEINDEX, old, nOld * sizeof(icfEdge*));
+
+  return 0;
+error:
+  return -1;
+
+} /* icfEdgeIndex_resize() */
+
+/**********************************************************
+* Function: icfEdgeIndex_enable
+*----------------------------------------------------------
+* Creates the edge index of a mesh from all its edges,
+* which have their nodes set. Nothing is done, if the
+* index is already enabled.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfEdgeIndex_enable(icfMesh *mesh)
+{
+  icfListNode  *cur;
+  icfEdgeIndex *index = NULL;
+
+  if (mesh->edgeIndex != NULL)
+    return 0;
+
+  index = (icfEdgeIndex*) icfMem_calloc(ICF_MEM_EDGEINDEX,
+                                        1, sizeof(icfEdgeIndex));
+  check_mem(index);
+
+  index->nEdges = 0;
+  index->nSlots = icfEdgeIndex_nSlots(mesh->edgeStack->count);
+  index->slots  = (icfEdge**) icfMem_calloc(ICF_MEM_EDGEINDEX,
+                                            index->nSlots,
+                                            sizeof(icfEdge*));
+  check_mem(index->slots);
+
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *edge = (icfEdge*) cur->value;
+    if (edge->n[0] != NULL)
+      icfEdgeIndex_place(index, edge);
+  }
+
+  mesh->edgeIndex = index;
+
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG,
+      "EDGE INDEX OF %" ICF_PRIdx " EDGES IN %" ICF_PRIdx " SLOTS",
+      index->nEdges, index->nSlots);
+
+  return 0;
+error:
+  if (index != NULL)
+    icfMem_free(ICF_MEM_EDGEINDEX, index, sizeof(icfEdgeIndex));
+  return -1;
+
+} /* icfEdgeIndex_enable() */
+
+/**********************************************************
+* Function: icfEdgeIndex_disable
+*----------------------------------------------------------
+* Releases the edge index of a mesh
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+**********************************************************/
+void icfEdgeIndex_disable(icfMesh *mesh)
+{
+  icfEdgeIndex *index = mesh->edgeIndex;
+
+  if (index == NULL)
+    return;
+
+  icfMem_free(ICF_MEM_EDGEINDEX, index->slots,
+              index->nSlots * sizeof(icfEdge*));
+  icfMem_free(ICF_MEM_EDGEINDEX, index, sizeof(icfEdgeIndex));
+
+  mesh->edgeIndex = NULL;
+
+} /* icfEdgeIndex_disable() */
+
+/**********************************************************
+* Function: icfEdgeIndex_rebuild
+*----------------------------------------------------------
+* Refills the edge index of a mesh from its edge stack,
+* which is required after the nodes or edges have been
+* moved in memory (see icfMesh_compact()). The table is
+* not reallocated.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+**********************************************************/
+void icfEdgeIndex_rebuild(icfMesh *mesh)
+{
+  icfListNode  *cur;
+  icfEdgeIndex *index = mesh->edgeIndex;
+
+  if (index == NULL)
+    return;
+
+  memset(index->slots, 0, index->nSlots * sizeof(icfEdge*));
+  index->nEdges = 0;
+
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *edge = (icfEdge*) cur->value;
+    if (edge->n[0] != NULL)
+      icfEdgeIndex_place(index, edge);
+  }
+
+} /* icfEdgeIndex_rebuild() */
+
+/**********************************************************
+* Function: icfEdgeIndex_insert
+*----------------------------------------------------------
+* Adds an edge with set nodes to an edge index and
+* doubles the table, if its fill ratio gets too high
+*----------------------------------------------------------
+* @param: index - edge index
+* @param: edge  - edge to add
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfEdgeIndex_insert(icfEdgeIndex *index, icfEdge *edge)
+{
+  if (10 * (int64_t)(index->nEdges+1)
+      >= ICF_EDGEINDEX_MAXLOAD * (int64_t) index->nSlots)
+    check(icfEdgeIndex_resize(index, 2 * index->nSlots) == 0,
+        "Failed to grow the edge index.");
+
+  icfEdgeIndex_place(index, edge);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfEdgeIndex_insert() */
+
+/**********************************************************
+* Function: icfEdgeIndex_remove
+*----------------------------------------------------------
+* Removes an edge from an edge index. The nodes of the
+* edge must not have changed since its insertion.
+* The following edges of the probe sequence are shifted
+* back into the gap, unless their initial slot lies
+* cyclically behind the gap.
+*----------------------------------------------------------
+* @param: index - edge index
+* @param: edge  - edge to remove
+**********************************************************/
+void icfEdgeIndex_remove(icfEdgeIndex *index, icfEdge *edge)
+{
+  const icfIndex mask = index->nSlots - 1;
+  icfIndex gap = icfEdgeIndex_slot(index, edge->n[0], edge->n[1]);
+  icfIndex cur;
+
+  while (index->slots[gap] != edge)
+  {
+    if (index->slots[gap] == NULL)
+      return;
+    gap = (gap + 1) & mask;
+  }
+
+  for (cur = (gap + 1) & mask;
+       index->slots[cur] != NULL;
+       cur = (cur + 1) & mask)
+  {
+    const icfEdge *e    = index->slots[cur];
+    const icfIndex home = icfEdgeIndex_slot(index, e->n[0], e->n[1]);
+
+    /*-----------------------------------------------------
+    | Distances along the probe sequence from the initial
+    | slot of the edge to the gap and to its slot
+    -----------------------------------------------------*/
+    if (((gap - home) & mask) < ((cur - home) & mask))
+    {
+      index->slots[gap] = index->slots[cur];
+      gap = cur;
+    }
+  }
+
+  index->slots[gap] = NULL;
+  index->nEdges -= 1;
+
+} /* icfEdgeIndex_remove() */
+
+/**********************************************************
+* Function: icfEdgeIndex_find
+*----------------------------------------------------------
+* @param: mesh   - pointer to mesh structure
+* @param: n0, n1 - nodes of the edge in any order
+* @return: edge connecting both nodes, NULL if there is
+*          no such edge or if the index is disabled
+**********************************************************/
+icfEdge *icfEdgeIndex_find(const icfMesh *mesh,
+                           const icfNode *n0,
+                           const icfNode *n1)
+{
+  const icfEdgeIndex *index = mesh->edgeIndex;
+  icfIndex mask, slot;
+
+  if (index == NULL || n0 == NULL || n1 == NULL)
+    return NULL;
+
+  mask = index->nSlots - 1;
+  slot = icfEdgeIndex_slot(index, n0, n1);
+
+  while (index->slots[slot] != NULL)
+  {
+    if (icfEdgeIndex_matches(index->slots[slot], n0, n1))
+      return index->slots[slot];
+    slot = (slot + 1) & mask;
+  }
+
+  return NULL;
+
+} /* icfEdgeIndex_find() */
+
+/**********************************************************
+* Function: icfEdgeIndex_findByIndex
+*----------------------------------------------------------
+* Lookup by node indices, which are only valid after
+* icfMesh_update()
+*----------------------------------------------------------
+* @param: mesh   - pointer to mesh structure
+* @param: i0, i1 - node indices of the edge in any order
+* @return: edge connecting both nodes, NULL if there is
+*          no such edge or if the index is disabled
+**********************************************************/
+icfEdge *icfEdgeIndex_findByIndex(const icfMesh *mesh,
+                                  icfIndex       i0,
+                                  icfIndex       i1)
+{
+  if (i0 < 0 || i1 < 0 || i0 >= mesh->nNodes || i1 >= mesh->nNodes)
+    return NULL;
+
+  return icfEdgeIndex_find(mesh, mesh->nodes[i0], mesh->nodes[i1]);
+
+} /* icfEdgeIndex_findByIndex() */
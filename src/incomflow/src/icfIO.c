@@ -6,6 +6,8 @@
  * on usage and license.
  */
 
+#include <stdint.h>
+
 #include "incomflow/icfTypes.h"
 #include "incomflow/icfList.h"
 #include "incomflow/icfFlowData.h"
@@ -18,16 +20,20 @@
 #include "incomflow/dbg.h"
 #include "incomflow/bstrlib.h"
 #include "incomflow/icfIO.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfProf.h"
 
 
 /*************************************************************
-* Function to create a new parameter file reader
+* Function to load a file into a new file reader
+* If <split> is TRUE, the file is also split into lines
 *
 * Reference:
 * https://stackoverflow.com/questions/14002954/c-programming
 * -how-to-read-the-whole-file-contents-into-a-buffer
 *************************************************************/
-icfIOReader *icfIO_createReader(const char *file_path)
+static icfIOReader *icfIO_loadReader(const char *file_path,
+                                     icfBool     split)
 {
   /*---------------------------------------------------------
   | Allocate memory for txtio structure 
@@ -60,9 +66,12 @@ icfIOReader *icfIO_createReader(const char *file_path)
   txtfile->length = length + 1;
 
   /* Split buffer according to newlines                    */
-  char splitter = '\n';
-  txtfile->txtlist = bsplit(bbuffer, splitter);
-  txtfile->nlines = txtfile->txtlist->qty;
+  if (split == TRUE)
+  {
+    char splitter = '\n';
+    txtfile->txtlist = bsplit(bbuffer, splitter);
+    txtfile->nlines = txtfile->txtlist->qty;
+  }
 
   fclose(fptr);
   free(buffer);
@@ -72,6 +81,23 @@ error:
   return NULL;
 }
 
+/*************************************************************
+* Function to create a new parameter file reader
+*************************************************************/
+icfIOReader *icfIO_createReader(const char *file_path)
+{
+  return icfIO_loadReader(file_path, TRUE);
+}
+
+/*************************************************************
+* Function to create a new mesh file reader, which does not
+* split the file into lines
+*************************************************************/
+icfIOReader *icfIO_createMeshReader(const char *file_path)
+{
+  return icfIO_loadReader(file_path, FALSE);
+}
+
 /*************************************************************
 * Function to destroy a file reader structure
 *************************************************************/
@@ -422,154 +448,441 @@ error:
 
 } /* icfIO_extractArray() */
 
-/**********************************************************
-* Function: icfIO_readMeshNodes
-*----------------------------------------------------------
-* Function to read the mesh nodes from a mesh file
-* and writes them into an array of doubles
-*----------------------------------------------------------
-* @param:  txtlist  - text file
-* @param:  xyNodes_ - array to write node coordinates
-* @param:  nNodes_  - integer to write number of nodes
-**********************************************************/
-void icfIO_readMeshNodes(struct bstrList *txtlist,
-                         icfDouble      (**xyNodes_)[2], 
-                         int             *nNodes_)
+/*************************************************************
+* Powers of ten, which are exactly representable as doubles
+*************************************************************/
+static const double icfIO_pow10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  
+  1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 
+  1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 
+};
+
+/*************************************************************
+* Function: icfIO_parseDouble
+*------------------------------------------------------------
+* Locale independent parser for decimal floating point 
+* numbers. Up to 19 significant digits are accumulated in
+* an integer mantissa, which is scaled by a power of ten. 
+* The result is correctly rounded, if the mantissa has 
+* at most 15 digits and the exponent is at most 22.
+* Otherwise, the scaling is done in extended precision.
+* Leading blanks are skipped.
+*------------------------------------------------------------
+* @param: p - pointer to the text, moved behind the number
+* @param: value - parsed value
+* @return: 0 on success, -1 if no number was found
+*************************************************************/
+static int icfIO_parseDouble(const char **p, icfDouble *value)
 {
-  icfDouble (*xyNodes)[2];
-  int nNodes = 0;
+  const char *c = *p;
+  uint64_t mant   = 0;
+  int      nDig   = 0;
+  int      exp10  = 0;
+  int      neg    = 0;
+  int      expNeg = 0;
+  int      expVal = 0;
+  const char *start;
 
-  int i, iMax, nValues, nodeID;
+  while (*c == ' ' || *c == '\t')
+    c++;
 
-  bstring line;
-  bstring *valPtr;
-  struct bstrList *values;
+  if (*c == '-' || *c == '+')
+    neg = (*c++ == '-');
+
+  start = c;
+
+  /*----------------------------------------------------------
+  | Integer part - skip leading zeros
+  ----------------------------------------------------------*/
+  while (*c == '0')
+    c++;
+  for ( ; *c >= '0' && *c <= '9'; c++)
+  {
+    if (nDig < 19)
+    {
+      mant = 10 * mant + (uint64_t)(*c - '0');
+      nDig++;
+    }
+    else
+      exp10++;
+  }
 
   /*----------------------------------------------------------
-  | Get total number of nodes 
+  | Fractional part
   ----------------------------------------------------------*/
-  icfIO_extractParam(txtlist, "NODES", 0, &nNodes);
-  check(nNodes > 0, "No nodes defined in mesh file.");
+  if (*c == '.')
+  {
+    c++;
+    for ( ; *c >= '0' && *c <= '9'; c++)
+    {
+      if (nDig == 0 && *c == '0')
+        exp10--;
+      else if (nDig < 19)
+      {
+        mant = 10 * mant + (uint64_t)(*c - '0');
+        nDig++;
+        exp10--;
+      }
+    }
+  }
+
+  if (c == start || (c == start + 1 && *start == '.'))
+    return -1;
 
   /*----------------------------------------------------------
-  | Get line index where we start to gather nodes
+  | Exponent
   ----------------------------------------------------------*/
-  bstring *flPtr  = txtlist->entry;
-  bstring markStr = bfromcstr( "NODES" );
+  if (*c == 'e' || *c == 'E')
+  {
+    const char *e = c + 1;
 
-  for (i = 0; i < txtlist->qty; i++)
-    if ( binstr(flPtr[i], 0, markStr) != BSTR_ERR )
-      break;
+    if (*e == '-' || *e == '+')
+      expNeg = (*e++ == '-');
 
-  iMax = i + nNodes + 1;
+    if (*e >= '0' && *e <= '9')
+    {
+      for ( ; *e >= '0' && *e <= '9'; e++)
+        if (expVal < 10000)
+          expVal = 10 * expVal + (*e - '0');
+      exp10 += expNeg ? -expVal : expVal;
+      c = e;
+    }
+  }
 
-  xyNodes = calloc(nNodes, 2*sizeof(icfDouble));
+  *p = c;
 
-  for (i = i+1; i < iMax; i++)
+  /*----------------------------------------------------------
+  | Scale mantissa
+  ----------------------------------------------------------*/
+  if (mant == 0)
+  {
+    *value = neg ? -0.0 : 0.0;
+  }
+  else if (mant <= ((uint64_t)1 << 53) && exp10 >= -22 && exp10 <= 22)
+  {
+    double v = (double) mant;
+    v = (exp10 < 0) ? v / icfIO_pow10[-exp10] : v * icfIO_pow10[exp10];
+    *value = neg ? -v : v;
+  }
+  else
   {
-    line  = flPtr[i];
+    long double v = (long double) mant;
 
-    values  = bsplit(line, '\t');
-    nValues = values->qty;
-    valPtr  = values->entry;
+    while (exp10 > 22 && v < 1e308L)
+    {
+      v *= 1e22L;
+      exp10 -= 22;
+    }
+    while (exp10 < -22 && v > 1e-308L)
+    {
+      v /= 1e22L;
+      exp10 += 22;
+    }
 
-    check (nValues == 3, 
-        "Wrong definition for node coordinates.");
+    if (exp10 > 22 || exp10 < -22)
+      v = (exp10 > 0) ? v * 1e22L : 0.0L;
+    else if (exp10 < 0)
+      v /= (long double) icfIO_pow10[-exp10];
+    else
+      v *= (long double) icfIO_pow10[exp10];
 
-    nodeID = atoi(valPtr[0]->data);
+    *value = (icfDouble) (neg ? -v : v);
+  }
 
-    xyNodes[nodeID][0] = atof(valPtr[1]->data);
-    xyNodes[nodeID][1] = atof(valPtr[2]->data);
+  return 0;
 
-    bstrListDestroy( values );
+} /* icfIO_parseDouble() */
 
-  }
+/*************************************************************
+* Function: icfIO_parseIndex
+*------------------------------------------------------------
+* Parser for signed integers. Leading blanks are skipped.
+* The magnitude is accumulated unsigned, such that the 
+* full range of icfIndex is accepted.
+*------------------------------------------------------------
+* @param: p - pointer to the text, moved behind the number
+* @param: value - parsed value
+* @return: 0 on success, -1 if no number was found or if
+*          it exceeds the range of icfIndex
+*************************************************************/
+static int icfIO_parseIndex(const char **p, icfIndex *value)
+{
+  const char *c = *p;
+  uint64_t v   = 0;
+  uint64_t max = (uint64_t) ICF_INDEX_MAX;
+  int      neg = 0;
 
-  bdestroy( markStr );
+  while (*c == ' ' || *c == '\t')
+    c++;
 
-  *xyNodes_ = xyNodes;
-  *nNodes_  = nNodes;
+  if (*c == '-' || *c == '+')
+    neg = (*c++ == '-');
 
-  return;
+  if (*c < '0' || *c > '9')
+    return -1;
 
-error:
-  return;
+  max += neg;
 
-} /* icfIO_readMeshNodes() */
+  for ( ; *c >= '0' && *c <= '9'; c++)
+  {
+    uint64_t d = (uint64_t) (*c - '0');
 
+    if (v > (max - d) / 10)
+      return -1;
 
-/**********************************************************
-* Function: icfIO_readMeshTriangles
-*----------------------------------------------------------
-* Function to read the mesh nodes from a mesh file
-* and writes them into an array of ints
-*----------------------------------------------------------
-* @param:  txtlist  - text file
-* @param:  idxTris_ - array to write triangles node indices
-* @param:  nTris_   - integer to write number of triangles
-**********************************************************/
-void icfIO_readMeshTriangles(struct bstrList *txtlist,
-                             icfIndex      (**idxTris_)[3], 
-                             int             *nTris_)
+    v = 10 * v + d;
+  }
+
+  *p     = c;
+  *value = (icfIndex) (neg ? 0 - v : v);
+
+  return 0;
+
+} /* icfIO_parseIndex() */
+
+/*************************************************************
+* Function: icfIO_findSection
+*------------------------------------------------------------
+* Searches for a line, that starts with the section 
+* specifier <name>, e.g. "NODES 1024". 
+*------------------------------------------------------------
+* @param: txt, length - file data 
+* @param: name - section specifier
+* @param: nRows - number of rows behind the specifier
+* @return: offset of the first data line or -1 if the 
+*          section was not found
+*************************************************************/
+static long icfIO_findSection(const char *txt, 
+                              long        length, 
+                              const char *name,
+                              icfIndex   *nRows)
 {
-  icfIndex (*idxTris)[3];
-  int nTris = 0;
+  size_t len = strlen(name);
+  long   pos = 0;
 
-  int i, iMax, nValues, triID;
+  while (pos < length)
+  {
+    const char *line = txt + pos;
+    const char *nl   = memchr(line, '\n', length - pos);
+    long        next = (nl == NULL) ? length : (nl - txt) + 1;
 
-  bstring line;
-  bstring *valPtr;
-  struct bstrList *values;
+    if ( strncmp(line, name, len) == 0 
+        && (line[len] == ' ' || line[len] == '\t') )
+    {
+      icfIndex    n;
+      const char *c = line + len;
+
+      if ( icfIO_parseIndex(&c, &n) != 0 )
+        return -1;
+
+      *nRows = n;
+      return next;
+    }
+
+    pos = next;
+  }
+
+  return -1;
+
+} /* icfIO_findSection() */
+
+/*************************************************************
+* Function: icfIO_parseSection
+*------------------------------------------------------------
+* Parses the data lines of a mesh file section, where 
+* every line consists of a row ID and <nCols> values:
+*   ID  v_1  v_2  ...  v_nCols
+* The values are stored directly in row ID of the array,
+* every row ID must occur exactly once.
+* The byte range of the section is divided into chunks, 
+* whose boundaries are moved to the next line start, 
+* and the chunks are parsed in parallel.
+*------------------------------------------------------------
+* @param: file - file reader
+* @param: name - section specifier
+* @param: nCols - number of values per line
+* @param: isFloat - TRUE for double values, FALSE for 
+*                   integer values
+* @param: values_ - array to write values
+* @param: nRows_  - integer to write number of rows
+* @return: 0 on success, -1 on errors
+*************************************************************/
+static int icfIO_parseSection(icfIOReader *file,
+                              const char  *name,
+                              int          nCols,
+                              icfBool      isFloat,
+                              void       **values_,
+                              icfIndex    *nRows_)
+{
+  const char *txt    = (const char*) file->txt->data;
+  long        length = file->txt->slen;
+  long        start, end;
+  icfIndex    i, nRows = 0;
+  icfIndex    nChunks;
+  icfIndex    nErrors = 0;
+  icfIndex    nLines  = 0;
+  icfIndex    nDupls  = 0;
+  void       *values  = NULL;
+  unsigned char *seen = NULL;
+  size_t      rowSize = nCols * (isFloat ? sizeof(icfDouble) 
+                                         : sizeof(icfIndex));
 
   /*----------------------------------------------------------
-  | Get total number of triangles 
+  | Locate the section and the end of its last line 
   ----------------------------------------------------------*/
-  icfIO_extractParam(txtlist, "TRIANGLES", 0, &nTris);
-  check(nTris > 0, "No triangles defined in mesh file.");
+  start = icfIO_findSection(txt, length, name, &nRows);
+  check(start >= 0 && nRows > 0, 
+      "No %s defined in %s.", name, file->path);
+
+  for (i = 0, end = start; i < nRows && end < length; i++)
+  {
+    const char *nl = memchr(txt + end, '\n', length - end);
+    end = (nl == NULL) ? length : (nl - txt) + 1;
+  }
+
+  values = calloc(nRows, rowSize);
+  seen   = calloc(nRows, sizeof(unsigned char));
+  check_mem(values && seen);
 
   /*----------------------------------------------------------
-  | Get line index where we start to gather tris
+  | Parse chunks of about 256 kB
   ----------------------------------------------------------*/
-  bstring *flPtr  = txtlist->entry;
-  bstring markStr = bfromcstr( "TRIANGLES" );
+  nChunks = (icfIndex) ((end - start) / (1L << 18)) + 1;
 
-  for (i = 0; i < txtlist->qty; i++)
-    if ( binstr(flPtr[i], 0, markStr) != BSTR_ERR )
-      break;
+#pragma omp parallel for reduction(+:nErrors,nLines,nDupls) \
+                         schedule(dynamic)
+  for (i = 0; i < nChunks; i++)
+  {
+    long cStart = start + (end - start) * i / nChunks;
+    long cEnd   = start + (end - start) * (i+1) / nChunks;
+    const char *c;
+    int j;
+
+    ICF_PROF_BEGIN(parseChunk, "icfIO_parseChunk");
+
+    /*--------------------------------------------------------
+    | A line belongs to the chunk, that contains its first
+    | character
+    --------------------------------------------------------*/
+    if (i > 0)
+    {
+      const char *nl = memchr(txt + cStart - 1, '\n', end - cStart + 1);
+      cStart = (nl == NULL) ? end : (nl - txt) + 1;
+    }
 
-  iMax = i + nTris + 1;
+    c = txt + cStart;
 
-  idxTris = calloc(nTris, 3*sizeof(icfIndex));
+    while (c < txt + cEnd)
+    {
+      icfIndex id;
 
-  for (i = i+1; i < iMax; i++)
-  {
-    line    = flPtr[i];
-    values  = bsplit(line, '\t');
-    nValues = values->qty;
-    valPtr  = values->entry;
+      while (*c == ' ' || *c == '\t' || *c == '\r')
+        c++;
+
+      if (*c == '\n')
+      {
+        c++;
+        continue;
+      }
 
-    check (nValues == 4, 
-        "Wrong definition for triangles.");
+      if ( icfIO_parseIndex(&c, &id) != 0 || id < 0 || id >= nRows )
+      {
+        nErrors++;
+        break;
+      }
 
-    triID = atoi(valPtr[0]->data);
+      /*------------------------------------------------------
+      | Mark the row ID, duplicates would leave other rows
+      | undefined
+      ------------------------------------------------------*/
+      if (__atomic_exchange_n(&seen[id], 1, __ATOMIC_RELAXED) != 0)
+      {
+        nDupls++;
+        break;
+      }
+
+      for (j = 0; j < nCols; j++)
+      {
+        int status = isFloat 
+          ? icfIO_parseDouble(&c, (icfDouble*)values + id*nCols + j)
+          : icfIO_parseIndex(&c,  (icfIndex*)values  + id*nCols + j);
+        if (status != 0)
+          break;
+      }
+
+      while (*c == ' ' || *c == '\t' || *c == '\r')
+        c++;
 
-    idxTris[triID][0] = atof(valPtr[1]->data);
-    idxTris[triID][1] = atof(valPtr[2]->data);
-    idxTris[triID][2] = atof(valPtr[3]->data);
+      if ( j < nCols || (*c != '\n' && *c != '\0') )
+      {
+        nErrors++;
+        break;
+      }
 
-    bstrListDestroy( values );
+      nLines++;
+      c++;
+    }
 
+    ICF_PROF_END(parseChunk);
   }
 
-  bdestroy( markStr );
+  check(nDupls == 0,
+      "Duplicate row IDs in %s of %s.", name, file->path);
+  check(nErrors == 0 && nLines == nRows,
+      "Wrong definition of %s in %s.", name, file->path);
 
-  *idxTris_ = idxTris;
-  *nTris_   = nTris;
+  free(seen);
 
-  return;
+  *values_ = values;
+  *nRows_  = nRows;
+
+  return 0;
 
 error:
-  return;
+  free(values);
+  free(seen);
+  return -1;
+
+} /* icfIO_parseSection() */
+
+/**********************************************************
+* Function: icfIO_readMeshNodes
+*----------------------------------------------------------
+* Function to read the mesh nodes from a mesh file
+* and writes them into an array of doubles
+*----------------------------------------------------------
+* @param:  file     - file reader
+* @param:  xyNodes_ - array to write node coordinates
+* @param:  nNodes_  - integer to write number of nodes
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfIO_readMeshNodes(icfIOReader     *file,
+                        icfDouble      (**xyNodes_)[2], 
+                        icfIndex        *nNodes_)
+{
+  return icfIO_parseSection(file, "NODES", 2, TRUE, 
+                            (void**) xyNodes_, nNodes_);
+
+} /* icfIO_readMeshNodes() */
+
+
+/**********************************************************
+* Function: icfIO_readMeshTriangles
+*----------------------------------------------------------
+* Function to read the mesh triangles from a mesh file
+* and writes them into an array of ints
+*----------------------------------------------------------
+* @param:  file     - file reader
+* @param:  idxTris_ - array to write triangles node indices
+* @param:  nTris_   - integer to write number of triangles
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfIO_readMeshTriangles(icfIOReader     *file,
+                            icfIndex      (**idxTris_)[3], 
+                            icfIndex        *nTris_)
+{
+  return icfIO_parseSection(file, "TRIANGLES", 3, FALSE, 
+                            (void**) idxTris_, nTris_);
 
 } /* icfIO_readMeshTriangles() */
 
@@ -579,80 +892,77 @@ error:
 * Function to read the mesh triangle neighbor connectivity
 * from a mesh file and writes them into an array of ints
 *----------------------------------------------------------
-* @param:  txtlist  - text file
+* @param:  file        - file reader
 * @param:  idxTriNbrs_ - array to write tri-neighbor indices 
-* @param:  nNbrs_   - integer to write number of triangles
+* @param:  nTris_      - integer to write number of triangles
+* @return: 0 on success, -1 on errors
 **********************************************************/
-void icfIO_readMeshTriNbrs(struct bstrList *txtlist,
-                           icfIndex      (**idxTriNbrs_)[3], 
-                           int             *nTris_)
+int icfIO_readMeshTriNbrs(icfIOReader     *file,
+                          icfIndex      (**idxTriNbrs_)[3], 
+                          icfIndex        *nTris_)
 {
-  icfIndex (*idxTriNbrs)[3];
-  int nTris = 0;
-
-  int i, iMax, nValues, triID;
+  return icfIO_parseSection(file, "NEIGHBORS", 3, FALSE, 
+                            (void**) idxTriNbrs_, nTris_);
 
-  bstring line;
-  bstring *valPtr;
-  struct bstrList *values;
-
-  /*----------------------------------------------------------
-  | Get total number of triangles 
-  ----------------------------------------------------------*/
-  icfIO_extractParam(txtlist, "NEIGHBORS", 0, &nTris);
-  check(nTris > 0, "No triangles defined in mesh file.");
-
-  /*----------------------------------------------------------
-  | Get line index where we start to gather tris
-  ----------------------------------------------------------*/
-  bstring *flPtr  = txtlist->entry;
-  bstring markStr = bfromcstr( "NEIGHBORS" );
+} /* icfIO_readMeshNeighbors() */
 
-  for (i = 0; i < txtlist->qty; i++)
-    if ( binstr(flPtr[i], 0, markStr) != BSTR_ERR )
-      break;
+/**********************************************************
+* Function: icfIO_readMeshBdryEdges
+*----------------------------------------------------------
+* Function to read the boundary edges from a mesh file
+* and writes them into an array of ints
+* Every boundary edge is defined by its two node indices
+* and its boundary marker
+*----------------------------------------------------------
+* @param:  file          - file reader
+* @param:  idxBdryEdges_ - array to write boundary edges
+* @param:  nBdryEdges_   - integer to write number of edges
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfIO_readMeshBdryEdges(icfIOReader     *file,
+                            icfIndex      (**idxBdryEdges_)[3], 
+                            icfIndex        *nBdryEdges_)
+{
+  return icfIO_parseSection(file, "BOUNDARIES", 3, FALSE, 
+                            (void**) idxBdryEdges_, nBdryEdges_);
 
-  iMax = i + nTris + 1;
+} /* icfIO_readMeshBdryEdges() */
 
-  idxTriNbrs = calloc(nTris, 3*sizeof(icfIndex));
+/**********************************************************
+* Function: icfIO_countOutside()
+*----------------------------------------------------------
+* Returns the number of entries of a parsed index section,
+* which are outside of [lower, upper)
+**********************************************************/
+static icfIndex icfIO_countOutside(icfIndex (*idx)[3],
+                                   icfIndex   nRows,
+                                   icfIndex   lower,
+                                   icfIndex   upper)
+{
+  icfIndex i, nOutside = 0;
 
-  for (i = i+1; i < iMax; i++)
+#pragma omp parallel for reduction(+:nOutside) schedule(static)
+  for (i = 0; i < nRows; i++)
   {
-    line    = flPtr[i];
-    values  = bsplit(line, '\t');
-    nValues = values->qty;
-    valPtr  = values->entry;
-
-    check (nValues == 4, 
-        "Wrong definition for triangles.");
-
-    triID = atoi(valPtr[0]->data);
-
-    idxTriNbrs[triID][0] = atof(valPtr[1]->data);
-    idxTriNbrs[triID][1] = atof(valPtr[2]->data);
-    idxTriNbrs[triID][2] = atof(valPtr[3]->data);
-
-    bstrListDestroy( values );
-
+    int j;
+    for (j = 0; j < 3; j++)
+      if (idx[i][j] < lower || idx[i][j] >= upper)
+        nOutside++;
   }
 
-  bdestroy( markStr );
-
-  *idxTriNbrs_ = idxTriNbrs;
-  *nTris_   = nTris;
+  return nOutside;
 
-  return;
-
-error:
-  return;
-
-} /* icfIO_readMeshNeighbors() */
+} /* icfIO_countOutside() */
 
 /**********************************************************
 * Function: icfIO_readMesh
 *----------------------------------------------------------
 * Function to read a mesh file an create a mesh structure
 * from it
+* If the file contains no NEIGHBORS section, the edges 
+* and triangle neighbors are computed from the triangles.
+* Boundary edges are then taken from an optional 
+* BOUNDARIES section.
 *----------------------------------------------------------
 * @param : meshFile - string with path to a mesh file
 * @param : mesh - pointer to mesh structure
@@ -660,185 +970,824 @@ error:
 **********************************************************/
 void icfIO_readMesh(const char *meshFile, icfMesh *mesh)
 {
-  int nNodes;
-  int nTris;
-  int nEdges;
-  int i,j;
+  icfIndex nNodes     = 0;
+  icfIndex nTris      = 0;
+  icfIndex nNbrs      = 0;
+  icfIndex nBdryEdges = 0;
+
+  icfDouble (*xyNodes)[2]      = NULL;
+  icfIndex  (*idxTris)[3]      = NULL;
+  icfIndex  (*idxTriNbrs)[3]   = NULL;
+  icfIndex  (*idxBdryEdges)[3] = NULL;
 
-  icfDouble (*xyNodes)[2];
-  icfIndex  (*idxTris)[3];
-  icfIndex  (*idxTriNbrs)[3];
+  ICF_PROF_BEGIN(readMesh, "icfIO_readMesh");
 
   /*----------------------------------------------------------
   | Set up file reader
   ----------------------------------------------------------*/
-  icfIOReader *file = icfIO_createReader( meshFile );
+  icfIOReader *file = icfIO_createMeshReader( meshFile );
+  check(file != NULL, "Failed to read mesh file %s.", meshFile);
 
   /*----------------------------------------------------------
   | read node coordinates
   ----------------------------------------------------------*/
-  icfIO_readMeshNodes(file->txtlist, &xyNodes, &nNodes);
+  check(icfIO_readMeshNodes(file, &xyNodes, &nNodes) == 0,
+      "Failed to read nodes from %s.", meshFile);
 
   /*----------------------------------------------------------
   | read triangle connectivity
   ----------------------------------------------------------*/
-  icfIO_readMeshTriangles(file->txtlist, &idxTris, &nTris);
+  check(icfIO_readMeshTriangles(file, &idxTris, &nTris) == 0,
+      "Failed to read triangles from %s.", meshFile);
+  check(icfIO_countOutside(idxTris, nTris, 0, nNodes) == 0,
+      "Triangle node indices out of range in %s.", meshFile);
 
   /*----------------------------------------------------------
-  | read triangle neighborhood connectivity
+  | read triangle neighborhood connectivity or compute 
+  | it from the triangles 
   ----------------------------------------------------------*/
-  icfIO_readMeshTriNbrs(file->txtlist, &idxTriNbrs, &nTris);
+  icfIO_findSection((const char*) file->txt->data, file->txt->slen,
+                    "NEIGHBORS", &nNbrs);
+
+  if (nNbrs > 0)
+  {
+    check(icfIO_readMeshTriNbrs(file, &idxTriNbrs, &nNbrs) == 0,
+        "Failed to read neighbors from %s.", meshFile);
+    check(nNbrs == nTris, 
+        "Wrong number of neighbors in %s.", meshFile);
+
+    /*--------------------------------------------------------
+    | Negative entries are boundary markers or 
+    | ICF_OUTPUT_NOBDRY
+    --------------------------------------------------------*/
+    check(icfIO_countOutside(idxTriNbrs, nTris, 
+                             ICF_OUTPUT_NOBDRY, nTris) == 0,
+        "Triangle neighbors out of range in %s.", meshFile);
+
+    check(icfMesh_buildFromNbrs(mesh, nNodes, xyNodes, 
+          nTris, idxTris, idxTriNbrs) == 0,
+        "Failed to create mesh from %s.", meshFile);
+  }
+  else
+  {
+    icfIO_findSection((const char*) file->txt->data, file->txt->slen,
+                      "BOUNDARIES", &nBdryEdges);
+
+    if (nBdryEdges > 0)
+      check(icfIO_readMeshBdryEdges(file, &idxBdryEdges, 
+                                    &nBdryEdges) == 0,
+          "Failed to read boundaries from %s.", meshFile);
+
+    check(icfMesh_buildFromTris(mesh, nNodes, xyNodes, 
+          nTris, idxTris, nBdryEdges, idxBdryEdges) == 0,
+        "Failed to create mesh from %s.", meshFile);
+  }
 
   /*----------------------------------------------------------
-  | Create mesh nodes
+  | free reader
   ----------------------------------------------------------*/
-  icfNode **n = calloc(nNodes, sizeof(icfNode*));
-
-  for (i = 0; i < nNodes; i++)
-    n[i] = icfNode_create(mesh, xyNodes[i]);
+  icfIO_destroyReader(file);
 
   /*----------------------------------------------------------
-  | Create mesh triangles
+  | Free arrays
   ----------------------------------------------------------*/
-  icfTri **t = calloc(nTris, sizeof(icfTri*));
+  free(xyNodes);
+  free(idxTris);
+  free(idxTriNbrs);
+  free(idxBdryEdges);
 
-  for (i = 0; i < nTris; i++)
+  ICF_PROF_END(readMesh);
+  return;
+error:
+  if (file != NULL)
+    icfIO_destroyReader(file);
+
+  free(xyNodes);
+  free(idxTris);
+  free(idxTriNbrs);
+  free(idxBdryEdges);
+
+  ICF_PROF_END(readMesh);
+  return;
+
+} /* icfIO_readMesh() */
+
+/*************************************************************
+* Gmsh file reader state
+* The whole file is kept in memory and parsed with a 
+* cursor. Numbers are read either as text or as raw 
+* binary data, depending on the file type.
+*************************************************************/
+typedef struct icfGmshReader {
+  char    *buf;     /* file data, terminated by '\0'         */
+  long     length;  /* Number of bytes in buf                */
+  long     pos;     /* Current read position                 */
+  icfBool  binary;  /* TRUE for binary files                 */
+} icfGmshReader;
+
+/*************************************************************
+* Number of nodes of the gmsh element types
+*************************************************************/
+static int icfGmsh_elementNodes(int type)
+{
+  switch (type)
+  {
+    case  1: return 2;  /* 2-node line        */
+    case  2: return 3;  /* 3-node triangle    */
+    case  3: return 4;  /* 4-node quadrangle  */
+    case  4: return 4;  /* 4-node tetrahedron */
+    case  5: return 8;  /* 8-node hexahedron  */
+    case  6: return 6;  /* 6-node prism       */
+    case  7: return 5;  /* 5-node pyramid     */
+    case  8: return 3;  /* 3-node line        */
+    case  9: return 6;  /* 6-node triangle    */
+    case 10: return 9;  /* 9-node quadrangle  */
+    case 11: return 10; /* 10-node tetrahedron*/
+    case 15: return 1;  /* 1-node point       */
+    case 16: return 8;  /* 8-node quadrangle  */
+    default: return -1;
+  }
+} /* icfGmsh_elementNodes() */
+
+/*************************************************************
+* Skip whitespace characters of a gmsh file
+*************************************************************/
+static void icfGmsh_skipSpace(icfGmshReader *r)
+{
+  while ( r->pos < r->length && 
+        ( r->buf[r->pos] == ' '  || r->buf[r->pos] == '\t' ||
+          r->buf[r->pos] == '\n' || r->buf[r->pos] == '\r' ) )
+    r->pos++;
+} /* icfGmsh_skipSpace() */
+
+/*************************************************************
+* Move behind the next newline character of a gmsh file
+*************************************************************/
+static void icfGmsh_skipLine(icfGmshReader *r)
+{
+  while ( r->pos < r->length && r->buf[r->pos] != '\n' )
+    r->pos++;
+  if ( r->pos < r->length )
+    r->pos++;
+} /* icfGmsh_skipLine() */
+
+/*************************************************************
+* Read an integer from a gmsh file
+*************************************************************/
+static int icfGmsh_readInt(icfGmshReader *r, int *value)
+{
+  if (r->binary)
+  {
+    check(r->pos + (long)sizeof(int) <= r->length,
+        "Unexpected end of gmsh file.");
+    memcpy(value, r->buf + r->pos, sizeof(int));
+    r->pos += sizeof(int);
+  }
+  else
+  {
+    char *end;
+    *value = (int) strtol(r->buf + r->pos, &end, 10);
+    check(end != r->buf + r->pos, 
+        "Failed to read integer from gmsh file.");
+    r->pos = end - r->buf;
+  }
+  return 0;
+error:
+  return -1;
+} /* icfGmsh_readInt() */
+
+/*************************************************************
+* Read <n> unsigned integers of type size_t from a gmsh file
+* Binary data is copied directly into the array
+*************************************************************/
+static int icfGmsh_readSizes(icfGmshReader *r, 
+                             size_t        *values, 
+                             size_t         n)
+{
+  size_t i;
+
+  if (r->binary)
   {
-    t[i] = icfTri_create(mesh);
-    icfTri_setNodes(t[i], n[idxTris[i][0]], 
-                    n[idxTris[i][1]], n[idxTris[i][2]]);
+    check(r->pos + (long)(n*sizeof(size_t)) <= r->length,
+        "Unexpected end of gmsh file.");
+    memcpy(values, r->buf + r->pos, n*sizeof(size_t));
+    r->pos += n * sizeof(size_t);
   }
+  else
+  {
+    for (i = 0; i < n; i++)
+    {
+      char *end;
+      values[i] = (size_t) strtoull(r->buf + r->pos, &end, 10);
+      check(end != r->buf + r->pos, 
+          "Failed to read integer from gmsh file.");
+      r->pos = end - r->buf;
+    }
+  }
+  return 0;
+error:
+  return -1;
+} /* icfGmsh_readSizes() */
+
+/*************************************************************
+* Read <n> doubles from a gmsh file
+* Binary data is copied directly into the array
+*************************************************************/
+static int icfGmsh_readDoubles(icfGmshReader *r, 
+                               double        *values, 
+                               size_t         n)
+{
+  size_t i;
+
+  if (r->binary)
+  {
+    check(r->pos + (long)(n*sizeof(double)) <= r->length,
+        "Unexpected end of gmsh file.");
+    memcpy(values, r->buf + r->pos, n*sizeof(double));
+    r->pos += n * sizeof(double);
+  }
+  else
+  {
+    for (i = 0; i < n; i++)
+    {
+      char *end;
+      values[i] = strtod(r->buf + r->pos, &end);
+      check(end != r->buf + r->pos, 
+          "Failed to read number from gmsh file.");
+      r->pos = end - r->buf;
+    }
+  }
+  return 0;
+error:
+  return -1;
+} /* icfGmsh_readDoubles() */
+
+/*************************************************************
+* Read the name of the next section of a gmsh file, 
+* e.g. "Nodes" for "$Nodes"
+* Returns 1 if the end of the file has been reached
+*************************************************************/
+static int icfGmsh_nextSection(icfGmshReader *r, 
+                               char          *name,
+                               int            maxLen)
+{
+  int n = 0;
+
+  icfGmsh_skipSpace(r);
+
+  if (r->pos >= r->length)
+    return 1;
+
+  check(r->buf[r->pos] == '$', 
+      "Invalid section start in gmsh file.");
+  r->pos++;
+
+  while ( r->pos < r->length && n < maxLen-1 &&
+          r->buf[r->pos] != '\n' && r->buf[r->pos] != '\r' )
+    name[n++] = r->buf[r->pos++];
+  name[n] = '\0';
+
+  icfGmsh_skipLine(r);
+
+  return 0;
+error:
+  return -1;
+} /* icfGmsh_nextSection() */
+
+/*************************************************************
+* Move behind the end marker "$End<name>" of a section
+* The search is done byte-wise, such that also unknown
+* binary sections can be skipped
+*************************************************************/
+static int icfGmsh_endSection(icfGmshReader *r, 
+                              const char    *name)
+{
+  size_t len = strlen(name);
+
+  for ( ; r->pos + 4 + (long)len <= r->length; r->pos++)
+  {
+    if ( r->buf[r->pos] == '$' 
+        && strncmp(r->buf + r->pos + 1, "End", 3) == 0 
+        && strncmp(r->buf + r->pos + 4, name, len) == 0 )
+    {
+      icfGmsh_skipLine(r);
+      return 0;
+    }
+  }
+
+  log_err("Missing $End%s in gmsh file.", name);
+  return -1;
+
+} /* icfGmsh_endSection() */
+
+/**********************************************************
+* Function: icfIO_readGmsh
+*----------------------------------------------------------
+* Function to read a mesh in the Gmsh format 4.1 
+* (ASCII or binary) and to create a mesh structure from it.
+* Only 3-node triangles are used as mesh elements.
+* 2-node lines of curves, that belong to a physical
+* group, are assigned to the boundary, whose marker equals
+* the physical tag. Missing boundaries are created 
+* with the name of the physical group.
+* Edges and triangle neighbors are computed with 
+* icfMesh_buildFromTris().
+*----------------------------------------------------------
+* @param : meshFile - string with path to a gmsh file
+* @param : mesh - pointer to an empty mesh structure
+**********************************************************/
+void icfIO_readGmsh(const char *meshFile, icfMesh *mesh)
+{
+  icfGmshReader r = { NULL, 0, 0, FALSE };
+  FILE   *fp = NULL;
+  char    section[64];
+  icfIndex i, k;
+  int      j;
+  int      status;
+
+  icfIndex nNodes     = 0;
+  icfIndex nTris      = 0;
+  icfIndex nBdryEdges = 0;
+
+  icfDouble (*xyNodes)[2]      = NULL;
+  icfIndex  (*idxTris)[3]      = NULL;
+  icfIndex  (*idxBdryEdges)[3] = NULL;
 
   /*----------------------------------------------------------
-  | Create mesh edges
-  | Determine number of edges from Euler's formula:
-  | >   e = n + t - 1 + b
-  | where f is the number of interior boundaries in the mesh.
-  | Since the edge array is only used for initialization, 
-  | we simply set b to the number of boundaries. Therefore,
-  | e will be a bit longer than nescessary.
-  | 
-  | 
-  | Source:
-  | https://en.wikipedia.org/wiki/Planar_graph#Euler.27s_formula)
-  |
-  |          n2 _____
-  |          / \     /
-  |      t1 / t \ t0/
-  |        /_____\ /
-  |      n0  t2   n1
+  | Node tag -> node index map
   ----------------------------------------------------------*/
-  nEdges = nNodes + nTris - 1 + mesh->nBdrys;
-  icfEdge **e = calloc(nEdges, sizeof(icfEdge*));
+  icfIndex *nodeMap    = NULL;
+  size_t    maxNodeTag = 0;
 
-  icfListNode *cur;
-  int iEdge = 0;
+  /*----------------------------------------------------------
+  | Physical names with their dimension and tag, and the 
+  | first physical tag of every curve
+  ----------------------------------------------------------*/
+  int    nPhysNames = 0;
+  int   *physDims   = NULL;
+  int   *physTags   = NULL;
+  char **physNames  = NULL;
 
-  for (i = 0; i < nTris; i++)
+  int    nCurves    = 0;
+  int   *curveTags  = NULL;
+  int   *curvePhys  = NULL;
+
+  /*----------------------------------------------------------
+  | Buffers for the data of single entity blocks 
+  ----------------------------------------------------------*/
+  size_t  *sizeBuf   = NULL;
+  size_t   sizeAlloc = 0;
+  double  *dblBuf    = NULL;
+  size_t   dblAlloc  = 0;
+
+  /*----------------------------------------------------------
+  | Read the whole file into memory
+  ----------------------------------------------------------*/
+  fp = fopen(meshFile, "rb");
+  check(fp != NULL, "Failed to open gmsh file %s.", meshFile);
+
+  fseek(fp, 0, SEEK_END);
+  r.length = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  r.buf = (char*) malloc(r.length + 1);
+  check_mem(r.buf);
+  check( fread(r.buf, 1, r.length, fp) == (size_t) r.length,
+      "Failed to read gmsh file %s.", meshFile);
+  r.buf[r.length] = '\0';
+
+  fclose(fp);
+  fp = NULL;
+
+  /*----------------------------------------------------------
+  | Parse all sections
+  ----------------------------------------------------------*/
+  while ( (status = icfGmsh_nextSection(&r, section, 64)) == 0 )
   {
+    /*--------------------------------------------------------
+    | $MeshFormat: version file-type data-size
+    --------------------------------------------------------*/
+    if ( strcmp(section, "MeshFormat") == 0 )
+    {
+      double version;
+      int    fileType, dataSize, one;
 
-    for (j = 0; j < 3; j++)
+      check( icfGmsh_readDoubles(&r, &version, 1) == 0
+          && icfGmsh_readInt(&r, &fileType) == 0
+          && icfGmsh_readInt(&r, &dataSize) == 0,
+          "Invalid $MeshFormat in gmsh file %s.", meshFile);
+
+      check( version >= 4.05 && version < 5.0, 
+          "Gmsh file %s has version %.1f - "
+          "only version 4.1 is supported.", meshFile, version);
+
+      if (fileType == 1)
+      {
+        check( dataSize == sizeof(size_t),
+            "Gmsh file %s has unsupported data size %d.", 
+            meshFile, dataSize);
+
+        icfGmsh_skipLine(&r);
+        r.binary = TRUE;
+        check( icfGmsh_readInt(&r, &one) == 0 && one == 1,
+            "Gmsh file %s has a different endianness.", 
+            meshFile);
+      }
+    }
+    /*--------------------------------------------------------
+    | $PhysicalNames: always stored as text
+    | dimension physicalTag "name"
+    --------------------------------------------------------*/
+    else if ( strcmp(section, "PhysicalNames") == 0 )
     {
-      icfBdry *bdry = NULL;
-      int triNbr    = idxTriNbrs[i][j];
+      icfBool binary = r.binary;
+      int     n, dim, tag;
 
-      /*------------------------------------------------------
-      | Create boundary edge (negative neighbor indices)
-      ------------------------------------------------------*/
-      if (triNbr < 0)
+      r.binary = FALSE;
+      check( icfGmsh_readInt(&r, &n) == 0, 
+          "Invalid $PhysicalNames in gmsh file %s.", meshFile);
+
+      physDims  = (int*)   calloc(n, sizeof(int));
+      physTags  = (int*)   calloc(n, sizeof(int));
+      physNames = (char**) calloc(n, sizeof(char*));
+      check_mem(physDims);
+      check_mem(physTags);
+      check_mem(physNames);
+
+      for (i = 0; i < n; i++)
       {
-        int marker = -triNbr;
+        long start;
+
+        check( icfGmsh_readInt(&r, &dim) == 0
+            && icfGmsh_readInt(&r, &tag) == 0,
+            "Invalid $PhysicalNames in gmsh file %s.", meshFile);
+
+        while (r.pos < r.length && r.buf[r.pos] != '"')
+          r.pos++;
+        start = ++r.pos;
+        while (r.pos < r.length && r.buf[r.pos] != '"')
+          r.pos++;
+        check( r.pos < r.length, 
+            "Invalid $PhysicalNames in gmsh file %s.", meshFile);
+
+        physDims[nPhysNames]  = dim;
+        physTags[nPhysNames]  = tag;
+        physNames[nPhysNames] = (char*) calloc(r.pos-start+1, 
+                                               sizeof(char));
+        check_mem(physNames[nPhysNames]);
+        memcpy(physNames[nPhysNames], r.buf+start, r.pos-start);
+        nPhysNames++;
+
+        r.pos++;
+      }
+      r.binary = binary;
+    }
+    /*--------------------------------------------------------
+    | $Entities: store the physical tags of all curves
+    --------------------------------------------------------*/
+    else if ( strcmp(section, "Entities") == 0 )
+    {
+      size_t nEnts[4];
+      size_t nTags;
+      double bbox[6];
+      int    tag, physTag, dim, e;
 
-        int iBdry = 0;
-        for (cur = mesh->bdryStack->first;
-             cur != NULL; cur = cur->next)
+      check( icfGmsh_readSizes(&r, nEnts, 4) == 0, 
+          "Invalid $Entities in gmsh file %s.", meshFile);
+
+      curveTags = (int*) calloc(nEnts[1], sizeof(int));
+      curvePhys = (int*) calloc(nEnts[1], sizeof(int));
+      check_mem(curveTags);
+      check_mem(curvePhys);
+
+      for (dim = 0; dim < 4; dim++)
+      {
+        for (e = 0; e < (int) nEnts[dim]; e++)
         {
-          if (((icfBdry*)cur->value)->marker == marker)
+          /*--------------------------------------------------
+          | Points store their coordinates, all other 
+          | entities their bounding box
+          --------------------------------------------------*/
+          check( icfGmsh_readInt(&r, &tag) == 0
+              && icfGmsh_readDoubles(&r, bbox, 
+                                     dim == 0 ? 3 : 6) == 0
+              && icfGmsh_readSizes(&r, &nTags, 1) == 0,
+              "Invalid $Entities in gmsh file %s.", meshFile);
+
+          physTag = -1;
+          for (k = 0; k < (int) nTags; k++)
           {
-            bdry = (icfBdry*)cur->value;
-            break;
+            int t;
+            check( icfGmsh_readInt(&r, &t) == 0,
+              "Invalid $Entities in gmsh file %s.", meshFile);
+            if (k == 0)
+              physTag = t;
+          }
+
+          if (dim == 1)
+          {
+            if (nTags > 1)
+              log_warn("Curve %d of gmsh file %s belongs to "
+                       "%d physical groups - using group %d.",
+                       tag, meshFile, (int) nTags, physTag);
+
+            curveTags[nCurves] = tag;
+            curvePhys[nCurves] = physTag;
+            nCurves++;
           }
-          iBdry++;
-        }
-        check(bdry != NULL, "Found undefined boundary marker %d in mesh.", marker);
 
-        int n0     = idxTris[i][(j+1)%3];
-        int n1     = idxTris[i][(j+2)%3];
+          /*--------------------------------------------------
+          | Bounding entities
+          --------------------------------------------------*/
+          if (dim > 0)
+          {
+            check( icfGmsh_readSizes(&r, &nTags, 1) == 0,
+              "Invalid $Entities in gmsh file %s.", meshFile);
+            for (k = 0; k < (int) nTags; k++)
+            {
+              int t;
+              check( icfGmsh_readInt(&r, &t) == 0,
+                "Invalid $Entities in gmsh file %s.", meshFile);
+            }
+          }
+        }
+      }
+    }
+    /*--------------------------------------------------------
+    | $Nodes: blocks of node tags followed by coordinates
+    --------------------------------------------------------*/
+    else if ( strcmp(section, "Nodes") == 0 )
+    {
+      size_t header[4];
+      size_t b, nBlock;
+      int    dim, tag, parametric, nParams;
 
-        e[iEdge] = icfEdge_create(mesh);
-        icfEdge_setNodes(e[iEdge], n[n0], n[n1]);
-        icfEdge_setTris(e[iEdge], t[i], NULL);
+      check( icfGmsh_readSizes(&r, header, 4) == 0, 
+          "Invalid $Nodes in gmsh file %s.", meshFile);
 
-        icfBdry_addEdge(bdry, e[iEdge]);
-        icfBdry_addNode(bdry, n[n0], 0);
-        icfBdry_addNode(bdry, n[n1], 1);
+      maxNodeTag = header[3];
 
-        t[i]->t[j] = NULL;
-        t[i]->e[(j+1)%3] = e[iEdge];
+      xyNodes = calloc(header[1], 2*sizeof(icfDouble));
+      nodeMap = (icfIndex*) malloc((maxNodeTag+1)*sizeof(icfIndex));
+      check_mem(xyNodes);
+      check_mem(nodeMap);
 
-        iEdge++;
+      for (b = 0; b <= maxNodeTag; b++)
+        nodeMap[b] = -1;
 
-      }
-      /*------------------------------------------------------
-      | Create interior edge (only once)
-      ------------------------------------------------------*/
-      else if (triNbr > i)
+      for (b = 0; b < header[0]; b++)
       {
-        int n0 = idxTris[i][(j+1)%3];
-        int n1 = idxTris[i][(j+2)%3];
+        check( icfGmsh_readInt(&r, &dim) == 0 
+            && icfGmsh_readInt(&r, &tag) == 0
+            && icfGmsh_readInt(&r, &parametric) == 0
+            && icfGmsh_readSizes(&r, &nBlock, 1) == 0,
+            "Invalid $Nodes in gmsh file %s.", meshFile);
+
+        nParams = 0;
+        if (parametric && (dim == 1 || dim == 2))
+          nParams = dim;
+
+        check( nNodes + nBlock <= header[1], 
+            "Invalid $Nodes in gmsh file %s.", meshFile);
+
+        /*------------------------------------------------------
+        | Grow block buffers
+        ------------------------------------------------------*/
+        if (nBlock > sizeAlloc)
+        {
+          free(sizeBuf);
+          sizeAlloc = nBlock;
+          sizeBuf   = (size_t*) malloc(sizeAlloc*sizeof(size_t));
+          check_mem(sizeBuf);
+        }
+        if (nBlock*(3+nParams) > dblAlloc)
+        {
+          free(dblBuf);
+          dblAlloc = nBlock*(3+nParams);
+          dblBuf   = (double*) malloc(dblAlloc*sizeof(double));
+          check_mem(dblBuf);
+        }
 
-        e[iEdge] = icfEdge_create(mesh);
+        check( icfGmsh_readSizes(&r, sizeBuf, nBlock) == 0
+            && icfGmsh_readDoubles(&r, dblBuf, 
+                                   nBlock*(3+nParams)) == 0,
+            "Invalid $Nodes in gmsh file %s.", meshFile);
 
-        icfEdge_setNodes(e[iEdge], n[n0], n[n1]);
-        icfEdge_setTris(e[iEdge], t[i], t[triNbr]);
+        for (k = 0; k < (icfIndex) nBlock; k++)
+        {
+          check( sizeBuf[k] <= maxNodeTag, 
+            "Invalid node tag in gmsh file %s.", meshFile);
 
-        t[i]->e[(j+1)%3] = e[iEdge];
+          nodeMap[sizeBuf[k]] = nNodes;
+          xyNodes[nNodes][0]  = dblBuf[k*(3+nParams)  ];
+          xyNodes[nNodes][1]  = dblBuf[k*(3+nParams)+1];
+          nNodes++;
+        }
+      }
+    }
+    /*--------------------------------------------------------
+    | $Elements: blocks of element tags and node tags
+    --------------------------------------------------------*/
+    else if ( strcmp(section, "Elements") == 0 )
+    {
+      size_t header[4];
+      size_t b, nBlock, nData;
+      size_t nElems = 0;
+      int    dim, tag, type, nPerElem, marker;
 
-        if (n[n0] == t[triNbr]->n[0])
-          t[triNbr]->e[2] = e[iEdge];
-        else if (n[n0] == t[triNbr]->n[1])
-          t[triNbr]->e[0] = e[iEdge];
-        else if (n[n0] == t[triNbr]->n[2])
-          t[triNbr]->e[1] = e[iEdge];
-        else
-          log_err("Wrong triangle connectivity in mesh.");
+      check( nodeMap != NULL, 
+          "Gmsh file %s defines $Elements before $Nodes.", 
+          meshFile);
 
-        iEdge++;
+      check( icfGmsh_readSizes(&r, header, 4) == 0, 
+          "Invalid $Elements in gmsh file %s.", meshFile);
 
-        t[i]->t[j] = t[triNbr];
-      }
-      else if (triNbr < i)
+      idxTris      = calloc(header[1], 3*sizeof(icfIndex));
+      idxBdryEdges = calloc(header[1], 3*sizeof(icfIndex));
+      check_mem(idxTris);
+      check_mem(idxBdryEdges);
+
+      for (b = 0; b < header[0]; b++)
       {
-        t[i]->t[j] = t[triNbr];
+        check( icfGmsh_readInt(&r, &dim) == 0 
+            && icfGmsh_readInt(&r, &tag) == 0
+            && icfGmsh_readInt(&r, &type) == 0
+            && icfGmsh_readSizes(&r, &nBlock, 1) == 0,
+            "Invalid $Elements in gmsh file %s.", meshFile);
+
+        /*------------------------------------------------------
+        | Triangles and lines are stored in arrays of 
+        | header[1] rows - all blocks count against it
+        ------------------------------------------------------*/
+        check( nBlock <= header[1] - nElems, 
+            "Invalid $Elements in gmsh file %s.", meshFile);
+        nElems += nBlock;
+
+        nPerElem = icfGmsh_elementNodes(type);
+        check( nPerElem > 0, 
+            "Unsupported element type %d in gmsh file %s.",
+            type, meshFile);
+
+        nData = nBlock * (1 + nPerElem);
+        if (nData > sizeAlloc)
+        {
+          free(sizeBuf);
+          sizeAlloc = nData;
+          sizeBuf   = (size_t*) malloc(sizeAlloc*sizeof(size_t));
+          check_mem(sizeBuf);
+        }
+
+        check( icfGmsh_readSizes(&r, sizeBuf, nData) == 0,
+            "Invalid $Elements in gmsh file %s.", meshFile);
+
+        /*------------------------------------------------------
+        | Check node tags of the block 
+        ------------------------------------------------------*/
+        for (k = 0; k < (icfIndex) nBlock; k++)
+          for (j = 1; j <= nPerElem; j++)
+          {
+            size_t n = sizeBuf[k*(1+nPerElem)+j];
+            check( n <= maxNodeTag && nodeMap[n] >= 0,
+              "Invalid node tag in gmsh file %s.", meshFile);
+          }
+
+        /*------------------------------------------------------
+        | 3-node triangles 
+        ------------------------------------------------------*/
+        if (type == 2)
+        {
+          for (k = 0; k < (icfIndex) nBlock; k++)
+          {
+            for (j = 0; j < 3; j++)
+              idxTris[nTris][j] = nodeMap[sizeBuf[k*4+j+1]];
+            nTris++;
+          }
+        }
+        /*------------------------------------------------------
+        | 2-node lines of physical curves
+        ------------------------------------------------------*/
+        else if (type == 1)
+        {
+          marker = -1;
+          for (i = 0; i < nCurves; i++)
+            if (curveTags[i] == tag)
+              marker = curvePhys[i];
+
+          if (marker < 0)
+            continue;
+
+          for (k = 0; k < (icfIndex) nBlock; k++)
+          {
+            idxBdryEdges[nBdryEdges][0] = nodeMap[sizeBuf[k*3+1]];
+            idxBdryEdges[nBdryEdges][1] = nodeMap[sizeBuf[k*3+2]];
+            idxBdryEdges[nBdryEdges][2] = marker;
+            nBdryEdges++;
+          }
+        }
+        else if (type != 15)
+        {
+          log_warn("Skipping %d elements of type %d in "
+                   "gmsh file %s.", (int) nBlock, type, meshFile);
+        }
       }
     }
+
+    /*--------------------------------------------------------
+    | Move behind the end of the section - unknown sections
+    | are skipped 
+    --------------------------------------------------------*/
+    check( icfGmsh_endSection(&r, section) == 0,
+        "Failed to read gmsh file %s.", meshFile);
   }
 
+  check( status == 1, "Failed to read gmsh file %s.", meshFile);
+  check( nTris > 0, "Gmsh file %s contains no triangles.", meshFile);
+
   /*----------------------------------------------------------
-  | free reader
+  | Gmsh triangles may be oriented clockwise 
   ----------------------------------------------------------*/
-  icfIO_destroyReader(file);
+  for (i = 0; i < nTris; i++)
+  {
+    icfDouble *p0 = xyNodes[idxTris[i][0]];
+    icfDouble *p1 = xyNodes[idxTris[i][1]];
+    icfDouble *p2 = xyNodes[idxTris[i][2]];
 
+    icfDouble area = (p1[0]-p0[0]) * (p2[1]-p0[1]) 
+                   - (p2[0]-p0[0]) * (p1[1]-p0[1]);
+
+    if (area < 0.0)
+    {
+      icfIndex tmp  = idxTris[i][1];
+      idxTris[i][1] = idxTris[i][2];
+      idxTris[i][2] = tmp;
+    }
+  }
 
   /*----------------------------------------------------------
-  | Free arrays
+  | Create all boundaries, which are not yet defined
   ----------------------------------------------------------*/
-  free(xyNodes);
-  free(idxTris);
-  free(idxTriNbrs);
-  free(n);
-  free(t);
-  free(e);
+  for (i = 0; i < nBdryEdges; i++)
+  {
+    icfListNode *cur;
+    icfIndex     marker = idxBdryEdges[i][2];
+    icfBool      found  = FALSE;
+
+    for (cur = mesh->bdryStack->first; cur != NULL; cur = cur->next)
+      if ( ((icfBdry*)cur->value)->marker == marker )
+        found = TRUE;
+
+    if (found == TRUE)
+      continue;
+
+    /*--------------------------------------------------------
+    | Boundary markers are tags of physical curves - surface
+    | groups may share the same tag
+    --------------------------------------------------------*/
+    for (k = 0; k < nPhysNames; k++)
+      if (physDims[k] == 1 && physTags[k] == marker)
+        break;
+
+    if (k < nPhysNames)
+    {
+      check( icfBdry_create(mesh, 0, marker, physNames[k]) != NULL,
+          "Failed to create boundary %" ICF_PRIdx ".", marker);
+    }
+    else
+    {
+      char name[32];
+      snprintf(name, 32, "BDRY_%" ICF_PRIdx, marker);
+      check( icfBdry_create(mesh, 0, marker, name) != NULL,
+          "Failed to create boundary %" ICF_PRIdx ".", marker);
+    }
+  }
+
+  /*----------------------------------------------------------
+  | Create the mesh entities
+  ----------------------------------------------------------*/
+  check( icfMesh_buildFromTris(mesh, nNodes, xyNodes, 
+        nTris, idxTris, nBdryEdges, idxBdryEdges) == 0,
+      "Failed to create mesh from %s.", meshFile);
 
-  return;
 error:
+  if (fp != NULL)
+    fclose(fp);
+
+  for (k = 0; k < nPhysNames; k++)
+    free(physNames[k]);
+
+  free(r.buf);
+  free(physNames);
+  free(physDims);
+  free(physTags);
+  free(curveTags);
+  free(curvePhys);
+  free(nodeMap);
+  free(sizeBuf);
+  free(dblBuf);
   free(xyNodes);
   free(idxTris);
-  free(idxTriNbrs);
-  free(n);
-  free(t);
-  free(e);
+  free(idxBdryEdges);
 
   return;
 
-} /* icfIO_readMesh() */
+} /* icfIO_readGmsh() */
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include "incomflow/icfList.h"
 #include "incomflow/dbg.h"
+#include "incomflow/icfMem.h"
 
 
 /**************************************************************
@@ -18,7 +19,7 @@
 **************************************************************/
 icfList *icfList_create()
 {
-  return calloc(1, sizeof(icfList));
+  return icfMem_calloc(ICF_MEM_LISTS, 1, sizeof(icfList));
 }
 
 /**************************************************************
@@ -29,11 +30,11 @@ void icfList_destroy(icfList *list)
 {
   ICFLIST_FOREACH(list, first, next, cur) {
     if (cur->prev) {
-      free(cur->prev);
+      icfMem_free(ICF_MEM_LISTS, cur->prev, sizeof(icfListNode));
     }
   }
-  free(list->last);
-  free(list);
+  icfMem_free(ICF_MEM_LISTS, list->last, sizeof(icfListNode));
+  icfMem_free(ICF_MEM_LISTS, list, sizeof(icfList));
 }
 
 /**************************************************************
@@ -61,7 +62,8 @@ void icfList_clear_destroy(icfList *list)
 **************************************************************/
 void icfList_push(icfList *list, void *value)
 {
-  icfListNode *node = calloc(1, sizeof(icfListNode));
+  icfListNode *node = icfMem_calloc(ICF_MEM_LISTS, 1, 
+                                     sizeof(icfListNode));
   check_mem(node);
 
   node->value = value;
@@ -96,7 +98,8 @@ void *icfList_pop(icfList *list)
 **************************************************************/
 void icfList_unshift(icfList *list, void *value)
 {
-  icfListNode *node = calloc(1, sizeof(icfListNode));
+  icfListNode *node = icfMem_calloc(ICF_MEM_LISTS, 1, 
+                                     sizeof(icfListNode));
   check_mem(node);
 
   node->value = value;
@@ -160,7 +163,7 @@ void *icfList_remove(icfList *list, icfListNode *node)
   
   list->count--;
   result = node->value;
-  free(node);
+  icfMem_free(ICF_MEM_LISTS, node, sizeof(icfListNode));
 
 error:
   return result;
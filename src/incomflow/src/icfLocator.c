@@ -0,0 +1,550 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfLocator.h"
+#include "incomflow/icfProf.h"
+
+/**********************************************************
+* Maximum number of steps of a neighbor walk, before the
+* query falls back to the seed grid
+**********************************************************/
+#define ICF_LOCATOR_MAXWALK 256
+
+/**********************************************************
+* Function: icfLocator_orient()
+*----------------------------------------------------------
+* Returns twice the signed area of the triangle (a,b,p),
+* which is positive, if p lies left of a->b
+**********************************************************/
+static inline icfDouble icfLocator_orient(const icfNode   *a,
+                                          const icfNode   *b,
+                                          const icfDouble *p)
+{
+  return ((icfDouble)b->xy[0] - a->xy[0]) * (p[1] - a->xy[1])
+       - ((icfDouble)b->xy[1] - a->xy[1]) * (p[0] - a->xy[0]);
+} /* icfLocator_orient() */
+
+/**********************************************************
+* Function: icfLocator_bary()
+*----------------------------------------------------------
+* Computes the barycentric coordinates of a point in a
+* counter-clockwise triangle and returns the smallest
+* one. Points inside the triangle have a non-negative
+* minimum. The coordinates are normalised by the area
+* of the node coordinates, not by the stored area, 
+* which may have a lower precision.
+*----------------------------------------------------------
+* @param iMin: returns the node of the smallest
+*              coordinate, whose opposite edge separates
+*              the point from the triangle
+**********************************************************/
+static inline icfDouble icfLocator_bary(const icfTri    *t,
+                                        const icfDouble *p,
+                                        icfDouble       *w,
+                                        int             *iMin)
+{
+  int i;
+  icfDouble scale;
+
+  for (i = 0; i < 3; i++)
+    w[i] = icfLocator_orient(t->n[(i+1)%3], t->n[(i+2)%3], p);
+
+  scale = 1.0 / (w[0] + w[1] + w[2]);
+  w[0] *= scale;
+  w[1] *= scale;
+  w[2] *= scale;
+
+  *iMin = (w[0] <= w[1]) ? ((w[0] <= w[2]) ? 0 : 2) 
+                         : ((w[1] <= w[2]) ? 1 : 2);
+
+  return w[*iMin];
+
+} /* icfLocator_bary() */
+
+/**********************************************************
+* Function: icfLocator_walk()
+*----------------------------------------------------------
+* Walks over the leaf neighbors from a triangle leaf
+* towards a point. Every step crosses the edge opposite
+* to the smallest barycentric coordinate.
+*----------------------------------------------------------
+* @return: containing triangle leaf, NULL if the walk
+*          leaves the domain or exceeds its step limit
+**********************************************************/
+static icfTri *icfLocator_walk(icfTri *t, const icfDouble *p)
+{
+  int k, i = 0;
+  icfDouble w[3];
+
+  for (k = 0; k < ICF_LOCATOR_MAXWALK && t != NULL; k++)
+  {
+    if (icfLocator_bary(t, p, w, &i) >= -ICF_LOCATOR_EPS)
+      return t;
+
+    t = t->t[i];
+  }
+
+  return NULL;
+
+} /* icfLocator_walk() */
+
+/**********************************************************
+* Function: icfLocator_cell()
+*----------------------------------------------------------
+* Returns the seed grid column or row of a coordinate,
+* clipped to the grid
+**********************************************************/
+static inline icfIndex icfLocator_cell(icfDouble x,
+                                       icfDouble x0,
+                                       icfDouble h,
+                                       icfIndex  n)
+{
+  icfDouble c = floor((x - x0) / h);
+  return (c < 0.0) ? 0 : (c >= (icfDouble) n) ? n-1 : (icfIndex) c;
+} /* icfLocator_cell() */
+
+/**********************************************************
+* Function: icfLocator_seed()
+*----------------------------------------------------------
+* Finds the root triangle of a point in the seed grid
+* and descends its refinement tree to a leaf
+*----------------------------------------------------------
+* @return: triangle leaf, NULL if the point lies outside
+*          of all root triangles
+**********************************************************/
+static icfTri *icfLocator_seed(const icfLocator *loc,
+                               const icfDouble  *p)
+{
+  icfIndex  k, c;
+  icfTri   *t = NULL;
+  icfDouble w[3], wBest = -DBL_MAX;
+  int       i;
+
+  if (  p[0] < loc->xyMin[0] || p[0] > loc->xyMax[0]
+     || p[1] < loc->xyMin[1] || p[1] > loc->xyMax[1] )
+    return NULL;
+
+  c = icfLocator_cell(p[1], loc->xyMin[1], loc->cellSize[1], loc->ny)
+        * loc->nx
+    + icfLocator_cell(p[0], loc->xyMin[0], loc->cellSize[0], loc->nx);
+
+  /*-------------------------------------------------------
+  | Root triangle, which contains the point, or which 
+  | contains it best within the tolerance
+  -------------------------------------------------------*/
+  for (k = loc->cellStart[c]; k < loc->cellStart[c+1]; k++)
+  {
+    icfDouble wMin = icfLocator_bary(loc->cellTris[k], p, w, &i);
+
+    if (wMin > wBest)
+    {
+      wBest = wMin;
+      t     = loc->cellTris[k];
+    }
+
+    if (wBest >= 0.0)
+      break;
+  }
+
+  if (t == NULL || wBest < -ICF_LOCATOR_EPS)
+    return NULL;
+
+  /*-------------------------------------------------------
+  | Descend the refinement tree: the point lies in the 
+  | second child, if it lies outside of the first one
+  -------------------------------------------------------*/
+  while (t->cold->treeSplit >= 0)
+  {
+    icfTri *c0 = icfTri_getChild(t, 0);
+
+    t = (icfLocator_bary(c0, p, w, &i) >= 0.0) 
+      ? c0 : icfTri_getChild(t, 1);
+  }
+
+  return t;
+
+} /* icfLocator_seed() */
+
+/**********************************************************
+* Function: icfLocator_near()
+*----------------------------------------------------------
+* Returns TRUE, if the centroid of a triangle and a point
+* lie in the same cell of the seed grid. Walks between 
+* farther points cost more than the descent from a root.
+**********************************************************/
+static inline icfBool icfLocator_near(const icfLocator *loc,
+                                      const icfTri     *t,
+                                      const icfDouble  *p)
+{
+  return icfLocator_cell(p[0], loc->xyMin[0], loc->cellSize[0], loc->nx)
+      == icfLocator_cell(t->xy[0], loc->xyMin[0], loc->cellSize[0], loc->nx)
+      && icfLocator_cell(p[1], loc->xyMin[1], loc->cellSize[1], loc->ny)
+      == icfLocator_cell(t->xy[1], loc->xyMin[1], loc->cellSize[1], loc->ny);
+} /* icfLocator_near() */
+
+/**********************************************************
+* Function: icfLocator_find()
+*----------------------------------------------------------
+* Locates a point starting from a triangle leaf, that
+* has been found by a previous query
+*----------------------------------------------------------
+* @param hint: start of the neighbor walk, may be NULL
+* @return: triangle leaf, NULL if the point lies outside
+*          of the mesh
+**********************************************************/
+static icfTri *icfLocator_find(const icfLocator *loc,
+                               const icfDouble  *p,
+                               icfTri           *hint)
+{
+  icfTri   *t = NULL;
+  icfDouble w[3];
+  int       i;
+
+  if (hint != NULL)
+  {
+    if (icfLocator_bary(hint, p, w, &i) >= -ICF_LOCATOR_EPS)
+      return hint;
+    if (icfLocator_near(loc, hint, p))
+      t = icfLocator_walk(hint->t[i], p);
+  }
+
+  if (t == NULL)
+  {
+    icfTri *seed = icfLocator_seed(loc, p);
+
+    /*-----------------------------------------------------
+    | The walk from the seed only fails for points within
+    | the tolerance of the domain boundary
+    -----------------------------------------------------*/
+    if (seed != NULL)
+      t = icfLocator_walk(seed, p);
+    if (t == NULL)
+      t = seed;
+  }
+
+  return t;
+
+} /* icfLocator_find() */
+
+/**********************************************************
+* Function: icfLocator_free()
+*----------------------------------------------------------
+* Releases the seed grid of a locator
+**********************************************************/
+static void icfLocator_free(icfLocator *loc)
+{
+  icfMem_free(ICF_MEM_LOCATOR, loc->cellStart,
+              (loc->nx*loc->ny+1) * sizeof(icfIndex));
+  icfMem_free(ICF_MEM_LOCATOR, loc->cellTris,
+              (loc->nCellTris+1) * sizeof(icfTri*));
+
+  loc->nx        = 0;
+  loc->ny        = 0;
+  loc->cellStart = NULL;
+  loc->nCellTris = 0;
+  loc->cellTris  = NULL;
+  loc->last      = NULL;
+
+} /* icfLocator_free() */
+
+/**********************************************************
+* Function: icfLocator_build()
+*----------------------------------------------------------
+* Builds the seed grid over the root triangles of the
+* mesh. Every root triangle is listed in all cells,
+* which overlap its bounding box.
+*----------------------------------------------------------
+* @return: 0 on success, -1 on errors
+**********************************************************/
+static int icfLocator_build(icfLocator *loc)
+{
+  int pass;
+  icfIndex i, j, k, nRoots = 0, nCells;
+  icfDouble dx, dy;
+  icfListNode *cur;
+  icfMesh *mesh = loc->mesh;
+
+  icfLocator_free(loc);
+
+  /*-------------------------------------------------------
+  | Bounding box of the root triangles
+  -------------------------------------------------------*/
+  loc->xyMin[0] = loc->xyMin[1] =  DBL_MAX;
+  loc->xyMax[0] = loc->xyMax[1] = -DBL_MAX;
+
+  for (cur = mesh->triStack->first; cur != NULL; cur = cur->next)
+  {
+    const icfTri *t = (icfTri*) cur->value;
+
+    if (t->cold->treeParent >= 0)
+      continue;
+
+    for (k = 0; k < 3; k++)
+    {
+      loc->xyMin[0] = fmin(loc->xyMin[0], t->n[k]->xy[0]);
+      loc->xyMin[1] = fmin(loc->xyMin[1], t->n[k]->xy[1]);
+      loc->xyMax[0] = fmax(loc->xyMax[0], t->n[k]->xy[0]);
+      loc->xyMax[1] = fmax(loc->xyMax[1], t->n[k]->xy[1]);
+    }
+    nRoots += 1;
+  }
+
+  /*-------------------------------------------------------
+  | Grid dimensions, such that the cells are about square
+  -------------------------------------------------------*/
+  dx = fmax(loc->xyMax[0] - loc->xyMin[0], DBL_MIN);
+  dy = fmax(loc->xyMax[1] - loc->xyMin[1], DBL_MIN);
+
+  nCells  = nRoots / ICF_LOCATOR_ROOTSPERCELL;
+  loc->nx = (icfIndex) sqrt((icfDouble) nCells * dx / dy);
+  loc->nx = (loc->nx < 1) ? 1 : loc->nx;
+  loc->ny = nCells / loc->nx;
+  loc->ny = (loc->ny < 1) ? 1 : loc->ny;
+  nCells  = loc->nx * loc->ny;
+
+  loc->cellSize[0] = dx / loc->nx;
+  loc->cellSize[1] = dy / loc->ny;
+
+  loc->cellStart = (icfIndex*) icfMem_calloc(ICF_MEM_LOCATOR,
+                                             nCells+1, sizeof(icfIndex));
+  check_mem(loc->cellStart);
+
+  /*-------------------------------------------------------
+  | Count the roots per cell in the first pass, then
+  | fill in the roots
+  -------------------------------------------------------*/
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (cur = mesh->triStack->first; cur != NULL; cur = cur->next)
+    {
+      icfTri *t = (icfTri*) cur->value;
+      icfDouble x0, y0, x1, y1;
+      icfIndex  i0, j0, i1, j1;
+
+      if (t->cold->treeParent >= 0)
+        continue;
+
+      x0 = fmin(fmin(t->n[0]->xy[0], t->n[1]->xy[0]), t->n[2]->xy[0]);
+      y0 = fmin(fmin(t->n[0]->xy[1], t->n[1]->xy[1]), t->n[2]->xy[1]);
+      x1 = fmax(fmax(t->n[0]->xy[0], t->n[1]->xy[0]), t->n[2]->xy[0]);
+      y1 = fmax(fmax(t->n[0]->xy[1], t->n[1]->xy[1]), t->n[2]->xy[1]);
+
+      i0 = icfLocator_cell(x0, loc->xyMin[0], loc->cellSize[0], loc->nx);
+      j0 = icfLocator_cell(y0, loc->xyMin[1], loc->cellSize[1], loc->ny);
+      i1 = icfLocator_cell(x1, loc->xyMin[0], loc->cellSize[0], loc->nx);
+      j1 = icfLocator_cell(y1, loc->xyMin[1], loc->cellSize[1], loc->ny);
+
+      for (j = j0; j <= j1; j++)
+        for (i = i0; i <= i1; i++)
+        {
+          if (pass == 0)
+            loc->cellStart[j*loc->nx + i + 1] += 1;
+          else
+            loc->cellTris[loc->cellStart[j*loc->nx + i]++] = t;
+        }
+    }
+
+    if (pass == 0)
+    {
+      for (k = 0; k < nCells; k++)
+        loc->cellStart[k+1] += loc->cellStart[k];
+
+      loc->nCellTris = loc->cellStart[nCells];
+      loc->cellTris  = (icfTri**) icfMem_malloc(ICF_MEM_LOCATOR,
+                         (loc->nCellTris+1) * sizeof(icfTri*));
+      check_mem(loc->cellTris);
+    }
+  }
+
+  /*-------------------------------------------------------
+  | The offsets have been shifted to the ends of their
+  | cells while filling in
+  -------------------------------------------------------*/
+  for (k = nCells; k > 0; k--)
+    loc->cellStart[k] = loc->cellStart[k-1];
+  loc->cellStart[0] = 0;
+
+  loc->revision = mesh->revision;
+
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG,
+      "LOCATOR GRID %" ICF_PRIdx " x %" ICF_PRIdx " FOR %" ICF_PRIdx
+      " ROOTS", loc->nx, loc->ny, nRoots);
+
+  return 0;
+error:
+  icfLocator_free(loc);
+  return -1;
+
+} /* icfLocator_build() */
+
+/**********************************************************
+* Function: icfLocator_create
+*----------------------------------------------------------
+* Creates a locator for an updated mesh. The locator
+* must be destroyed before its mesh.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+* @return: pointer to new locator, NULL on errors
+**********************************************************/
+icfLocator *icfLocator_create(icfMesh *mesh)
+{
+  icfLocator *loc = (icfLocator*) icfMem_calloc(ICF_MEM_LOCATOR,
+                                                1, sizeof(icfLocator));
+  check_mem(loc);
+
+  loc->mesh = mesh;
+
+  check(icfLocator_build(loc) == 0,
+      "Failed to build the locator seed grid.");
+
+  return loc;
+error:
+  if (loc != NULL)
+    icfMem_free(ICF_MEM_LOCATOR, loc, sizeof(icfLocator));
+  return NULL;
+
+} /* icfLocator_create() */
+
+/**********************************************************
+* Function: icfLocator_destroy
+*----------------------------------------------------------
+* @param: loc - pointer to locator
+**********************************************************/
+void icfLocator_destroy(icfLocator *loc)
+{
+  if (loc == NULL)
+    return;
+
+  icfLocator_free(loc);
+  icfMem_free(ICF_MEM_LOCATOR, loc, sizeof(icfLocator));
+
+} /* icfLocator_destroy() */
+
+/**********************************************************
+* Function: icfLocator_sync()
+*----------------------------------------------------------
+* Rebuilds the seed grid, if the mesh has been changed
+* since the last build
+*----------------------------------------------------------
+* @return: 0 on success, -1 on errors
+**********************************************************/
+static int icfLocator_sync(icfLocator *loc)
+{
+  if (loc->revision == loc->mesh->revision && loc->cellStart != NULL)
+    return 0;
+
+  return icfLocator_build(loc);
+
+} /* icfLocator_sync() */
+
+/**********************************************************
+* Function: icfLocator_locate
+*----------------------------------------------------------
+* Finds the triangle leaf, which contains a point.
+* The mesh must be updated (see icfMesh_update()).
+*----------------------------------------------------------
+* @param: loc - pointer to locator
+* @param: xy  - coordinates of the point
+* @param: w   - optional barycentric coordinates of the
+*               point with respect to the nodes n[0..2]
+*               of the triangle, may be NULL
+* @return: triangle leaf, NULL if the point lies outside
+*          of the mesh
+**********************************************************/
+icfTri *icfLocator_locate(icfLocator      *loc,
+                          const icfDouble  xy[2],
+                          icfDouble        w[3])
+{
+  int     i;
+  icfTri *t;
+
+  if (icfLocator_sync(loc) != 0)
+    return NULL;
+
+  t = icfLocator_find(loc, xy, loc->last);
+
+  if (t != NULL)
+  {
+    loc->last = t;
+    if (w != NULL)
+      icfLocator_bary(t, xy, w, &i);
+  }
+  else if (w != NULL)
+    w[0] = w[1] = w[2] = 0.0;
+
+  return t;
+
+} /* icfLocator_locate() */
+
+/**********************************************************
+* Function: icfLocator_locateBatch
+*----------------------------------------------------------
+* Locates an array of points in parallel with OpenMP, if
+* available. Every thread starts its walks from its
+* previous result, hence neighboring points should be
+* stored next to each other.
+*----------------------------------------------------------
+* @param: loc  - pointer to locator
+* @param: n    - number of points
+* @param: xy   - coordinates of the points
+* @param: tris - array to write the triangle leafs to,
+*                NULL for points outside of the mesh
+* @param: w    - optional array to write the barycentric
+*                coordinates to, may be NULL
+* @return: number of located points, -1 on errors
+**********************************************************/
+icfIndex icfLocator_locateBatch(icfLocator  *loc,
+                                icfIndex     n,
+                                icfDouble  (*xy)[2],
+                                icfTri     **tris,
+                                icfDouble  (*w)[3])
+{
+  icfIndex nFound = 0;
+
+  ICF_PROF_BEGIN(locate, "icfLocator_locateBatch");
+
+  check(icfLocator_sync(loc) == 0,
+      "Failed to build the locator seed grid.");
+
+#pragma omp parallel reduction(+:nFound)
+  {
+    icfIndex i;
+    int      iMin;
+    icfTri  *hint = loc->last;
+
+#pragma omp for schedule(static)
+    for (i = 0; i < n; i++)
+    {
+      tris[i] = icfLocator_find(loc, xy[i], hint);
+
+      if (tris[i] != NULL)
+      {
+        hint    = tris[i];
+        nFound += 1;
+        if (w != NULL)
+          icfLocator_bary(tris[i], xy[i], w[i], &iMin);
+      }
+      else if (w != NULL)
+        w[i][0] = w[i][1] = w[i][2] = 0.0;
+    }
+  }
+
+  ICF_PROF_END(locate);
+  return nFound;
+
+error:
+  ICF_PROF_END(locate);
+  return -1;
+
+} /* icfLocator_locateBatch() */
@@ -0,0 +1,390 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfLog.h"
+
+#define ICF_LOG_MSGLEN 256
+
+/**********************************************************
+* Global logger state
+**********************************************************/
+int icfLog_levels[ICF_LOG_NMODULES] = {
+  ICF_LOG_DEFAULT_LEVEL, ICF_LOG_DEFAULT_LEVEL, ICF_LOG_DEFAULT_LEVEL,
+  ICF_LOG_DEFAULT_LEVEL, ICF_LOG_DEFAULT_LEVEL, ICF_LOG_DEFAULT_LEVEL
+};
+
+static const char *icfLog_levelNames[] = {
+  "off", "error", "warn", "info", "debug", "trace"
+};
+
+static const char *icfLog_moduleNames[ICF_LOG_NMODULES] = {
+  "app", "mesh", "edge", "tri", "io", "output"
+};
+
+static FILE *icfLog_stream = NULL;
+
+/**********************************************************
+* Asynchronous logger: ring buffer of formatted messages
+**********************************************************/
+typedef struct icfLogAsync {
+  char            (*msgs)[ICF_LOG_MSGLEN];
+  int               size;
+  int               head;
+  int               count;
+  icfBool           active;
+  icfBool           stop;
+  icfBool           writing;
+  long              nDropped;
+  pthread_t         thread;
+  pthread_mutex_t   lock;
+  pthread_cond_t    notEmpty;
+  pthread_cond_t    drained;
+} icfLogAsync;
+
+static icfLogAsync icfLog_async = {
+  .lock     = PTHREAD_MUTEX_INITIALIZER,
+  .notEmpty = PTHREAD_COND_INITIALIZER,
+  .drained  = PTHREAD_COND_INITIALIZER,
+};
+
+/**********************************************************
+* Function: icfLog_setLevel
+*----------------------------------------------------------
+* Sets the log level of a module
+*----------------------------------------------------------
+* @param: module - module or ICF_LOG_ALL
+* @param: level  - ICF_LOG_OFF ... ICF_LOG_TRACE
+**********************************************************/
+void icfLog_setLevel(int module, int level)
+{
+  int i;
+
+  if (level < ICF_LOG_OFF)
+    level = ICF_LOG_OFF;
+  if (level > ICF_LOG_TRACE)
+    level = ICF_LOG_TRACE;
+
+  for (i = 0; i < ICF_LOG_NMODULES; i++)
+    if (module == ICF_LOG_ALL || module == i)
+      __atomic_store_n(&icfLog_levels[i], level, __ATOMIC_RELAXED);
+
+} /* icfLog_setLevel() */
+
+/**********************************************************
+* Function: icfLog_findName
+*----------------------------------------------------------
+* Returns the index of a name of length len in a list
+* of names or -1
+**********************************************************/
+static int icfLog_findName(const char  *name, 
+                           size_t       len,
+                           const char **names, 
+                           int          nNames)
+{
+  int i;
+
+  for (i = 0; i < nNames; i++)
+    if (strlen(names[i]) == len && strncasecmp(name, names[i], len) == 0)
+      return i;
+
+  return -1;
+
+} /* icfLog_findName() */
+
+/**********************************************************
+* Function: icfLog_configure
+*----------------------------------------------------------
+* Sets log levels from a comma separated specification.
+*----------------------------------------------------------
+* @param: spec - specification or NULL (no changes)
+* @return: 0 on success, -1 for invalid entries
+**********************************************************/
+int icfLog_configure(const char *spec)
+{
+  const char *c = spec;
+  int status = 0;
+
+  if (spec == NULL)
+    return 0;
+
+  while (*c != '\0')
+  {
+    size_t      len  = strcspn(c, ",");
+    const char *eq   = memchr(c, '=', len);
+    int         module = ICF_LOG_ALL;
+    int         level;
+
+    if (eq != NULL)
+    {
+      module = icfLog_findName(c, eq - c, icfLog_moduleNames, 
+                               ICF_LOG_NMODULES);
+      level  = icfLog_findName(eq+1, len - (eq - c) - 1, 
+                               icfLog_levelNames, ICF_LOG_TRACE+1);
+    }
+    else
+      level  = icfLog_findName(c, len, icfLog_levelNames, 
+                               ICF_LOG_TRACE+1);
+
+    if (len > 0 && (level < 0 || (eq != NULL && module < 0)))
+    {
+      log_warn("Invalid log specification '%.*s'.", (int) len, c);
+      status = -1;
+    }
+    else if (len > 0)
+      icfLog_setLevel(module, level);
+
+    c += len;
+    if (*c == ',')
+      c++;
+  }
+
+  return status;
+
+} /* icfLog_configure() */
+
+/**********************************************************
+* Function: icfLog_setStream
+*----------------------------------------------------------
+* Sets the output stream of all messages (default stderr)
+**********************************************************/
+void icfLog_setStream(FILE *stream)
+{
+  icfLog_flush();
+
+  pthread_mutex_lock(&icfLog_async.lock);
+  icfLog_stream = stream;
+  pthread_mutex_unlock(&icfLog_async.lock);
+
+} /* icfLog_setStream() */
+
+/**********************************************************
+* Function: icfLog_writerLoop
+*----------------------------------------------------------
+* Main function of the asynchronous log writer
+**********************************************************/
+static void *icfLog_writerLoop(void *arg)
+{
+  icfLogAsync *async = (icfLogAsync*)arg;
+  char msg[ICF_LOG_MSGLEN];
+
+  pthread_mutex_lock(&async->lock);
+
+  while (TRUE)
+  {
+    while (async->count == 0 && async->stop == FALSE)
+      pthread_cond_wait(&async->notEmpty, &async->lock);
+
+    if (async->count == 0 && async->stop == TRUE)
+      break;
+
+    memcpy(msg, async->msgs[async->head], ICF_LOG_MSGLEN);
+    async->head     = (async->head + 1) % async->size;
+    async->count   -= 1;
+    async->writing  = TRUE;
+
+    FILE *stream = (icfLog_stream != NULL) ? icfLog_stream : stderr;
+
+    pthread_mutex_unlock(&async->lock);
+    fputs(msg, stream);
+    pthread_mutex_lock(&async->lock);
+
+    async->writing = FALSE;
+
+    if (async->count == 0)
+    {
+      fflush(stream);
+      pthread_cond_broadcast(&async->drained);
+    }
+  }
+
+  pthread_cond_broadcast(&async->drained);
+  pthread_mutex_unlock(&async->lock);
+
+  return NULL;
+
+} /* icfLog_writerLoop() */
+
+/**********************************************************
+* Function: icfLog_startAsync
+*----------------------------------------------------------
+* Starts a background thread, which writes the messages.
+*----------------------------------------------------------
+* @param: nMessages - ring buffer size
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfLog_startAsync(int nMessages)
+{
+  icfLogAsync *async = &icfLog_async;
+
+  check(nMessages > 0, "Invalid log buffer size.");
+
+  pthread_mutex_lock(&async->lock);
+
+  if (async->active == TRUE)
+  {
+    pthread_mutex_unlock(&async->lock);
+    return 0;
+  }
+
+  async->msgs = calloc(nMessages, ICF_LOG_MSGLEN);
+
+  if (async->msgs == NULL)
+  {
+    pthread_mutex_unlock(&async->lock);
+    sentinel("Out of memory.");
+  }
+
+  async->size     = nMessages;
+  async->head     = 0;
+  async->count    = 0;
+  async->stop     = FALSE;
+  async->writing  = FALSE;
+  async->nDropped = 0;
+
+  if (pthread_create(&async->thread, NULL, 
+                     icfLog_writerLoop, async) != 0)
+  {
+    free(async->msgs);
+    async->msgs = NULL;
+    pthread_mutex_unlock(&async->lock);
+    sentinel("Failed to start log writer thread.");
+  }
+
+  async->active = TRUE;
+
+  pthread_mutex_unlock(&async->lock);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfLog_startAsync() */
+
+/**********************************************************
+* Function: icfLog_stopAsync
+*----------------------------------------------------------
+* Writes all buffered messages and stops the background
+* thread. Messages are written directly afterwards.
+**********************************************************/
+void icfLog_stopAsync(void)
+{
+  icfLogAsync *async = &icfLog_async;
+
+  pthread_mutex_lock(&async->lock);
+
+  if (async->active == FALSE)
+  {
+    pthread_mutex_unlock(&async->lock);
+    return;
+  }
+
+  async->stop = TRUE;
+  pthread_cond_signal(&async->notEmpty);
+  pthread_mutex_unlock(&async->lock);
+
+  pthread_join(async->thread, NULL);
+
+  pthread_mutex_lock(&async->lock);
+  async->active = FALSE;
+  free(async->msgs);
+  async->msgs = NULL;
+  pthread_mutex_unlock(&async->lock);
+
+} /* icfLog_stopAsync() */
+
+/**********************************************************
+* Function: icfLog_flush
+*----------------------------------------------------------
+* Blocks until all buffered messages are written
+**********************************************************/
+void icfLog_flush(void)
+{
+  icfLogAsync *async = &icfLog_async;
+
+  pthread_mutex_lock(&async->lock);
+
+  while ( async->active == TRUE 
+       && (async->count > 0 || async->writing == TRUE) )
+    pthread_cond_wait(&async->drained, &async->lock);
+
+  fflush((icfLog_stream != NULL) ? icfLog_stream : stderr);
+
+  pthread_mutex_unlock(&async->lock);
+
+} /* icfLog_flush() */
+
+/**********************************************************
+* Function: icfLog_nDropped
+*----------------------------------------------------------
+* @return: number of messages dropped by the async logger
+**********************************************************/
+long icfLog_nDropped(void)
+{
+  long n;
+
+  pthread_mutex_lock(&icfLog_async.lock);
+  n = icfLog_async.nDropped;
+  pthread_mutex_unlock(&icfLog_async.lock);
+
+  return n;
+
+} /* icfLog_nDropped() */
+
+/**********************************************************
+* Function: icfLog_write
+*----------------------------------------------------------
+* Formats and writes a message - use icfLog() instead
+**********************************************************/
+void icfLog_write(int module, int level, const char *fmt, ...)
+{
+  icfLogAsync *async = &icfLog_async;
+  char    msg[ICF_LOG_MSGLEN];
+  int     n;
+  va_list args;
+
+  n = snprintf(msg, ICF_LOG_MSGLEN, "[%s] %s: ", 
+      icfLog_levelNames[level], icfLog_moduleNames[module]);
+
+  va_start(args, fmt);
+  vsnprintf(msg + n, ICF_LOG_MSGLEN - n - 1, fmt, args);
+  va_end(args);
+
+  n = strlen(msg);
+  msg[n]   = '\n';
+  msg[n+1] = '\0';
+
+  pthread_mutex_lock(&async->lock);
+
+  if (async->active == TRUE)
+  {
+    if (async->count < async->size)
+    {
+      int iSlot = (async->head + async->count) % async->size;
+      memcpy(async->msgs[iSlot], msg, n+2);
+      async->count += 1;
+      pthread_cond_signal(&async->notEmpty);
+    }
+    else
+      async->nDropped += 1;
+
+    pthread_mutex_unlock(&async->lock);
+    return;
+  }
+
+  pthread_mutex_unlock(&async->lock);
+
+  fputs(msg, (icfLog_stream != NULL) ? icfLog_stream : stderr);
+
+} /* icfLog_write() */
@@ -0,0 +1,239 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <stdlib.h>
+
+#include "incomflow/icfMem.h"
+
+/**********************************************************
+* Global allocator bookkeeping
+**********************************************************/
+static int64_t icfMem_bytes[ICF_MEM_NCATEGORIES];
+static int64_t icfMem_blocks[ICF_MEM_NCATEGORIES];
+static int64_t icfMem_total = 0;
+static int64_t icfMem_high  = 0;
+static int64_t icfMem_count = 0;
+
+static const char *icfMem_names[ICF_MEM_NCATEGORIES] = {
+  "mesh",
+  "nodes",
+  "edges",
+  "tris",
+  "lists",
+  "leaf_arrays",
+  "bdry_arrays",
+  "bdry_faces",
+  "tree",
+  "edge_index",
+  "locator",
+  "snapshot",
+};
+
+/**********************************************************
+* Function: icfMem_account()
+*----------------------------------------------------------
+* Adds a change of live bytes to a category and raises
+* the high-water mark
+**********************************************************/
+static inline void icfMem_account(icfMemCategory category,
+                                  int64_t        bytes,
+                                  int64_t        blocks)
+{
+  int64_t total, high;
+
+  __atomic_fetch_add(&icfMem_bytes[category], bytes, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&icfMem_blocks[category], blocks,
+                     __ATOMIC_RELAXED);
+
+  total = __atomic_add_fetch(&icfMem_total, bytes, __ATOMIC_RELAXED);
+
+  if (bytes <= 0)
+    return;
+
+  high = __atomic_load_n(&icfMem_high, __ATOMIC_RELAXED);
+  while (total > high
+      && !__atomic_compare_exchange_n(&icfMem_high, &high, total,
+                                      1, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED))
+    ;
+
+} /* icfMem_account() */
+
+/**********************************************************
+* Function: icfMem_malloc()
+*----------------------------------------------------------
+* @param: category - accounting category
+* @param: size     - size of the block in bytes
+* @return: pointer to the block, NULL on failure
+**********************************************************/
+void *icfMem_malloc(icfMemCategory category, size_t size)
+{
+  void *ptr = malloc(size);
+
+  __atomic_fetch_add(&icfMem_count, 1, __ATOMIC_RELAXED);
+
+  if (ptr != NULL)
+    icfMem_account(category, (int64_t) size, 1);
+
+  return ptr;
+
+} /* icfMem_malloc() */
+
+/**********************************************************
+* Function: icfMem_calloc()
+*----------------------------------------------------------
+* @param: category - accounting category
+* @param: n, size  - number and size of the elements
+* @return: pointer to the zeroed block, NULL on failure
+**********************************************************/
+void *icfMem_calloc(icfMemCategory category, size_t n, size_t size)
+{
+  void *ptr = calloc(n, size);
+
+  __atomic_fetch_add(&icfMem_count, 1, __ATOMIC_RELAXED);
+
+  if (ptr != NULL)
+    icfMem_account(category, (int64_t) (n*size), 1);
+
+  return ptr;
+
+} /* icfMem_calloc() */
+
+/**********************************************************
+* Function: icfMem_realloc()
+*----------------------------------------------------------
+* @param: category - accounting category
+* @param: ptr      - block to resize
+* @param: oldSize  - current size of the block in bytes
+* @param: newSize  - new size of the block in bytes
+* @return: pointer to the resized block, NULL on failure
+**********************************************************/
+void *icfMem_realloc(icfMemCategory category, void *ptr,
+                     size_t oldSize, size_t newSize)
+{
+  void *newPtr;
+
+  __atomic_fetch_add(&icfMem_count, 1, __ATOMIC_RELAXED);
+
+  /*-------------------------------------------------------
+  | realloc() with a size of zero may free the block and
+  | return NULL, which callers would take as a failure
+  -------------------------------------------------------*/
+  if (newSize == 0)
+  {
+    newPtr = calloc(0, 1);
+    if (newPtr == NULL)
+      return NULL;
+
+    icfMem_free(category, ptr, oldSize);
+    icfMem_account(category, 0, 1);
+    return newPtr;
+  }
+
+  newPtr = realloc(ptr, newSize);
+
+  if (newPtr != NULL)
+    icfMem_account(category, (int64_t) newSize - (int64_t) oldSize,
+                   (ptr == NULL) ? 1 : 0);
+
+  return newPtr;
+
+} /* icfMem_realloc() */
+
+/**********************************************************
+* Function: icfMem_free()
+*----------------------------------------------------------
+* @param: category - accounting category of the block
+* @param: ptr      - block to free, may be NULL
+* @param: size     - size of the block in bytes
+**********************************************************/
+void icfMem_free(icfMemCategory category, void *ptr, size_t size)
+{
+  if (ptr == NULL)
+    return;
+
+  icfMem_account(category, -(int64_t) size, -1);
+  free(ptr);
+
+} /* icfMem_free() */
+
+/**********************************************************
+* Function: icfMem_getStats()
+*----------------------------------------------------------
+* @param: stats - structure to copy the bookkeeping to
+**********************************************************/
+void icfMem_getStats(icfMemStats *stats)
+{
+  int i;
+
+  for (i = 0; i < ICF_MEM_NCATEGORIES; i++)
+  {
+    stats->bytes[i]  = __atomic_load_n(&icfMem_bytes[i],
+                                       __ATOMIC_RELAXED);
+    stats->blocks[i] = __atomic_load_n(&icfMem_blocks[i],
+                                       __ATOMIC_RELAXED);
+  }
+
+  stats->totalBytes = icfMem_allocated();
+  stats->peakBytes  = icfMem_peak();
+  stats->nAllocs    = icfMem_nAllocs();
+
+} /* icfMem_getStats() */
+
+/**********************************************************
+* Function: icfMem_allocated()
+*----------------------------------------------------------
+* @return: live bytes of all categories
+**********************************************************/
+int64_t icfMem_allocated(void)
+{
+  return __atomic_load_n(&icfMem_total, __ATOMIC_RELAXED);
+} /* icfMem_allocated() */
+
+/**********************************************************
+* Function: icfMem_peak()
+*----------------------------------------------------------
+* @return: high-water mark of the live bytes
+**********************************************************/
+int64_t icfMem_peak(void)
+{
+  return __atomic_load_n(&icfMem_high, __ATOMIC_RELAXED);
+} /* icfMem_peak() */
+
+/**********************************************************
+* Function: icfMem_nAllocs()
+*----------------------------------------------------------
+* @return: number of allocations and reallocations
+**********************************************************/
+int64_t icfMem_nAllocs(void)
+{
+  return __atomic_load_n(&icfMem_count, __ATOMIC_RELAXED);
+} /* icfMem_nAllocs() */
+
+/**********************************************************
+* Function: icfMem_resetPeak()
+*----------------------------------------------------------
+* Sets the high-water mark to the current live bytes
+**********************************************************/
+void icfMem_resetPeak(void)
+{
+  __atomic_store_n(&icfMem_high, icfMem_allocated(), __ATOMIC_RELAXED);
+} /* icfMem_resetPeak() */
+
+/**********************************************************
+* Function: icfMem_categoryName()
+*----------------------------------------------------------
+* @return: name of an accounting category
+**********************************************************/
+const char *icfMem_categoryName(icfMemCategory category)
+{
+  if (category < 0 || category >= ICF_MEM_NCATEGORIES)
+    return "unknown";
+
+  return icfMem_names[category];
+
+} /* icfMem_categoryName() */
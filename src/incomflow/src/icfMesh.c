@@ -5,6 +5,12 @@
  * Refer to the accompanying documentation for details
  * on usage and license.
  */
+#include <stdint.h>
+#include <string.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 #include "incomflow/icfTypes.h"
 #include "incomflow/icfList.h"
 #include "incomflow/icfFlowData.h"
@@ -13,6 +19,11 @@
 #include "incomflow/icfNode.h"
 #include "incomflow/icfEdge.h"
 #include "incomflow/icfTri.h"
+#include "incomflow/icfSplit.h"
+#include "incomflow/icfEdgeIndex.h"
+#include "incomflow/icfMeshOrder.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfProf.h"
 
 /**********************************************************
 * Function: icfMesh_create
@@ -24,7 +35,8 @@
 **********************************************************/
 icfMesh *icfMesh_create(void)
 {
-  icfMesh *mesh = (icfMesh*) calloc(1, sizeof(icfMesh) );
+  icfMesh *mesh = (icfMesh*) icfMem_calloc(ICF_MEM_MESH, 
+                                           1, sizeof(icfMesh) );
   check_mem(mesh);
 
   /*-------------------------------------------------------
@@ -32,13 +44,16 @@ icfMesh *icfMesh_create(void)
   -------------------------------------------------------*/
   mesh->nNodes = 0;
   mesh->nodeStack = icfList_create();
-  mesh->nodes = (icfNode**) calloc(0, sizeof(icfNode*) );
+  mesh->nodes = (icfNode**) icfMem_calloc(ICF_MEM_LEAFS, 
+                                          0, sizeof(icfNode*) );
+  mesh->nNodesAlloc = 0;
 
   /*-------------------------------------------------------
   | Mesh edges 
   -------------------------------------------------------*/
   mesh->nEdges = 0;
   mesh->edgeStack = icfList_create();
+  mesh->edgeIndex = NULL;
 
   /*-------------------------------------------------------
   | Mesh triangles 
@@ -56,14 +71,38 @@ icfMesh *icfMesh_create(void)
   | Mesh edge leafs 
   -------------------------------------------------------*/
   mesh->nEdgeLeafs = 0;
-  mesh->edgeLeafs = (icfEdge**) calloc(0, sizeof(icfEdge*));
+  mesh->edgeLeafs = (icfEdge**) icfMem_calloc(ICF_MEM_LEAFS, 
+                                               0, sizeof(icfEdge*));
+  mesh->edgeOrder = ICF_EDGEORDER_STACK;
 
   /*-------------------------------------------------------
   | Mesh triangle leafs 
   -------------------------------------------------------*/
   mesh->nTriLeafs = 0;
-  mesh->triLeafs = (icfTri**) calloc(0, sizeof(icfTri*));
+  mesh->triLeafs = (icfTri**) icfMem_calloc(ICF_MEM_LEAFS, 
+                                             0, sizeof(icfTri*));
+
+  /*-------------------------------------------------------
+  | Refinement forest
+  -------------------------------------------------------*/
+  mesh->nSplits      = 0;
+  mesh->nSplitsAlloc = 0;
+  mesh->splitFree    = -1;
+  mesh->splits       = NULL;
+
+  /*-------------------------------------------------------
+  | Contiguous entity blocks
+  -------------------------------------------------------*/
+  mesh->nNodeSlab    = 0;
+  mesh->nodeSlab     = NULL;
+  mesh->nEdgeSlab    = 0;
+  mesh->edgeSlab     = NULL;
+  mesh->edgeColdSlab = NULL;
+  mesh->nTriSlab     = 0;
+  mesh->triSlab      = NULL;
+  mesh->triColdSlab  = NULL;
 
+  mesh->revision     = 0;
 
   return mesh;
 error:
@@ -71,6 +110,35 @@ error:
 
 } /* icfMesh_create() */
 
+/**********************************************************
+* Function: icfMesh_freeSlabs()
+*----------------------------------------------------------
+* Releases the contiguous entity blocks of a mesh
+**********************************************************/
+static void icfMesh_freeSlabs(icfMesh *mesh)
+{
+  icfMem_free(ICF_MEM_NODES, mesh->nodeSlab, 
+              mesh->nNodeSlab*sizeof(icfNode));
+  icfMem_free(ICF_MEM_EDGES, mesh->edgeSlab, 
+              mesh->nEdgeSlab*sizeof(icfEdge));
+  icfMem_free(ICF_MEM_EDGES, mesh->edgeColdSlab, 
+              mesh->nEdgeSlab*sizeof(icfEdgeCold));
+  icfMem_free(ICF_MEM_TRIS, mesh->triSlab, 
+              mesh->nTriSlab*sizeof(icfTri));
+  icfMem_free(ICF_MEM_TRIS, mesh->triColdSlab, 
+              mesh->nTriSlab*sizeof(icfTriCold));
+
+  mesh->nNodeSlab    = 0;
+  mesh->nodeSlab     = NULL;
+  mesh->nEdgeSlab    = 0;
+  mesh->edgeSlab     = NULL;
+  mesh->edgeColdSlab = NULL;
+  mesh->nTriSlab     = 0;
+  mesh->triSlab      = NULL;
+  mesh->triColdSlab  = NULL;
+
+} /* icfMesh_freeSlabs() */
+
 /**********************************************************
 * Function: icfMesh_destroy
 *----------------------------------------------------------
@@ -83,6 +151,12 @@ int icfMesh_destroy(icfMesh *mesh)
 {
   icfListNode *cur, *nxt;
 
+  /*-------------------------------------------------------
+  | Drop the edge index first, such that the edges are
+  | not removed from it one by one
+  -------------------------------------------------------*/
+  icfEdgeIndex_disable(mesh);
+
   /*-------------------------------------------------------
   | Free all edges on the stack
   -------------------------------------------------------*/
@@ -93,9 +167,7 @@ int icfMesh_destroy(icfMesh *mesh)
     icfEdge_destroy(cur->value);
     cur = nxt;
   }
-#if (ICF_DEBUG > 0)
-  icfPrint("MESH EDGES FREE");
-#endif
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, "MESH EDGES FREE");
 
   /*-------------------------------------------------------
   | Free all tris on the stack
@@ -107,37 +179,32 @@ int icfMesh_destroy(icfMesh *mesh)
     icfTri_destroy(cur->value);
     cur = nxt;
   }
-#if (ICF_DEBUG > 0)
-  icfPrint("MESH TRIANGLES FREE");
-#endif
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, "MESH TRIANGLES FREE");
 
   /*-------------------------------------------------------
-  | Free all bdrys on the stack
+  | Free all nodes on the stack, which removes them 
+  | from the boundaries
   -------------------------------------------------------*/
-  cur = nxt = mesh->bdryStack->first;
+  cur = nxt = mesh->nodeStack->first;
   while (nxt != NULL)
   {
     nxt = cur->next;
-    icfBdry_destroy(cur->value);
+    icfNode_destroy(cur->value);
     cur = nxt;
   }
-#if (ICF_DEBUG > 0)
-  icfPrint("MESH BOUNDARIES FREE");
-#endif
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, "MESH NODES FREE");
 
   /*-------------------------------------------------------
-  | Free all nodes on the stack
+  | Free all bdrys on the stack
   -------------------------------------------------------*/
-  cur = nxt = mesh->nodeStack->first;
+  cur = nxt = mesh->bdryStack->first;
   while (nxt != NULL)
   {
     nxt = cur->next;
-    icfNode_destroy(cur->value);
+    icfBdry_destroy(cur->value);
     cur = nxt;
   }
-#if (ICF_DEBUG > 0)
-  icfPrint("MESH NODES FREE");
-#endif
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, "MESH BOUNDARIES FREE");
 
   /*-------------------------------------------------------
   | Free all mesh list structures
@@ -150,14 +217,28 @@ int icfMesh_destroy(icfMesh *mesh)
   /*-------------------------------------------------------
   | Free all mesh leaf arrays
   -------------------------------------------------------*/
-  free(mesh->edgeLeafs);
-  free(mesh->triLeafs);
-  free(mesh->nodes);
+  icfMem_free(ICF_MEM_LEAFS, mesh->edgeLeafs, 
+              mesh->nEdgeLeafs*sizeof(icfEdge*));
+  icfMem_free(ICF_MEM_LEAFS, mesh->triLeafs, 
+              mesh->nTriLeafs*sizeof(icfTri*));
+  icfMem_free(ICF_MEM_LEAFS, mesh->nodes, 
+              mesh->nNodesAlloc*sizeof(icfNode*));
+
+  /*-------------------------------------------------------
+  | Free the refinement forest
+  -------------------------------------------------------*/
+  icfMem_free(ICF_MEM_TREE, mesh->splits, 
+              mesh->nSplitsAlloc*sizeof(icfSplit));
+
+  /*-------------------------------------------------------
+  | Free the contiguous entity blocks
+  -------------------------------------------------------*/
+  icfMesh_freeSlabs(mesh);
 
   /*-------------------------------------------------------
   | Finally free mesh structure memory
   -------------------------------------------------------*/
-  free(mesh);
+  icfMem_free(ICF_MEM_MESH, mesh, sizeof(icfMesh));
 
   return 0;
 
@@ -249,7 +330,7 @@ void icfMesh_remNode(icfMesh *mesh, icfNode *node)
 **********************************************************/
 void icfMesh_remEdge(icfMesh *mesh, icfEdge *edge)
 {
-  icfList_remove(mesh->edgeStack, edge->stackPos);
+  icfList_remove(mesh->edgeStack, edge->cold->stackPos);
   mesh->nEdges -= 1;
 } /* tmMesh_remEdge() */
 
@@ -262,7 +343,7 @@ void icfMesh_remEdge(icfMesh *mesh, icfEdge *edge)
 **********************************************************/
 void icfMesh_remTri(icfMesh *mesh, icfTri *tri)
 {
-  icfList_remove(mesh->triStack, tri->stackPos);
+  icfList_remove(mesh->triStack, tri->cold->stackPos);
   mesh->nTris -= 1;
 } /* tmMesh_remTri() */
 
@@ -279,6 +360,614 @@ void icfMesh_remBdry(icfMesh *mesh, icfBdry *bdry)
   mesh->nBdrys -= 1;
 } /* tmMesh_remBdry() */
 
+/**********************************************************
+* Function: icfMesh_buildFromNbrs()
+*----------------------------------------------------------
+* Function to create the entities of an empty mesh from
+* arrays of node coordinates, triangle node indices and
+* triangle neighbor indices.
+* The neighbor tris[i][j] is located opposite of the 
+* node tris[i][j]. Negative neighbor indices denote 
+* boundary edges with the marker -triNbrs[i][j].
+* All boundaries must be defined in the mesh beforehand.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param nNodes, xyNodes: node coordinates
+* @param nTris, idxTris: triangle node indices
+* @param idxTriNbrs: triangle neighbor indices
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMesh_buildFromNbrs(icfMesh   *mesh,
+                          icfIndex   nNodes,
+                          icfDouble (*xyNodes)[2],
+                          icfIndex   nTris,
+                          icfIndex  (*idxTris)[3],
+                          icfIndex  (*idxTriNbrs)[3])
+{
+  icfIndex i;
+  int      j;
+  icfListNode *cur;
+
+  icfNode **n = NULL;
+  icfTri  **t = NULL;
+
+  /*----------------------------------------------------------
+  | Create mesh nodes
+  ----------------------------------------------------------*/
+  n = calloc(nNodes, sizeof(icfNode*));
+  check_mem(n);
+
+  for (i = 0; i < nNodes; i++)
+    n[i] = icfNode_create(mesh, xyNodes[i]);
+
+  /*----------------------------------------------------------
+  | Create mesh triangles
+  ----------------------------------------------------------*/
+  t = calloc(nTris, sizeof(icfTri*));
+  check_mem(t);
+
+  for (i = 0; i < nTris; i++)
+  {
+    t[i] = icfTri_create(mesh);
+    icfTri_setNodes(t[i], n[idxTris[i][0]], 
+                    n[idxTris[i][1]], n[idxTris[i][2]]);
+  }
+
+  /*----------------------------------------------------------
+  | Create mesh edges
+  | Every interior edge is created only once by the 
+  | triangle with the lower index.
+  |
+  |          n2 _____
+  |          / \     /
+  |      t1 / t \ t0/
+  |        /_____\ /
+  |      n0  t2   n1
+  ----------------------------------------------------------*/
+  for (i = 0; i < nTris; i++)
+  {
+    for (j = 0; j < 3; j++)
+    {
+      icfBdry *bdry = NULL;
+      icfEdge *edge = NULL;
+      icfIndex triNbr = idxTriNbrs[i][j];
+
+      /*------------------------------------------------------
+      | Create boundary edge (negative neighbor indices)
+      | ICF_OUTPUT_NOBDRY denotes an edge without boundary
+      ------------------------------------------------------*/
+      if (triNbr < 0)
+      {
+        icfIndex n0 = idxTris[i][(j+1)%3];
+        icfIndex n1 = idxTris[i][(j+2)%3];
+
+        if (triNbr != ICF_OUTPUT_NOBDRY)
+        {
+          icfIndex marker = -triNbr;
+
+          for (cur = mesh->bdryStack->first;
+               cur != NULL; cur = cur->next)
+          {
+            if (((icfBdry*)cur->value)->marker == marker)
+            {
+              bdry = (icfBdry*)cur->value;
+              break;
+            }
+          }
+          check(bdry != NULL, 
+              "Found undefined boundary marker %" ICF_PRIdx " in mesh.", 
+              marker);
+        }
+
+        edge = icfEdge_create(mesh);
+        icfEdge_setNodes(edge, n[n0], n[n1]);
+        icfEdge_setTris(edge, t[i], NULL);
+
+        if (bdry != NULL)
+        {
+          icfBdry_addEdge(bdry, edge);
+          icfBdry_addNode(bdry, n[n0], 0);
+          icfBdry_addNode(bdry, n[n1], 1);
+        }
+
+        t[i]->t[j] = NULL;
+        t[i]->e[(j+1)%3] = edge;
+
+      }
+      /*------------------------------------------------------
+      | Create interior edge (only once)
+      ------------------------------------------------------*/
+      else if (triNbr > i)
+      {
+        icfIndex n0 = idxTris[i][(j+1)%3];
+        icfIndex n1 = idxTris[i][(j+2)%3];
+
+        edge = icfEdge_create(mesh);
+
+        icfEdge_setNodes(edge, n[n0], n[n1]);
+        icfEdge_setTris(edge, t[i], t[triNbr]);
+
+        t[i]->e[(j+1)%3] = edge;
+
+        if (n[n0] == t[triNbr]->n[0])
+          t[triNbr]->e[2] = edge;
+        else if (n[n0] == t[triNbr]->n[1])
+          t[triNbr]->e[0] = edge;
+        else if (n[n0] == t[triNbr]->n[2])
+          t[triNbr]->e[1] = edge;
+        else
+          log_err("Wrong triangle connectivity in mesh.");
+
+        t[i]->t[j] = t[triNbr];
+      }
+      else if (triNbr < i)
+      {
+        t[i]->t[j] = t[triNbr];
+      }
+    }
+  }
+
+  free(n);
+  free(t);
+
+  return 0;
+error:
+  free(n);
+  free(t);
+
+  return -1;
+
+} /* icfMesh_buildFromNbrs() */
+
+/**********************************************************
+* Open-addressing hash table for sorted node index pairs.
+* Every slot stores both node indices of its pair, such
+* that distinct pairs never share a slot, whatever the 
+* size of the indices. Empty slots hold the lower index
+* ICF_PAIR_EMPTY, slot values are initialized to 
+* ICF_PAIR_PENDING.
+**********************************************************/
+#define ICF_PAIR_EMPTY   UINT64_MAX
+#define ICF_PAIR_PENDING -1
+#define ICF_PAIR_DONE    -2
+
+typedef struct icfPairTable {
+  uint64_t *lo;
+  uint64_t *hi;
+  icfIndex *vals;
+  uint64_t  mask;
+} icfPairTable;
+
+/**********************************************************
+* Function: icfPairTable_init()
+*----------------------------------------------------------
+* Allocates a table with at least 2*nKeys slots
+*----------------------------------------------------------
+* @return: 0 on success, -1 on errors
+**********************************************************/
+static int icfPairTable_init(icfPairTable *tbl, long nKeys)
+{
+  uint64_t nSlots = 16;
+
+  while (nSlots < 2 * (uint64_t)nKeys)
+    nSlots *= 2;
+
+  tbl->mask = nSlots - 1;
+  tbl->lo   = (uint64_t*) malloc(nSlots * sizeof(uint64_t));
+  tbl->hi   = (uint64_t*) malloc(nSlots * sizeof(uint64_t));
+  tbl->vals = (icfIndex*) malloc(nSlots * sizeof(icfIndex));
+  check_mem(tbl->lo && tbl->hi && tbl->vals);
+
+  memset(tbl->lo,   0xff, nSlots * sizeof(uint64_t));
+  memset(tbl->vals, 0xff, nSlots * sizeof(icfIndex));
+
+  return 0;
+error:
+  free(tbl->lo);
+  free(tbl->hi);
+  free(tbl->vals);
+  tbl->lo   = NULL;
+  tbl->hi   = NULL;
+  tbl->vals = NULL;
+  return -1;
+
+} /* icfPairTable_init() */
+
+/**********************************************************
+* Function: icfPairTable_free()
+**********************************************************/
+static void icfPairTable_free(icfPairTable *tbl)
+{
+  free(tbl->lo);
+  free(tbl->hi);
+  free(tbl->vals);
+} /* icfPairTable_free() */
+
+/**********************************************************
+* Function: icfPairTable_sort()
+*----------------------------------------------------------
+* Sorts the node indices of an unordered pair
+**********************************************************/
+static inline void icfPairTable_sort(icfIndex a, icfIndex b,
+                                     uint64_t *lo, uint64_t *hi)
+{
+  *lo = (uint64_t)(a < b ? a : b);
+  *hi = (uint64_t)(a < b ? b : a);
+} /* icfPairTable_sort() */
+
+/**********************************************************
+* Function: icfPairTable_slot()
+*----------------------------------------------------------
+* Returns the initial slot of a sorted pair, which mixes 
+* both indices in full width
+**********************************************************/
+static inline uint64_t icfPairTable_slot(const icfPairTable *tbl,
+                                         uint64_t lo, uint64_t hi)
+{
+  uint64_t h = (lo * 0x9E3779B97F4A7C15ULL) ^ hi;
+
+  h *= 0xC2B2AE3D27D4EB4FULL;
+
+  return (h >> 32) & tbl->mask;
+} /* icfPairTable_slot() */
+
+/**********************************************************
+* Function: icfPairTable_insert()
+*----------------------------------------------------------
+* Serial insertion of a value for an unordered pair
+**********************************************************/
+static void icfPairTable_insert(icfPairTable *tbl,
+                                icfIndex      a,
+                                icfIndex      b,
+                                icfIndex      val)
+{
+  uint64_t lo, hi, slot;
+
+  icfPairTable_sort(a, b, &lo, &hi);
+  slot = icfPairTable_slot(tbl, lo, hi);
+
+  while ( tbl->lo[slot] != ICF_PAIR_EMPTY 
+      && (tbl->lo[slot] != lo || tbl->hi[slot] != hi) )
+    slot = (slot + 1) & tbl->mask;
+
+  tbl->lo[slot]   = lo;
+  tbl->hi[slot]   = hi;
+  tbl->vals[slot] = val;
+
+} /* icfPairTable_insert() */
+
+/**********************************************************
+* Function: icfPairTable_get()
+*----------------------------------------------------------
+* Returns the value of an unordered pair or 
+* ICF_PAIR_PENDING if the pair is not stored in the table
+**********************************************************/
+static icfIndex icfPairTable_get(const icfPairTable *tbl,
+                                 icfIndex            a,
+                                 icfIndex            b)
+{
+  uint64_t lo, hi, slot;
+
+  icfPairTable_sort(a, b, &lo, &hi);
+  slot = icfPairTable_slot(tbl, lo, hi);
+
+  while (tbl->lo[slot] != ICF_PAIR_EMPTY)
+  {
+    if (tbl->lo[slot] == lo && tbl->hi[slot] == hi)
+      return tbl->vals[slot];
+    slot = (slot + 1) & tbl->mask;
+  }
+
+  return ICF_PAIR_PENDING;
+
+} /* icfPairTable_get() */
+
+/**********************************************************
+* Function: icfMesh_pairTris()
+*----------------------------------------------------------
+* Function to compute the triangle neighbor indices 
+* from the triangle node indices alone.
+* Edges are identified by their sorted node pair in 
+* an open-addressing hash table, such that the pairing
+* runs in linear time. The pairing loop is parallelised
+* with OpenMP, if available.
+* Unpaired triangle sides get the neighbor index -1.
+*----------------------------------------------------------
+* @param nTris, idxTris: triangle node indices
+* @param idxTriNbrs: array to write neighbor indices to
+* @return: 0 on success, -1 for non-manifold or 
+*          inconsistently oriented triangles
+**********************************************************/
+int icfMesh_pairTris(icfIndex   nTris,
+                     icfIndex (*idxTris)[3],
+                     icfIndex (*idxTriNbrs)[3])
+{
+  icfIndex h;
+  icfIndex nHalf   = 3 * nTris;
+  icfIndex nErrors = 0;
+
+  icfPairTable tbl;
+
+  /*-------------------------------------------------------
+  | Every edge is inserted only once, by the first 
+  | triangle side that reaches it
+  -------------------------------------------------------*/
+  check(icfPairTable_init(&tbl, nHalf / 2 + 1) == 0,
+      "Failed to allocate edge hash table.");
+
+  for (h = 0; h < nHalf; h++)
+    idxTriNbrs[h/3][h%3] = -1;
+
+  /*-------------------------------------------------------
+  | Each triangle side (half-edge) h = 3*i + j is 
+  | opposite of node j in triangle i.
+  | The first half-edge of an edge claims an empty slot
+  | with the lower node index, stores the higher one and 
+  | publishes its own index. The second one finds both 
+  | node indices, consumes the published index and 
+  | connects both triangles.
+  -------------------------------------------------------*/
+#pragma omp parallel for reduction(+:nErrors) schedule(static)
+  for (h = 0; h < nHalf; h++)
+  {
+    const icfIndex i   = h / 3;
+    const int      j   = h % 3;
+    const icfIndex a   = idxTris[i][(j+1)%3];
+    const icfIndex b   = idxTris[i][(j+2)%3];
+
+    uint64_t lo, hi, slot;
+
+    icfPairTable_sort(a, b, &lo, &hi);
+    slot = icfPairTable_slot(&tbl, lo, hi);
+
+    while (TRUE)
+    {
+      uint64_t cur = __atomic_load_n(&tbl.lo[slot], 
+                                     __ATOMIC_ACQUIRE);
+
+      if ( cur == ICF_PAIR_EMPTY
+        && __atomic_compare_exchange_n(&tbl.lo[slot], &cur, lo,
+             FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) )
+      {
+        tbl.hi[slot] = hi;
+        __atomic_store_n(&tbl.vals[slot], (icfIndex)h, 
+                         __ATOMIC_RELEASE);
+        break;
+      }
+
+      if (cur == lo)
+      {
+        icfIndex h0;
+
+        /*-------------------------------------------------
+        | The published index makes the higher node index
+        | of the slot visible
+        -------------------------------------------------*/
+        do 
+        {
+          h0 = __atomic_load_n(&tbl.vals[slot], __ATOMIC_ACQUIRE);
+        } while (h0 == ICF_PAIR_PENDING);
+
+        if (tbl.hi[slot] != hi)
+        {
+          slot = (slot + 1) & tbl.mask;
+          continue;
+        }
+
+        /*-------------------------------------------------
+        | More than two triangles share this edge
+        -------------------------------------------------*/
+        if ( h0 == ICF_PAIR_DONE
+          || !__atomic_compare_exchange_n(&tbl.vals[slot], &h0, 
+                ICF_PAIR_DONE, FALSE, 
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) )
+        {
+          nErrors += 1;
+          break;
+        }
+
+        const icfIndex i0 = h0 / 3;
+        const int      j0 = h0 % 3;
+
+        /*-------------------------------------------------
+        | Neighbors must traverse the edge in opposite
+        | directions
+        -------------------------------------------------*/
+        if (idxTris[i0][(j0+1)%3] != b)
+          nErrors += 1;
+
+        idxTriNbrs[i][j]   = i0;
+        idxTriNbrs[i0][j0] = i;
+        break;
+      }
+
+      slot = (slot + 1) & tbl.mask;
+    }
+  }
+
+  icfPairTable_free(&tbl);
+
+  check(nErrors == 0, 
+      "Found %" ICF_PRIdx " non-manifold or misoriented triangle sides.", 
+      nErrors);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfMesh_pairTris() */
+
+/**********************************************************
+* Function: icfMesh_buildFromTris()
+*----------------------------------------------------------
+* Function to create the entities of an empty mesh from
+* arrays of node coordinates and triangle node indices.
+* Edges and triangle neighbors are computed with 
+* icfMesh_pairTris(). 
+* Boundary edges are assigned to the boundaries via 
+* an optional list of boundary edges (n0, n1, marker).
+* Boundary edges, that are not listed, are not assigned
+* to any boundary.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param nNodes, xyNodes: node coordinates
+* @param nTris, idxTris: triangle node indices
+* @param nBdryEdges, idxBdryEdges: boundary edges 
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMesh_buildFromTris(icfMesh   *mesh,
+                          icfIndex   nNodes,
+                          icfDouble (*xyNodes)[2],
+                          icfIndex   nTris,
+                          icfIndex  (*idxTris)[3],
+                          icfIndex   nBdryEdges,
+                          icfIndex  (*idxBdryEdges)[3])
+{
+  icfIndex i;
+  int      j;
+  icfIndex nFree = 0;
+  icfListNode *cur;
+
+  icfPairTable tbl = { NULL, NULL, NULL, 0 };
+
+  icfIndex (*idxTriNbrs)[3] = NULL;
+  icfNode **n = NULL;
+  icfTri  **t = NULL;
+
+  /*----------------------------------------------------------
+  | Compute triangle neighbors
+  ----------------------------------------------------------*/
+  idxTriNbrs = calloc(nTris, 3*sizeof(icfIndex));
+  check_mem(idxTriNbrs);
+
+  check(icfMesh_pairTris(nTris, idxTris, idxTriNbrs) == 0,
+      "Failed to compute triangle neighbors.");
+
+  /*----------------------------------------------------------
+  | Hash table for the boundary edge markers
+  ----------------------------------------------------------*/
+  check(icfPairTable_init(&tbl, nBdryEdges) == 0,
+      "Failed to allocate boundary edge hash table.");
+
+  for (i = 0; i < nBdryEdges; i++)
+    icfPairTable_insert(&tbl, idxBdryEdges[i][0], idxBdryEdges[i][1],
+                        idxBdryEdges[i][2]);
+
+  /*----------------------------------------------------------
+  | Create mesh nodes and triangles
+  ----------------------------------------------------------*/
+  n = calloc(nNodes, sizeof(icfNode*));
+  check_mem(n);
+
+  for (i = 0; i < nNodes; i++)
+    n[i] = icfNode_create(mesh, xyNodes[i]);
+
+  t = calloc(nTris, sizeof(icfTri*));
+  check_mem(t);
+
+  for (i = 0; i < nTris; i++)
+  {
+    t[i] = icfTri_create(mesh);
+    icfTri_setNodes(t[i], n[idxTris[i][0]], 
+                    n[idxTris[i][1]], n[idxTris[i][2]]);
+  }
+
+  /*----------------------------------------------------------
+  | Create mesh edges
+  ----------------------------------------------------------*/
+  for (i = 0; i < nTris; i++)
+  {
+    for (j = 0; j < 3; j++)
+    {
+      icfEdge *edge   = NULL;
+      icfIndex triNbr = idxTriNbrs[i][j];
+      icfIndex n0     = idxTris[i][(j+1)%3];
+      icfIndex n1     = idxTris[i][(j+2)%3];
+
+      /*------------------------------------------------------
+      | Create boundary edge
+      ------------------------------------------------------*/
+      if (triNbr < 0)
+      {
+        edge = icfEdge_create(mesh);
+        icfEdge_setNodes(edge, n[n0], n[n1]);
+        icfEdge_setTris(edge, t[i], NULL);
+
+        t[i]->t[j] = NULL;
+        t[i]->e[(j+1)%3] = edge;
+
+        icfBdry *bdry = NULL;
+        icfIndex marker = icfPairTable_get(&tbl, n0, n1);
+
+        for (cur = mesh->bdryStack->first;
+             cur != NULL && marker != ICF_PAIR_PENDING; 
+             cur = cur->next)
+        {
+          if (((icfBdry*)cur->value)->marker == marker)
+          {
+            bdry = (icfBdry*)cur->value;
+            break;
+          }
+        }
+
+        if (bdry == NULL)
+        {
+          nFree += 1;
+          continue;
+        }
+
+        icfBdry_addEdge(bdry, edge);
+        icfBdry_addNode(bdry, n[n0], 0);
+        icfBdry_addNode(bdry, n[n1], 1);
+      }
+      /*------------------------------------------------------
+      | Create interior edge (only once)
+      ------------------------------------------------------*/
+      else if (triNbr > i)
+      {
+        edge = icfEdge_create(mesh);
+
+        icfEdge_setNodes(edge, n[n0], n[n1]);
+        icfEdge_setTris(edge, t[i], t[triNbr]);
+
+        t[i]->e[(j+1)%3] = edge;
+
+        if (n[n0] == t[triNbr]->n[0])
+          t[triNbr]->e[2] = edge;
+        else if (n[n0] == t[triNbr]->n[1])
+          t[triNbr]->e[0] = edge;
+        else
+          t[triNbr]->e[1] = edge;
+
+        t[i]->t[j] = t[triNbr];
+      }
+      else
+      {
+        t[i]->t[j] = t[triNbr];
+      }
+    }
+  }
+
+  if (nFree > 0)
+    log_warn("%" ICF_PRIdx " boundary edges are not assigned to a "
+             "boundary.", nFree);
+
+  icfPairTable_free(&tbl);
+  free(idxTriNbrs);
+  free(n);
+  free(t);
+
+  return 0;
+error:
+  icfPairTable_free(&tbl);
+  free(idxTriNbrs);
+  free(n);
+  free(t);
+
+  return -1;
+
+} /* icfMesh_buildFromTris() */
+
 /**********************************************************
 * Function: icfMesh_refine()
 *----------------------------------------------------------
@@ -290,6 +979,8 @@ void icfMesh_refine(icfFlowData *flowData, icfMesh *mesh)
 {
   icfListNode *cur;
 
+  ICF_PROF_BEGIN(refine, "icfMesh_refine");
+
   icfRefineFun refineFun = flowData->refineFun;
   check(refineFun != NULL,
       "Refinement function has not been defined.");
@@ -302,7 +993,7 @@ void icfMesh_refine(icfFlowData *flowData, icfMesh *mesh)
   {
     icfTri *t = (icfTri*)cur->value;
 
-    if (refineFun(flowData, t) == TRUE && t->isSplit == FALSE)
+    if (refineFun(flowData, t) == TRUE && t->cold->isSplit == FALSE)
       icfTri_markToSplit(t);
 
   }
@@ -314,7 +1005,7 @@ void icfMesh_refine(icfFlowData *flowData, icfMesh *mesh)
   {
     icfEdge *e = (icfEdge*)cur->value;
 
-    if (e->split == TRUE && e->isSplit == FALSE)
+    if (e->cold->split == TRUE && e->cold->isSplit == FALSE)
       icfEdge_split(e);
   }
 
@@ -323,8 +1014,10 @@ void icfMesh_refine(icfFlowData *flowData, icfMesh *mesh)
   -------------------------------------------------------*/
   icfMesh_update(mesh);
 
+  ICF_PROF_END(refine);
   return;
 error:
+  ICF_PROF_END(refine);
   return;
 
 } /* isfMesh_refine() */
@@ -342,9 +1035,11 @@ void icfMesh_coarsen(icfFlowData *flowData, icfMesh *mesh)
   icfTri  **triLeafs  = mesh->triLeafs;
   icfEdge **edgeLeafs = mesh->edgeLeafs;
 
-  int i;
-  int nTris  = mesh->nTriLeafs;
-  int nEdges = mesh->nEdgeLeafs;
+  icfIndex i;
+  icfIndex nTris  = mesh->nTriLeafs;
+  icfIndex nEdges = mesh->nEdgeLeafs;
+
+  ICF_PROF_BEGIN(coarsen, "icfMesh_coarsen");
 
   icfRefineFun coarseFun = flowData->coarseFun;
   check(coarseFun != NULL,
@@ -357,7 +1052,7 @@ void icfMesh_coarsen(icfFlowData *flowData, icfMesh *mesh)
   {
     icfTri *t = triLeafs[i];
 
-    if (t->merge == FALSE && coarseFun(flowData, t) == TRUE)
+    if (t->cold->merge == FALSE && coarseFun(flowData, t) == TRUE)
       icfTri_markToMerge(t);
 
   }
@@ -370,7 +1065,7 @@ void icfMesh_coarsen(icfFlowData *flowData, icfMesh *mesh)
     icfEdge *e = edgeLeafs[i];
 
     if (e != NULL)
-      if (e->merge == TRUE)
+      if (e->cold->merge == TRUE)
         icfEdge_merge(e);
   }
 
@@ -379,8 +1074,10 @@ void icfMesh_coarsen(icfFlowData *flowData, icfMesh *mesh)
   -------------------------------------------------------*/
   icfMesh_update(mesh);
 
+  ICF_PROF_END(coarsen);
   return;
 error:
+  ICF_PROF_END(coarsen);
   return;
 
 } /* icfMesh_coarsen() */
@@ -402,6 +1099,10 @@ void icfMesh_update(icfMesh *mesh)
 {
   icfListNode *cur, *curBdry;
 
+  ICF_PROF_BEGIN(update, "icfMesh_update");
+
+  mesh->revision += 1;
+
   /*-------------------------------------------------------
   | Count leafs in both triangle- and edge-trees
   | This is the point, where triangles and edges
@@ -410,62 +1111,63 @@ void icfMesh_update(icfMesh *mesh)
   | 
   | Also: set default values for some attributes
   -------------------------------------------------------*/
-  int iTri = 0;
-  int iEdge = 0;
-  int nTriLeafs = 0;
-  int nEdgeLeafs = 0;
+  icfIndex iTri = 0;
+  icfIndex iEdge = 0;
+  icfIndex nTriLeafs = 0;
+  icfIndex nEdgeLeafs = 0;
 
   for (cur = mesh->triStack->first; 
        cur != NULL; cur = cur->next)
   {
     icfTri *t = (icfTri*)cur->value;
-    t->index  = iTri;
-    t->isLeaf = FALSE;
-    t->merge  = FALSE;
-    t->split  = FALSE;
+    t->cold->index  = iTri;
+    t->cold->isLeaf = FALSE;
+    t->cold->merge  = FALSE;
+    t->cold->split  = FALSE;
     iTri++;
 
-    if (t->isSplit == FALSE)
+    if (t->cold->isSplit == FALSE)
       nTriLeafs += 1;
   }
 
-#if (ICF_DEBUG > 2)
-  icfPrint("FOUND %d TRI LEAFS", nTriLeafs);
-#endif
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, "FOUND %" ICF_PRIdx " TRI LEAFS", 
+         nTriLeafs);
 
   for (cur = mesh->edgeStack->first; 
        cur != NULL; cur = cur->next)
   {
     icfEdge *e = (icfEdge*)cur->value;
-    e->index  = iEdge;
-    e->isLeaf = FALSE;
-    e->merge  = FALSE;
-    e->split  = FALSE;
+    e->cold->index  = iEdge;
+    e->cold->isLeaf = FALSE;
+    e->cold->merge  = FALSE;
+    e->cold->split  = FALSE;
     iEdge++;
 
-    if (e->isSplit == FALSE)
+    if (e->cold->isSplit == FALSE)
       nEdgeLeafs += 1;
   }
 
-#if (ICF_DEBUG > 2)
-  icfPrint("FOUND %d EDGE LEAFS", nEdgeLeafs);
-#endif
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, "FOUND %" ICF_PRIdx " EDGE LEAFS", 
+         nEdgeLeafs);
 
   /*-------------------------------------------------------
   | reallocate memory for leafs
   -------------------------------------------------------*/
   icfEdge **newEdgeLeafs;
-  mesh->nEdgeLeafs = nEdgeLeafs;
-  newEdgeLeafs = (icfEdge**) realloc(mesh->edgeLeafs, 
+  newEdgeLeafs = (icfEdge**) icfMem_realloc(ICF_MEM_LEAFS, 
+      mesh->edgeLeafs, mesh->nEdgeLeafs*sizeof(icfEdge*),
       nEdgeLeafs*sizeof(icfEdge*));
-  if (newEdgeLeafs != NULL)
-    mesh->edgeLeafs = newEdgeLeafs;
+  check_mem(newEdgeLeafs);
+  mesh->edgeLeafs  = newEdgeLeafs;
+  mesh->nEdgeLeafs = nEdgeLeafs;
 
   icfTri **newTriLeafs;
-  mesh->nTriLeafs = nTriLeafs;
-  newTriLeafs = (icfTri**) realloc(mesh->triLeafs, 
+  newTriLeafs = (icfTri**) icfMem_realloc(ICF_MEM_LEAFS, 
+      mesh->triLeafs, mesh->nTriLeafs*sizeof(icfTri*),
       nTriLeafs*sizeof(icfTri*));
-  mesh->triLeafs = newTriLeafs;
+  check_mem(newTriLeafs);
+  mesh->triLeafs  = newTriLeafs;
+  mesh->nTriLeafs = nTriLeafs;
 
   /*-------------------------------------------------------
   | Set pointer-array to triangles and mark leafs
@@ -477,11 +1179,11 @@ void icfMesh_update(icfMesh *mesh)
   {
     icfTri *t = (icfTri*)cur->value;
 
-    if (t->isSplit == FALSE)
+    if (t->cold->isSplit == FALSE)
     {
-      t->isLeaf            = TRUE;
+      t->cold->isLeaf      = TRUE;
       mesh->triLeafs[iTri] = t;
-      t->leafPos           = iTri;
+      t->cold->leafPos     = iTri;
       iTri++;
     }
   }
@@ -495,11 +1197,11 @@ void icfMesh_update(icfMesh *mesh)
   {
     icfEdge *e = (icfEdge*)cur->value;
 
-    if (e->isSplit == FALSE)
+    if (e->cold->isSplit == FALSE)
     {
-      e->isLeaf              = TRUE;
+      e->cold->isLeaf        = TRUE;
       mesh->edgeLeafs[iEdge] = e;
-      e->leafPos             = iEdge;
+      e->cold->leafPos       = iEdge;
       iEdge++;
     }
   }
@@ -510,12 +1212,14 @@ void icfMesh_update(icfMesh *mesh)
   | their global indices
   -------------------------------------------------------*/
   icfNode **newNodes;
-  newNodes = (icfNode**) realloc(mesh->nodes, 
+  newNodes = (icfNode**) icfMem_realloc(ICF_MEM_LEAFS, 
+      mesh->nodes, mesh->nNodesAlloc*sizeof(icfNode*),
       mesh->nNodes*sizeof(icfNode*));
-  if (newNodes != NULL)
-    mesh->nodes = newNodes;
+  check_mem(newNodes);
+  mesh->nodes       = newNodes;
+  mesh->nNodesAlloc = mesh->nNodes;
 
-  int iNode = 0;
+  icfIndex iNode = 0;
   for (cur = mesh->nodeStack->first; 
        cur != NULL; cur = cur->next)
   {
@@ -525,6 +1229,12 @@ void icfMesh_update(icfMesh *mesh)
     iNode++;
   }
 
+  /*-------------------------------------------------------
+  | Optional reordering of the nodes and edge leafs
+  -------------------------------------------------------*/
+  check(icfMeshOrder_apply(mesh) == 0, 
+      "Failed to reorder the mesh leafs.");
+
   /*-------------------------------------------------------
   | Update arrays for all boundary nodes and boundary 
   | edge leafs
@@ -538,10 +1248,12 @@ void icfMesh_update(icfMesh *mesh)
     | Boundary nodes
     -----------------------------------------------------*/
     icfNode **newBdryNodes;
-    newBdryNodes = (icfNode**) realloc(bdry->bdryNodes, 
+    newBdryNodes = (icfNode**) icfMem_realloc(ICF_MEM_BDRY, 
+        bdry->bdryNodes, bdry->nNodesAlloc*sizeof(icfNode*),
         bdry->nNodes*sizeof(icfNode*));
-    if (newBdryNodes != NULL)
-      bdry->bdryNodes = newBdryNodes;
+    check_mem(newBdryNodes);
+    bdry->bdryNodes   = newBdryNodes;
+    bdry->nNodesAlloc = bdry->nNodes;
 
     iNode = 0;
     for (cur = bdry->nodeStack->first; 
@@ -563,15 +1275,16 @@ void icfMesh_update(icfMesh *mesh)
       icfEdge *e = (icfEdge*)cur->value;
       iEdge++;
 
-      if (e->isSplit == FALSE)
+      if (e->cold->isSplit == FALSE)
         nEdgeLeafs += 1;
     }
 
-    bdry->nEdgeLeafs = nEdgeLeafs;
-    newEdgeLeafs = (icfEdge**) realloc(bdry->edgeLeafs, 
+    newEdgeLeafs = (icfEdge**) icfMem_realloc(ICF_MEM_BDRY, 
+        bdry->edgeLeafs, bdry->nEdgeLeafs*sizeof(icfEdge*),
         nEdgeLeafs*sizeof(icfEdge*));
-    if (newEdgeLeafs != NULL)
-      bdry->edgeLeafs = newEdgeLeafs;
+    check_mem(newEdgeLeafs);
+    bdry->edgeLeafs  = newEdgeLeafs;
+    bdry->nEdgeLeafs = nEdgeLeafs;
 
 
     iEdge = 0;
@@ -580,13 +1293,20 @@ void icfMesh_update(icfMesh *mesh)
     {
       icfEdge *e = (icfEdge*)cur->value;
 
-      if (e->isSplit == FALSE)
+      if (e->cold->isSplit == FALSE)
       {
         bdry->edgeLeafs[iEdge] = e;
         iEdge++;
       }
     }
 
+    /*-----------------------------------------------------
+    | Boundary face arrays
+    -----------------------------------------------------*/
+    check(icfBdry_updateFaces(bdry) == 0,
+        "Failed to update the faces of boundary %" ICF_PRIdx ".", 
+        bdry->marker);
+
   }
 
   /*-------------------------------------------------------
@@ -595,45 +1315,419 @@ void icfMesh_update(icfMesh *mesh)
   -------------------------------------------------------*/
   icfMesh_calcDualMetrics(mesh);
 
+  ICF_PROF_SET(ICF_PROF_TRI_LEAFS,  mesh->nTriLeafs);
+  ICF_PROF_SET(ICF_PROF_EDGE_LEAFS, mesh->nEdgeLeafs);
+  ICF_PROF_END(update);
   
   return;
 error:
+  ICF_PROF_END(update);
   return;
 
 } /* icfMesh_update() */
 
 /**********************************************************
-* Function: icfMesh_calcDualMetrics()
+* Forwarding of entity pointers in icfMesh_compact():
+* after its copy has been placed, the index of a 
+* relocated edge or triangle holds the position of the
+* copy in the new block. Nodes are placed at their index.
+**********************************************************/
+#define ICF_FWD_NODE(n) \
+  ( (n) != NULL ? &nodeSlab[(n)->index] : NULL )
+#define ICF_FWD_EDGE(e) \
+  ( (e) != NULL ? &edgeSlab[(e)->cold->index] : NULL )
+#define ICF_FWD_TRI(t) \
+  ( (t) != NULL ? &triSlab[(t)->cold->index] : NULL )
+#define ICF_FWD_SPLIT(s) \
+  ( (s) >= 0 ? splitMap[(s)] : -1 )
+
+/**********************************************************
+* Function: icfMesh_compact()
 *----------------------------------------------------------
-* Fuction to compute the median dual normals for the mesh
-* The dual normals are associated to the mesh edges.
-* Edge normals point from n[0] to n[1].
-*             /\
-*           /    \
-*         /   t0   \
-*       /  ___/o     \
-*     / __/    |       \
-*   /  /       |xc       \
-*  n0----------o--------->n1
-*   \  \__     |         /
-*     \   \__  |       /
-*       \     \o     /
-*         \   t1   /
-*           \    /
-*             \/
-*
+* Function to relocate all entities of an updated mesh 
+* into contiguous blocks
 *----------------------------------------------------------
 * @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
 **********************************************************/
-void icfMesh_calcDualMetrics(icfMesh *mesh) 
+int icfMesh_compact(icfMesh *mesh)
 {
-  int      nEdges = mesh->nEdgeLeafs;
-  icfEdge **edges = mesh->edgeLeafs;
+  icfListNode *curBdry;
+  icfIndex i, j, k;
 
-  icfIndex iEdge;
+  const icfIndex nNodes  = mesh->nNodes;
+  const icfIndex nEdges  = mesh->nEdges;
+  const icfIndex nTris   = mesh->nTris;
+  const icfIndex nSplits = mesh->nSplits;
 
-  icfNode *n0, *n1;
-  icfTri  *t0, *t1;
+  icfEdge     **edgeOrder    = NULL;
+  icfTri      **triOrder     = NULL;
+  icfIndex     *splitMap     = NULL;
+
+  icfNode      *nodeSlab     = NULL;
+  icfEdge      *edgeSlab     = NULL;
+  icfEdgeCold  *edgeColdSlab = NULL;
+  icfTri       *triSlab      = NULL;
+  icfTriCold   *triColdSlab  = NULL;
+  icfSplit     *splits       = NULL;
+
+  ICF_PROF_BEGIN(compact, "icfMesh_compact");
+
+  /*-------------------------------------------------------
+  | Every split holds one non-leaf edge and its non-leaf
+  | triangles, all other entities are leafs
+  -------------------------------------------------------*/
+  check(mesh->nNodesAlloc == nNodes
+     && mesh->nEdgeLeafs + nSplits == nEdges,
+      "Mesh must be updated before compaction.");
+
+  /*-------------------------------------------------------
+  | Allocate all blocks up front, such that the mesh is 
+  | left untouched if memory runs out
+  -------------------------------------------------------*/
+  edgeOrder = (icfEdge**) malloc((nEdges+1) * sizeof(icfEdge*));
+  triOrder  = (icfTri**)  malloc((nTris+1)  * sizeof(icfTri*));
+  splitMap  = (icfIndex*) malloc((mesh->nSplitsAlloc+1) 
+                                 * sizeof(icfIndex));
+  check_mem(edgeOrder && triOrder && splitMap);
+
+  if (nNodes > 0)
+  {
+    nodeSlab = (icfNode*) icfMem_malloc(ICF_MEM_NODES, 
+        nNodes * sizeof(icfNode));
+    check_mem(nodeSlab);
+  }
+
+  if (nEdges > 0)
+  {
+    edgeSlab = (icfEdge*) icfMem_malloc(ICF_MEM_EDGES, 
+        nEdges * sizeof(icfEdge));
+    check_mem(edgeSlab);
+    edgeColdSlab = (icfEdgeCold*) icfMem_malloc(ICF_MEM_EDGES, 
+        nEdges * sizeof(icfEdgeCold));
+    check_mem(edgeColdSlab);
+  }
+
+  if (nTris > 0)
+  {
+    triSlab = (icfTri*) icfMem_malloc(ICF_MEM_TRIS, 
+        nTris * sizeof(icfTri));
+    check_mem(triSlab);
+    triColdSlab = (icfTriCold*) icfMem_malloc(ICF_MEM_TRIS, 
+        nTris * sizeof(icfTriCold));
+    check_mem(triColdSlab);
+  }
+
+  if (nSplits > 0)
+  {
+    splits = (icfSplit*) icfMem_malloc(ICF_MEM_TREE, 
+        nSplits * sizeof(icfSplit));
+    check_mem(splits);
+  }
+
+  /*-------------------------------------------------------
+  | New entity order: edge and triangle leafs in leaf 
+  | order, followed by the non-leaf entities in the order
+  | of their splits. The splits are packed in the same 
+  | order.
+  -------------------------------------------------------*/
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+    edgeOrder[i] = mesh->edgeLeafs[i];
+  for (i = 0; i < mesh->nTriLeafs; i++)
+    triOrder[i] = mesh->triLeafs[i];
+
+  j = mesh->nEdgeLeafs;
+  k = mesh->nTriLeafs;
+
+  for (i = 0; i < mesh->nSplitsAlloc; i++)
+  {
+    const icfSplit *split = ICF_SPLIT(mesh, i);
+
+    if (split->e == NULL || j >= nEdges)
+    {
+      splitMap[i] = -1;
+      continue;
+    }
+
+    splitMap[i]    = j - mesh->nEdgeLeafs;
+    edgeOrder[j++] = split->e;
+
+    if (split->t_p[0] != NULL && k < nTris)
+      triOrder[k++] = split->t_p[0];
+    if (split->t_p[1] != NULL && k < nTris)
+      triOrder[k++] = split->t_p[1];
+  }
+
+  check(j == nEdges && k == nTris,
+      "Found %" ICF_PRIdx " edges and %" ICF_PRIdx " triangles "
+      "in a mesh of %" ICF_PRIdx " edges and %" ICF_PRIdx 
+      " triangles.", j, k, nEdges, nTris);
+
+  /*-------------------------------------------------------
+  | Copy the entities and leave their new positions 
+  | in the old entities. Nodes keep their position.
+  -------------------------------------------------------*/
+#pragma omp parallel for schedule(static)
+  for (i = 0; i < nNodes; i++)
+    nodeSlab[i] = *mesh->nodes[i];
+
+#pragma omp parallel for schedule(static)
+  for (i = 0; i < nEdges; i++)
+  {
+    edgeSlab[i]      = *edgeOrder[i];
+    edgeColdSlab[i]  = *edgeOrder[i]->cold;
+    edgeSlab[i].cold = &edgeColdSlab[i];
+    edgeOrder[i]->cold->index = i;
+  }
+
+#pragma omp parallel for schedule(static)
+  for (i = 0; i < nTris; i++)
+  {
+    triSlab[i]      = *triOrder[i];
+    triColdSlab[i]  = *triOrder[i]->cold;
+    triSlab[i].cold = &triColdSlab[i];
+    triOrder[i]->cold->index = i;
+  }
+
+  /*-------------------------------------------------------
+  | Redirect all pointers between the entities and the 
+  | stack positions of the entities
+  -------------------------------------------------------*/
+#pragma omp parallel for private(k) schedule(static)
+  for (i = 0; i < nNodes; i++)
+  {
+    icfNode *n = &nodeSlab[i];
+
+    n->stackPos->value = n;
+
+    for (k = 0; k < 2; k++)
+      if (n->bdryStackPos[k] != NULL)
+        n->bdryStackPos[k]->value = n;
+  }
+
+#pragma omp parallel for schedule(static)
+  for (i = 0; i < nEdges; i++)
+  {
+    icfEdge *e = &edgeSlab[i];
+
+    e->n[0] = ICF_FWD_NODE(e->n[0]);
+    e->n[1] = ICF_FWD_NODE(e->n[1]);
+    e->t[0] = ICF_FWD_TRI(e->t[0]);
+    e->t[1] = ICF_FWD_TRI(e->t[1]);
+
+    e->cold->treeParent = ICF_FWD_SPLIT(e->cold->treeParent);
+    e->cold->treeSplit  = ICF_FWD_SPLIT(e->cold->treeSplit);
+
+    e->cold->stackPos->value = e;
+    if (e->cold->bdryStackPos != NULL)
+      e->cold->bdryStackPos->value = e;
+  }
+
+#pragma omp parallel for private(j) schedule(static)
+  for (i = 0; i < nTris; i++)
+  {
+    icfTri *t = &triSlab[i];
+
+    /*-----------------------------------------------------
+    | Neighbors of split triangles are not maintained and
+    | are restored when their children are merged; the 
+    | marked split edge is only valid during refinement
+    -----------------------------------------------------*/
+    for (j = 0; j < 3; j++)
+    {
+      t->n[j] = ICF_FWD_NODE(t->n[j]);
+      t->e[j] = ICF_FWD_EDGE(t->e[j]);
+      t->t[j] = (t->cold->isSplit == FALSE) 
+              ? ICF_FWD_TRI(t->t[j]) : NULL;
+    }
+
+    t->cold->e_split    = NULL;
+    t->cold->treeParent = ICF_FWD_SPLIT(t->cold->treeParent);
+    t->cold->treeSplit  = ICF_FWD_SPLIT(t->cold->treeSplit);
+
+    t->cold->stackPos->value = t;
+  }
+
+#pragma omp parallel for private(k) schedule(static)
+  for (i = 0; i < mesh->nSplitsAlloc; i++)
+  {
+    if (splitMap[i] < 0)
+      continue;
+
+    const icfSplit *old   = ICF_SPLIT(mesh, i);
+    icfSplit       *split = &splits[splitMap[i]];
+
+    split->e = ICF_FWD_EDGE(old->e);
+    split->n = ICF_FWD_NODE(old->n);
+
+    for (k = 0; k < 4; k++)
+    {
+      split->e_c[k] = ICF_FWD_EDGE(old->e_c[k]);
+      split->t_c[k] = ICF_FWD_TRI(old->t_c[k]);
+    }
+
+    split->t_p[0]   = ICF_FWD_TRI(old->t_p[0]);
+    split->t_p[1]   = ICF_FWD_TRI(old->t_p[1]);
+    split->nextFree = -1;
+  }
+
+  /*-------------------------------------------------------
+  | Redirect the boundary arrays
+  -------------------------------------------------------*/
+  for (curBdry = mesh->bdryStack->first; 
+       curBdry != NULL; curBdry = curBdry->next)
+  {
+    icfBdry *bdry = (icfBdry*)curBdry->value;
+
+    for (i = 0; i < bdry->nNodesAlloc; i++)
+      bdry->bdryNodes[i] = ICF_FWD_NODE(bdry->bdryNodes[i]);
+    for (i = 0; i < bdry->nEdgeLeafs; i++)
+      bdry->edgeLeafs[i] = ICF_FWD_EDGE(bdry->edgeLeafs[i]);
+  }
+
+  /*-------------------------------------------------------
+  | Release the old entities: individually allocated 
+  | ones one by one, the previous blocks at once
+  -------------------------------------------------------*/
+  for (i = 0; i < nNodes; i++)
+  {
+    icfNode *n = mesh->nodes[i];
+
+    if (!ICF_MESH_INSLAB(n, mesh->nodeSlab, mesh->nNodeSlab))
+      icfMem_free(ICF_MEM_NODES, n, sizeof(icfNode));
+
+    mesh->nodes[i] = &nodeSlab[i];
+  }
+
+  for (i = 0; i < nEdges; i++)
+  {
+    icfEdge *e = edgeOrder[i];
+
+    if (!ICF_MESH_INSLAB(e, mesh->edgeSlab, mesh->nEdgeSlab))
+      icfMem_free(ICF_MEM_EDGES, e, ICF_EDGE_BLOCKSIZE);
+  }
+
+  for (i = 0; i < nTris; i++)
+  {
+    icfTri *t = triOrder[i];
+
+    if (!ICF_MESH_INSLAB(t, mesh->triSlab, mesh->nTriSlab))
+      icfMem_free(ICF_MEM_TRIS, t, ICF_TRI_BLOCKSIZE);
+  }
+
+  icfMesh_freeSlabs(mesh);
+  icfMem_free(ICF_MEM_TREE, mesh->splits, 
+              mesh->nSplitsAlloc*sizeof(icfSplit));
+
+  /*-------------------------------------------------------
+  | Install the new blocks; the leafs are located at the
+  | beginning of the blocks
+  -------------------------------------------------------*/
+  mesh->nNodeSlab    = nNodes;
+  mesh->nodeSlab     = nodeSlab;
+  mesh->nEdgeSlab    = nEdges;
+  mesh->edgeSlab     = edgeSlab;
+  mesh->edgeColdSlab = edgeColdSlab;
+  mesh->nTriSlab     = nTris;
+  mesh->triSlab      = triSlab;
+  mesh->triColdSlab  = triColdSlab;
+
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+    mesh->edgeLeafs[i] = &edgeSlab[i];
+  for (i = 0; i < mesh->nTriLeafs; i++)
+    mesh->triLeafs[i] = &triSlab[i];
+
+  mesh->splits       = splits;
+  mesh->nSplitsAlloc = nSplits;
+  mesh->splitFree    = -1;
+
+  /*-------------------------------------------------------
+  | The edge index is hashed by node addresses
+  -------------------------------------------------------*/
+  icfEdgeIndex_rebuild(mesh);
+
+  mesh->revision += 1;
+
+  free(edgeOrder);
+  free(triOrder);
+  free(splitMap);
+
+  /*-------------------------------------------------------
+  | Hand free heap pages back to the operating system
+  -------------------------------------------------------*/
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG, 
+      "COMPACTED %" ICF_PRIdx " NODES, %" ICF_PRIdx " EDGES, "
+      "%" ICF_PRIdx " TRIS, %" ICF_PRIdx " SPLITS", 
+      nNodes, nEdges, nTris, nSplits);
+
+  ICF_PROF_END(compact);
+  return 0;
+
+error:
+  icfMem_free(ICF_MEM_NODES, nodeSlab, nNodes*sizeof(icfNode));
+  icfMem_free(ICF_MEM_EDGES, edgeSlab, nEdges*sizeof(icfEdge));
+  icfMem_free(ICF_MEM_EDGES, edgeColdSlab, nEdges*sizeof(icfEdgeCold));
+  icfMem_free(ICF_MEM_TRIS, triSlab, nTris*sizeof(icfTri));
+  icfMem_free(ICF_MEM_TRIS, triColdSlab, nTris*sizeof(icfTriCold));
+  icfMem_free(ICF_MEM_TREE, splits, nSplits*sizeof(icfSplit));
+  free(edgeOrder);
+  free(triOrder);
+  free(splitMap);
+  ICF_PROF_END(compact);
+  return -1;
+
+} /* icfMesh_compact() */
+
+#undef ICF_FWD_NODE
+#undef ICF_FWD_EDGE
+#undef ICF_FWD_TRI
+#undef ICF_FWD_SPLIT
+
+
+/**********************************************************
+* Function: icfMesh_calcDualMetrics()
+*----------------------------------------------------------
+* Fuction to compute the median dual normals for the mesh
+* The dual normals are associated to the mesh edges.
+* Edge normals point from n[0] to n[1].
+*             /\
+*           /    \
+*         /   t0   \
+*       /  ___/o     \
+*     / __/    |       \
+*   /  /       |xc       \
+*  n0----------o--------->n1
+*   \  \__     |         /
+*     \   \__  |       /
+*       \     \o     /
+*         \   t1   /
+*           \    /
+*             \/
+*
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+void icfMesh_calcDualMetrics(icfMesh *mesh) 
+{
+  icfIndex  nEdges = mesh->nEdgeLeafs;
+  icfEdge **edges  = mesh->edgeLeafs;
+
+  icfIndex iEdge, iNode;
+
+  icfNode *n0, *n1;
+  icfTri  *t0, *t1;
+
+  ICF_PROF_BEGIN(dualMetrics, "icfMesh_calcDualMetrics");
+
+  /*-------------------------------------------------------
+  | Reset median-dual element areas
+  -------------------------------------------------------*/
+  for (iNode = 0; iNode < mesh->nNodes; iNode++)
+    mesh->nodes[iNode]->vol = 0.0;
 
   /*-------------------------------------------------------
   | Compute interior face normals and associated 
@@ -686,8 +1780,8 @@ void icfMesh_calcDualMetrics(icfMesh *mesh)
     const icfDouble nx =  dy0 + dy1;
     const icfDouble ny = -dx0 - dx1;
 
-    edge->intrNorm[0] += nx;
-    edge->intrNorm[1] += ny;
+    edge->intrNorm[0] = nx;
+    edge->intrNorm[1] = ny;
   }
 
   /*-------------------------------------------------------
@@ -701,6 +1795,8 @@ void icfMesh_calcDualMetrics(icfMesh *mesh)
   |          |       |     |        |
   |          V       V     V        V
   | 
+  | The normals are stored in the face arrays of the 
+  | boundaries, which are sized by icfMesh_update()
   -------------------------------------------------------*/
   icfListNode *curBdry;
 
@@ -709,13 +1805,17 @@ void icfMesh_calcDualMetrics(icfMesh *mesh)
   {
     icfBdry *bdry = (icfBdry*)curBdry->value;
 
+    if (bdry->nFaces != bdry->nEdgeLeafs)
+    {
+      log_warn("Faces of boundary %" ICF_PRIdx " are not updated.", 
+               bdry->marker);
+      continue;
+    }
+
     for (iEdge = 0; iEdge < bdry->nEdgeLeafs; iEdge++)
     {
       icfEdge *e = bdry->edgeLeafs[iEdge];
 
-      if (e->bdryNorm == NULL)
-        e->bdryNorm = calloc(2, 2*sizeof(icfDouble));
-
       icfNode *n0 = e->n[0];
       icfNode *n1 = e->n[1];
 
@@ -733,18 +1833,497 @@ void icfMesh_calcDualMetrics(icfMesh *mesh)
       const icfDouble n1x =   y1 - yc;
       const icfDouble n1y = -(x1 - xc);
 
-      e->bdryNorm[0][0] = n0x;
-      e->bdryNorm[0][1] = n0y;
+      bdry->faceLen[iEdge]        = e->len;
+
+      bdry->faceNorm[0][0][iEdge] = n0x;
+      bdry->faceNorm[0][1][iEdge] = n0y;
 
-      e->bdryNorm[1][0] = n1x;
-      e->bdryNorm[1][1] = n1y;
+      bdry->faceNorm[1][0][iEdge] = n1x;
+      bdry->faceNorm[1][1][iEdge] = n1y;
 
     }
   }
 
+  ICF_PROF_END(dualMetrics);
+
 } /* icfMesh_calcDualMetrics() */
 
 
+/**********************************************************
+* Function: icfMesh_memoryStats()
+*----------------------------------------------------------
+* Function to compute the memory held by a mesh, 
+* including non-leaf tree entities, list nodes, leaf 
+* arrays, boundary arrays, boundary normals and the 
+* edge index.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param stats: structure to write the statistics to
+**********************************************************/
+void icfMesh_memoryStats(icfMesh *mesh, icfMeshMemStats *stats)
+{
+  icfListNode *cur, *curBdry;
+  int i, level;
+
+  memset(stats, 0, sizeof(icfMeshMemStats));
+
+  /*-------------------------------------------------------
+  | Mesh structure, its stacks and leaf arrays
+  -------------------------------------------------------*/
+  stats->bytes[ICF_MEM_MESH]  += sizeof(icfMesh);
+  stats->bytes[ICF_MEM_LISTS] += 4 * sizeof(icfList);
+  stats->bytes[ICF_MEM_LEAFS] += 
+      mesh->nNodesAlloc * sizeof(icfNode*)
+    + mesh->nEdgeLeafs  * sizeof(icfEdge*)
+    + mesh->nTriLeafs   * sizeof(icfTri*);
+  stats->bytes[ICF_MEM_TREE]  += mesh->nSplitsAlloc * sizeof(icfSplit);
+
+  if (mesh->edgeIndex != NULL)
+    stats->bytes[ICF_MEM_EDGEINDEX] += sizeof(icfEdgeIndex)
+      + mesh->edgeIndex->nSlots * sizeof(icfEdge*);
+
+  stats->nListNodes += mesh->nodeStack->count 
+                     + mesh->edgeStack->count
+                     + mesh->triStack->count
+                     + mesh->bdryStack->count;
+
+  /*-------------------------------------------------------
+  | Contiguous entity blocks
+  -------------------------------------------------------*/
+  stats->bytes[ICF_MEM_NODES] += mesh->nNodeSlab * sizeof(icfNode);
+  stats->bytes[ICF_MEM_EDGES] += mesh->nEdgeSlab 
+    * (sizeof(icfEdge) + sizeof(icfEdgeCold));
+  stats->bytes[ICF_MEM_TRIS]  += mesh->nTriSlab 
+    * (sizeof(icfTri) + sizeof(icfTriCold));
+
+  /*-------------------------------------------------------
+  | Nodes
+  -------------------------------------------------------*/
+  stats->nNodes = mesh->nodeStack->count;
+
+  for (cur = mesh->nodeStack->first; cur != NULL; cur = cur->next)
+    if (!ICF_MESH_INSLAB(cur->value, mesh->nodeSlab, mesh->nNodeSlab))
+      stats->bytes[ICF_MEM_NODES] += sizeof(icfNode);
+
+  /*-------------------------------------------------------
+  | Edges of all tree levels
+  -------------------------------------------------------*/
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *e = (icfEdge*)cur->value;
+
+    level = (e->cold->treeLevel < ICF_MESH_MAXLEVELS) 
+          ? e->cold->treeLevel : ICF_MESH_MAXLEVELS-1;
+    stats->nEdges[level] += 1;
+    if (level >= stats->nLevels)
+      stats->nLevels = level+1;
+
+    if (e->cold->isSplit == FALSE)
+      stats->nEdgeLeafs[level] += 1;
+
+    if (!ICF_MESH_INSLAB(e, mesh->edgeSlab, mesh->nEdgeSlab))
+      stats->bytes[ICF_MEM_EDGES] += ICF_EDGE_BLOCKSIZE;
+  }
+
+  /*-------------------------------------------------------
+  | Triangles of all tree levels
+  -------------------------------------------------------*/
+  for (cur = mesh->triStack->first; cur != NULL; cur = cur->next)
+  {
+    icfTri *t = (icfTri*)cur->value;
+
+    level = (t->cold->treeLevel < ICF_MESH_MAXLEVELS) 
+          ? t->cold->treeLevel : ICF_MESH_MAXLEVELS-1;
+    stats->nTris[level] += 1;
+    if (level >= stats->nLevels)
+      stats->nLevels = level+1;
+
+    if (t->cold->isSplit == FALSE)
+      stats->nTriLeafs[level] += 1;
+
+    if (!ICF_MESH_INSLAB(t, mesh->triSlab, mesh->nTriSlab))
+      stats->bytes[ICF_MEM_TRIS] += ICF_TRI_BLOCKSIZE;
+  }
+
+  /*-------------------------------------------------------
+  | Boundaries, their stacks and arrays
+  -------------------------------------------------------*/
+  for (curBdry = mesh->bdryStack->first; 
+       curBdry != NULL; curBdry = curBdry->next)
+  {
+    icfBdry *bdry = (icfBdry*)curBdry->value;
+
+    stats->bytes[ICF_MEM_MESH]  += sizeof(icfBdry);
+    if (bdry->name != NULL)
+      stats->bytes[ICF_MEM_MESH] += strlen(bdry->name) + 1;
+
+    stats->bytes[ICF_MEM_LISTS] += 2 * sizeof(icfList);
+    stats->bytes[ICF_MEM_BDRY]  += 
+        bdry->nNodesAlloc * sizeof(icfNode*)
+      + bdry->nEdgeLeafs  * sizeof(icfEdge*);
+    stats->bytes[ICF_MEM_BDRYFACES] += ICF_BDRY_FACEBYTES(bdry->nFaces);
+
+    stats->nListNodes += bdry->nodeStack->count 
+                       + bdry->edgeStack->count;
+  }
+
+  stats->bytes[ICF_MEM_LISTS] += stats->nListNodes * sizeof(icfListNode);
+
+  for (i = 0; i < ICF_MEM_NCATEGORIES; i++)
+    stats->totalBytes += stats->bytes[i];
+
+  stats->allocatedBytes = icfMem_allocated();
+  stats->peakBytes      = icfMem_peak();
+
+} /* icfMesh_memoryStats() */
+
+/**********************************************************
+* Relative tolerance of the dual volume sum, which is 
+* accumulated in the storage precision
+**********************************************************/
+#if ICF_REAL_BITS == 32
+#define ICF_MESH_VOLTOL 1.0e-4
+#else
+#define ICF_MESH_VOLTOL 1.0e-10
+#endif
+
+/**********************************************************
+* Validation errors: counted in the reduction variable 
+* nErrors, the first ICF_MESH_MAXREPORTS are logged to
+* the mesh module
+**********************************************************/
+#define ICF_VALIDATE(cond, M, ...)                                 \
+  if (!(cond))                                                     \
+  {                                                                \
+    nErrors += 1;                                                  \
+    if (__atomic_fetch_add(&nReported, 1, __ATOMIC_RELAXED)        \
+          < ICF_MESH_MAXREPORTS)                                   \
+      icfLog(ICF_LOG_MESH, ICF_LOG_ERROR,                          \
+             "INVALID MESH: " M, ##__VA_ARGS__);                   \
+  }
+
+/**********************************************************
+* Function: icfMesh_validate()
+*----------------------------------------------------------
+* Function to check the consistency of an updated mesh
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: number of inconsistencies, 0 for a valid mesh
+**********************************************************/
+int icfMesh_validate(icfMesh *mesh)
+{
+  icfIndex i, j;
+  int      nErrors    = 0;
+  int      nReported  = 0;
+  icfIndex nSingle    = 0;
+  icfIndex nBdryLeafs = 0;
+
+  icfDouble triArea = 0.0;
+  icfDouble dualVol = 0.0;
+
+  int     *nIn  = NULL;
+  int     *nOut = NULL;
+
+  const icfIndex nTris  = mesh->nTriLeafs;
+  const icfIndex nEdges = mesh->nEdgeLeafs;
+  const icfIndex nNodes = mesh->nNodes;
+
+  ICF_PROF_BEGIN(validate, "icfMesh_validate");
+
+  ICF_VALIDATE(mesh->nNodesAlloc == mesh->nNodes,
+      "%" ICF_PRIdx " nodes, but %" ICF_PRIdx " indexed nodes - mesh is not updated.",
+      mesh->nNodes, mesh->nNodesAlloc);
+
+  if (nErrors > 0)
+    goto error;
+
+  /*-------------------------------------------------------
+  | Triangle leafs: 
+  | e[j] connects n[j] and n[j+1] and t[j+2] is the 
+  | neighbor across e[j]
+  -------------------------------------------------------*/
+#pragma omp parallel for private(j) reduction(+:nErrors,triArea) \
+                         schedule(static)
+  for (i = 0; i < nTris; i++)
+  {
+    icfTri *t = mesh->triLeafs[i];
+
+    ICF_VALIDATE( t->cold->isLeaf == TRUE 
+               && t->cold->isSplit == FALSE 
+               && t->cold->leafPos == i && t->cold->mesh == mesh,
+        "Triangle leaf %" ICF_PRIdx " has wrong leaf flags.", i);
+
+    if ( t->n[0] == NULL || t->n[1] == NULL || t->n[2] == NULL
+      || t->e[0] == NULL || t->e[1] == NULL || t->e[2] == NULL )
+    {
+      ICF_VALIDATE(FALSE, "Triangle leaf %" ICF_PRIdx " has no nodes or edges.", i);
+      continue;
+    }
+
+    const icfReal *xy0 = t->n[0]->xy;
+    const icfReal *xy1 = t->n[1]->xy;
+    const icfReal *xy2 = t->n[2]->xy;
+
+    const icfDouble area = 0.5 * ( (xy1[0]-xy0[0])*(xy2[1]-xy0[1]) 
+                                 - (xy1[1]-xy0[1])*(xy2[0]-xy0[0]) );
+
+    ICF_VALIDATE(area > 0.0, 
+        "Triangle leaf %" ICF_PRIdx " (%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ") "
+        "is not counter-clockwise.",
+        i, t->n[0]->index, t->n[1]->index, t->n[2]->index);
+
+    triArea += area;
+
+    for (j = 0; j < 3; j++)
+    {
+      icfEdge *e  = t->e[j];
+      icfNode *n0 = t->n[j];
+      icfNode *n1 = t->n[(j+1)%3];
+
+      const icfBool fwd = (e->n[0] == n0 && e->n[1] == n1);
+      const icfBool bwd = (e->n[0] == n1 && e->n[1] == n0);
+
+      ICF_VALIDATE(fwd || bwd,
+          "Edge %" ICF_PRIdx " of triangle leaf %" ICF_PRIdx " does not connect "
+          "its nodes.",
+          j, i);
+      ICF_VALIDATE(e->cold->isSplit == FALSE,
+          "Edge %" ICF_PRIdx " of triangle leaf %" ICF_PRIdx " is split.", j, i);
+
+      if (!fwd && !bwd)
+        continue;
+
+      /*---------------------------------------------------
+      | The triangle is left of the edge, if both traverse
+      | the nodes in the same direction
+      ---------------------------------------------------*/
+      const int side = fwd ? 0 : 1;
+      icfTri   *nbr  = e->t[1-side];
+
+      ICF_VALIDATE(e->t[side] == t,
+          "Triangle leaf %" ICF_PRIdx " is on the wrong side of its "
+          "edge %" ICF_PRIdx ".",
+          i, j);
+      ICF_VALIDATE(t->t[(j+2)%3] == nbr,
+          "Triangle leaf %" ICF_PRIdx " has a wrong neighbor across "
+          "edge %" ICF_PRIdx ".",
+          i, j);
+      ICF_VALIDATE( nbr == NULL 
+                 || nbr->t[0] == t || nbr->t[1] == t || nbr->t[2] == t,
+          "Neighbors of triangle leaf %" ICF_PRIdx " are not symmetric.", i);
+    }
+
+    /*-----------------------------------------------------
+    | Refinement tree
+    -----------------------------------------------------*/
+    const icfIndex iSplit = t->cold->treeParent;
+
+    if (iSplit < 0)
+    {
+      ICF_VALIDATE(t->cold->treeLevel == 0,
+          "Triangle leaf %" ICF_PRIdx " of level %" ICF_PRIdx
+          " has no parent.",
+          i, t->cold->treeLevel);
+    }
+    else if ( iSplit >= mesh->nSplitsAlloc 
+           || ICF_SPLIT(mesh, iSplit)->e == NULL )
+    {
+      ICF_VALIDATE(FALSE, 
+          "Triangle leaf %" ICF_PRIdx " refers to the unused "
+          "split %" ICF_PRIdx ".", i, iSplit);
+    }
+    else
+    {
+      icfTri *p = icfTri_getParent(t);
+
+      ICF_VALIDATE( p != NULL 
+                 && p->cold->isSplit == TRUE 
+                 && p->cold->treeSplit == iSplit
+                 && ( icfTri_getChild(p, 0) == t 
+                   || icfTri_getChild(p, 1) == t )
+                 && t->cold->treeLevel == p->cold->treeLevel + 1,
+          "Triangle leaf %" ICF_PRIdx " is not a child of its parent.", i);
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Edge leafs:
+  | Edges with a single triangle have it on the left and 
+  | belong to a boundary
+  -------------------------------------------------------*/
+#pragma omp parallel for private(j) reduction(+:nErrors,nSingle) \
+                         schedule(static)
+  for (i = 0; i < nEdges; i++)
+  {
+    icfEdge *e = mesh->edgeLeafs[i];
+
+    ICF_VALIDATE( e->cold->isLeaf == TRUE 
+               && e->cold->isSplit == FALSE 
+               && e->cold->leafPos == i && e->cold->mesh == mesh,
+        "Edge leaf %" ICF_PRIdx " has wrong leaf flags.", i);
+
+    if (e->n[0] == NULL || e->n[1] == NULL || e->n[0] == e->n[1])
+    {
+      ICF_VALIDATE(FALSE, "Edge leaf %" ICF_PRIdx " has invalid nodes.", i);
+      continue;
+    }
+
+    ICF_VALIDATE(e->t[0] != NULL,
+        "Edge leaf %" ICF_PRIdx " (%" ICF_PRIdx ",%" ICF_PRIdx ") has no left triangle.", 
+        i, e->n[0]->index, e->n[1]->index);
+
+    for (j = 0; j < 2; j++)
+    {
+      icfTri *t = e->t[j];
+
+      ICF_VALIDATE( t == NULL 
+                 || (t->cold->isLeaf == TRUE 
+                  && (t->e[0] == e || t->e[1] == e || t->e[2] == e)),
+          "Edge leaf %" ICF_PRIdx " is not an edge of its triangle %" ICF_PRIdx ".", i, j);
+    }
+
+    if (e->t[1] == NULL)
+      nSingle += 1;
+
+    ICF_VALIDATE((e->t[1] == NULL) == (e->cold->bdry != NULL),
+        "Edge leaf %" ICF_PRIdx " (%" ICF_PRIdx ",%" ICF_PRIdx ") has %d triangles, "
+        "but %s boundary.", 
+        i, e->n[0]->index, e->n[1]->index, 
+        (e->t[1] == NULL) ? 1 : 2, 
+        (e->cold->bdry == NULL) ? "no" : "a");
+
+    ICF_VALIDATE( e->cold->bdry == NULL
+               || (e->cold->bdryStackPos != NULL 
+                && e->cold->bdryStackPos->value == e),
+        "Edge leaf %" ICF_PRIdx " is not on the stack of its boundary.", i);
+
+    /*-----------------------------------------------------
+    | Refinement tree
+    -----------------------------------------------------*/
+    const icfIndex iSplit = e->cold->treeParent;
+
+    if (iSplit < 0)
+    {
+      ICF_VALIDATE(e->cold->treeLevel == 0,
+          "Edge leaf %" ICF_PRIdx " of level %" ICF_PRIdx 
+          " has no parent.",
+          i, e->cold->treeLevel);
+    }
+    else if ( iSplit >= mesh->nSplitsAlloc 
+           || ICF_SPLIT(mesh, iSplit)->e == NULL )
+    {
+      ICF_VALIDATE(FALSE, 
+          "Edge leaf %" ICF_PRIdx " refers to the unused "
+          "split %" ICF_PRIdx ".", i, iSplit);
+    }
+    else
+    {
+      icfEdge *p = icfEdge_getParent(e);
+
+      ICF_VALIDATE( p->cold->isSplit == TRUE 
+                 && p->cold->treeSplit == iSplit
+                 && ( icfEdge_getChild(p, 0) == e 
+                   || icfEdge_getChild(p, 1) == e 
+                   || icfEdge_getChild(p, 2) == e 
+                   || icfEdge_getChild(p, 3) == e )
+                 && e->cold->treeLevel == p->cold->treeLevel + 1,
+          "Edge leaf %" ICF_PRIdx " is not a child of its parent.", i);
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Nodes and median-dual volumes
+  -------------------------------------------------------*/
+#pragma omp parallel for reduction(+:nErrors,dualVol) schedule(static)
+  for (i = 0; i < nNodes; i++)
+  {
+    icfNode *n = mesh->nodes[i];
+
+    ICF_VALIDATE(n->index == i && n->mesh == mesh,
+        "Node %" ICF_PRIdx " has a wrong index.", i);
+    ICF_VALIDATE(n->vol > 0.0,
+        "Node %" ICF_PRIdx " (%g,%g) has the dual volume %g.", 
+        i, n->xy[0], n->xy[1], n->vol);
+
+    dualVol += n->vol;
+  }
+
+  ICF_VALIDATE(fabs(dualVol - triArea) <= ICF_MESH_VOLTOL*fabs(triArea),
+      "Dual volumes sum up to %.12g instead of %.12g.", 
+      dualVol, triArea);
+
+  /*-------------------------------------------------------
+  | Boundaries: every boundary node has as many incoming
+  | as outgoing boundary edges
+  -------------------------------------------------------*/
+  icfListNode *curBdry;
+
+  nIn  = calloc(nNodes, sizeof(int));
+  nOut = calloc(nNodes, sizeof(int));
+  check_mem(nIn);
+  check_mem(nOut);
+
+  for (curBdry = mesh->bdryStack->first; 
+       curBdry != NULL; curBdry = curBdry->next)
+  {
+    icfBdry *bdry = (icfBdry*)curBdry->value;
+
+    for (j = 0; j < bdry->nEdgeLeafs; j++)
+    {
+      icfEdge *e = bdry->edgeLeafs[j];
+
+      ICF_VALIDATE(e->cold->bdry == bdry && e->cold->isLeaf == TRUE,
+          "Edge leaf %" ICF_PRIdx " of boundary %" ICF_PRIdx
+          " is not on this boundary.",
+          j, bdry->marker);
+
+      ICF_VALIDATE( j < bdry->nFaces
+                 && bdry->faceNodes[0][j] == e->n[0]->index
+                 && bdry->faceNodes[1][j] == e->n[1]->index
+                 && e->t[0] != NULL
+                 && bdry->faceTri[j] == e->t[0]->cold->leafPos,
+          "Face %" ICF_PRIdx " of boundary %" ICF_PRIdx
+          " does not match its edge.",
+          j, bdry->marker);
+
+      nOut[e->n[0]->index] += 1;
+      nIn[e->n[1]->index]  += 1;
+    }
+
+    nBdryLeafs += bdry->nEdgeLeafs;
+  }
+
+  ICF_VALIDATE(nBdryLeafs == nSingle,
+      "%" ICF_PRIdx " edges with a single triangle, but %" ICF_PRIdx ""
+      " boundary edges.",
+      nSingle, nBdryLeafs);
+
+  for (i = 0; i < nNodes; i++)
+    ICF_VALIDATE(nIn[i] == nOut[i],
+        "Boundary is not closed at node %" ICF_PRIdx " (%g,%g).", 
+        i, mesh->nodes[i]->xy[0], mesh->nodes[i]->xy[1]);
+
+  free(nIn);
+  free(nOut);
+
+  if (nErrors > 0)
+    icfLog(ICF_LOG_MESH, ICF_LOG_ERROR,
+           "MESH VALIDATION FOUND %d INCONSISTENCIES", nErrors);
+
+  ICF_PROF_END(validate);
+
+  return nErrors;
+
+error:
+  free(nIn);
+  free(nOut);
+
+  ICF_PROF_END(validate);
+
+  return (nErrors > 0) ? nErrors : 1;
+
+} /* icfMesh_validate() */
+
 /**********************************************************
 * Function: icfMesh_printMesh()
 *----------------------------------------------------------
@@ -755,16 +2334,16 @@ void icfMesh_calcDualMetrics(icfMesh *mesh)
 void icfMesh_printMesh(icfMesh *mesh) 
 {
   icfListNode *cur;
-  int i;
+  icfIndex i;
 
   /*-------------------------------------------------------
   | Set node indices and print node coordinates
   -------------------------------------------------------*/
-  fprintf(stdout,"NODES %d\n", mesh->nNodes);
+  fprintf(stdout,"NODES %" ICF_PRIdx "\n", mesh->nNodes);
   for (cur = mesh->nodeStack->first; 
        cur != NULL; cur = cur->next)
   {
-    icfDouble *xy = ((icfNode*)cur->value)->xy;
+    icfReal   *xy = ((icfNode*)cur->value)->xy;
     icfIndex   i  = ((icfNode*)cur->value)->index;
 
     char *bdry_0, *bdry_1;
@@ -778,20 +2357,21 @@ void icfMesh_printMesh(icfMesh *mesh)
     else 
       bdry_1 = "None";
 
-    fprintf(stdout,"%d\t%9.5f\t%9.5f\t%s\t%s\n", 
+    fprintf(stdout,"%" ICF_PRIdx "\t%9.5f\t%9.5f\t%s\t%s\n",
         i, xy[0], xy[1], bdry_0, bdry_1);
   }
 
   /*-------------------------------------------------------
   | print triangles
   -------------------------------------------------------*/
-  fprintf(stdout,"TRIANGLES %d\n", mesh->nTriLeafs);
+  fprintf(stdout,"TRIANGLES %" ICF_PRIdx "\n", mesh->nTriLeafs);
   for (i = 0; i < mesh->nTriLeafs; i++)
   {
     icfTri *curTri = mesh->triLeafs[i];
 
-    fprintf(stdout,"%d\t%d\t%d\t%d\n", 
-        curTri->index, 
+    fprintf(stdout,"%" ICF_PRIdx "\t%" ICF_PRIdx
+        "\t%" ICF_PRIdx "\t%" ICF_PRIdx "\n",
+        curTri->cold->index, 
         curTri->n[0]->index,
         curTri->n[1]->index,
         curTri->n[2]->index);
@@ -800,7 +2380,7 @@ void icfMesh_printMesh(icfMesh *mesh)
   /*-------------------------------------------------------
   | print mesh edges
   -------------------------------------------------------*/
-  fprintf(stdout,"EDGES %d\n", mesh->nEdgeLeafs);
+  fprintf(stdout,"EDGES %" ICF_PRIdx "\n", mesh->nEdgeLeafs);
   for (i = 0; i < mesh->nEdgeLeafs; i++)
   {
     icfEdge *curEdge = mesh->edgeLeafs[i];
@@ -815,25 +2395,26 @@ void icfMesh_printMesh(icfMesh *mesh)
     icfTri *t1 = curEdge->t[1];
 
     char *bdry;
-    if (curEdge->bdry != NULL)
-      bdry = curEdge->bdry->name;
+    if (curEdge->cold->bdry != NULL)
+      bdry = curEdge->cold->bdry->name;
     else
       bdry = "None";
 
     if (t0 != NULL)
-      i0 = t0->index;
+      i0 = t0->cold->index;
     if (t1 != NULL)
-      i1 = t1->index;
+      i1 = t1->cold->index;
 
-    curEdge->index = i;
-    fprintf(stdout,"%d\t%9d\t%9d\t%9d\t%9d\t%s\n", i, 
+    curEdge->cold->index = i;
+    fprintf(stdout,"%" ICF_PRIdx "\t%9" ICF_PRIdx "\t%9" ICF_PRIdx
+        "\t%9" ICF_PRIdx "\t%9" ICF_PRIdx "\t%s\n", i,
         n0, n1, i0, i1, bdry);
   }
 
   /*-------------------------------------------------------
   | print triangles neighbors
   -------------------------------------------------------*/
-  fprintf(stdout,"TRI NEIGHBORS %d\n", mesh->nTriLeafs);
+  fprintf(stdout,"TRI NEIGHBORS %" ICF_PRIdx "\n", mesh->nTriLeafs);
   
   for (i = 0; i < mesh->nTriLeafs; i++)
   {
@@ -856,21 +2437,23 @@ void icfMesh_printMesh(icfMesh *mesh)
     icfIndex ie2 = -1;
 
     if (t0 != NULL)
-      it0 = t0->index;
+      it0 = t0->cold->index;
     if (t1 != NULL)
-      it1 = t1->index;
+      it1 = t1->cold->index;
     if (t2 != NULL)
-      it2 = t2->index;
+      it2 = t2->cold->index;
 
     if (e0 != NULL)
-      ie0 = e0->index;
+      ie0 = e0->cold->index;
     if (e1 != NULL)
-      ie1 = e1->index;
+      ie1 = e1->cold->index;
     if (e2 != NULL)
-      ie2 = e2->index;
+      ie2 = e2->cold->index;
 
-    fprintf(stdout,"%d\t%9d\t%9d\t%9d\t%9d\t%9d\t%9d\n", 
-        curTri->index, it0, it1, it2, ie0, ie1, ie2);
+    fprintf(stdout,"%" ICF_PRIdx "\t%9" ICF_PRIdx "\t%9" ICF_PRIdx
+        "\t%9" ICF_PRIdx "\t%9" ICF_PRIdx "\t%9" ICF_PRIdx
+        "\t%9" ICF_PRIdx "\n",
+        curTri->cold->index, it0, it1, it2, ie0, ie1, ie2);
   } 
 
 } /* tmMesh_printMesh() */
@@ -0,0 +1,380 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <stdint.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfMeshGen.h"
+
+/**********************************************************
+* Function: icfMeshGen_initParams
+*----------------------------------------------------------
+* Sets default parameters: the unit square with 
+* 1 x 1 cells, without jitter and without holes
+*----------------------------------------------------------
+* @param: params - parameters to initialize
+**********************************************************/
+void icfMeshGen_initParams(icfMeshGenParams *params)
+{
+  params->xy0[0] = 0.0;
+  params->xy0[1] = 0.0;
+  params->xy1[0] = 1.0;
+  params->xy1[1] = 1.0;
+  params->nx     = 1;
+  params->ny     = 1;
+  params->jitter = 0.0;
+  params->seed   = 0;
+  params->nHoles = 0;
+  params->holes  = NULL;
+
+} /* icfMeshGen_initParams() */
+
+/**********************************************************
+* Function: icfMeshGen_random
+*----------------------------------------------------------
+* Stateless pseudo random number in [-1,1] for a 
+* given key (splitmix64), such that the node jitter 
+* does not depend on the number of threads
+**********************************************************/
+static icfDouble icfMeshGen_random(uint64_t key)
+{
+  key += 0x9E3779B97F4A7C15ULL;
+  key  = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  key  = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+  key  =  key ^ (key >> 31);
+
+  return 2.0 * (icfDouble)(key >> 11) / (icfDouble)(1ULL << 53) - 1.0;
+
+} /* icfMeshGen_random() */
+
+/**********************************************************
+* Function: icfMeshGen_getBdry
+*----------------------------------------------------------
+* Returns the boundary with a given marker and creates 
+* it, if it is not defined in the mesh
+**********************************************************/
+static icfBdry *icfMeshGen_getBdry(icfMesh    *mesh,
+                                   icfIndex    marker,
+                                   const char *name)
+{
+  icfListNode *cur;
+
+  for (cur = mesh->bdryStack->first; cur != NULL; cur = cur->next)
+    if (((icfBdry*)cur->value)->marker == marker)
+      return (icfBdry*)cur->value;
+
+  return icfBdry_create(mesh, 0, marker, name);
+
+} /* icfMeshGen_getBdry() */
+
+/**********************************************************
+* Function: icfMeshGen_rectangle
+*----------------------------------------------------------
+* Creates the entities of a triangulated rectangle 
+* in an empty mesh. 
+*
+* Every cell (i,j) contains the triangles A and B. 
+* The diagonal alternates with the parity of i+j:
+*
+*  even:  n3______n2       odd:  n3______n2
+*          |    /|                |\    |
+*          | B /  |                | \ B |
+*          |  / A |                |A \  |
+*          |/____|                |___\|
+*         n0     n1              n0     n1
+*
+* A touches the south side of the cell, B the north side,
+* A the east side for even and the west side for odd
+* cells. The neighbors of all triangles are therefore
+* known without any search.
+*----------------------------------------------------------
+* @param: mesh   - pointer to an empty mesh structure
+* @param: params - generator parameters
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshGen_rectangle(icfMesh                *mesh,
+                         const icfMeshGenParams *params)
+{
+  const int nx = params->nx;
+  const int ny = params->ny;
+
+  const icfDouble dx = (params->xy1[0] - params->xy0[0]) / nx;
+  const icfDouble dy = (params->xy1[1] - params->xy0[1]) / ny;
+
+  long i, j;
+  int  nNodes = 0;
+  int  nTris  = 0;
+  int  status = -1;
+
+  /*-------------------------------------------------------
+  | Per-cell triangle offsets (-1 for removed cells),
+  | per-node indices (-1 for unused nodes) and row sums
+  -------------------------------------------------------*/
+  icfIndex  *cellTri   = NULL;
+  icfIndex  *nodeIdx   = NULL;
+  icfIndex  *rowCount  = NULL;
+
+  icfDouble (*xyNodes)[2]    = NULL;
+  icfIndex  (*idxTris)[3]    = NULL;
+  icfIndex  (*idxTriNbrs)[3] = NULL;
+
+  check(nx > 0 && ny > 0, "Invalid mesh generator resolution.");
+  check(dx > 0.0 && dy > 0.0, "Invalid mesh generator domain.");
+  check(params->jitter >= 0.0 && params->jitter < 1.0/6.0,
+      "Mesh generator jitter must be in [0, 1/6).");
+
+  cellTri  = (icfIndex*) malloc((size_t)nx*ny*sizeof(icfIndex));
+  nodeIdx  = (icfIndex*) malloc((size_t)(nx+1)*(ny+1)*sizeof(icfIndex));
+  rowCount = (icfIndex*) calloc(ny+2, sizeof(icfIndex));
+  check_mem(cellTri);
+  check_mem(nodeIdx);
+  check_mem(rowCount);
+
+  /*-------------------------------------------------------
+  | Mark removed cells and count active cells per row
+  -------------------------------------------------------*/
+#pragma omp parallel for private(i) schedule(static)
+  for (j = 0; j < ny; j++)
+  {
+    icfIndex count = 0;
+
+    for (i = 0; i < nx; i++)
+    {
+      icfDouble xc = params->xy0[0] + (i + 0.5) * dx;
+      icfDouble yc = params->xy0[1] + (j + 0.5) * dy;
+      int k, active = 1;
+
+      for (k = 0; k < params->nHoles; k++)
+        if (  xc > params->holes[k][0] && xc < params->holes[k][2]
+           && yc > params->holes[k][1] && yc < params->holes[k][3] )
+          active = 0;
+
+      cellTri[j*nx+i] = active;
+      count          += active;
+    }
+
+    rowCount[j] = count;
+  }
+
+  /*-------------------------------------------------------
+  | Prefix sum over rows -> triangle offsets
+  -------------------------------------------------------*/
+  for (j = 0; j < ny; j++)
+  {
+    icfIndex count = rowCount[j];
+    rowCount[j] = nTris;
+    nTris      += 2 * count;
+  }
+
+  check(nTris > 0, "Generated mesh contains no triangles.");
+
+#pragma omp parallel for private(i) schedule(static)
+  for (j = 0; j < ny; j++)
+  {
+    icfIndex iTri = rowCount[j];
+
+    for (i = 0; i < nx; i++)
+    {
+      if (cellTri[j*nx+i] > 0)
+      {
+        cellTri[j*nx+i] = iTri;
+        iTri += 2;
+      }
+      else
+        cellTri[j*nx+i] = -1;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Mark used nodes and count them per row
+  -------------------------------------------------------*/
+#define CELL(ii, jj) ( ((ii) < 0 || (ii) >= nx || (jj) < 0 \
+                     || (jj) >= ny) ? -1 : cellTri[(jj)*nx+(ii)] )
+
+#pragma omp parallel for private(i) schedule(static)
+  for (j = 0; j <= ny; j++)
+  {
+    icfIndex count = 0;
+
+    for (i = 0; i <= nx; i++)
+    {
+      int used = ( CELL(i-1, j-1) >= 0 || CELL(i, j-1) >= 0
+                || CELL(i-1, j  ) >= 0 || CELL(i, j  ) >= 0 );
+
+      nodeIdx[j*(nx+1)+i] = used;
+      count += used;
+    }
+
+    rowCount[j] = count;
+  }
+
+  for (j = 0; j <= ny; j++)
+  {
+    icfIndex count = rowCount[j];
+    rowCount[j] = nNodes;
+    nNodes     += count;
+  }
+
+  xyNodes    = calloc(nNodes, 2*sizeof(icfDouble));
+  idxTris    = calloc(nTris,  3*sizeof(icfIndex));
+  idxTriNbrs = calloc(nTris,  3*sizeof(icfIndex));
+  check_mem(xyNodes);
+  check_mem(idxTris);
+  check_mem(idxTriNbrs);
+
+  /*-------------------------------------------------------
+  | Node indices and coordinates
+  | Only nodes, whose four adjacent cells are all active,
+  | are displaced, such that the boundaries stay straight
+  -------------------------------------------------------*/
+#pragma omp parallel for private(i) schedule(static)
+  for (j = 0; j <= ny; j++)
+  {
+    icfIndex iNode = rowCount[j];
+
+    for (i = 0; i <= nx; i++)
+    {
+      long k = j*(nx+1) + i;
+
+      if (nodeIdx[k] == 0)
+      {
+        nodeIdx[k] = -1;
+        continue;
+      }
+
+      icfDouble x = params->xy0[0] + i * dx;
+      icfDouble y = params->xy0[1] + j * dy;
+
+      if ( params->jitter > 0.0
+          && CELL(i-1, j-1) >= 0 && CELL(i, j-1) >= 0
+          && CELL(i-1, j  ) >= 0 && CELL(i, j  ) >= 0 )
+      {
+        uint64_t key = ((uint64_t)params->seed << 40) ^ (2*(uint64_t)k);
+        x += params->jitter * dx * icfMeshGen_random(key);
+        y += params->jitter * dy * icfMeshGen_random(key+1);
+      }
+
+      xyNodes[iNode][0] = x;
+      xyNodes[iNode][1] = y;
+      nodeIdx[k]        = iNode;
+      iNode++;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Triangles and neighbors
+  | Neighbors across removed cells or the domain border 
+  | get the negative boundary marker
+  -------------------------------------------------------*/
+#define NODE(ii, jj) nodeIdx[(jj)*(nx+1)+(ii)]
+
+#pragma omp parallel for private(i) schedule(static)
+  for (j = 0; j < ny; j++)
+  {
+    for (i = 0; i < nx; i++)
+    {
+      icfIndex tA = cellTri[j*nx+i];
+      icfIndex tB = tA + 1;
+
+      if (tA < 0)
+        continue;
+
+      icfIndex n0 = NODE(i,   j  );
+      icfIndex n1 = NODE(i+1, j  );
+      icfIndex n2 = NODE(i+1, j+1);
+      icfIndex n3 = NODE(i,   j+1);
+
+      /*---------------------------------------------------
+      | Neighbor triangles across the four cell sides:
+      | the south neighbor is B of (i,j-1), the north 
+      | neighbor is A of (i,j+1). East and west neighbors
+      | have the opposite parity: an even cell touches A 
+      | of its east and B of its west neighbor, an odd 
+      | cell vice versa
+      ---------------------------------------------------*/
+      icfIndex cS = CELL(i, j-1);
+      icfIndex cN = CELL(i, j+1);
+      icfIndex cE = CELL(i+1, j);
+      icfIndex cW = CELL(i-1, j);
+      int      even = ((i+j) % 2 == 0);
+
+      icfIndex tS = (cS >= 0) ? cS + 1 
+        : (j == 0)    ? -ICF_MESHGEN_SOUTH : -ICF_MESHGEN_HOLE;
+      icfIndex tN = (cN >= 0) ? cN 
+        : (j == ny-1) ? -ICF_MESHGEN_NORTH : -ICF_MESHGEN_HOLE;
+      icfIndex tE = (cE >= 0) ? cE + (even ? 0 : 1)
+        : (i == nx-1) ? -ICF_MESHGEN_EAST  : -ICF_MESHGEN_HOLE;
+      icfIndex tW = (cW >= 0) ? cW + (even ? 1 : 0)
+        : (i == 0)    ? -ICF_MESHGEN_WEST  : -ICF_MESHGEN_HOLE;
+
+      if (even)
+      {
+        /* A = (n0,n1,n2), B = (n0,n2,n3) */
+        idxTris[tA][0] = n0; idxTris[tA][1] = n1; idxTris[tA][2] = n2;
+        idxTris[tB][0] = n0; idxTris[tB][1] = n2; idxTris[tB][2] = n3;
+
+        idxTriNbrs[tA][0] = tE; 
+        idxTriNbrs[tA][1] = tB; 
+        idxTriNbrs[tA][2] = tS;
+
+        idxTriNbrs[tB][0] = tN; 
+        idxTriNbrs[tB][1] = tW; 
+        idxTriNbrs[tB][2] = tA;
+      }
+      else
+      {
+        /* A = (n0,n1,n3), B = (n1,n2,n3) */
+        idxTris[tA][0] = n0; idxTris[tA][1] = n1; idxTris[tA][2] = n3;
+        idxTris[tB][0] = n1; idxTris[tB][1] = n2; idxTris[tB][2] = n3;
+
+        idxTriNbrs[tA][0] = tB; 
+        idxTriNbrs[tA][1] = tW; 
+        idxTriNbrs[tA][2] = tS;
+
+        idxTriNbrs[tB][0] = tN; 
+        idxTriNbrs[tB][1] = tA; 
+        idxTriNbrs[tB][2] = tE;
+      }
+    }
+  }
+
+#undef NODE
+#undef CELL
+
+  /*-------------------------------------------------------
+  | Boundaries and mesh entities
+  -------------------------------------------------------*/
+  check(icfMeshGen_getBdry(mesh, ICF_MESHGEN_SOUTH, "SOUTH") != NULL
+     && icfMeshGen_getBdry(mesh, ICF_MESHGEN_EAST,  "EAST" ) != NULL
+     && icfMeshGen_getBdry(mesh, ICF_MESHGEN_NORTH, "NORTH") != NULL
+     && icfMeshGen_getBdry(mesh, ICF_MESHGEN_WEST,  "WEST" ) != NULL,
+      "Failed to create mesh boundaries.");
+
+  if (params->nHoles > 0)
+    check(icfMeshGen_getBdry(mesh, ICF_MESHGEN_HOLE, "HOLE") != NULL,
+        "Failed to create mesh boundaries.");
+
+  check(icfMesh_buildFromNbrs(mesh, nNodes, xyNodes, 
+        nTris, idxTris, idxTriNbrs) == 0,
+      "Failed to create generated mesh.");
+
+  status = 0;
+
+error:
+  free(cellTri);
+  free(nodeIdx);
+  free(rowCount);
+  free(xyNodes);
+  free(idxTris);
+  free(idxTriNbrs);
+
+  return status;
+
+} /* icfMeshGen_rectangle() */
@@ -0,0 +1,468 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfMeshOrder.h"
+#include "incomflow/icfProf.h"
+
+/**********************************************************
+* Names of the edge orderings
+**********************************************************/
+static const char *icfMeshOrder_names[ICF_EDGEORDER_N] = {
+  "stack",
+  "minnode",
+  "rcm",
+};
+
+/**********************************************************
+* Maximum number of trial searches for a pseudo-
+* peripheral node
+**********************************************************/
+#define ICF_MESHORDER_MAXTRIALS 8
+
+/**********************************************************
+* icfNodeGraph: Node graph of the edge leafs in
+* compressed row storage
+**********************************************************/
+typedef struct icfNodeGraph {
+  icfIndex  nNodes;
+  icfIndex *xadj;   /* Offsets of the adjacency lists   */
+  icfIndex *adj;    /* Neighbor node indices            */
+} icfNodeGraph;
+
+#define ICF_NODEGRAPH_DEG(g, i) ((g)->xadj[(i)+1] - (g)->xadj[(i)])
+
+/**********************************************************
+* Function: icfNodeGraph_build()
+*----------------------------------------------------------
+* @return: 0 on success, -1 on errors
+**********************************************************/
+static int icfNodeGraph_build(icfNodeGraph *g, const icfMesh *mesh)
+{
+  icfIndex i;
+  const icfIndex nNodes = mesh->nNodes;
+  const icfIndex nEdges = mesh->nEdgeLeafs;
+
+  g->nNodes = nNodes;
+  g->xadj   = (icfIndex*) calloc(nNodes+1, sizeof(icfIndex));
+  g->adj    = (icfIndex*) malloc((2*nEdges+1) * sizeof(icfIndex));
+  check_mem(g->xadj && g->adj);
+
+  /*-------------------------------------------------------
+  | Count the degrees, the offsets are used as insertion
+  | positions and shifted back afterwards
+  -------------------------------------------------------*/
+  for (i = 0; i < nEdges; i++)
+  {
+    const icfEdge *e = mesh->edgeLeafs[i];
+    g->xadj[e->n[0]->index + 1] += 1;
+    g->xadj[e->n[1]->index + 1] += 1;
+  }
+
+  for (i = 0; i < nNodes; i++)
+    g->xadj[i+1] += g->xadj[i];
+
+  for (i = 0; i < nEdges; i++)
+  {
+    const icfIndex i0 = mesh->edgeLeafs[i]->n[0]->index;
+    const icfIndex i1 = mesh->edgeLeafs[i]->n[1]->index;
+    g->adj[g->xadj[i0]++] = i1;
+    g->adj[g->xadj[i1]++] = i0;
+  }
+
+  for (i = nNodes; i > 0; i--)
+    g->xadj[i] = g->xadj[i-1];
+  g->xadj[0] = 0;
+
+  return 0;
+
+error:
+  free(g->xadj);
+  free(g->adj);
+  g->xadj = NULL;
+  g->adj  = NULL;
+  return -1;
+
+} /* icfNodeGraph_build() */
+
+/**********************************************************
+* Function: icfNodeGraph_free()
+**********************************************************/
+static void icfNodeGraph_free(icfNodeGraph *g)
+{
+  free(g->xadj);
+  free(g->adj);
+} /* icfNodeGraph_free() */
+
+/**********************************************************
+* Function: icfNodeGraph_levels()
+*----------------------------------------------------------
+* Breadth-first search of the level structure rooted at
+* a node. The reached nodes are written to queue and
+* their levels are reset afterwards.
+*----------------------------------------------------------
+* @param level: levels of all nodes, -1 if not reached
+* @param nLevels: returns the depth of the structure
+* @return: node of minimum degree in the last level
+**********************************************************/
+static icfIndex icfNodeGraph_levels(const icfNodeGraph *g,
+                                    icfIndex            root,
+                                    icfIndex           *level,
+                                    icfIndex           *queue,
+                                    icfIndex           *nLevels)
+{
+  icfIndex head = 0, tail = 0, k;
+
+  level[root]   = 0;
+  queue[tail++] = root;
+
+  while (head < tail)
+  {
+    const icfIndex v = queue[head++];
+
+    for (k = g->xadj[v]; k < g->xadj[v+1]; k++)
+    {
+      const icfIndex w = g->adj[k];
+
+      if (level[w] < 0)
+      {
+        level[w]      = level[v] + 1;
+        queue[tail++] = w;
+      }
+    }
+  }
+
+  *nLevels = level[queue[tail-1]] + 1;
+
+  icfIndex last = queue[tail-1];
+
+  for (k = tail-1; k >= 0 && level[queue[k]] == *nLevels-1; k--)
+    if (ICF_NODEGRAPH_DEG(g, queue[k]) < ICF_NODEGRAPH_DEG(g, last))
+      last = queue[k];
+
+  for (k = 0; k < tail; k++)
+    level[queue[k]] = -1;
+
+  return last;
+
+} /* icfNodeGraph_levels() */
+
+/**********************************************************
+* Function: icfMeshOrder_nodesRCM()
+*----------------------------------------------------------
+* Function to number the nodes of a mesh by the reverse
+* Cuthill-McKee ordering of its leaf edges
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshOrder_nodesRCM(icfMesh *mesh)
+{
+  icfIndex i, k;
+  icfNodeGraph graph = { 0, NULL, NULL };
+
+  const icfIndex nNodes = mesh->nNodes;
+
+  icfIndex  *level = NULL;
+  icfIndex  *perm  = NULL;
+  icfNode  **nodes = NULL;
+
+  if (nNodes == 0)
+    return 0;
+
+  check(icfNodeGraph_build(&graph, mesh) == 0,
+      "Failed to build the node graph.");
+
+  level = (icfIndex*) malloc(nNodes * sizeof(icfIndex));
+  perm  = (icfIndex*) malloc(nNodes * sizeof(icfIndex));
+  nodes = (icfNode**) malloc(nNodes * sizeof(icfNode*));
+  check_mem(level && perm && nodes);
+
+  for (i = 0; i < nNodes; i++)
+    level[i] = -1;
+
+  /*-------------------------------------------------------
+  | Cuthill-McKee ordering of every connected component
+  -------------------------------------------------------*/
+  icfIndex nDone = 0;
+  icfIndex start = 0;
+
+  while (nDone < nNodes)
+  {
+    while (level[start] >= 0)
+      start++;
+
+    /*-----------------------------------------------------
+    | Pseudo-peripheral root (George & Liu): move to a
+    | node of the last level, as long as the depth of
+    | the level structure grows. The unnumbered part of
+    | perm serves as queue.
+    -----------------------------------------------------*/
+    icfIndex root = start;
+    icfIndex nLevels, nLevelsNext;
+    icfIndex cand = icfNodeGraph_levels(&graph, root, level,
+                                        &perm[nDone], &nLevels);
+
+    for (k = 0; k < ICF_MESHORDER_MAXTRIALS; k++)
+    {
+      icfIndex next = icfNodeGraph_levels(&graph, cand, level,
+                                          &perm[nDone], &nLevelsNext);
+      if (nLevelsNext <= nLevels)
+        break;
+
+      root    = cand;
+      cand    = next;
+      nLevels = nLevelsNext;
+    }
+
+    /*-----------------------------------------------------
+    | Breadth-first numbering, neighbors by ascending
+    | degree
+    -----------------------------------------------------*/
+    icfIndex head = nDone;
+
+    level[root]   = 0;
+    perm[nDone++]   = root;
+
+    while (head < nDone)
+    {
+      const icfIndex v     = perm[head++];
+      const icfIndex first = nDone;
+
+      for (k = graph.xadj[v]; k < graph.xadj[v+1]; k++)
+      {
+        const icfIndex w = graph.adj[k];
+
+        if (level[w] < 0)
+        {
+          level[w]      = 0;
+          perm[nDone++] = w;
+        }
+      }
+
+      for (i = first+1; i < nDone; i++)
+      {
+        const icfIndex w   = perm[i];
+        const icfIndex deg = ICF_NODEGRAPH_DEG(&graph, w);
+        icfIndex j = i;
+
+        while (j > first && ICF_NODEGRAPH_DEG(&graph, perm[j-1]) > deg)
+        {
+          perm[j] = perm[j-1];
+          j--;
+        }
+        perm[j] = w;
+      }
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Reverse the ordering and renumber the nodes
+  -------------------------------------------------------*/
+  for (i = 0; i < nNodes; i++)
+    nodes[nNodes-1-i] = mesh->nodes[perm[i]];
+
+  for (i = 0; i < nNodes; i++)
+  {
+    mesh->nodes[i]        = nodes[i];
+    mesh->nodes[i]->index = i;
+  }
+
+  icfNodeGraph_free(&graph);
+  free(level);
+  free(perm);
+  free(nodes);
+
+  return 0;
+
+error:
+  icfNodeGraph_free(&graph);
+  free(level);
+  free(perm);
+  free(nodes);
+
+  return -1;
+
+} /* icfMeshOrder_nodesRCM() */
+
+/**********************************************************
+* Function: icfMeshOrder_countSort()
+*----------------------------------------------------------
+* Stable counting sort of edges by their lower or higher
+* node index
+**********************************************************/
+static void icfMeshOrder_countSort(icfEdge  **src,
+                                   icfEdge  **dst,
+                                   icfIndex   nEdges,
+                                   icfIndex  *count,
+                                   icfIndex   nNodes,
+                                   icfBool    lower)
+{
+  icfIndex i;
+
+  memset(count, 0, (nNodes+1) * sizeof(icfIndex));
+
+#define ICF_MESHORDER_KEY(e)                                   \
+  ( ((e)->n[0]->index < (e)->n[1]->index) == (lower == TRUE)   \
+    ? (e)->n[0]->index : (e)->n[1]->index )
+
+  for (i = 0; i < nEdges; i++)
+    count[ICF_MESHORDER_KEY(src[i]) + 1] += 1;
+
+  for (i = 0; i < nNodes; i++)
+    count[i+1] += count[i];
+
+  for (i = 0; i < nEdges; i++)
+    dst[count[ICF_MESHORDER_KEY(src[i])]++] = src[i];
+
+#undef ICF_MESHORDER_KEY
+
+} /* icfMeshOrder_countSort() */
+
+/**********************************************************
+* Function: icfMeshOrder_edgeLeafs()
+*----------------------------------------------------------
+* Function to sort the edge leafs of a mesh by their
+* lower and then by their higher node index
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshOrder_edgeLeafs(icfMesh *mesh)
+{
+  icfIndex i;
+
+  const icfIndex nEdges = mesh->nEdgeLeafs;
+  const icfIndex nNodes = mesh->nNodes;
+
+  icfIndex  *count = NULL;
+  icfEdge  **edges = NULL;
+
+  if (nEdges == 0)
+    return 0;
+
+  count = (icfIndex*) malloc((nNodes+1) * sizeof(icfIndex));
+  edges = (icfEdge**) malloc(nEdges * sizeof(icfEdge*));
+  check_mem(count && edges);
+
+  /*-------------------------------------------------------
+  | Least significant key first
+  -------------------------------------------------------*/
+  icfMeshOrder_countSort(mesh->edgeLeafs, edges, nEdges,
+                         count, nNodes, FALSE);
+  icfMeshOrder_countSort(edges, mesh->edgeLeafs, nEdges,
+                         count, nNodes, TRUE);
+
+  for (i = 0; i < nEdges; i++)
+    mesh->edgeLeafs[i]->cold->leafPos = i;
+
+  free(count);
+  free(edges);
+
+  return 0;
+
+error:
+  free(count);
+  free(edges);
+
+  return -1;
+
+} /* icfMeshOrder_edgeLeafs() */
+
+/**********************************************************
+* Function: icfMeshOrder_apply()
+*----------------------------------------------------------
+* Function to reorder the nodes and edge leafs of a mesh
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfMeshOrder_apply(icfMesh *mesh)
+{
+  if (mesh->edgeOrder == ICF_EDGEORDER_STACK)
+    return 0;
+
+  ICF_PROF_BEGIN(order, "icfMeshOrder_apply");
+
+  if (mesh->edgeOrder == ICF_EDGEORDER_RCM)
+    check(icfMeshOrder_nodesRCM(mesh) == 0,
+        "Failed to compute the RCM node ordering.");
+
+  check(icfMeshOrder_edgeLeafs(mesh) == 0,
+      "Failed to sort the edge leafs.");
+
+  ICF_PROF_END(order);
+  return 0;
+
+error:
+  ICF_PROF_END(order);
+  return -1;
+
+} /* icfMeshOrder_apply() */
+
+/**********************************************************
+* Function: icfMeshOrder_bandwidth()
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: largest index difference of the nodes of an
+*          edge leaf
+**********************************************************/
+icfIndex icfMeshOrder_bandwidth(const icfMesh *mesh)
+{
+  icfIndex i, bw = 0;
+
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+  {
+    const icfEdge *e = mesh->edgeLeafs[i];
+    icfIndex d = e->n[1]->index - e->n[0]->index;
+
+    if (d < 0)
+      d = -d;
+    if (d > bw)
+      bw = d;
+  }
+
+  return bw;
+
+} /* icfMeshOrder_bandwidth() */
+
+/**********************************************************
+* Function: icfMeshOrder_name()
+*----------------------------------------------------------
+* @return: name of an edge ordering
+**********************************************************/
+const char *icfMeshOrder_name(icfEdgeOrder order)
+{
+  if (order < 0 || order >= ICF_EDGEORDER_N)
+    return "unknown";
+
+  return icfMeshOrder_names[order];
+
+} /* icfMeshOrder_name() */
+
+/**********************************************************
+* Function: icfMeshOrder_fromName()
+*----------------------------------------------------------
+* @return: edge ordering of a name, -1 if unknown
+**********************************************************/
+int icfMeshOrder_fromName(const char *name)
+{
+  int i;
+
+  for (i = 0; i < ICF_EDGEORDER_N; i++)
+    if (strcmp(name, icfMeshOrder_names[i]) == 0)
+      return i;
+
+  return -1;
+
+} /* icfMeshOrder_fromName() */
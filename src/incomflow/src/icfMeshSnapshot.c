@@ -0,0 +1,321 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshSnapshot.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfProf.h"
+
+/**********************************************************
+* Size of one entry of every snapshot array in bytes
+**********************************************************/
+static const size_t icfMeshSnapshot_entrySize[ICF_SNAPSHOT_NARRAYS] = {
+  2 * sizeof(icfDouble),   /* ICF_SNAPSHOT_NODEXY   */
+  1 * sizeof(icfDouble),   /* ICF_SNAPSHOT_NODEVOL  */
+  3 * sizeof(icfIndex),    /* ICF_SNAPSHOT_TRINODES */
+  3 * sizeof(icfIndex),    /* ICF_SNAPSHOT_TRINBRS  */
+  2 * sizeof(icfDouble),   /* ICF_SNAPSHOT_TRIXY    */
+  1 * sizeof(icfDouble),   /* ICF_SNAPSHOT_TRIAREA  */
+  1 * sizeof(icfIndex),    /* ICF_SNAPSHOT_TRILEVEL */
+};
+
+/**********************************************************
+* Largest entry size of all arrays in bytes, which 
+* depends on the widths of icfDouble and icfIndex
+**********************************************************/
+#define ICF_SNAPSHOT_MAXENTRY                                  \
+  ( 3 * ( (sizeof(icfDouble) > sizeof(icfIndex))              \
+          ? sizeof(icfDouble) : sizeof(icfIndex) ) )
+
+_Static_assert(2 * sizeof(icfDouble) <= ICF_SNAPSHOT_MAXENTRY
+            && 3 * sizeof(icfIndex)  <= ICF_SNAPSHOT_MAXENTRY,
+    "Snapshot entries exceed the chunk buffer.");
+
+/**********************************************************
+* icfSnapshotBuffer: Stack buffer of one chunk, which is
+* aligned for both value types
+**********************************************************/
+typedef union icfSnapshotBuffer {
+  icfDouble     d;
+  icfIndex      i;
+  unsigned char bytes[ICF_SNAPSHOT_MAXENTRY * ICF_SNAPSHOT_CHUNKLEN];
+} icfSnapshotBuffer;
+
+/**********************************************************
+* Function: icfMeshSnapshot_fill()
+*----------------------------------------------------------
+* Writes the entries i0 ... i1-1 of an array from the 
+* mesh to a buffer
+**********************************************************/
+static void icfMeshSnapshot_fill(const icfMesh    *mesh,
+                                 icfSnapshotArray  array,
+                                 icfIndex          i0,
+                                 icfIndex          i1,
+                                 void             *buf)
+{
+  icfDouble      *v   = (icfDouble*) buf;
+  icfIndex       *idx = (icfIndex*)  buf;
+  icfNode *const *n   = (array <= ICF_SNAPSHOT_NODEVOL)
+                      ? mesh->nodes + i0 : NULL;
+  icfTri  *const *t   = (array >= ICF_SNAPSHOT_TRINODES)
+                      ? mesh->triLeafs + i0 : NULL;
+  const icfIndex  m   = i1 - i0;
+  icfIndex        k;
+  int             j;
+
+  switch (array)
+  {
+    case ICF_SNAPSHOT_NODEXY:
+      for (k = 0; k < m; k++)
+      {
+        v[2*k]   = n[k]->xy[0];
+        v[2*k+1] = n[k]->xy[1];
+      }
+      break;
+
+    case ICF_SNAPSHOT_NODEVOL:
+      for (k = 0; k < m; k++)
+        v[k] = n[k]->vol;
+      break;
+
+    case ICF_SNAPSHOT_TRINODES:
+      for (k = 0; k < m; k++)
+        for (j = 0; j < 3; j++)
+          idx[3*k+j] = t[k]->n[j]->index;
+      break;
+
+    /*-----------------------------------------------------
+    | The neighbor t[j] is located opposite of n[j],
+    | which is the edge e[(j+1)%3]
+    -----------------------------------------------------*/
+    case ICF_SNAPSHOT_TRINBRS:
+      for (k = 0; k < m; k++)
+        for (j = 0; j < 3; j++)
+        {
+          const icfEdge *e = t[k]->e[(j+1)%3];
+
+          if (t[k]->t[j] != NULL)
+            idx[3*k+j] = t[k]->t[j]->cold->leafPos;
+          else if (e->cold->bdry != NULL)
+            idx[3*k+j] = -e->cold->bdry->marker;
+          else
+            idx[3*k+j] = ICF_OUTPUT_NOBDRY;
+        }
+      break;
+
+    case ICF_SNAPSHOT_TRIXY:
+      for (k = 0; k < m; k++)
+      {
+        v[2*k]   = t[k]->xy[0];
+        v[2*k+1] = t[k]->xy[1];
+      }
+      break;
+
+    case ICF_SNAPSHOT_TRIAREA:
+      for (k = 0; k < m; k++)
+        v[k] = t[k]->area;
+      break;
+
+    case ICF_SNAPSHOT_TRILEVEL:
+      for (k = 0; k < m; k++)
+        idx[k] = t[k]->cold->treeLevel;
+      break;
+
+    default:
+      break;
+  }
+
+} /* icfMeshSnapshot_fill() */
+
+/**********************************************************
+* Function: icfMeshSnapshot_releaseChunk()
+*----------------------------------------------------------
+* Removes a holder from a chunk and frees the chunk with
+* its last holder
+**********************************************************/
+static void icfMeshSnapshot_releaseChunk(icfSnapshotChunk *chunk)
+{
+  if (chunk == NULL)
+    return;
+
+  if (__atomic_sub_fetch(&chunk->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    icfMem_free(ICF_MEM_SNAPSHOT, chunk, 
+                sizeof(icfSnapshotChunk) + chunk->size);
+
+} /* icfMeshSnapshot_releaseChunk() */
+
+/**********************************************************
+* Function: icfMeshSnapshot_capture
+*----------------------------------------------------------
+* Captures the leaf data of an updated mesh. The chunks
+* are filled in parallel with OpenMP, if available.
+* The returned snapshot is held once by the caller.
+* Every chunk is first written to a buffer on the stack 
+* and compared to the same chunk of the previous 
+* snapshot, such that unchanged chunks are neither
+* allocated nor written twice.
+*----------------------------------------------------------
+* @param: mesh - pointer to mesh structure
+* @param: prev - previous snapshot of the mesh, whose
+*                unchanged chunks are shared, may be NULL
+* @return: pointer to new snapshot, NULL on errors
+**********************************************************/
+icfMeshSnapshot *icfMeshSnapshot_capture(icfMesh         *mesh,
+                                         icfMeshSnapshot *prev)
+{
+  int              a;
+  int              nFailed = 0;
+  icfIndex         nShared = 0, nCopied = 0;
+  icfMeshSnapshot *snap    = NULL;
+
+  ICF_PROF_BEGIN(capture, "icfMeshSnapshot_capture");
+
+  snap = (icfMeshSnapshot*) icfMem_calloc(ICF_MEM_SNAPSHOT, 
+                                          1, sizeof(icfMeshSnapshot));
+  check_mem(snap);
+
+  snap->refs     = 1;
+  snap->revision = mesh->revision;
+  snap->nNodes   = mesh->nNodes;
+  snap->nTris    = mesh->nTriLeafs;
+
+  for (a = 0; a < ICF_SNAPSHOT_NARRAYS; a++)
+  {
+    const icfIndex n = (a <= ICF_SNAPSHOT_NODEVOL) 
+                     ? snap->nNodes : snap->nTris;
+    const icfIndex nChunks = (n + ICF_SNAPSHOT_CHUNKMASK) 
+                           >> ICF_SNAPSHOT_CHUNKSHIFT;
+    icfIndex k;
+
+    snap->chunks[a] = (icfSnapshotChunk**) icfMem_calloc(
+        ICF_MEM_SNAPSHOT, nChunks+1, sizeof(icfSnapshotChunk*));
+    check_mem(snap->chunks[a]);
+    snap->nChunks[a] = nChunks;
+
+#pragma omp parallel for reduction(+:nShared,nCopied,nFailed) schedule(static)
+    for (k = 0; k < nChunks; k++)
+    {
+      icfSnapshotBuffer buf;
+
+      const icfIndex i0   = k << ICF_SNAPSHOT_CHUNKSHIFT;
+      const icfIndex i1   = (i0 + ICF_SNAPSHOT_CHUNKLEN < n)
+                          ? i0 + ICF_SNAPSHOT_CHUNKLEN : n;
+      const icfIndex size = (i1 - i0) * icfMeshSnapshot_entrySize[a];
+
+      icfSnapshotChunk *old = (prev != NULL && k < prev->nChunks[a])
+                            ? prev->chunks[a][k] : NULL;
+      icfSnapshotChunk *chunk;
+
+      icfMeshSnapshot_fill(mesh, a, i0, i1, buf.bytes);
+
+      /*---------------------------------------------------
+      | Share unchanged chunks of the previous snapshot
+      ---------------------------------------------------*/
+      if ( old != NULL && old->size == size 
+        && memcmp(old->data, buf.bytes, size) == 0 )
+      {
+        __atomic_fetch_add(&old->refs, 1, __ATOMIC_RELAXED);
+        snap->chunks[a][k] = old;
+        nShared += 1;
+        continue;
+      }
+
+      chunk = (icfSnapshotChunk*) icfMem_malloc(ICF_MEM_SNAPSHOT,
+                                   sizeof(icfSnapshotChunk) + size);
+      if (chunk == NULL)
+      {
+        nFailed += 1;
+        continue;
+      }
+
+      chunk->refs = 1;
+      chunk->size = size;
+      memcpy(chunk->data, buf.bytes, size);
+
+      snap->chunks[a][k] = chunk;
+      nCopied += 1;
+    }
+  }
+
+  check(nFailed == 0, "Failed to allocate %d snapshot chunks.", nFailed);
+
+  snap->nShared = nShared;
+  snap->nCopied = nCopied;
+
+  icfLog(ICF_LOG_MESH, ICF_LOG_DEBUG,
+      "SNAPSHOT OF %" ICF_PRIdx " NODES AND %" ICF_PRIdx " TRIS: %" 
+      ICF_PRIdx " SHARED AND %" ICF_PRIdx " COPIED CHUNKS",
+      snap->nNodes, snap->nTris, nShared, nCopied);
+
+  ICF_PROF_END(capture);
+  return snap;
+
+error:
+  icfMeshSnapshot_release(snap);
+  ICF_PROF_END(capture);
+  return NULL;
+
+} /* icfMeshSnapshot_capture() */
+
+/**********************************************************
+* Function: icfMeshSnapshot_retain
+*----------------------------------------------------------
+* Adds a holder to a snapshot, which may be called from
+* any thread
+*----------------------------------------------------------
+* @param: snap - pointer to snapshot
+* @return: snap
+**********************************************************/
+icfMeshSnapshot *icfMeshSnapshot_retain(icfMeshSnapshot *snap)
+{
+  __atomic_fetch_add(&snap->refs, 1, __ATOMIC_RELAXED);
+  return snap;
+} /* icfMeshSnapshot_retain() */
+
+/**********************************************************
+* Function: icfMeshSnapshot_release
+*----------------------------------------------------------
+* Removes a holder from a snapshot, which may be called
+* from any thread. The snapshot is destroyed with its
+* last holder, chunks are freed with their last snapshot.
+*----------------------------------------------------------
+* @param: snap - pointer to snapshot, may be NULL
+**********************************************************/
+void icfMeshSnapshot_release(icfMeshSnapshot *snap)
+{
+  int      a;
+  icfIndex k;
+
+  if (snap == NULL)
+    return;
+
+  if (__atomic_sub_fetch(&snap->refs, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  for (a = 0; a < ICF_SNAPSHOT_NARRAYS; a++)
+  {
+    if (snap->chunks[a] == NULL)
+      continue;
+
+    for (k = 0; k < snap->nChunks[a]; k++)
+      icfMeshSnapshot_releaseChunk(snap->chunks[a][k]);
+
+    icfMem_free(ICF_MEM_SNAPSHOT, snap->chunks[a], 
+                (snap->nChunks[a]+1) * sizeof(icfSnapshotChunk*));
+  }
+
+  icfMem_free(ICF_MEM_SNAPSHOT, snap, sizeof(icfMeshSnapshot));
+
+} /* icfMeshSnapshot_release() */
@@ -11,6 +11,7 @@
 #include "incomflow/icfMesh.h"
 #include "incomflow/icfBdry.h"
 #include "incomflow/icfFlowData.h"
+#include "incomflow/icfProf.h"
 
 /**********************************************************
 * Function: icfNode_create
@@ -22,7 +23,8 @@
 **********************************************************/
 icfNode *icfNode_create(icfMesh *mesh, icfDouble *xy)
 {
-  icfNode *node = (icfNode*) calloc(1, sizeof(icfNode));
+  icfNode *node = (icfNode*) icfMem_calloc(ICF_MEM_NODES, 
+                                          1, sizeof(icfNode));
   check_mem(node);
 
   /*-------------------------------------------------------
@@ -30,21 +32,6 @@ icfNode *icfNode_create(icfMesh *mesh, icfDouble *xy)
   -------------------------------------------------------*/
   node->mesh   = mesh;
 
-  /*-------------------------------------------------------
-  | If this node is a refinement node, it contains the
-  | connectivity to all neighboring triangles / edges
-  | in the respective refinement tree level
-  -------------------------------------------------------*/
-  node->e_c[0] = NULL;
-  node->e_c[1] = NULL;
-  node->e_c[2] = NULL;
-  node->e_c[3] = NULL;
-
-  node->t_c[0] = NULL;
-  node->t_c[1] = NULL;
-  node->t_c[2] = NULL;
-  node->t_c[3] = NULL;
-
   /*-------------------------------------------------------
   | Node coordinates 
   -------------------------------------------------------*/
@@ -74,6 +61,9 @@ icfNode *icfNode_create(icfMesh *mesh, icfDouble *xy)
   -------------------------------------------------------*/
   node->vol      = 0.0;
 
+  ICF_PROF_ADD(ICF_PROF_NODES_CREATED, 1);
+  ICF_PROF_ADD(ICF_PROF_BYTES_ALLOCATED, sizeof(icfNode));
+
   return node;
 error:
   return NULL;
@@ -92,11 +82,20 @@ int icfNode_destroy(icfNode *node)
 {
   icfMesh_remNode(node->mesh, node);
 
-  //if (node->bdry[0] != NULL)
-  //  icfBdry_remNode(node->bdry[0], node);
-  //else if (node->bdry[1] != NULL)
-  //  icfBdry_remNode(node->bdry[1], node);
+  /*-------------------------------------------------------
+  | Refinement nodes of boundary edges are listed twice 
+  | on the same boundary
+  -------------------------------------------------------*/
+  if (node->bdry[0] != NULL)
+    icfBdry_remNode(node->bdry[0], node);
+  if (node->bdry[1] != NULL)
+    icfBdry_remNode(node->bdry[1], node);
+
+  ICF_PROF_ADD(ICF_PROF_NODES_FREED, 1);
+  ICF_PROF_ADD(ICF_PROF_BYTES_FREED, sizeof(icfNode));
 
-  free(node);
+  if (!ICF_MESH_INSLAB(node, node->mesh->nodeSlab, 
+                       node->mesh->nNodeSlab))
+    icfMem_free(ICF_MEM_NODES, node, sizeof(icfNode));
   return 0;
 } /* icfNode_destroy() */
@@ -0,0 +1,758 @@
+/*
+ * This source file is part of the incomflow library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdint.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshSnapshot.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfProf.h"
+
+/**********************************************************
+* Function: icfOutput_clearCellFields
+*----------------------------------------------------------
+* Frees the cell fields of a frame, except for the first
+* <nKeep> fields
+*----------------------------------------------------------
+* @param: frame - frame to clear
+* @param: nKeep - number of fields to keep
+**********************************************************/
+static void icfOutput_clearCellFields(icfOutputFrame *frame,
+                                      int             nKeep)
+{
+  int i;
+
+  for (i = nKeep; i < frame->nCellFields; i++)
+    free(frame->cellFields[i]);
+
+  if (nKeep < frame->nCellFields)
+    frame->nCellFields = nKeep;
+
+  if (frame->nCellFields > 0)
+    return;
+
+  free(frame->cellFields);
+  free(frame->cellFieldNames);
+
+  frame->cellFields     = NULL;
+  frame->cellFieldNames = NULL;
+  frame->nCellFields    = 0;
+
+} /* icfOutput_clearCellFields() */
+
+/**********************************************************
+* Function: icfOutput_newCellField
+*----------------------------------------------------------
+* Appends an uninitialized cell field to a frame
+*----------------------------------------------------------
+* @param: frame - frame to add the field to
+* @param: name  - field name
+* @param: size  - number of values to allocate, at least
+*                 the number of triangles of the frame
+* @return: pointer to the field values or NULL on errors
+**********************************************************/
+static icfDouble *icfOutput_newCellField(icfOutputFrame *frame,
+                                         const char     *name,
+                                         icfIndex        size)
+{
+  int n = frame->nCellFields;
+
+  icfDouble **fields = realloc(frame->cellFields, 
+      (n+1)*sizeof(icfDouble*));
+  check_mem(fields);
+  frame->cellFields = fields;
+
+  char (*names)[ICF_OUTPUT_NAMELEN] = realloc(frame->cellFieldNames,
+      (n+1)*ICF_OUTPUT_NAMELEN);
+  check_mem(names);
+  frame->cellFieldNames = names;
+
+  fields[n] = (icfDouble*) malloc((size+1)*sizeof(icfDouble));
+  check_mem(fields[n]);
+
+  memset(names[n], 0, ICF_OUTPUT_NAMELEN);
+  strncpy(names[n], name, ICF_OUTPUT_NAMELEN-1);
+
+  frame->nCellFields += 1;
+
+  return fields[n];
+error:
+  return NULL;
+
+} /* icfOutput_newCellField() */
+
+/**********************************************************
+* Function: icfOutput_levelField
+*----------------------------------------------------------
+* Returns the "level" field of a resized frame. The field
+* is always the first cell field of a captured frame and 
+* is kept with the capacity of the triangle buffers, 
+* such that it is only allocated, if the frame grows.
+*----------------------------------------------------------
+* @param: frame - frame after icfOutput_resizeFrame()
+* @return: pointer to the field values or NULL on errors
+**********************************************************/
+static icfDouble *icfOutput_levelField(icfOutputFrame *frame)
+{
+  if (frame->nCellFields > 0)
+    return frame->cellFields[0];
+
+  return icfOutput_newCellField(frame, "level", frame->nTrisAlloc);
+
+} /* icfOutput_levelField() */
+
+/**********************************************************
+* Function: icfOutput_resizeFrame
+*----------------------------------------------------------
+* Sets the number of nodes and triangles of a frame,
+* grows its buffers if required and clears its cell 
+* fields, except for the "level" field
+*----------------------------------------------------------
+* @param: frame  - frame to resize
+* @param: nNodes - number of nodes
+* @param: nTris  - number of triangles
+* @return: 0 on success, -1 on errors
+**********************************************************/
+static int icfOutput_resizeFrame(icfOutputFrame *frame,
+                                 icfIndex        nNodes,
+                                 icfIndex        nTris)
+{
+  /*-------------------------------------------------------
+  | Grow buffers if required
+  -------------------------------------------------------*/
+  if (nNodes > frame->nNodesAlloc)
+  {
+    icfDouble (*xy)[2] = realloc(frame->xy,
+        nNodes*2*sizeof(icfDouble));
+    check_mem(xy);
+    frame->xy = xy;
+
+    icfDouble *vol = realloc(frame->vol,
+        nNodes*sizeof(icfDouble));
+    check_mem(vol);
+    frame->vol = vol;
+
+    frame->nNodesAlloc = nNodes;
+  }
+
+  if (nTris > frame->nTrisAlloc)
+  {
+    icfIndex (*tris)[3] = realloc(frame->tris,
+        nTris*3*sizeof(icfIndex));
+    check_mem(tris);
+    frame->tris = tris;
+
+    icfIndex (*triNbrs)[3] = realloc(frame->triNbrs,
+        nTris*3*sizeof(icfIndex));
+    check_mem(triNbrs);
+    frame->triNbrs = triNbrs;
+
+    if (frame->nCellFields > 0)
+    {
+      icfDouble *level = realloc(frame->cellFields[0],
+          (nTris+1)*sizeof(icfDouble));
+      check_mem(level);
+      frame->cellFields[0] = level;
+    }
+
+    frame->nTrisAlloc = nTris;
+  }
+
+  frame->nNodes = nNodes;
+  frame->nTris  = nTris;
+
+  icfOutput_clearCellFields(frame, 1);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfOutput_resizeFrame() */
+
+/**********************************************************
+* Function: icfOutput_captureFrame
+*----------------------------------------------------------
+* Copies the leaf data of a mesh into a frame
+* The mesh must have been updated before.
+*----------------------------------------------------------
+* @param: frame - frame to write data to
+* @param: mesh  - mesh to capture
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_captureFrame(icfOutputFrame *frame,
+                           icfMesh        *mesh)
+{
+  icfIndex i;
+  int      j;
+  icfIndex nNodes = mesh->nNodes;
+  icfIndex nTris  = mesh->nTriLeafs;
+
+  check(icfOutput_resizeFrame(frame, nNodes, nTris) == 0,
+      "Failed to resize output frame.");
+
+  /*-------------------------------------------------------
+  | Copy node data
+  -------------------------------------------------------*/
+  for (i = 0; i < nNodes; i++)
+  {
+    icfNode *n = mesh->nodes[i];
+    frame->xy[i][0] = n->xy[0];
+    frame->xy[i][1] = n->xy[1];
+    frame->vol[i]   = n->vol;
+  }
+
+  /*-------------------------------------------------------
+  | Copy triangle data
+  | -> The neighbor t[j] is located opposite of n[j],
+  |    which is the edge e[(j+1)%3]
+  -------------------------------------------------------*/
+  for (i = 0; i < nTris; i++)
+  {
+    icfTri *t = mesh->triLeafs[i];
+
+    for (j = 0; j < 3; j++)
+    {
+      frame->tris[i][j] = t->n[j]->index;
+
+      if (t->t[j] != NULL)
+        frame->triNbrs[i][j] = t->t[j]->cold->leafPos;
+      else if (t->e[(j+1)%3]->cold->bdry != NULL)
+        frame->triNbrs[i][j] = -t->e[(j+1)%3]->cold->bdry->marker;
+      else
+        frame->triNbrs[i][j] = ICF_OUTPUT_NOBDRY;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Refinement level of the triangles
+  -------------------------------------------------------*/
+  icfDouble *level = icfOutput_levelField(frame);
+  check(level != NULL, "Failed to capture cell field.");
+
+  for (i = 0; i < nTris; i++)
+    level[i] = (icfDouble) mesh->triLeafs[i]->cold->treeLevel;
+
+  return 0;
+error:
+  return -1;
+
+} /* icfOutput_captureFrame() */
+
+/**********************************************************
+* Function: icfOutput_captureSnapshot
+*----------------------------------------------------------
+* Copies the data of a mesh snapshot into a frame, which
+* yields the same frame as icfOutput_captureFrame() at
+* the time of the snapshot
+*----------------------------------------------------------
+* @param: frame - frame to write data to
+* @param: snap  - snapshot to capture
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_captureSnapshot(icfOutputFrame        *frame,
+                              const icfMeshSnapshot *snap)
+{
+  icfIndex i;
+  int      j;
+
+  check(icfOutput_resizeFrame(frame, snap->nNodes, snap->nTris) == 0,
+      "Failed to resize output frame.");
+
+  for (i = 0; i < snap->nNodes; i++)
+  {
+    const icfDouble *xy = icfMeshSnapshot_nodeXY(snap, i);
+    frame->xy[i][0] = xy[0];
+    frame->xy[i][1] = xy[1];
+    frame->vol[i]   = icfMeshSnapshot_nodeVol(snap, i);
+  }
+
+  for (i = 0; i < snap->nTris; i++)
+  {
+    const icfIndex *tri  = icfMeshSnapshot_triNodes(snap, i);
+    const icfIndex *nbrs = icfMeshSnapshot_triNbrs(snap, i);
+
+    for (j = 0; j < 3; j++)
+    {
+      frame->tris[i][j]    = tri[j];
+      frame->triNbrs[i][j] = nbrs[j];
+    }
+  }
+
+  icfDouble *level = icfOutput_levelField(frame);
+  check(level != NULL, "Failed to capture cell field.");
+
+  for (i = 0; i < snap->nTris; i++)
+    level[i] = (icfDouble) icfMeshSnapshot_triLevel(snap, i);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfOutput_captureSnapshot() */
+
+/**********************************************************
+* Function: icfOutput_writeFrame
+*----------------------------------------------------------
+* Writes a frame to a text file, that can be read with
+* icfIO_readMesh()
+*----------------------------------------------------------
+* @param: frame - frame to write
+* @param: path  - output file path
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_writeFrame(const icfOutputFrame *frame,
+                         const char           *path)
+{
+  icfIndex i;
+
+  FILE *fptr = fopen(path, "w");
+  check(fptr, "Failed to open %s.", path);
+
+  fprintf(fptr, "NODES %" ICF_PRIdx "\n", frame->nNodes);
+  for (i = 0; i < frame->nNodes; i++)
+    fprintf(fptr, "%" ICF_PRIdx "\t%.16e\t%.16e\n",
+        i, frame->xy[i][0], frame->xy[i][1]);
+
+  fprintf(fptr, "TRIANGLES %" ICF_PRIdx "\n", frame->nTris);
+  for (i = 0; i < frame->nTris; i++)
+    fprintf(fptr, "%" ICF_PRIdx "\t%" ICF_PRIdx "\t%" ICF_PRIdx
+        "\t%" ICF_PRIdx "\n", i,
+        frame->tris[i][0], frame->tris[i][1], frame->tris[i][2]);
+
+  fprintf(fptr, "NEIGHBORS %" ICF_PRIdx "\n", frame->nTris);
+  for (i = 0; i < frame->nTris; i++)
+    fprintf(fptr, "%" ICF_PRIdx "\t%" ICF_PRIdx "\t%" ICF_PRIdx
+        "\t%" ICF_PRIdx "\n", i,
+        frame->triNbrs[i][0], frame->triNbrs[i][1],
+        frame->triNbrs[i][2]);
+
+  check(fclose(fptr) == 0, "Failed to write %s.", path);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfOutput_writeFrame() */
+
+/**********************************************************
+* Function: icfOutput_addCellField
+*----------------------------------------------------------
+* Adds a copy of a cell field to a captured frame
+*----------------------------------------------------------
+* @param: frame  - captured frame
+* @param: name   - field name
+* @param: values - one value for every triangle leaf
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_addCellField(icfOutputFrame  *frame,
+                           const char      *name,
+                           const icfDouble *values)
+{
+  icfDouble *field = icfOutput_newCellField(frame, name, frame->nTris);
+  check(field != NULL, "Failed to add cell field %s.", name);
+
+  memcpy(field, values, frame->nTris*sizeof(icfDouble));
+
+  return 0;
+error:
+  return -1;
+
+} /* icfOutput_addCellField() */
+
+/**********************************************************
+* Function: icfOutput_writeFrameBinary
+*----------------------------------------------------------
+* Writes a frame to a binary leaf mesh dump.
+* Every array is written with a single fwrite() call.
+*----------------------------------------------------------
+* @param: frame - frame to write
+* @param: path  - output file path
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_writeFrameBinary(const icfOutputFrame *frame,
+                               const char           *path)
+{
+  int     i;
+  size_t  nNodes = frame->nNodes;
+  size_t  nTris  = frame->nTris;
+  char    header[64];
+  char    nodeFieldName[ICF_OUTPUT_NAMELEN];
+
+  int32_t hdrInt[6] = { ICF_OUTPUT_BINVERSION, 
+                        sizeof(icfDouble), sizeof(icfIndex),
+                        1, frame->nCellFields, 0 };
+  int64_t hdrLong[4] = { frame->step, frame->nNodes, 
+                         frame->nTris, 0 };
+
+  FILE *fptr = fopen(path, "wb");
+  check(fptr, "Failed to open %s.", path);
+
+  /*-------------------------------------------------------
+  | Header and field names
+  -------------------------------------------------------*/
+  memset(header, 0, 64);
+  memcpy(header,      ICF_OUTPUT_MAGIC, strlen(ICF_OUTPUT_MAGIC));
+  memcpy(header + 8,  hdrInt,  sizeof(hdrInt));
+  memcpy(header + 32, hdrLong, sizeof(hdrLong));
+
+  memset(nodeFieldName, 0, ICF_OUTPUT_NAMELEN);
+  strcpy(nodeFieldName, "vol");
+
+  check(fwrite(header, 1, 64, fptr) == 64, 
+      "Failed to write %s.", path);
+  check(fwrite(nodeFieldName, ICF_OUTPUT_NAMELEN, 1, fptr) == 1,
+      "Failed to write %s.", path);
+  if (frame->nCellFields > 0)
+    check(fwrite(frame->cellFieldNames, ICF_OUTPUT_NAMELEN, 
+          frame->nCellFields, fptr) == (size_t) frame->nCellFields,
+        "Failed to write %s.", path);
+
+  /*-------------------------------------------------------
+  | Leaf data
+  -------------------------------------------------------*/
+  check(fwrite(frame->xy, 2*sizeof(icfDouble), nNodes, fptr) == nNodes
+     && fwrite(frame->tris, 3*sizeof(icfIndex), nTris, fptr) == nTris
+     && fwrite(frame->triNbrs, 3*sizeof(icfIndex), nTris, fptr) == nTris
+     && fwrite(frame->vol, sizeof(icfDouble), nNodes, fptr) == nNodes,
+      "Failed to write %s.", path);
+
+  for (i = 0; i < frame->nCellFields; i++)
+    check(fwrite(frame->cellFields[i], sizeof(icfDouble), 
+          nTris, fptr) == nTris, "Failed to write %s.", path);
+
+  check(fclose(fptr) == 0, "Failed to write %s.", path);
+
+  return 0;
+error:
+  if (fptr != NULL)
+    fclose(fptr);
+  return -1;
+
+} /* icfOutput_writeFrameBinary() */
+
+/**********************************************************
+* Function: icfOutput_dumpMesh
+*----------------------------------------------------------
+* Writes the leaf data of a mesh to a binary leaf mesh 
+* dump. The mesh must have been updated before.
+*----------------------------------------------------------
+* @param: mesh - mesh to write
+* @param: path - output file path
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_dumpMesh(icfMesh    *mesh,
+                       const char *path)
+{
+  icfOutputFrame frame;
+  memset(&frame, 0, sizeof(icfOutputFrame));
+
+  check(icfOutput_captureFrame(&frame, mesh) == 0,
+      "Failed to capture mesh.");
+  check(icfOutput_writeFrameBinary(&frame, path) == 0,
+      "Failed to dump mesh to %s.", path);
+
+  icfOutput_clearFrame(&frame);
+
+  return 0;
+error:
+  icfOutput_clearFrame(&frame);
+  return -1;
+
+} /* icfOutput_dumpMesh() */
+
+/**********************************************************
+* Function: icfOutput_clearFrame
+*----------------------------------------------------------
+* Frees all buffers of a frame
+*----------------------------------------------------------
+* @param: frame - frame to clear
+**********************************************************/
+void icfOutput_clearFrame(icfOutputFrame *frame)
+{
+  free(frame->xy);
+  free(frame->vol);
+  free(frame->tris);
+  free(frame->triNbrs);
+  free(frame->path);
+
+  icfOutput_clearCellFields(frame, 0);
+
+  frame->xy          = NULL;
+  frame->vol         = NULL;
+  frame->tris        = NULL;
+  frame->triNbrs     = NULL;
+  frame->path        = NULL;
+  frame->nNodes      = 0;
+  frame->nNodesAlloc = 0;
+  frame->nTris       = 0;
+  frame->nTrisAlloc  = 0;
+
+} /* icfOutput_clearFrame() */
+
+/**********************************************************
+* Function: icfOutput_writerLoop
+*----------------------------------------------------------
+* Main function of the writer thread.
+* Writes queued frames until the writer is stopped and
+* no more frames are queued.
+*----------------------------------------------------------
+* @param: arg - pointer to writer structure
+**********************************************************/
+static void *icfOutput_writerLoop(void *arg)
+{
+  icfOutputWriter *writer = (icfOutputWriter*)arg;
+
+  while (TRUE)
+  {
+    /*-----------------------------------------------------
+    | Wait for a queued frame
+    -----------------------------------------------------*/
+    pthread_mutex_lock(&writer->lock);
+
+    while (writer->count == 0 && writer->stop == FALSE)
+      pthread_cond_wait(&writer->notEmpty, &writer->lock);
+
+    if (writer->count == 0 && writer->stop == TRUE)
+    {
+      pthread_mutex_unlock(&writer->lock);
+      break;
+    }
+
+    icfOutputFrame *frame = &writer->frames[writer->head];
+
+    pthread_mutex_unlock(&writer->lock);
+
+    /*-----------------------------------------------------
+    | Write the frame without holding the lock,
+    | since the solver thread does not touch queued frames
+    -----------------------------------------------------*/
+    ICF_PROF_BEGIN(write, "icfOutput_write");
+
+    int status = (writer->binary == TRUE)
+      ? icfOutput_writeFrameBinary(frame, frame->path)
+      : icfOutput_writeFrame(frame, frame->path);
+
+    ICF_PROF_END(write);
+
+    if (status != 0)
+      log_err("Failed to write snapshot %" ICF_PRIdx ".", frame->step);
+
+    /*-----------------------------------------------------
+    | Release the frame
+    -----------------------------------------------------*/
+    pthread_mutex_lock(&writer->lock);
+
+    writer->head      = (writer->head + 1) % writer->nSlots;
+    writer->count    -= 1;
+    writer->nWritten += 1;
+
+    pthread_cond_broadcast(&writer->notFull);
+    pthread_mutex_unlock(&writer->lock);
+  }
+
+  return NULL;
+
+} /* icfOutput_writerLoop() */
+
+/**********************************************************
+* Function: icfOutput_createWriter
+*----------------------------------------------------------
+* Create a new asynchronous writer and start its
+* background thread.
+* Snapshots are written to "<prefix>_<step>.dat" or to 
+* "<prefix>_<step>.bin" for binary writers
+*----------------------------------------------------------
+* @param: prefix - prefix of output files
+* @param: nSlots - number of staging frames (>= 1)
+*                  2 gives a double-buffered writer
+* @return: pointer to new writer structure
+**********************************************************/
+icfOutputWriter *icfOutput_createWriter(const char *prefix,
+                                        int         nSlots)
+{
+  icfOutputWriter *writer = NULL;
+
+  check(nSlots > 0, "Output writer requires at least one slot.");
+
+  writer = (icfOutputWriter*) calloc(1, sizeof(icfOutputWriter));
+  check_mem(writer);
+
+  writer->prefix = (char*) malloc(strlen(prefix) + 1);
+  check_mem(writer->prefix);
+  strcpy(writer->prefix, prefix);
+
+  /*-------------------------------------------------------
+  | Ring buffer of frames
+  -------------------------------------------------------*/
+  writer->nSlots = nSlots;
+  writer->frames = (icfOutputFrame*) calloc(nSlots,
+      sizeof(icfOutputFrame));
+  check_mem(writer->frames);
+
+  writer->head   = 0;
+  writer->count  = 0;
+  writer->stop   = FALSE;
+  writer->binary = FALSE;
+
+  /*-------------------------------------------------------
+  | Writer thread
+  -------------------------------------------------------*/
+  pthread_mutex_init(&writer->lock, NULL);
+  pthread_cond_init(&writer->notEmpty, NULL);
+  pthread_cond_init(&writer->notFull, NULL);
+
+  if (pthread_create(&writer->thread, NULL,
+                     icfOutput_writerLoop, writer) != 0)
+  {
+    pthread_cond_destroy(&writer->notFull);
+    pthread_cond_destroy(&writer->notEmpty);
+    pthread_mutex_destroy(&writer->lock);
+    sentinel("Failed to start output writer thread.");
+  }
+
+  return writer;
+error:
+  if (writer != NULL)
+  {
+    free(writer->frames);
+    free(writer->prefix);
+    free(writer);
+  }
+  return NULL;
+
+} /* icfOutput_createWriter() */
+
+/**********************************************************
+* Function: icfOutput_destroyWriter
+*----------------------------------------------------------
+* Writes all queued frames, stops the writer thread
+* and frees the writer
+*----------------------------------------------------------
+* @param: writer - pointer to writer structure
+* @return: returns 0 on success
+**********************************************************/
+int icfOutput_destroyWriter(icfOutputWriter *writer)
+{
+  int i;
+
+  pthread_mutex_lock(&writer->lock);
+  writer->stop = TRUE;
+  pthread_cond_broadcast(&writer->notEmpty);
+  pthread_mutex_unlock(&writer->lock);
+
+  pthread_join(writer->thread, NULL);
+
+  pthread_mutex_destroy(&writer->lock);
+  pthread_cond_destroy(&writer->notEmpty);
+  pthread_cond_destroy(&writer->notFull);
+
+  for (i = 0; i < writer->nSlots; i++)
+    icfOutput_clearFrame(&writer->frames[i]);
+
+  free(writer->frames);
+  free(writer->prefix);
+  free(writer);
+
+  return 0;
+
+} /* icfOutput_destroyWriter() */
+
+/**********************************************************
+* Function: icfOutput_pushMesh
+*----------------------------------------------------------
+* Stages the leaf data of a mesh in a free frame and
+* queues it for writing.
+* Blocks if all frames of the writer are queued.
+*----------------------------------------------------------
+* @param: writer - pointer to writer structure
+* @param: mesh   - mesh to write
+* @param: step   - time step of the snapshot
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfOutput_pushMesh(icfOutputWriter *writer,
+                       icfMesh         *mesh,
+                       icfIndex         step)
+{
+  ICF_PROF_BEGIN(push, "icfOutput_pushMesh");
+
+  /*-------------------------------------------------------
+  | Wait for a free frame (back-pressure)
+  -------------------------------------------------------*/
+  pthread_mutex_lock(&writer->lock);
+
+  if (writer->count == writer->nSlots)
+    writer->nStalls += 1;
+
+  while (writer->count == writer->nSlots)
+    pthread_cond_wait(&writer->notFull, &writer->lock);
+
+  int iSlot = (writer->head + writer->count) % writer->nSlots;
+  icfOutputFrame *frame = &writer->frames[iSlot];
+
+  pthread_mutex_unlock(&writer->lock);
+
+  /*-------------------------------------------------------
+  | Stage mesh data - the writer thread does not touch
+  | frames, which are not queued
+  -------------------------------------------------------*/
+  int pathLen = strlen(writer->prefix) + 32;
+  char *path  = (char*) realloc(frame->path, pathLen);
+  check_mem(path);
+  frame->path = path;
+  snprintf(frame->path, pathLen, "%s_%06" ICF_PRIdx ".%s",
+      writer->prefix, step, (writer->binary == TRUE) ? "bin" : "dat");
+
+  frame->step = step;
+
+  check(icfOutput_captureFrame(frame, mesh) == 0,
+      "Failed to capture snapshot %" ICF_PRIdx ".", step);
+
+  /*-------------------------------------------------------
+  | Queue the frame
+  -------------------------------------------------------*/
+  pthread_mutex_lock(&writer->lock);
+
+  writer->count   += 1;
+  writer->nQueued += 1;
+
+  pthread_cond_signal(&writer->notEmpty);
+  pthread_mutex_unlock(&writer->lock);
+
+  ICF_PROF_END(push);
+  return 0;
+error:
+  ICF_PROF_END(push);
+  return -1;
+
+} /* icfOutput_pushMesh() */
+
+/**********************************************************
+* Function: icfOutput_flush
+*----------------------------------------------------------
+* Blocks until all queued frames have been written
+*----------------------------------------------------------
+* @param: writer - pointer to writer structure
+**********************************************************/
+void icfOutput_flush(icfOutputWriter *writer)
+{
+  pthread_mutex_lock(&writer->lock);
+
+  while (writer->count > 0)
+    pthread_cond_wait(&writer->notFull, &writer->lock);
+
+  pthread_mutex_unlock(&writer->lock);
+
+} /* icfOutput_flush() */
@@ -0,0 +1,465 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfProf.h"
+#include "incomflow/icfTrace.h"
+
+/**********************************************************
+* Global profiling state
+**********************************************************/
+int icfProf_active = 0;
+
+static icfProfTimer    icfProf_timers[ICF_PROF_MAXTIMERS];
+static int             icfProf_nTimers = 0;
+static int64_t         icfProf_counters[ICF_PROF_NCOUNTERS];
+static pthread_mutex_t icfProf_lock = PTHREAD_MUTEX_INITIALIZER;
+static icfBool         icfProf_atExit = FALSE;
+
+static const char *icfProf_counterNames[ICF_PROF_NCOUNTERS] = {
+  "edge_splits",
+  "edge_merges",
+  "nodes_created",
+  "nodes_freed",
+  "edges_created",
+  "edges_freed",
+  "tris_created",
+  "tris_freed",
+  "bytes_allocated",
+  "bytes_freed",
+  "tri_leafs",
+  "edge_leafs",
+};
+
+/**********************************************************
+* Per-thread stack of running timers
+**********************************************************/
+typedef struct icfProfFrame {
+  int      id;
+  int64_t  start;
+  int64_t  childNs;
+  int64_t  hw[ICF_PROF_NHW];
+} icfProfFrame;
+
+static __thread icfProfFrame icfProf_stack[ICF_PROF_MAXDEPTH];
+static __thread int          icfProf_depth = 0;
+
+/**********************************************************
+* Function: icfProf_now
+*----------------------------------------------------------
+* @return: monotonic time stamp in nanoseconds
+**********************************************************/
+int64_t icfProf_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+
+} /* icfProf_now() */
+
+/**********************************************************
+* Function: icfProf_exitReport
+*----------------------------------------------------------
+* Report function, which is registered with atexit()
+**********************************************************/
+static void icfProf_exitReport(void)
+{
+  icfProf_report(stderr);
+
+} /* icfProf_exitReport() */
+
+/**********************************************************
+* Function: icfProf_enable
+*----------------------------------------------------------
+* Enables the profiling hooks
+*----------------------------------------------------------
+* @param: reportAtExit - if TRUE, a report is printed to 
+*                        stderr when the program exits
+**********************************************************/
+void icfProf_enable(icfBool reportAtExit)
+{
+  pthread_mutex_lock(&icfProf_lock);
+
+  if (reportAtExit == TRUE && icfProf_atExit == FALSE)
+  {
+    if (atexit(icfProf_exitReport) == 0)
+      icfProf_atExit = TRUE;
+    else
+      log_warn("Failed to register profiling report at exit.");
+  }
+
+  pthread_mutex_unlock(&icfProf_lock);
+
+  icfProf_setFlags(ICF_PROF_TIMERS, TRUE);
+
+} /* icfProf_enable() */
+
+/**********************************************************
+* Function: icfProf_disable
+*----------------------------------------------------------
+* Disables the profiling hooks. Accumulated data is kept.
+**********************************************************/
+void icfProf_disable(void)
+{
+  icfProf_setFlags(ICF_PROF_TIMERS, FALSE);
+
+} /* icfProf_disable() */
+
+/**********************************************************
+* Function: icfProf_setFlags
+*----------------------------------------------------------
+* Sets or clears runtime switches ICF_PROF_TIMERS 
+* and ICF_PROF_TRACE
+*----------------------------------------------------------
+* @param: flags - switches to modify
+* @param: on    - TRUE to set, FALSE to clear
+**********************************************************/
+void icfProf_setFlags(int flags, icfBool on)
+{
+  if (on == TRUE)
+    __atomic_or_fetch(&icfProf_active, flags, __ATOMIC_RELEASE);
+  else
+    __atomic_and_fetch(&icfProf_active, ~flags, __ATOMIC_RELEASE);
+
+} /* icfProf_setFlags() */
+
+/**********************************************************
+* Function: icfProf_reset
+*----------------------------------------------------------
+* Resets all timers and counters to zero. 
+* Registered timer names are kept.
+**********************************************************/
+void icfProf_reset(void)
+{
+  int i, j;
+
+  pthread_mutex_lock(&icfProf_lock);
+
+  for (i = 0; i < ICF_PROF_MAXTIMERS; i++)
+  {
+    __atomic_store_n(&icfProf_timers[i].calls,   0, __ATOMIC_RELAXED);
+    __atomic_store_n(&icfProf_timers[i].totalNs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&icfProf_timers[i].selfNs,  0, __ATOMIC_RELAXED);
+
+    for (j = 0; j < ICF_PROF_NHW; j++)
+      __atomic_store_n(&icfProf_timers[i].hw[j], -1, __ATOMIC_RELAXED);
+  }
+
+  for (i = 0; i < ICF_PROF_NCOUNTERS; i++)
+    __atomic_store_n(&icfProf_counters[i], 0, __ATOMIC_RELAXED);
+
+  pthread_mutex_unlock(&icfProf_lock);
+
+} /* icfProf_reset() */
+
+/**********************************************************
+* Function: icfProf_find
+*----------------------------------------------------------
+* Returns the id of a registered timer or -1
+* The lock must be held by the caller
+**********************************************************/
+static int icfProf_find(const char *name)
+{
+  int i;
+
+  for (i = 0; i < icfProf_nTimers; i++)
+    if (strncmp(icfProf_timers[i].name, name, ICF_PROF_NAMELEN-1) == 0)
+      return i;
+
+  return -1;
+
+} /* icfProf_find() */
+
+/**********************************************************
+* Function: icfProf_register
+*----------------------------------------------------------
+* Returns the timer id for a name and registers the 
+* timer, if it does not exist yet
+*----------------------------------------------------------
+* @param: name - timer name
+* @return: timer id, -1 if all timer slots are in use
+**********************************************************/
+int icfProf_register(const char *name)
+{
+  int id;
+
+  pthread_mutex_lock(&icfProf_lock);
+
+  id = icfProf_find(name);
+
+  if (id < 0 && icfProf_nTimers < ICF_PROF_MAXTIMERS)
+  {
+    id = icfProf_nTimers++;
+    strncpy(icfProf_timers[id].name, name, ICF_PROF_NAMELEN-1);
+    memset(icfProf_timers[id].hw, 0xFF, sizeof(icfProf_timers[id].hw));
+  }
+  else if (id < 0)
+    log_warn("Too many profiling timers - %s is not timed.", name);
+
+  pthread_mutex_unlock(&icfProf_lock);
+
+  return id;
+
+} /* icfProf_register() */
+
+/**********************************************************
+* Function: icfProf_begin
+*----------------------------------------------------------
+* Starts a timer in the calling thread
+*----------------------------------------------------------
+* @param: id - timer id of icfProf_register()
+* @return: TRUE, if a timer frame was pushed
+**********************************************************/
+int icfProf_begin(int id)
+{
+  icfProfFrame *frame;
+
+  if (id < 0 || icfProf_depth >= ICF_PROF_MAXDEPTH)
+    return FALSE;
+
+  frame = &icfProf_stack[icfProf_depth++];
+  frame->id      = id;
+  frame->childNs = 0;
+
+  if ((icfProf_active & (ICF_PROF_TIMERS|ICF_PROF_HW)) 
+      == (ICF_PROF_TIMERS|ICF_PROF_HW))
+    icfProf_readHW(frame->hw);
+
+  frame->start   = icfProf_now();
+
+  return TRUE;
+
+} /* icfProf_begin() */
+
+/**********************************************************
+* Function: icfProf_end
+*----------------------------------------------------------
+* Stops a timer in the calling thread and passes the 
+* timed scope to the event tracer, if tracing is active
+*----------------------------------------------------------
+* @param: id - timer id of icfProf_register()
+**********************************************************/
+void icfProf_end(int id)
+{
+  icfProfFrame *frame;
+  int64_t       elapsed;
+
+  if ( id < 0 || icfProf_depth < 1 
+      || icfProf_stack[icfProf_depth-1].id != id )
+    return;
+
+  frame   = &icfProf_stack[--icfProf_depth];
+  elapsed = icfProf_now() - frame->start;
+
+  if (icfProf_active & ICF_PROF_TIMERS)
+  {
+    __atomic_fetch_add(&icfProf_timers[id].calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&icfProf_timers[id].totalNs, elapsed, 
+                       __ATOMIC_RELAXED);
+    __atomic_fetch_add(&icfProf_timers[id].selfNs, 
+                       elapsed - frame->childNs, __ATOMIC_RELAXED);
+  }
+
+  /*-------------------------------------------------------
+  | Hardware counters - unavailable events remain at -1
+  -------------------------------------------------------*/
+  if ((icfProf_active & (ICF_PROF_TIMERS|ICF_PROF_HW)) 
+      == (ICF_PROF_TIMERS|ICF_PROF_HW))
+  {
+    int64_t hw[ICF_PROF_NHW];
+    int64_t unset = -1;
+    int     i;
+
+    icfProf_readHW(hw);
+
+    for (i = 0; i < ICF_PROF_NHW; i++)
+    {
+      if (hw[i] < 0 || frame->hw[i] < 0)
+        continue;
+
+      __atomic_compare_exchange_n(&icfProf_timers[id].hw[i], &unset, 0,
+          FALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&icfProf_timers[id].hw[i], hw[i] - frame->hw[i],
+                         __ATOMIC_RELAXED);
+      unset = -1;
+    }
+  }
+
+  if (icfProf_active & ICF_PROF_TRACE)
+    icfTrace_record(icfProf_timers[id].name, frame->start, elapsed);
+
+  if (icfProf_depth > 0)
+    icfProf_stack[icfProf_depth-1].childNs += elapsed;
+
+} /* icfProf_end() */
+
+/**********************************************************
+* Function: icfProf_add / icfProf_set
+*----------------------------------------------------------
+* Adds a value to a counter or overwrites it
+**********************************************************/
+void icfProf_add(icfProfCounter counter, int64_t value)
+{
+  __atomic_fetch_add(&icfProf_counters[counter], value, 
+                     __ATOMIC_RELAXED);
+
+} /* icfProf_add() */
+
+void icfProf_set(icfProfCounter counter, int64_t value)
+{
+  __atomic_store_n(&icfProf_counters[counter], value, 
+                   __ATOMIC_RELAXED);
+
+} /* icfProf_set() */
+
+/**********************************************************
+* Function: icfProf_getCounter
+*----------------------------------------------------------
+* @return: current value of a counter
+**********************************************************/
+int64_t icfProf_getCounter(icfProfCounter counter)
+{
+  return __atomic_load_n(&icfProf_counters[counter], __ATOMIC_RELAXED);
+
+} /* icfProf_getCounter() */
+
+/**********************************************************
+* Function: icfProf_getTimer
+*----------------------------------------------------------
+* Copies the accumulated data of a named timer
+*----------------------------------------------------------
+* @param: name  - timer name
+* @param: timer - structure to copy the data to
+* @return: 0 on success, -1 if the timer does not exist
+**********************************************************/
+int icfProf_getTimer(const char *name, icfProfTimer *timer)
+{
+  int id;
+
+  pthread_mutex_lock(&icfProf_lock);
+  id = icfProf_find(name);
+
+  if (id >= 0)
+  {
+    memcpy(timer->name, icfProf_timers[id].name, ICF_PROF_NAMELEN);
+    timer->calls   = __atomic_load_n(&icfProf_timers[id].calls, 
+                                     __ATOMIC_RELAXED);
+    timer->totalNs = __atomic_load_n(&icfProf_timers[id].totalNs, 
+                                     __ATOMIC_RELAXED);
+    timer->selfNs  = __atomic_load_n(&icfProf_timers[id].selfNs, 
+                                     __ATOMIC_RELAXED);
+    memcpy(timer->hw, icfProf_timers[id].hw, sizeof(timer->hw));
+  }
+
+  pthread_mutex_unlock(&icfProf_lock);
+
+  return (id >= 0) ? 0 : -1;
+
+} /* icfProf_getTimer() */
+
+/**********************************************************
+* Function: icfProf_getTimers
+*----------------------------------------------------------
+* Copies the data of all registered timers
+*----------------------------------------------------------
+* @param: timers    - array to copy the data to
+* @param: maxTimers - size of the array
+* @return: number of copied timers
+**********************************************************/
+int icfProf_getTimers(icfProfTimer *timers, int maxTimers)
+{
+  int i, n;
+
+  pthread_mutex_lock(&icfProf_lock);
+
+  n = (icfProf_nTimers < maxTimers) ? icfProf_nTimers : maxTimers;
+
+  for (i = 0; i < n; i++)
+    memcpy(&timers[i], &icfProf_timers[i], sizeof(icfProfTimer));
+
+  pthread_mutex_unlock(&icfProf_lock);
+
+  return n;
+
+} /* icfProf_getTimers() */
+
+/**********************************************************
+* Function: icfProf_counterName
+*----------------------------------------------------------
+* @return: name of a counter
+**********************************************************/
+const char *icfProf_counterName(icfProfCounter counter)
+{
+  if (counter < 0 || counter >= ICF_PROF_NCOUNTERS)
+    return "unknown";
+
+  return icfProf_counterNames[counter];
+
+} /* icfProf_counterName() */
+
+/**********************************************************
+* Function: icfProf_report
+*----------------------------------------------------------
+* Prints all timers with at least one call and all 
+* non-zero counters
+*----------------------------------------------------------
+* @param: fptr - output stream
+**********************************************************/
+void icfProf_report(FILE *fptr)
+{
+  int i, j;
+
+  pthread_mutex_lock(&icfProf_lock);
+
+  fprintf(fptr, "%-32s %12s %14s %14s %12s\n", 
+      "timer", "calls", "total [ms]", "self [ms]", "mean [us]");
+
+  for (i = 0; i < icfProf_nTimers; i++)
+  {
+    const icfProfTimer *t = &icfProf_timers[i];
+
+    if (t->calls < 1)
+      continue;
+
+    fprintf(fptr, "%-32s %12lld %14.3f %14.3f %12.3f\n", t->name,
+        (long long) t->calls, 
+        1.0e-6 * t->totalNs, 
+        1.0e-6 * t->selfNs,
+        1.0e-3 * t->totalNs / t->calls);
+
+    for (j = 0; j < ICF_PROF_NHW; j++)
+      if (t->hw[j] >= 0)
+        fprintf(fptr, "  %-30s %12lld\n", icfProf_hwName(j), 
+            (long long) t->hw[j]);
+
+    if ( t->hw[ICF_PROF_HW_CYCLES] > 0 
+        && t->hw[ICF_PROF_HW_INSTRUCTIONS] >= 0 )
+      fprintf(fptr, "  %-30s %12.3f\n", "ipc", 
+          (double) t->hw[ICF_PROF_HW_INSTRUCTIONS] 
+                 / t->hw[ICF_PROF_HW_CYCLES]);
+  }
+
+  fprintf(fptr, "%-32s %12s\n", "counter", "value");
+
+  for (i = 0; i < ICF_PROF_NCOUNTERS; i++)
+  {
+    if (icfProf_counters[i] == 0)
+      continue;
+
+    fprintf(fptr, "%-32s %12lld\n", icfProf_counterNames[i], 
+        (long long) icfProf_counters[i]);
+  }
+
+  pthread_mutex_unlock(&icfProf_lock);
+
+} /* icfProf_report() */
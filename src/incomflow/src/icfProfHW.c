@@ -0,0 +1,184 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfProf.h"
+
+static const char *icfProf_hwNames[ICF_PROF_NHW] = {
+  "cycles",
+  "instructions",
+  "cache_misses",
+  "branch_misses",
+  "page_faults",
+};
+
+/**********************************************************
+* Per-thread event file descriptors
+* icfProf_hwState: 0 -> not opened, 1 -> opened
+**********************************************************/
+static __thread int icfProf_hwFds[ICF_PROF_NHW];
+static __thread int icfProf_hwState = 0;
+static __thread int icfProf_hwCount = 0;
+
+/**********************************************************
+* Function: icfProf_hwName
+*----------------------------------------------------------
+* @return: name of a hardware event
+**********************************************************/
+const char *icfProf_hwName(icfProfHWEvent event)
+{
+  if (event < 0 || event >= ICF_PROF_NHW)
+    return "unknown";
+
+  return icfProf_hwNames[event];
+
+} /* icfProf_hwName() */
+
+#ifdef __linux__
+
+/**********************************************************
+* Function: icfProf_openHW
+*----------------------------------------------------------
+* Opens all events for the calling thread
+**********************************************************/
+static void icfProf_openHW(void)
+{
+  static const struct { uint32_t type; uint64_t config; } 
+  events[ICF_PROF_NHW] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES       },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS     },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES     },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES    },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS      },
+  };
+
+  int i;
+
+  icfProf_hwCount = 0;
+
+  for (i = 0; i < ICF_PROF_NHW; i++)
+  {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size           = sizeof(attr);
+    attr.type           = events[i].type;
+    attr.config         = events[i].config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED
+                        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    icfProf_hwFds[i] = (int) syscall(SYS_perf_event_open, 
+                                     &attr, 0, -1, -1, 0);
+
+    if (icfProf_hwFds[i] >= 0)
+      icfProf_hwCount += 1;
+  }
+
+  icfProf_hwState = 1;
+
+  if (icfProf_hwCount == 0)
+    log_warn("No hardware performance counters available.");
+
+} /* icfProf_openHW() */
+
+/**********************************************************
+* Function: icfProf_readHW
+*----------------------------------------------------------
+* Reads the hardware counters of the calling thread. 
+*----------------------------------------------------------
+* @param: values - event counts, -1 for unavailable events
+* @return: number of available events, -1 if none
+**********************************************************/
+int icfProf_readHW(int64_t values[ICF_PROF_NHW])
+{
+  int i;
+
+  if (icfProf_hwState == 0)
+    icfProf_openHW();
+
+  for (i = 0; i < ICF_PROF_NHW; i++)
+  {
+    uint64_t data[3];
+
+    values[i] = -1;
+
+    if (icfProf_hwFds[i] < 0)
+      continue;
+
+    if (read(icfProf_hwFds[i], data, sizeof(data)) != sizeof(data))
+      continue;
+
+    /*-----------------------------------------------------
+    | Scale counts of multiplexed events
+    -----------------------------------------------------*/
+    if (data[2] > 0 && data[2] < data[1])
+      values[i] = (int64_t)((double) data[0] * data[1] / data[2]);
+    else
+      values[i] = (int64_t) data[0];
+  }
+
+  return (icfProf_hwCount > 0) ? icfProf_hwCount : -1;
+
+} /* icfProf_readHW() */
+
+#else
+
+int icfProf_readHW(int64_t values[ICF_PROF_NHW])
+{
+  int i;
+
+  for (i = 0; i < ICF_PROF_NHW; i++)
+    values[i] = -1;
+
+  return -1;
+
+} /* icfProf_readHW() */
+
+#endif
+
+/**********************************************************
+* Function: icfProf_enableHW
+*----------------------------------------------------------
+* Attaches hardware counters to all timers. 
+*----------------------------------------------------------
+* @return: number of available events for the calling 
+*          thread, -1 if none is available
+**********************************************************/
+int icfProf_enableHW(void)
+{
+  int64_t values[ICF_PROF_NHW];
+  int     nEvents = icfProf_readHW(values);
+
+  if (nEvents > 0)
+    icfProf_setFlags(ICF_PROF_HW, TRUE);
+
+  return nEvents;
+
+} /* icfProf_enableHW() */
+
+/**********************************************************
+* Function: icfProf_disableHW
+*----------------------------------------------------------
+* Detaches the hardware counters from the timers
+**********************************************************/
+void icfProf_disableHW(void)
+{
+  icfProf_setFlags(ICF_PROF_HW, FALSE);
+
+} /* icfProf_disableHW() */
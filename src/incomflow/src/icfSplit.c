@@ -0,0 +1,102 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfSplit.h"
+#include "incomflow/icfMesh.h"
+
+/**********************************************************
+* Initial length of the split array of a mesh
+**********************************************************/
+#define ICF_SPLIT_MINALLOC 64
+
+/**********************************************************
+* Function: icfSplit_create()
+*----------------------------------------------------------
+* Takes an unused split from the split array of a mesh
+* and grows the array if required
+*----------------------------------------------------------
+* @param: mesh - mesh to add the split to
+* @return: index of the new split, -1 on failure
+**********************************************************/
+icfIndex icfSplit_create(icfMesh *mesh)
+{
+  icfIndex i;
+
+  /*-------------------------------------------------------
+  | Double the array and chain the new splits as unused
+  -------------------------------------------------------*/
+  if (mesh->splitFree < 0)
+  {
+    icfIndex nOld = mesh->nSplitsAlloc;
+    icfIndex nNew = (nOld > 0) ? 2 * nOld : ICF_SPLIT_MINALLOC;
+
+    icfSplit *splits = (icfSplit*) icfMem_realloc(ICF_MEM_TREE,
+        mesh->splits, nOld * sizeof(icfSplit), 
+        nNew * sizeof(icfSplit));
+    check_mem(splits);
+
+    for (i = nOld; i < nNew; i++)
+    {
+      splits[i].e        = NULL;
+      splits[i].nextFree = (i+1 < nNew) ? i+1 : -1;
+    }
+
+    mesh->splits       = splits;
+    mesh->nSplitsAlloc = nNew;
+    mesh->splitFree    = nOld;
+  }
+
+  /*-------------------------------------------------------
+  | Take the first unused split
+  -------------------------------------------------------*/
+  const icfIndex iSplit = mesh->splitFree;
+  icfSplit      *split  = ICF_SPLIT(mesh, iSplit);
+
+  mesh->splitFree = split->nextFree;
+  mesh->nSplits  += 1;
+
+  split->e = NULL;
+  split->n = NULL;
+
+  for (i = 0; i < 4; i++)
+  {
+    split->e_c[i] = NULL;
+    split->t_c[i] = NULL;
+  }
+
+  split->t_p[0]   = NULL;
+  split->t_p[1]   = NULL;
+  split->nextFree = -1;
+
+  return iSplit;
+
+error:
+  return -1;
+
+} /* icfSplit_create() */
+
+/**********************************************************
+* Function: icfSplit_destroy()
+*----------------------------------------------------------
+* Returns a split to the unused splits of its mesh
+*----------------------------------------------------------
+* @param: mesh   - mesh of the split
+* @param: iSplit - index of the split
+**********************************************************/
+void icfSplit_destroy(icfMesh *mesh, icfIndex iSplit)
+{
+  icfSplit *split = ICF_SPLIT(mesh, iSplit);
+
+  split->e        = NULL;
+  split->n        = NULL;
+  split->nextFree = mesh->splitFree;
+
+  mesh->splitFree = iSplit;
+  mesh->nSplits  -= 1;
+
+} /* icfSplit_destroy() */
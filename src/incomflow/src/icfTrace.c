@@ -0,0 +1,280 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <pthread.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfProf.h"
+#include "incomflow/icfTrace.h"
+
+/**********************************************************
+* icfTraceBuffer: Event ring buffer of a single thread
+**********************************************************/
+typedef struct icfTraceBuffer {
+  struct icfTraceBuffer *next;
+  int                    tid;       /* Trace thread id      */
+  int                    size;      /* Ring buffer size     */
+  long                   head;      /* Events recorded      */
+  icfTraceEvent          events[];
+} icfTraceBuffer;
+
+/**********************************************************
+* Global tracer state
+* Buffers are linked into a global list, when a thread 
+* records its first event. Thread local buffer pointers 
+* of a previous trace are detected by the generation.
+**********************************************************/
+static pthread_mutex_t  icfTrace_lock    = PTHREAD_MUTEX_INITIALIZER;
+static icfTraceBuffer  *icfTrace_buffers = NULL;
+static int              icfTrace_size    = ICF_TRACE_DEFAULT_EVENTS;
+static int              icfTrace_gen     = 0;
+static int              icfTrace_nTids   = 0;
+static int64_t          icfTrace_t0      = 0;
+
+static __thread icfTraceBuffer *icfTrace_local    = NULL;
+static __thread int             icfTrace_localGen = -1;
+
+/**********************************************************
+* Function: icfTrace_freeBuffers
+*----------------------------------------------------------
+* Frees all buffers - the lock must be held
+**********************************************************/
+static void icfTrace_freeBuffers(void)
+{
+  icfTraceBuffer *buf = icfTrace_buffers;
+
+  while (buf != NULL)
+  {
+    icfTraceBuffer *next = buf->next;
+    free(buf);
+    buf = next;
+  }
+
+  icfTrace_buffers = NULL;
+  icfTrace_nTids   = 0;
+  icfTrace_gen    += 1;
+
+} /* icfTrace_freeBuffers() */
+
+/**********************************************************
+* Function: icfTrace_start
+*----------------------------------------------------------
+* Discards all recorded events and starts tracing
+*----------------------------------------------------------
+* @param: nEvents - ring buffer size per thread 
+*                   (0 for ICF_TRACE_DEFAULT_EVENTS)
+**********************************************************/
+void icfTrace_start(int nEvents)
+{
+  pthread_mutex_lock(&icfTrace_lock);
+
+  icfTrace_freeBuffers();
+  icfTrace_size = (nEvents > 0) ? nEvents : ICF_TRACE_DEFAULT_EVENTS;
+  icfTrace_t0   = icfProf_now();
+
+  pthread_mutex_unlock(&icfTrace_lock);
+
+  icfProf_setFlags(ICF_PROF_TRACE, TRUE);
+
+} /* icfTrace_start() */
+
+/**********************************************************
+* Function: icfTrace_stop
+*----------------------------------------------------------
+* Stops tracing. Recorded events are kept.
+**********************************************************/
+void icfTrace_stop(void)
+{
+  icfProf_setFlags(ICF_PROF_TRACE, FALSE);
+
+} /* icfTrace_stop() */
+
+/**********************************************************
+* Function: icfTrace_clear
+*----------------------------------------------------------
+* Stops tracing and frees all event buffers
+**********************************************************/
+void icfTrace_clear(void)
+{
+  icfTrace_stop();
+
+  pthread_mutex_lock(&icfTrace_lock);
+  icfTrace_freeBuffers();
+  pthread_mutex_unlock(&icfTrace_lock);
+
+} /* icfTrace_clear() */
+
+/**********************************************************
+* Function: icfTrace_localBuffer
+*----------------------------------------------------------
+* Returns the buffer of the calling thread and creates 
+* it, if required
+**********************************************************/
+static icfTraceBuffer *icfTrace_localBuffer(void)
+{
+  icfTraceBuffer *buf;
+  int gen = __atomic_load_n(&icfTrace_gen, __ATOMIC_ACQUIRE);
+
+  if (icfTrace_local != NULL && icfTrace_localGen == gen)
+    return icfTrace_local;
+
+  pthread_mutex_lock(&icfTrace_lock);
+
+  buf = malloc(sizeof(icfTraceBuffer) 
+             + icfTrace_size * sizeof(icfTraceEvent));
+
+  if (buf == NULL)
+  {
+    pthread_mutex_unlock(&icfTrace_lock);
+    log_err("Failed to allocate trace buffer.");
+    return NULL;
+  }
+
+  buf->tid  = ++icfTrace_nTids;
+  buf->size = icfTrace_size;
+  buf->head = 0;
+  buf->next = icfTrace_buffers;
+
+  icfTrace_buffers  = buf;
+  icfTrace_local    = buf;
+  icfTrace_localGen = icfTrace_gen;
+
+  pthread_mutex_unlock(&icfTrace_lock);
+
+  return buf;
+
+} /* icfTrace_localBuffer() */
+
+/**********************************************************
+* Function: icfTrace_record
+*----------------------------------------------------------
+* Records a scope in the ring buffer of the calling 
+* thread
+*----------------------------------------------------------
+* @param: name     - event name
+* @param: start    - begin time stamp (icfProf_now())
+* @param: duration - duration in ns
+**********************************************************/
+void icfTrace_record(const char *name, 
+                     int64_t     start, 
+                     int64_t     duration)
+{
+  icfTraceBuffer *buf = icfTrace_localBuffer();
+  icfTraceEvent  *ev;
+
+  if (buf == NULL)
+    return;
+
+  ev = &buf->events[buf->head % buf->size];
+  ev->name     = name;
+  ev->start    = start;
+  ev->duration = duration;
+
+  buf->head += 1;
+
+} /* icfTrace_record() */
+
+/**********************************************************
+* Function: icfTrace_nEvents / icfTrace_nDropped
+*----------------------------------------------------------
+* @return: number of buffered events or of events,
+*          which were overwritten, summed over all threads
+**********************************************************/
+long icfTrace_nEvents(void)
+{
+  icfTraceBuffer *buf;
+  long n = 0;
+
+  pthread_mutex_lock(&icfTrace_lock);
+  for (buf = icfTrace_buffers; buf != NULL; buf = buf->next)
+    n += (buf->head < buf->size) ? buf->head : buf->size;
+  pthread_mutex_unlock(&icfTrace_lock);
+
+  return n;
+
+} /* icfTrace_nEvents() */
+
+long icfTrace_nDropped(void)
+{
+  icfTraceBuffer *buf;
+  long n = 0;
+
+  pthread_mutex_lock(&icfTrace_lock);
+  for (buf = icfTrace_buffers; buf != NULL; buf = buf->next)
+    n += (buf->head > buf->size) ? buf->head - buf->size : 0;
+  pthread_mutex_unlock(&icfTrace_lock);
+
+  return n;
+
+} /* icfTrace_nDropped() */
+
+/**********************************************************
+* Function: icfTrace_write
+*----------------------------------------------------------
+* Writes all buffered events as Chrome trace JSON
+* Time stamps are given in microseconds relative to 
+* the start of the trace.
+*----------------------------------------------------------
+* @param: path - output file
+* @return: 0 on success, -1 on errors
+**********************************************************/
+int icfTrace_write(const char *path)
+{
+  icfTraceBuffer *buf;
+  long            i;
+  const char     *sep = "";
+
+  FILE *fptr = fopen(path, "w");
+  check(fptr != NULL, "Failed to open trace file %s.", path);
+
+  pthread_mutex_lock(&icfTrace_lock);
+
+  fprintf(fptr, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  for (buf = icfTrace_buffers; buf != NULL; buf = buf->next)
+  {
+    long nEvents = (buf->head < buf->size) ? buf->head : buf->size;
+
+    /*-----------------------------------------------------
+    | Thread name metadata
+    -----------------------------------------------------*/
+    fprintf(fptr, "%s{\"name\":\"thread_name\",\"ph\":\"M\","
+        "\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+        sep, buf->tid, buf->tid);
+    sep = ",\n";
+
+    /*-----------------------------------------------------
+    | Events from the oldest to the latest
+    -----------------------------------------------------*/
+    for (i = buf->head - nEvents; i < buf->head; i++)
+    {
+      const icfTraceEvent *ev = &buf->events[i % buf->size];
+
+      fprintf(fptr, "%s{\"name\":\"%s\",\"cat\":\"incomflow\","
+          "\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+          "\"pid\":1,\"tid\":%d}",
+          sep, ev->name, 
+          1.0e-3 * (ev->start - icfTrace_t0), 
+          1.0e-3 * ev->duration, 
+          buf->tid);
+    }
+  }
+
+  fprintf(fptr, "\n]}\n");
+
+  pthread_mutex_unlock(&icfTrace_lock);
+
+  check(fclose(fptr) == 0, "Failed to write trace file %s.", path);
+
+  return 0;
+error:
+  return -1;
+
+} /* icfTrace_write() */
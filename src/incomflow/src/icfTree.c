@@ -0,0 +1,352 @@
+/*
+ * This source file is part of the incomflow library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfList.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfSplit.h"
+#include "incomflow/icfTree.h"
+#include "incomflow/icfProf.h"
+
+/**********************************************************
+* Function: icfTreeIter_split()
+*----------------------------------------------------------
+* Returns the split record of an entity, NULL if the 
+* entity is a leaf
+**********************************************************/
+static inline icfSplit *icfTreeIter_split(const icfTreeIter *it,
+                                          const void        *p)
+{
+  icfIndex iSplit = it->isTri 
+                  ? ((const icfTri*)  p)->cold->treeSplit
+                  : ((const icfEdge*) p)->cold->treeSplit;
+
+  return (iSplit < 0) ? NULL : ICF_SPLIT(it->mesh, iSplit);
+
+} /* icfTreeIter_split() */
+
+/**********************************************************
+* Function: icfTreeIter_child()
+*----------------------------------------------------------
+* Returns child i of an entity in the order of 
+* icfTri_getChild() and icfEdge_getChild()
+**********************************************************/
+static inline void *icfTreeIter_child(const icfTreeIter *it,
+                                      const icfSplit    *split,
+                                      const void        *p,
+                                      int                i)
+{
+  if (!it->isTri)
+    return split->e_c[i];
+
+  /*-------------------------------------------------------
+  | t_c = [tR0, tR1, tL1, tL0]
+  -------------------------------------------------------*/
+  return (p == split->t_p[0]) ? split->t_c[i] : split->t_c[3-i];
+
+} /* icfTreeIter_child() */
+
+/**********************************************************
+* Function: icfTreeIter_init()
+**********************************************************/
+static void icfTreeIter_init(icfTreeIter  *it,
+                             icfMesh      *mesh,
+                             void         *root,
+                             icfBool       isTri,
+                             icfTreeOrder  order)
+{
+  it->mesh      = mesh;
+  it->order     = order;
+  it->isTri     = isTri;
+  it->nChildren = isTri ? 2 : 4;
+
+  it->depth     = (root != NULL) ? 1 : 0;
+  it->curDepth  = 0;
+  it->path[0]   = root;
+  it->next[0]   = -1;
+
+  it->root      = root;
+  it->level     = 0;
+  it->deeper    = FALSE;
+  it->truncated = FALSE;
+
+} /* icfTreeIter_init() */
+
+/**********************************************************
+* Function: icfTreeIter_initTri
+*----------------------------------------------------------
+* @param: it    - iterator to initialize
+* @param: root  - root of the subtree, which is visited 
+*                 as well
+* @param: order - traversal order
+**********************************************************/
+void icfTreeIter_initTri(icfTreeIter  *it, 
+                         icfTri       *root, 
+                         icfTreeOrder  order)
+{
+  icfTreeIter_init(it, root != NULL ? root->cold->mesh : NULL, 
+                   root, TRUE, order);
+} /* icfTreeIter_initTri() */
+
+/**********************************************************
+* Function: icfTreeIter_initEdge
+*----------------------------------------------------------
+* @param: it    - iterator to initialize
+* @param: root  - root of the subtree, which is visited 
+*                 as well
+* @param: order - traversal order
+**********************************************************/
+void icfTreeIter_initEdge(icfTreeIter  *it, 
+                          icfEdge      *root, 
+                          icfTreeOrder  order)
+{
+  icfTreeIter_init(it, root != NULL ? root->cold->mesh : NULL, 
+                   root, FALSE, order);
+} /* icfTreeIter_initEdge() */
+
+/**********************************************************
+* Function: icfTreeIter_next
+*----------------------------------------------------------
+* Every call continues the depth-first walk of the path,
+* until an entity is entered (pre-order), left 
+* (post-order) or entered on the level of the current 
+* pass (level-order).
+*----------------------------------------------------------
+* @param: it - iterator
+* @return: next entity of the traversal, NULL at the end
+**********************************************************/
+void *icfTreeIter_next(icfTreeIter *it)
+{
+  for (;;)
+  {
+    while (it->depth > 0)
+    {
+      const int  d     = it->depth - 1;
+      void      *p     = it->path[d];
+      icfSplit  *split = it->split[d];
+      icfBool    down  = FALSE;
+
+      /*---------------------------------------------------
+      | Entity is entered
+      ---------------------------------------------------*/
+      if (it->next[d] < 0)
+      {
+        split        = icfTreeIter_split(it, p);
+        it->split[d] = split;
+        it->next[d]  = 0;
+
+        /*-------------------------------------------------
+        | The children are scattered in memory, their 
+        | loads are issued together
+        -------------------------------------------------*/
+        if (split != NULL)
+        {
+          int i;
+          for (i = 0; i < it->nChildren; i++)
+          {
+            void *c = icfTreeIter_child(it, split, p, i);
+            if (c != NULL)
+              __builtin_prefetch(c);
+          }
+        }
+
+        if (split != NULL && d+1 >= ICF_TREE_MAXDEPTH)
+          it->truncated = TRUE;
+
+        if (it->order == ICF_TREE_PREORDER)
+        {
+          it->curDepth = d;
+          return p;
+        }
+
+        if (it->order == ICF_TREE_LEVELORDER && d == it->level)
+        {
+          if (split != NULL && d+1 < ICF_TREE_MAXDEPTH)
+            it->deeper = TRUE;
+
+          it->next[d]  = it->nChildren;
+          it->curDepth = d;
+          return p;
+        }
+      }
+
+      /*---------------------------------------------------
+      | Descend into the next existing child
+      ---------------------------------------------------*/
+      if (split != NULL && d+1 < ICF_TREE_MAXDEPTH)
+      {
+        while (it->next[d] < it->nChildren && !down)
+        {
+          void *c = icfTreeIter_child(it, split, p, it->next[d]++);
+
+          if (c != NULL)
+          {
+            it->path[d+1] = c;
+            it->next[d+1] = -1;
+            it->depth    += 1;
+            down          = TRUE;
+          }
+        }
+      }
+
+      if (down)
+        continue;
+
+      /*---------------------------------------------------
+      | Entity is left
+      ---------------------------------------------------*/
+      it->depth -= 1;
+
+      if (it->order == ICF_TREE_POSTORDER)
+      {
+        it->curDepth = d;
+        return p;
+      }
+    }
+
+    /*-----------------------------------------------------
+    | Start the pass of the next level
+    -----------------------------------------------------*/
+    if (it->order != ICF_TREE_LEVELORDER || !it->deeper)
+      return NULL;
+
+    it->level  += 1;
+    it->deeper  = FALSE;
+    it->depth   = 1;
+    it->path[0] = it->root;
+    it->next[0] = -1;
+  }
+
+} /* icfTreeIter_next() */
+
+/**********************************************************
+* Function: icfTreeIter_depth
+*----------------------------------------------------------
+* @param: it - iterator
+* @return: depth of the last returned entity below the 
+*          root of the traversal
+**********************************************************/
+int icfTreeIter_depth(const icfTreeIter *it)
+{
+  return it->curDepth;
+} /* icfTreeIter_depth() */
+
+/**********************************************************
+* Function: icfTree_forEach()
+*----------------------------------------------------------
+* Traverses all trees of the entities on a mesh stack
+* in parallel
+*----------------------------------------------------------
+* @return: number of visited entities, -1 on errors
+**********************************************************/
+static icfIndex icfTree_forEach(icfMesh        *mesh,
+                                icfBool         isTri,
+                                icfTreeOrder    order,
+                                icfTreeTriFun   triFun,
+                                icfTreeEdgeFun  edgeFun,
+                                void           *data)
+{
+  icfIndex     i, nRoots = 0, nVisited = 0;
+  icfListNode *cur;
+  icfList     *stack = isTri ? mesh->triStack : mesh->edgeStack;
+  void       **roots = NULL;
+
+  ICF_PROF_BEGIN(forEach, "icfTree_forEach");
+
+  /*-------------------------------------------------------
+  | Roots of the forest are the entities of the initial
+  | mesh
+  -------------------------------------------------------*/
+  roots = (void**) malloc((stack->count+1) * sizeof(void*));
+  check_mem(roots);
+
+  for (cur = stack->first; cur != NULL; cur = cur->next)
+  {
+    icfIndex treeParent = isTri 
+      ? ((icfTri*)  cur->value)->cold->treeParent
+      : ((icfEdge*) cur->value)->cold->treeParent;
+
+    if (treeParent < 0)
+      roots[nRoots++] = cur->value;
+  }
+
+  /*-------------------------------------------------------
+  | Trees differ in size, they are handed out in chunks
+  -------------------------------------------------------*/
+#pragma omp parallel for reduction(+:nVisited) schedule(dynamic, 16)
+  for (i = 0; i < nRoots; i++)
+  {
+    icfTreeIter it;
+    void *p;
+
+    icfTreeIter_init(&it, mesh, roots[i], isTri, order);
+
+    while ((p = icfTreeIter_next(&it)) != NULL)
+    {
+      if (isTri)
+        triFun((icfTri*) p, data);
+      else
+        edgeFun((icfEdge*) p, data);
+      nVisited += 1;
+    }
+  }
+
+  free(roots);
+
+  ICF_PROF_END(forEach);
+  return nVisited;
+
+error:
+  ICF_PROF_END(forEach);
+  return -1;
+
+} /* icfTree_forEach() */
+
+/**********************************************************
+* Function: icfTree_forEachTri
+*----------------------------------------------------------
+* Visits all triangles of a mesh tree by tree. The root 
+* triangles of the initial mesh are distributed across 
+* the threads with OpenMP, if available, hence the 
+* function must only modify the data of its own tree.
+* Every tree is traversed in the given order.
+*----------------------------------------------------------
+* @param: mesh  - pointer to mesh structure
+* @param: order - traversal order within every tree
+* @param: fun   - function to call for every triangle
+* @param: data  - user data passed to fun
+* @return: number of visited triangles, -1 on errors
+**********************************************************/
+icfIndex icfTree_forEachTri(icfMesh       *mesh,
+                            icfTreeOrder   order,
+                            icfTreeTriFun  fun,
+                            void          *data)
+{
+  return icfTree_forEach(mesh, TRUE, order, fun, NULL, data);
+} /* icfTree_forEachTri() */
+
+/**********************************************************
+* Function: icfTree_forEachEdge
+*----------------------------------------------------------
+* Visits all edges of a mesh tree by tree, analogous to
+* icfTree_forEachTri()
+*----------------------------------------------------------
+* @param: mesh  - pointer to mesh structure
+* @param: order - traversal order within every tree
+* @param: fun   - function to call for every edge
+* @param: data  - user data passed to fun
+* @return: number of visited edges, -1 on errors
+**********************************************************/
+icfIndex icfTree_forEachEdge(icfMesh        *mesh,
+                             icfTreeOrder    order,
+                             icfTreeEdgeFun  fun,
+                             void           *data)
+{
+  return icfTree_forEach(mesh, FALSE, order, NULL, fun, data);
+} /* icfTree_forEachEdge() */
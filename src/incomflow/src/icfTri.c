@@ -12,9 +12,14 @@
 #include "incomflow/icfBdry.h"
 #include "incomflow/icfEdge.h"
 #include "incomflow/icfNode.h"
+#include "incomflow/icfSplit.h"
 #include "incomflow/icfFlowData.h"
+#include "incomflow/icfProf.h"
 #include "incomflow/dbg.h"
 
+_Static_assert(sizeof(icfTri) % _Alignof(icfTriCold) == 0,
+    "Cold records of triangles are misaligned in their block.");
+
 /**********************************************************
 * Function: icfTri_create
 *----------------------------------------------------------
@@ -25,21 +30,22 @@
 **********************************************************/
 icfTri *icfTri_create(icfMesh *mesh)
 {
-  icfTri *tri = (icfTri*) calloc(1, sizeof(icfTri));
+  icfTri *tri = (icfTri*) icfMem_calloc(ICF_MEM_TRIS, 
+                                        1, ICF_TRI_BLOCKSIZE);
   check_mem(tri);
 
+  tri->cold = (icfTriCold*) (tri + 1);
+
   /*-------------------------------------------------------
   | Parents
   -------------------------------------------------------*/
-  tri->mesh   = mesh;
-  tri->parent = NULL;
+  tri->cold->mesh   = mesh;
 
   /*-------------------------------------------------------
-  | Children
+  | Refinement forest
   -------------------------------------------------------*/
-  tri->t_c[0] = NULL;
-  tri->t_c[1] = NULL;
-  tri->n_c    = NULL;
+  tri->cold->treeParent = -1;
+  tri->cold->treeSplit  = -1;
 
   /*-------------------------------------------------------
   | Defining nodes: 
@@ -65,12 +71,12 @@ icfTri *icfTri_create(icfMesh *mesh)
   /*-------------------------------------------------------
   | Triangle properties
   -------------------------------------------------------*/
-  tri->index       = -1;
-  tri->split       = FALSE;
-  tri->merge       = FALSE;
-  tri->isSplit     = FALSE;
-  tri->isLeaf      = FALSE;
-  tri->treeLevel   = 0;
+  tri->cold->index       = -1;
+  tri->cold->split       = FALSE;
+  tri->cold->merge       = FALSE;
+  tri->cold->isSplit     = FALSE;
+  tri->cold->isLeaf      = FALSE;
+  tri->cold->treeLevel   = 0;
 
   /*-------------------------------------------------------
   | Geometric triangle properties
@@ -83,8 +89,11 @@ icfTri *icfTri_create(icfMesh *mesh)
   /*-------------------------------------------------------
   | Position of this triangle in mesh stack 
   -------------------------------------------------------*/
-  tri->stackPos = icfMesh_addTri(mesh, tri);
-  tri->leafPos  = -1;
+  tri->cold->stackPos = icfMesh_addTri(mesh, tri);
+  tri->cold->leafPos  = -1;
+
+  ICF_PROF_ADD(ICF_PROF_TRIS_CREATED, 1);
+  ICF_PROF_ADD(ICF_PROF_BYTES_ALLOCATED, ICF_TRI_BLOCKSIZE);
 
   return tri;
 error:
@@ -102,8 +111,20 @@ error:
 **********************************************************/
 int icfTri_destroy(icfTri *tri)
 {
-  icfMesh_remTri(tri->mesh, tri);
-  free(tri);
+  icfMesh_remTri(tri->cold->mesh, tri);
+
+  ICF_PROF_ADD(ICF_PROF_TRIS_FREED, 1);
+  ICF_PROF_ADD(ICF_PROF_BYTES_FREED, ICF_TRI_BLOCKSIZE);
+
+  /*-------------------------------------------------------
+  | Triangles in a contiguous block of the mesh are 
+  | released with the block, other triangles with their
+  | cold record
+  -------------------------------------------------------*/
+  icfMesh *mesh = tri->cold->mesh;
+
+  if (!ICF_MESH_INSLAB(tri, mesh->triSlab, mesh->nTriSlab))
+    icfMem_free(ICF_MEM_TRIS, tri, ICF_TRI_BLOCKSIZE);
   return 0;
 } /* icfTri_destroy() */
 
@@ -196,6 +217,54 @@ void icfTri_setTris(icfTri *tri,
   tri->t[2] = t2;
 } /*icfTri_setTris() */
 
+/**********************************************************
+* Function: icfTri_getParent
+*----------------------------------------------------------
+* @param: tri - triangle structure
+* @return: parent triangle in the refinement tree, 
+*          NULL for triangles of the initial mesh
+**********************************************************/
+icfTri *icfTri_getParent(const icfTri *tri)
+{
+  if (tri->cold->treeParent < 0)
+    return NULL;
+
+  icfSplit *split = ICF_SPLIT(tri->cold->mesh, tri->cold->treeParent);
+
+  /*-------------------------------------------------------
+  | The children tR0 and tR1 are right of the split edge
+  -------------------------------------------------------*/
+  if (tri == split->t_c[0] || tri == split->t_c[1])
+    return split->t_p[0];
+
+  return split->t_p[1];
+
+} /* icfTri_getParent() */
+
+/**********************************************************
+* Function: icfTri_getChild
+*----------------------------------------------------------
+* @param: tri - triangle structure
+* @param: i   - child number (0-1)
+* @return: child triangle, NULL if tri is not split
+**********************************************************/
+icfTri *icfTri_getChild(const icfTri *tri, int i)
+{
+  if (tri->cold->treeSplit < 0)
+    return NULL;
+
+  icfSplit *split = ICF_SPLIT(tri->cold->mesh, tri->cold->treeSplit);
+
+  /*-------------------------------------------------------
+  | t_c = [tR0, tR1, tL1, tL0]
+  -------------------------------------------------------*/
+  if (tri == split->t_p[0])
+    return split->t_c[i];
+
+  return split->t_c[3-i];
+
+} /* icfTri_getChild() */
+
 /**********************************************************
 * Function: icfTri_markToRefine
 *----------------------------------------------------------
@@ -210,7 +279,7 @@ void icfTri_markToSplit(icfTri *tri)
   /*-------------------------------------------------------
   | Return if triangle has already been marked
   -------------------------------------------------------*/
-  if (tri->split == TRUE)
+  if (tri->cold->split == TRUE)
     return;
 
   int i;
@@ -237,22 +306,22 @@ void icfTri_markToSplit(icfTri *tri)
   /*-------------------------------------------------------
   | Mark elments for splitting
   -------------------------------------------------------*/
-  tri->split         = TRUE;
-  tri->e_split       = eL;
-  eL->split          = TRUE;
+  tri->cold->split   = TRUE;
+  tri->cold->e_split = eL;
+  eL->cold->split    = TRUE;
 
   if (tri->t[iNb] != NULL)
   {
-    tri->t[iNb]->split = TRUE;
-    tri->t[iNb]->e_split = eL;
+    tri->t[iNb]->cold->split   = TRUE;
+    tri->t[iNb]->cold->e_split = eL;
   }
 
 
-#if (ICF_DEBUG > 2)
-  icfPrint("MARKED EDGE (%d,%d) IN TRIANGLE (%d,%d,%d) FOR SPLITTING",
+  icfLog(ICF_LOG_TRI, ICF_LOG_TRACE,
+      "MARKED EDGE (%" ICF_PRIdx ",%" ICF_PRIdx ") IN TRIANGLE "
+      "(%" ICF_PRIdx ",%" ICF_PRIdx ",%" ICF_PRIdx ") FOR SPLITTING",
       eL->n[0]->index, eL->n[1]->index,
       tri->n[0]->index, tri->n[1]->index, tri->n[2]->index);
-#endif
 
   return;
 error:
@@ -275,37 +344,38 @@ void icfTri_markToMerge(icfTri *tri)
   /*-------------------------------------------------------
   | Find siblings in refinement tree
   -------------------------------------------------------*/
-  icfNode *n = tri->n_c;
-  check(n != NULL,
+  check(tri->cold->treeParent >= 0,
       "Can not merge unrefined triangle");
 
-  icfEdge *eH0 = n->e_c[0];
-  icfEdge *eV0 = n->e_c[1];
-  icfEdge *eH1 = n->e_c[2];
-  icfEdge *eV1 = n->e_c[3];
+  icfSplit *split = ICF_SPLIT(tri->cold->mesh, tri->cold->treeParent);
+
+  icfEdge *eH0 = split->e_c[0];
+  icfEdge *eV0 = split->e_c[1];
+  icfEdge *eH1 = split->e_c[2];
+  icfEdge *eV1 = split->e_c[3];
 
-  icfTri  *tR0 = n->t_c[0];
-  icfTri  *tR1 = n->t_c[1];
-  icfTri  *tL1 = n->t_c[2];
-  icfTri  *tL0 = n->t_c[3];
+  icfTri  *tR0 = split->t_c[0];
+  icfTri  *tR1 = split->t_c[1];
+  icfTri  *tL1 = split->t_c[2];
+  icfTri  *tL0 = split->t_c[3];
 
   if (eH0 != NULL)
-    eH0->merge = TRUE;
+    eH0->cold->merge = TRUE;
   if (eV0 != NULL)
-    eV0->merge = TRUE;
+    eV0->cold->merge = TRUE;
   if (eH1 != NULL)
-    eH1->merge = TRUE;
+    eH1->cold->merge = TRUE;
   if (eV1 != NULL)
-    eV1->merge = TRUE;
+    eV1->cold->merge = TRUE;
 
   if (tR0 != NULL)
-    tR0->merge = TRUE;
+    tR0->cold->merge = TRUE;
   if (tR1 != NULL)
-    tR1->merge = TRUE;
+    tR1->cold->merge = TRUE;
   if (tL1 != NULL)
-    tL1->merge = TRUE;
+    tL1->cold->merge = TRUE;
   if (tL0 != NULL)
-    tL0->merge = TRUE;
+    tL0->cold->merge = TRUE;
 
   return;
 error:
@@ -15,6 +15,8 @@
 **********************************************************/
 int main(int argc, char *argv[])
 {
+  icfLog_configure(getenv("ICF_LOG"));
+
   icfPrint("Main function works.");
 
   return 0;
@@ -157,3 +157,42 @@ char *test_basic_structures()
 
   return NULL;
 } /* test_basic_tests() */
+
+/*************************************************************
+* Unit test function for the configured index and real types
+*************************************************************/
+char *test_basic_types()
+{
+  mu_assert(8*sizeof(icfIndex)  == ICF_INDEX_BITS,
+      "Wrong width of icfIndex.");
+  mu_assert(8*sizeof(icfReal)   == ICF_REAL_BITS,
+      "Wrong width of icfReal.");
+  mu_assert(8*sizeof(icfDouble) == ICF_DOUBLE_BITS,
+      "Wrong width of icfDouble.");
+  mu_assert(sizeof(icfDouble) >= sizeof(icfReal),
+      "Compute precision is below the storage precision.");
+
+  /*----------------------------------------------------------
+  | Entity fields are stored in the storage precision
+  ----------------------------------------------------------*/
+  icfNode node;
+  icfEdge edge;
+  icfTri  tri;
+
+  mu_assert(sizeof(node.xy[0]) == sizeof(icfReal)
+         && sizeof(edge.len)   == sizeof(icfReal)
+         && sizeof(tri.area)   == sizeof(icfReal),
+      "Mesh entities are not stored in the storage precision.");
+
+  /*----------------------------------------------------------
+  | Indices beyond 32 bit are printed without truncation
+  ----------------------------------------------------------*/
+  char buf[32];
+  snprintf(buf, 32, "%" ICF_PRIdx, (icfIndex) ICF_INDEX_MAX);
+  mu_assert(strcmp(buf, (ICF_INDEX_BITS == 64) ? "9223372036854775807"
+                                               : "2147483647") == 0,
+      "Wrong format of icfIndex.");
+
+  return NULL;
+
+} /* test_basic_types() */
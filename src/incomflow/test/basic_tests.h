@@ -6,4 +6,9 @@
 *************************************************************/
 char *test_basic_structures();
 
+/*************************************************************
+* Unit test function for the configured index and real types
+*************************************************************/
+char *test_basic_types();
+
 #endif
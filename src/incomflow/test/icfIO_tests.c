@@ -1,3 +1,5 @@
+#include <math.h>
+
 #include "incomflow/minunit.h"
 #include "incomflow/bstrlib.h"
 #include "incomflow/icfIO.h"
@@ -21,20 +23,21 @@ char *test_icfIO_readerFunctions()
   bstring *ptr  = NULL;
   icfIOReader *file = icfIO_createReader( testfile );
 
-  int nNodes;
-  int nTris;
+  int      nParam;
+  icfIndex nNodes;
+  icfIndex nTris;
 
   icfDouble (*xyNodes)[2];
   icfIndex  (*idxTris)[3];
   icfIndex  (*idxTriNbrs)[3];
 
-  icfIO_extractParam(file->txtlist, "NODES", 0, &nNodes);
+  icfIO_extractParam(file->txtlist, "NODES", 0, &nParam);
 
-  icfIO_readMeshNodes(file->txtlist, &xyNodes, &nNodes); 
+  icfIO_readMeshNodes(file, &xyNodes, &nNodes); 
 
-  icfIO_readMeshTriangles(file->txtlist, &idxTris, &nTris); 
+  icfIO_readMeshTriangles(file, &idxTris, &nTris); 
 
-  icfIO_readMeshTriNbrs(file->txtlist, &idxTriNbrs, &nTris); 
+  icfIO_readMeshTriNbrs(file, &idxTriNbrs, &nTris); 
 
   icfIO_destroyReader( file );
   free(xyNodes);
@@ -114,3 +117,407 @@ char *test_icfIO_readMesh()
   
   return NULL;
 }
+
+/*************************************************************
+* Helper functions to write numbers to a gmsh file, 
+* either as text or as binary data
+*************************************************************/
+static void gmsh_int(FILE *fptr, int binary, int v)
+{
+  if (binary)
+    fwrite(&v, sizeof(int), 1, fptr);
+  else
+    fprintf(fptr, "%d ", v);
+}
+
+static void gmsh_size(FILE *fptr, int binary, size_t v)
+{
+  if (binary)
+    fwrite(&v, sizeof(size_t), 1, fptr);
+  else
+    fprintf(fptr, "%lu ", (unsigned long) v);
+}
+
+static void gmsh_double(FILE *fptr, int binary, double v)
+{
+  if (binary)
+    fwrite(&v, sizeof(double), 1, fptr);
+  else
+    fprintf(fptr, "%.16g ", v);
+}
+
+static void gmsh_newline(FILE *fptr, int binary)
+{
+  if (!binary)
+    fprintf(fptr, "\n");
+}
+
+/*************************************************************
+* Writes a unit square in the gmsh 4.1 format. 
+* The square consists of four triangles around a center 
+* node, where the last triangle is oriented clockwise.
+* The four sides are the curves 1-4 with the physical 
+* tags 1-4, but only the tags 1-3 are named. The surface
+* group "FLUID" shares the tag 4 with the unnamed curves.
+* Node tags are not contiguous.
+* The $Elements header states <nElems> elements, the file
+* contains 9 of them.
+*************************************************************/
+static void write_gmsh(const char *path, int binary, int nElems)
+{
+  int i;
+  double xy[5][2] = { {0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0},
+                      {0.0, 1.0}, {0.5, 0.5} };
+  size_t tags[5]  = { 10, 20, 30, 40, 50 };
+  size_t tris[4][3] = { {10, 20, 50}, {20, 30, 50}, 
+                        {30, 40, 50}, {10, 50, 40} };
+
+  FILE *fptr = fopen(path, binary ? "wb" : "w");
+
+  fprintf(fptr, "$MeshFormat\n4.1 %d %d\n", binary, 
+          (int) sizeof(size_t));
+  if (binary)
+  {
+    gmsh_int(fptr, binary, 1);
+    fprintf(fptr, "\n");
+  }
+  fprintf(fptr, "$EndMeshFormat\n");
+
+  fprintf(fptr, "$PhysicalNames\n4\n");
+  fprintf(fptr, "1 1 \"SOUTH\"\n1 2 \"EAST\"\n1 3 \"NORTH\"\n");
+  fprintf(fptr, "2 4 \"FLUID\"\n");
+  fprintf(fptr, "$EndPhysicalNames\n");
+
+  /*----------------------------------------------------------
+  | Entities: 4 points, 4 curves, 1 surface
+  ----------------------------------------------------------*/
+  fprintf(fptr, "$Entities\n");
+  gmsh_size(fptr, binary, 4); gmsh_size(fptr, binary, 4);
+  gmsh_size(fptr, binary, 1); gmsh_size(fptr, binary, 0);
+  gmsh_newline(fptr, binary);
+
+  for (i = 0; i < 4; i++)
+  {
+    gmsh_int(fptr, binary, i+1);
+    gmsh_double(fptr, binary, xy[i][0]);
+    gmsh_double(fptr, binary, xy[i][1]);
+    gmsh_double(fptr, binary, 0.0);
+    gmsh_size(fptr, binary, 0);
+    gmsh_newline(fptr, binary);
+  }
+  for (i = 0; i < 4; i++)
+  {
+    int k;
+    gmsh_int(fptr, binary, i+1);
+    for (k = 0; k < 6; k++)
+      gmsh_double(fptr, binary, 0.0);
+    gmsh_size(fptr, binary, 1);
+    gmsh_int(fptr, binary, i+1);
+    gmsh_size(fptr, binary, 2);
+    gmsh_int(fptr, binary, i+1);
+    gmsh_int(fptr, binary, -((i+1)%4+1));
+    gmsh_newline(fptr, binary);
+  }
+  gmsh_int(fptr, binary, 1);
+  for (i = 0; i < 6; i++)
+    gmsh_double(fptr, binary, 0.0);
+  gmsh_size(fptr, binary, 1);
+  gmsh_int(fptr, binary, 4);
+  gmsh_size(fptr, binary, 4);
+  for (i = 0; i < 4; i++)
+    gmsh_int(fptr, binary, i+1);
+  gmsh_newline(fptr, binary);
+  fprintf(fptr, "%s$EndEntities\n", binary ? "\n" : "");
+
+  /*----------------------------------------------------------
+  | Nodes: corner nodes and a parametric surface node
+  ----------------------------------------------------------*/
+  fprintf(fptr, "$Nodes\n");
+  gmsh_size(fptr, binary, 2); gmsh_size(fptr, binary, 5);
+  gmsh_size(fptr, binary, 10); gmsh_size(fptr, binary, 50);
+  gmsh_newline(fptr, binary);
+
+  gmsh_int(fptr, binary, 0); gmsh_int(fptr, binary, 1);
+  gmsh_int(fptr, binary, 0); gmsh_size(fptr, binary, 4);
+  gmsh_newline(fptr, binary);
+  for (i = 0; i < 4; i++)
+  {
+    gmsh_size(fptr, binary, tags[i]);
+    gmsh_newline(fptr, binary);
+  }
+  for (i = 0; i < 4; i++)
+  {
+    gmsh_double(fptr, binary, xy[i][0]);
+    gmsh_double(fptr, binary, xy[i][1]);
+    gmsh_double(fptr, binary, 0.0);
+    gmsh_newline(fptr, binary);
+  }
+
+  gmsh_int(fptr, binary, 2); gmsh_int(fptr, binary, 1);
+  gmsh_int(fptr, binary, 1); gmsh_size(fptr, binary, 1);
+  gmsh_newline(fptr, binary);
+  gmsh_size(fptr, binary, tags[4]);
+  gmsh_newline(fptr, binary);
+  gmsh_double(fptr, binary, xy[4][0]);
+  gmsh_double(fptr, binary, xy[4][1]);
+  gmsh_double(fptr, binary, 0.0);
+  gmsh_double(fptr, binary, 0.5);
+  gmsh_double(fptr, binary, 0.5);
+  gmsh_newline(fptr, binary);
+  fprintf(fptr, "%s$EndNodes\n", binary ? "\n" : "");
+
+  /*----------------------------------------------------------
+  | Elements: one point, four lines, four triangles
+  ----------------------------------------------------------*/
+  fprintf(fptr, "$Elements\n");
+  gmsh_size(fptr, binary, 6); gmsh_size(fptr, binary, nElems);
+  gmsh_size(fptr, binary, 1); gmsh_size(fptr, binary, 9);
+  gmsh_newline(fptr, binary);
+
+  gmsh_int(fptr, binary, 0); gmsh_int(fptr, binary, 1);
+  gmsh_int(fptr, binary, 15); gmsh_size(fptr, binary, 1);
+  gmsh_newline(fptr, binary);
+  gmsh_size(fptr, binary, 1); gmsh_size(fptr, binary, tags[0]);
+  gmsh_newline(fptr, binary);
+
+  for (i = 0; i < 4; i++)
+  {
+    gmsh_int(fptr, binary, 1); gmsh_int(fptr, binary, i+1);
+    gmsh_int(fptr, binary, 1); gmsh_size(fptr, binary, 1);
+    gmsh_newline(fptr, binary);
+    gmsh_size(fptr, binary, i+2); 
+    gmsh_size(fptr, binary, tags[i]);
+    gmsh_size(fptr, binary, tags[(i+1)%4]);
+    gmsh_newline(fptr, binary);
+  }
+
+  gmsh_int(fptr, binary, 2); gmsh_int(fptr, binary, 1);
+  gmsh_int(fptr, binary, 2); gmsh_size(fptr, binary, 4);
+  gmsh_newline(fptr, binary);
+  for (i = 0; i < 4; i++)
+  {
+    gmsh_size(fptr, binary, i+6);
+    gmsh_size(fptr, binary, tris[i][0]);
+    gmsh_size(fptr, binary, tris[i][1]);
+    gmsh_size(fptr, binary, tris[i][2]);
+    gmsh_newline(fptr, binary);
+  }
+  fprintf(fptr, "%s$EndElements\n", binary ? "\n" : "");
+
+  fclose(fptr);
+}
+
+/*************************************************************
+* Unit test function for the gmsh reader
+*************************************************************/
+char *test_icfIO_readGmsh()
+{
+  int binary, i, j;
+  const char *path = "icfIO_test_gmsh.msh";
+
+  for (binary = 0; binary < 2; binary++)
+  {
+    write_gmsh(path, binary, 9);
+
+    icfMesh *mesh      = icfMesh_create();
+    icfBdry *bdrySouth = icfBdry_create(mesh, 0, 1, "INFLOW");
+
+    icfIO_readGmsh(path, mesh);
+    icfMesh_update(mesh);
+    remove(path);
+
+    mu_assert(mesh->nNodes == 5, "Wrong number of gmsh nodes.");
+    mu_assert(mesh->nTriLeafs == 4, 
+        "Wrong number of gmsh triangles.");
+    mu_assert(mesh->nEdgeLeafs == 8, 
+        "Wrong number of gmsh edges.");
+    mu_assert(mesh->nBdrys == 4, 
+        "Wrong number of gmsh boundaries.");
+
+    /*--------------------------------------------------------
+    | Defined boundaries are reused, missing boundaries are
+    | created with the names of the physical groups
+    --------------------------------------------------------*/
+    icfListNode *cur;
+    for (cur = mesh->bdryStack->first; cur != NULL; cur = cur->next)
+    {
+      icfBdry *bdry = (icfBdry*) cur->value;
+      const char *names[4] = { "INFLOW", "EAST", "NORTH", "BDRY_4" };
+
+      mu_assert(bdry->marker >= 1 && bdry->marker <= 4,
+          "Wrong gmsh boundary marker.");
+      mu_assert(strcmp(bdry->name, names[bdry->marker-1]) == 0,
+          "Wrong gmsh boundary name.");
+      mu_assert(bdry->nEdgeLeafs == 1, 
+          "Wrong number of gmsh boundary edges.");
+    }
+    mu_assert(bdrySouth->edgeLeafs[0]->n[0]->xy[1] == 0.0 &&
+              bdrySouth->edgeLeafs[0]->n[1]->xy[1] == 0.0,
+        "Wrong southern gmsh boundary edge.");
+
+    /*--------------------------------------------------------
+    | All triangles are oriented counter-clockwise
+    --------------------------------------------------------*/
+    for (i = 0; i < mesh->nTriLeafs; i++)
+    {
+      icfTri *t = mesh->triLeafs[i];
+      icfReal   *p0 = t->n[0]->xy;
+      icfReal   *p1 = t->n[1]->xy;
+      icfReal   *p2 = t->n[2]->xy;
+
+      mu_assert( (p1[0]-p0[0])*(p2[1]-p0[1]) 
+               - (p2[0]-p0[0])*(p1[1]-p0[1]) > 0.0,
+          "Gmsh triangle is oriented clockwise.");
+
+      for (j = 0; j < 3; j++)
+        mu_assert((t->t[j] == NULL) == (t->e[(j+1)%3]->t[1] == NULL),
+            "Wrong gmsh triangle neighbors.");
+    }
+
+    icfMesh_destroy(mesh);
+  }
+
+  /*----------------------------------------------------------
+  | Element blocks must not exceed the $Elements header
+  ----------------------------------------------------------*/
+  write_gmsh(path, 0, 3);
+
+  icfMesh *mesh = icfMesh_create();
+  icfIO_readGmsh(path, mesh);
+  remove(path);
+
+  mu_assert(mesh->nNodes == 0 && mesh->nTris == 0,
+      "Gmsh elements exceeding the header were read.");
+
+  icfMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_icfIO_readGmsh() */
+
+/*************************************************************
+* Unit test function for the parallel parsing of large
+* mesh file sections. The node lines are written in 
+* reverse order, with different number formats and with
+* mixed line endings.
+*************************************************************/
+char *test_icfIO_parseSections()
+{
+  int      i;
+  icfIndex nNodes = 200000;
+  icfIndex nTris  = 0;
+  const char *path = "icfIO_test_sections.dat";
+
+  icfDouble (*xyNodes)[2] = NULL;
+  icfIndex  (*idxTris)[3] = NULL;
+
+  FILE *fptr = fopen(path, "w");
+
+  fprintf(fptr, "NODES %" ICF_PRIdx "\n", nNodes);
+  for (i = nNodes-1; i >= 0; i--)
+  {
+    double x = 1.0e-3 * i + 1.0 / 3.0;
+    double y = -7.5e4 / (i + 1);
+
+    if (i % 3 == 0)
+      fprintf(fptr, "%d\t%.16e\t%.16e\n", i, x, y);
+    else if (i % 3 == 1)
+      fprintf(fptr, "%d  %.17g %.6f\r\n", i, x, y);
+    else
+      fprintf(fptr, "%d\t%.3E\t%d\n", i, x, (int) y);
+  }
+  fprintf(fptr, "TRIANGLES 2\n1\t2\t-3\t4\n0\t0\t1\t2\n");
+  fclose(fptr);
+
+  icfIOReader *file = icfIO_createMeshReader( path );
+  mu_assert(file != NULL, "Failed to create mesh reader.");
+
+  mu_assert(icfIO_readMeshNodes(file, &xyNodes, &nNodes) == 0,
+      "Failed to parse node section.");
+  mu_assert(icfIO_readMeshTriangles(file, &idxTris, &nTris) == 0,
+      "Failed to parse triangle section.");
+
+  icfIO_destroyReader( file );
+  remove(path);
+
+  mu_assert(nNodes == 200000 && nTris == 2, 
+      "Wrong number of section entries.");
+
+  /*----------------------------------------------------------
+  | Compare with the printed values
+  ----------------------------------------------------------*/
+  for (i = 0; i < nNodes; i++)
+  {
+    char   str[64];
+    double x = 1.0e-3 * i + 1.0 / 3.0;
+    double y = -7.5e4 / (i + 1);
+
+    if (i % 3 == 0)
+      snprintf(str, 64, "%.16e %.16e", x, y);
+    else if (i % 3 == 1)
+      snprintf(str, 64, "%.17g %.6f", x, y);
+    else
+      snprintf(str, 64, "%.3E %d", x, (int) y);
+
+    x = strtod(str, NULL);
+    y = strtod(strchr(str, ' '), NULL);
+
+    mu_assert(fabs(xyNodes[i][0] - x) <= 8.0 * ICF_DOUBLE_EPS * fabs(x) &&
+              fabs(xyNodes[i][1] - y) <= 8.0 * ICF_DOUBLE_EPS * fabs(y),
+        "Wrong parsed node coordinates.");
+  }
+
+  mu_assert(idxTris[1][0] == 2 && idxTris[1][1] == -3 
+         && idxTris[1][2] == 4 && idxTris[0][2] == 2, 
+      "Wrong parsed triangle indices.");
+
+  free(xyNodes);
+  free(idxTris);
+
+  /*----------------------------------------------------------
+  | Duplicate row IDs must be rejected, even if the number
+  | of lines matches the section size
+  ----------------------------------------------------------*/
+  fptr = fopen(path, "w");
+  fprintf(fptr, "TRIANGLES 3\n0\t0\t1\t2\n2\t1\t2\t3\n0\t2\t3\t4\n");
+  fclose(fptr);
+
+  file = icfIO_createMeshReader( path );
+  mu_assert(file != NULL, "Failed to create mesh reader.");
+
+  idxTris = NULL;
+  mu_assert(icfIO_readMeshTriangles(file, &idxTris, &nTris) != 0,
+      "Duplicate row IDs were not detected.");
+
+  icfIO_destroyReader( file );
+  remove(path);
+
+  /*----------------------------------------------------------
+  | Node and neighbor indices out of range must be rejected
+  ----------------------------------------------------------*/
+  for (i = 0; i < 2; i++)
+  {
+    fptr = fopen(path, "w");
+    fprintf(fptr, "NODES 3\n0 0.0 0.0\n1 1.0 0.0\n2 0.0 1.0\n");
+    if (i == 0)
+      fprintf(fptr, "TRIANGLES 1\n0 0 1 3\n");
+    else
+      fprintf(fptr, "TRIANGLES 1\n0 0 1 2\n"
+                    "NEIGHBORS 1\n0 1 -1 -1\n");
+    fclose(fptr);
+
+    icfMesh *mesh = icfMesh_create();
+    icfBdry_create(mesh, 0, 1, "WALL");
+
+    icfIO_readMesh(path, mesh);
+    remove(path);
+
+    mu_assert(mesh->nNodes == 0 && mesh->nTris == 0,
+        "Mesh indices out of range were read.");
+
+    icfMesh_destroy(mesh);
+  }
+
+  return NULL;
+
+} /* test_icfIO_parseSections() */
@@ -3,5 +3,7 @@
 
 char *test_icfIO_readerFunctions();
 char *test_icfIO_readMesh();
+char *test_icfIO_readGmsh();
+char *test_icfIO_parseSections();
 
 #endif
@@ -0,0 +1,168 @@
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfLocator.h"
+#include "icfTestMeshes.h"
+#include "icfLocator_tests.h"
+
+#define NPOINTS 400
+
+/*************************************************************
+* Returns TRUE, if a point lies inside of a triangle
+*************************************************************/
+static icfBool inside_tri(const icfTri *t, const icfDouble *p)
+{
+  int i;
+
+  for (i = 0; i < 3; i++)
+  {
+    const icfNode *a = t->n[(i+1)%3];
+    const icfNode *b = t->n[(i+2)%3];
+    icfDouble o = (b->xy[0] - a->xy[0]) * (p[1] - a->xy[1])
+                - (b->xy[1] - a->xy[1]) * (p[0] - a->xy[0]);
+
+    if (o < -1.0E-12)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*************************************************************
+* Returns the first triangle leaf, which contains a point, 
+* by a search over all leafs
+*************************************************************/
+static icfTri *brute_locate(icfMesh *mesh, const icfDouble *p)
+{
+  int i;
+
+  for (i = 0; i < mesh->nTriLeafs; i++)
+    if (inside_tri(mesh->triLeafs[i], p))
+      return mesh->triLeafs[i];
+
+  return NULL;
+}
+
+/*************************************************************
+* Unit test function for the point location
+*************************************************************/
+char *test_icfLocator_locate()
+{
+  int i;
+  unsigned seed = 12345;
+  icfDouble hole[1][4] = { { 0.5, 0.5, 0.75, 0.75 } };
+  icfDouble xy[NPOINTS][2], w[NPOINTS][3];
+  icfTri   *tris[NPOINTS];
+  icfMemStats memBefore, memAfter;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 12;
+  params.ny     = 12;
+  params.jitter = 0.1;
+  params.nHoles = 1;
+  params.holes  = hole;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_coarsenRefined);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  icfMem_getStats(&memBefore);
+
+  icfLocator *loc = icfLocator_create(mesh);
+  mu_assert(loc != NULL, "Failed to create locator.");
+
+  /*----------------------------------------------------------
+  | Centroids are found in their own leafs
+  ----------------------------------------------------------*/
+  for (i = 0; i < mesh->nTriLeafs; i++)
+  {
+    icfTri   *t = mesh->triLeafs[i];
+    icfDouble p[2] = { t->xy[0], t->xy[1] };
+
+    mu_assert(icfLocator_locate(loc, p, NULL) == t,
+        "Centroid is not located in its triangle.");
+  }
+
+  /*----------------------------------------------------------
+  | Random points, including points in the hole and 
+  | outside of the domain
+  ----------------------------------------------------------*/
+  for (i = 0; i < NPOINTS; i++)
+  {
+    seed = seed * 1103515245u + 12345u;
+    xy[i][0] = -0.1 + 1.2 * (icfDouble)(seed >> 8) / (1u << 24);
+    seed = seed * 1103515245u + 12345u;
+    xy[i][1] = -0.1 + 1.2 * (icfDouble)(seed >> 8) / (1u << 24);
+  }
+
+  for (i = 0; i < NPOINTS; i++)
+  {
+    icfTri *t = icfLocator_locate(loc, xy[i], w[i]);
+
+    if (brute_locate(mesh, xy[i]) == NULL)
+    {
+      mu_assert(t == NULL, "Point outside of the mesh is located.");
+      continue;
+    }
+
+    mu_assert(t != NULL && t->cold->isLeaf && inside_tri(t, xy[i]),
+        "Point is not located in its triangle leaf.");
+    mu_assert(fabs(w[i][0] + w[i][1] + w[i][2] - 1.0) < 1.0E4*ICF_DOUBLE_EPS,
+        "Barycentric coordinates do not sum up to one.");
+    mu_assert(fabs(w[i][0]*t->n[0]->xy[0] + w[i][1]*t->n[1]->xy[0]
+                 + w[i][2]*t->n[2]->xy[0] - xy[i][0]) < 1.0E-6,
+        "Wrong barycentric coordinates.");
+  }
+
+  /*----------------------------------------------------------
+  | Batch queries match the serial queries
+  ----------------------------------------------------------*/
+  int nFound = 0;
+  for (i = 0; i < NPOINTS; i++)
+    nFound += (icfLocator_locate(loc, xy[i], NULL) != NULL);
+
+  mu_assert(icfLocator_locateBatch(loc, NPOINTS, xy, tris, w) == nFound,
+      "Wrong number of located points in batch.");
+
+  for (i = 0; i < NPOINTS; i++)
+    mu_assert(tris[i] == icfLocator_locate(loc, xy[i], NULL),
+        "Batch query differs from serial query.");
+
+  /*----------------------------------------------------------
+  | The seed grid follows the changes of the mesh
+  ----------------------------------------------------------*/
+  icfMesh_coarsen(flowData, mesh);
+  mu_assert(icfMesh_compact(mesh) == 0, "Failed to compact mesh.");
+
+  for (i = 0; i < NPOINTS; i++)
+    mu_assert(icfLocator_locate(loc, xy[i], NULL) 
+              == brute_locate(mesh, xy[i]),
+        "Point is not located after coarsening.");
+
+  icfLocator_destroy(loc);
+  icfMem_getStats(&memAfter);
+
+  mu_assert(memAfter.bytes[ICF_MEM_LOCATOR] 
+            == memBefore.bytes[ICF_MEM_LOCATOR]
+         && memAfter.blocks[ICF_MEM_LOCATOR] 
+            == memBefore.blocks[ICF_MEM_LOCATOR],
+      "Locator memory was not released.");
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfLocator_locate() */
@@ -0,0 +1,9 @@
+#ifndef icfLocator_tests_h
+#define icfLocator_tests_h
+
+/*************************************************************
+* Unit test function for the point location
+*************************************************************/
+char *test_icfLocator_locate();
+
+#endif
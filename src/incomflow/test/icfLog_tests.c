@@ -0,0 +1,118 @@
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfLog.h"
+#include "icfLog_tests.h"
+
+/*************************************************************
+* Reads all messages, which were added to a temporary log 
+* file since the last call
+*************************************************************/
+static void read_log(FILE *fptr, long *pos, char *buf, size_t size)
+{
+  size_t n;
+
+  fflush(fptr);
+  fseek(fptr, *pos, SEEK_SET);
+  n = fread(buf, 1, size-1, fptr);
+  buf[n] = '\0';
+  *pos = ftell(fptr);
+  fseek(fptr, 0, SEEK_END);
+}
+
+/*************************************************************
+* Counts the lines of a string
+*************************************************************/
+static int count_lines(const char *buf)
+{
+  int n = 0;
+  for (; *buf != '\0'; buf++)
+    n += (*buf == '\n');
+  return n;
+}
+
+/*************************************************************
+* Unit test function for the levelled logger
+*************************************************************/
+char *test_icfLog_levels()
+{
+  int  i;
+  int  nEval = 0;
+  long pos = 0;
+  char buf[8192];
+
+  int levels[ICF_LOG_NMODULES];
+  memcpy(levels, icfLog_levels, sizeof(levels));
+
+  FILE *fptr = tmpfile();
+  mu_assert(fptr != NULL, "Failed to create temporary file.");
+  icfLog_setStream(fptr);
+
+  /*----------------------------------------------------------
+  | Disabled messages do not evaluate their arguments
+  ----------------------------------------------------------*/
+  icfLog_setLevel(ICF_LOG_ALL, ICF_LOG_WARN);
+
+  icfLog(ICF_LOG_EDGE, ICF_LOG_DEBUG, "value %d", ++nEval);
+  icfLog(ICF_LOG_EDGE, ICF_LOG_WARN,  "value %d", ++nEval);
+
+  read_log(fptr, &pos, buf, sizeof(buf));
+  mu_assert(nEval == 1, "Disabled message evaluated its arguments.");
+  mu_assert(strcmp(buf, "[warn] edge: value 1\n") == 0,
+      "Wrong log message.");
+
+  /*----------------------------------------------------------
+  | Module filters
+  ----------------------------------------------------------*/
+  mu_assert(icfLog_configure("error,mesh=debug,EDGE=trace") == 0,
+      "Failed to parse log specification.");
+  mu_assert(icfLog_levels[ICF_LOG_IO]   == ICF_LOG_ERROR
+         && icfLog_levels[ICF_LOG_MESH] == ICF_LOG_DEBUG
+         && icfLog_levels[ICF_LOG_EDGE] == ICF_LOG_TRACE,
+      "Wrong log levels.");
+  mu_assert(icfLog_configure("info,foo=debug,mesh=loud") != 0,
+      "Invalid log specification was accepted.");
+  mu_assert(icfLog_levels[ICF_LOG_IO] == ICF_LOG_INFO,
+      "Valid entries of a specification were ignored.");
+
+  /*----------------------------------------------------------
+  | Asynchronous logging keeps the message order
+  ----------------------------------------------------------*/
+  icfLog_setLevel(ICF_LOG_ALL, ICF_LOG_OFF);
+  icfLog_setLevel(ICF_LOG_TRI, ICF_LOG_TRACE);
+
+  mu_assert(icfLog_startAsync(256) == 0, 
+      "Failed to start async logger.");
+
+  for (i = 0; i < 100; i++)
+  {
+    icfLog(ICF_LOG_TRI, ICF_LOG_TRACE, "message %d", i);
+    icfLog(ICF_LOG_MESH, ICF_LOG_ERROR, "hidden %d", i);
+  }
+
+  icfLog_flush();
+  read_log(fptr, &pos, buf, sizeof(buf));
+
+  mu_assert(icfLog_nDropped() == 0, "Async logger dropped messages.");
+  mu_assert(count_lines(buf) == 100 
+         && strstr(buf, "[trace] tri: message 0\n") == buf
+         && strstr(buf, "hidden") == NULL,
+      "Wrong async log output.");
+
+  icfLog_stopAsync();
+
+  /*----------------------------------------------------------
+  | Restore logger state
+  ----------------------------------------------------------*/
+  icfLog_setStream(NULL);
+  fclose(fptr);
+
+  for (i = 0; i < ICF_LOG_NMODULES; i++)
+    icfLog_setLevel(i, levels[i]);
+
+  return NULL;
+
+} /* test_icfLog_levels() */
@@ -0,0 +1,9 @@
+#ifndef icfLog_tests_h
+#define icfLog_tests_h
+
+/*************************************************************
+* Unit test function for the levelled logger
+*************************************************************/
+char *test_icfLog_levels();
+
+#endif
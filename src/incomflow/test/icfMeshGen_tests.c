@@ -0,0 +1,138 @@
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfMeshGen.h"
+#include "icfMeshGen_tests.h"
+
+/*************************************************************
+* Returns the boundary with a given marker
+*************************************************************/
+static icfBdry *get_bdry(icfMesh *mesh, icfIndex marker)
+{
+  icfListNode *cur;
+
+  for (cur = mesh->bdryStack->first; cur != NULL; cur = cur->next)
+    if (((icfBdry*)cur->value)->marker == marker)
+      return (icfBdry*)cur->value;
+
+  return NULL;
+}
+
+/*************************************************************
+* Unit test function for the structured mesh generator
+*************************************************************/
+char *test_icfMeshGen_rectangle()
+{
+  int i, j;
+  icfDouble hole[1][4] = { { 1.0, 1.0, 3.0, 3.0 } };
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.xy1[0] = 6.0;
+  params.xy1[1] = 4.0;
+  params.nx     = 6;
+  params.ny     = 4;
+  params.jitter = 0.1;
+  params.seed   = 7;
+  params.nHoles = 1;
+  params.holes  = hole;
+
+  /*----------------------------------------------------------
+  | The WEST boundary is defined beforehand and must be
+  | reused by the generator
+  ----------------------------------------------------------*/
+  icfMesh *mesh     = icfMesh_create();
+  icfBdry *bdryWest = icfBdry_create(mesh, 0, ICF_MESHGEN_WEST, "INLET");
+
+  mu_assert(icfMeshGen_rectangle(mesh, &params) == 0,
+      "Failed to generate mesh.");
+  icfMesh_update(mesh);
+
+  /*----------------------------------------------------------
+  | Check entity numbers: 24 cells minus 4 hole cells
+  ----------------------------------------------------------*/
+  mu_assert(mesh->nTriLeafs == 40, "Wrong number of triangles.");
+  mu_assert(mesh->nNodes == 34, "Wrong number of nodes.");
+  mu_assert(mesh->nEdgeLeafs == 74, "Wrong number of edges.");
+
+  mu_assert(get_bdry(mesh, ICF_MESHGEN_WEST) == bdryWest,
+      "Existing boundary was not reused.");
+  mu_assert(get_bdry(mesh, ICF_MESHGEN_SOUTH)->nEdgeLeafs == 6
+         && get_bdry(mesh, ICF_MESHGEN_EAST )->nEdgeLeafs == 4
+         && get_bdry(mesh, ICF_MESHGEN_NORTH)->nEdgeLeafs == 6
+         && get_bdry(mesh, ICF_MESHGEN_WEST )->nEdgeLeafs == 4
+         && get_bdry(mesh, ICF_MESHGEN_HOLE )->nEdgeLeafs == 8,
+      "Wrong number of boundary edges.");
+
+  /*----------------------------------------------------------
+  | Check triangle areas and neighbors
+  ----------------------------------------------------------*/
+  icfDouble area = 0.0;
+  int       nMoved = 0;
+
+  for (i = 0; i < mesh->nTriLeafs; i++)
+  {
+    icfTri *t = mesh->triLeafs[i];
+
+    mu_assert(t->area > 0.0, "Invalid triangle area.");
+    area += t->area;
+
+    for (j = 0; j < 3; j++)
+    {
+      icfTri  *tn = t->t[j];
+      icfEdge *e  = t->e[(j+1)%3];
+
+      if (tn == NULL)
+      {
+        mu_assert(e->cold->bdry != NULL, 
+            "Boundary edge without boundary.");
+      }
+      else
+      {
+        mu_assert(tn->t[0] == t || tn->t[1] == t || tn->t[2] == t,
+            "Triangle neighbors are not symmetric.");
+      }
+    }
+  }
+
+  mu_assert(fabs(area - 20.0) < 1.0e4*ICF_REAL_EPS, "Wrong mesh area.");
+
+  /*----------------------------------------------------------
+  | Only interior nodes away from the hole are displaced
+  ----------------------------------------------------------*/
+  for (i = 0; i < mesh->nNodes; i++)
+  {
+    icfReal   *xy = mesh->nodes[i]->xy;
+    icfDouble  dx = fabs(xy[0] - round(xy[0]));
+    icfDouble  dy = fabs(xy[1] - round(xy[1]));
+
+    mu_assert(dx <= 0.1 && dy <= 0.1, "Node displaced too far.");
+
+    if (dx > 0.0 || dy > 0.0)
+      nMoved += 1;
+  }
+
+  mu_assert(nMoved == 6, 
+      "Wrong number of displaced nodes.");
+
+  icfMesh_destroy(mesh);
+
+  /*----------------------------------------------------------
+  | Invalid parameters must be rejected
+  ----------------------------------------------------------*/
+  mesh = icfMesh_create();
+  params.jitter = 0.5;
+  mu_assert(icfMeshGen_rectangle(mesh, &params) != 0,
+      "Invalid jitter was not detected.");
+  icfMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_icfMeshGen_rectangle() */
@@ -0,0 +1,9 @@
+#ifndef icfMeshGen_tests_h
+#define icfMeshGen_tests_h
+
+/*************************************************************
+* Unit test function for the structured mesh generator
+*************************************************************/
+char *test_icfMeshGen_rectangle();
+
+#endif
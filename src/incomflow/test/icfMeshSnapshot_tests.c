@@ -0,0 +1,217 @@
+#include <string.h>
+#include <pthread.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfMeshSnapshot.h"
+#include "icfTestMeshes.h"
+#include "icfMeshSnapshot_tests.h"
+
+/*************************************************************
+* Compares two output frames
+*************************************************************/
+static icfBool frames_equal(const icfOutputFrame *a, 
+                            const icfOutputFrame *b)
+{
+  if (a->nNodes != b->nNodes || a->nTris != b->nTris)
+    return FALSE;
+
+  return memcmp(a->xy,      b->xy,      a->nNodes*sizeof(*a->xy))    == 0
+      && memcmp(a->vol,     b->vol,     a->nNodes*sizeof(*a->vol))   == 0
+      && memcmp(a->tris,    b->tris,    a->nTris*sizeof(*a->tris))   == 0
+      && memcmp(a->triNbrs, b->triNbrs, a->nTris*sizeof(*a->triNbrs))==0
+      && memcmp(a->cellFields[0], b->cellFields[0], 
+                a->nTris*sizeof(icfDouble)) == 0;
+}
+
+/*************************************************************
+* Reader thread, which sums the triangle areas of a 
+* snapshot repeatedly, while the mesh is refined
+*************************************************************/
+typedef struct snapReader {
+  icfMeshSnapshot *snap;
+  icfDouble        area;
+  int              nPasses;
+  int              nWrong;
+} snapReader;
+
+static void *read_snapshot(void *arg)
+{
+  snapReader *reader = (snapReader*) arg;
+  int i, k;
+
+  for (k = 0; k < reader->nPasses; k++)
+  {
+    icfDouble area = 0.0;
+
+    for (i = 0; i < reader->snap->nTris; i++)
+      area += icfMeshSnapshot_triArea(reader->snap, i);
+
+    if (area != reader->area)
+      reader->nWrong += 1;
+  }
+
+  icfMeshSnapshot_release(reader->snap);
+
+  return NULL;
+}
+
+/*************************************************************
+* Unit test function for the copy-on-write mesh snapshots
+*************************************************************/
+char *test_icfMeshSnapshot_capture()
+{
+  int       a, i;
+  icfIndex  nChunks = 0;
+  icfMemStats memBefore, memAfter;
+
+  icfOutputFrame frameMesh, frameSnap, frameOld;
+  memset(&frameMesh, 0, sizeof(icfOutputFrame));
+  memset(&frameSnap, 0, sizeof(icfOutputFrame));
+  memset(&frameOld,  0, sizeof(icfOutputFrame));
+
+  icfMem_getStats(&memBefore);
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 40;
+  params.ny     = 40;
+  params.jitter = 0.1;
+
+  /*----------------------------------------------------------
+  | Refinement in the upper right corner keeps the leading
+  | entries of the leaf arrays
+  ----------------------------------------------------------*/
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineUpperRight,
+                         icfTestMeshes_refineUpperRight);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  /*----------------------------------------------------------
+  | The first snapshot copies all chunks and matches a
+  | frame captured from the mesh
+  ----------------------------------------------------------*/
+  icfMeshSnapshot *snap0 = icfMeshSnapshot_capture(mesh, NULL);
+  mu_assert(snap0 != NULL, "Failed to capture snapshot.");
+
+  for (a = 0; a < ICF_SNAPSHOT_NARRAYS; a++)
+    nChunks += snap0->nChunks[a];
+
+  mu_assert(snap0->nShared == 0 && snap0->nCopied == nChunks
+         && snap0->nChunks[ICF_SNAPSHOT_TRIAREA] > 1,
+      "Wrong chunks of the first snapshot.");
+
+  for (i = 0; i < snap0->nTris; i++)
+    mu_assert(icfMeshSnapshot_triXY(snap0, i)[1] 
+              == mesh->triLeafs[i]->xy[1]
+           && icfMeshSnapshot_triArea(snap0, i) 
+              == mesh->triLeafs[i]->area,
+        "Wrong triangle metrics of the snapshot.");
+
+  mu_assert(icfOutput_captureFrame(&frameMesh, mesh) == 0
+         && icfOutput_captureSnapshot(&frameSnap, snap0) == 0
+         && frames_equal(&frameMesh, &frameSnap),
+      "Snapshot does not match the mesh.");
+
+  mu_assert(icfOutput_captureSnapshot(&frameOld, snap0) == 0,
+      "Failed to capture snapshot frame.");
+
+  /*----------------------------------------------------------
+  | A snapshot of the unchanged mesh shares all chunks
+  ----------------------------------------------------------*/
+  icfMeshSnapshot *snap1 = icfMeshSnapshot_capture(mesh, snap0);
+  mu_assert(snap1 != NULL && snap1->nShared == nChunks 
+         && snap1->nCopied == 0,
+      "Unchanged snapshot does not share all chunks.");
+
+  for (a = 0; a < ICF_SNAPSHOT_NARRAYS; a++)
+    mu_assert(snap1->chunks[a][0] == snap0->chunks[a][0]
+           && snap0->chunks[a][0]->refs == 2,
+        "Wrong shared chunk.");
+
+  icfMeshSnapshot_release(snap1);
+
+  /*----------------------------------------------------------
+  | A reader thread holds the first snapshot, while the 
+  | mesh is refined
+  ----------------------------------------------------------*/
+  snapReader reader;
+  pthread_t  thread;
+
+  reader.snap    = icfMeshSnapshot_retain(snap0);
+  reader.area    = 0.0;
+  reader.nPasses = 200;
+  reader.nWrong  = 0;
+
+  for (i = 0; i < snap0->nTris; i++)
+    reader.area += icfMeshSnapshot_triArea(snap0, i);
+
+  mu_assert(pthread_create(&thread, NULL, read_snapshot, &reader) == 0,
+      "Failed to start reader thread.");
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  pthread_join(thread, NULL);
+
+  mu_assert(reader.nWrong == 0 && snap0->refs == 1,
+      "Reader thread saw a modified snapshot.");
+
+  /*----------------------------------------------------------
+  | The next snapshot matches the refined mesh and shares
+  | the unchanged chunks, the first one is kept
+  ----------------------------------------------------------*/
+  icfMeshSnapshot *snap2 = icfMeshSnapshot_capture(mesh, snap0);
+  mu_assert(snap2 != NULL && snap2->nTris > snap0->nTris
+         && snap2->nShared > 0 && snap2->nCopied > 0,
+      "Refined snapshot does not share chunks.");
+
+  mu_assert(icfOutput_captureFrame(&frameMesh, mesh) == 0
+         && icfOutput_captureSnapshot(&frameSnap, snap2) == 0
+         && frames_equal(&frameMesh, &frameSnap),
+      "Refined snapshot does not match the mesh.");
+
+  icfFlowData_destroy(flowData);
+
+  mu_assert(icfOutput_captureSnapshot(&frameSnap, snap0) == 0
+         && frames_equal(&frameOld, &frameSnap),
+      "First snapshot has been modified.");
+
+  icfMeshSnapshot_release(snap0);
+
+  for (i = 0; i < snap2->nTris; i++)
+    mu_assert(icfMeshSnapshot_triLevel(snap2, i) >= 0
+           && icfMeshSnapshot_triLevel(snap2, i) <= 3,
+        "Wrong levels of the refined snapshot.");
+
+  icfMeshSnapshot_release(snap2);
+
+  icfOutput_clearFrame(&frameMesh);
+  icfOutput_clearFrame(&frameSnap);
+  icfOutput_clearFrame(&frameOld);
+
+  /*----------------------------------------------------------
+  | All chunks are released with their last snapshot
+  ----------------------------------------------------------*/
+  icfMem_getStats(&memAfter);
+
+  mu_assert(memAfter.bytes[ICF_MEM_SNAPSHOT] 
+            == memBefore.bytes[ICF_MEM_SNAPSHOT]
+         && memAfter.blocks[ICF_MEM_SNAPSHOT] 
+            == memBefore.blocks[ICF_MEM_SNAPSHOT],
+      "Snapshot memory has not been released.");
+
+  return NULL;
+
+} /* test_icfMeshSnapshot_capture() */
@@ -0,0 +1,9 @@
+#ifndef icfMeshSnapshot_tests_h
+#define icfMeshSnapshot_tests_h
+
+/*************************************************************
+* Unit test function for the copy-on-write mesh snapshots
+*************************************************************/
+char *test_icfMeshSnapshot_capture();
+
+#endif
@@ -0,0 +1,929 @@
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfSplit.h"
+#include "incomflow/icfIO.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfMeshOrder.h"
+#include "incomflow/icfEdgeIndex.h"
+#include "icfTestMeshes.h"
+#include "icfMesh_tests.h"
+
+/*************************************************************
+* Writes a structured grid of nx x ny quads without the 
+* NEIGHBORS section to a mesh file. 
+* Only the southern and northern boundary edges are 
+* listed in the BOUNDARIES section.
+*************************************************************/
+static void write_grid(const char *path, int nx, int ny)
+{
+  int i, j, k;
+  FILE *fptr = fopen(path, "w");
+
+  fprintf(fptr, "NODES %d\n", (nx+1)*(ny+1));
+  for (j = 0, k = 0; j <= ny; j++)
+    for (i = 0; i <= nx; i++, k++)
+      fprintf(fptr, "%d\t%f\t%f\n", k, (double)i, (double)j);
+
+  fprintf(fptr, "TRIANGLES %d\n", 2*nx*ny);
+  for (j = 0, k = 0; j < ny; j++)
+    for (i = 0; i < nx; i++)
+    {
+      int n0 = j*(nx+1) + i;
+      int n1 = n0 + 1;
+      int n2 = n1 + nx + 1;
+      int n3 = n0 + nx + 1;
+      fprintf(fptr, "%d\t%d\t%d\t%d\n", k++, n0, n1, n2);
+      fprintf(fptr, "%d\t%d\t%d\t%d\n", k++, n0, n2, n3);
+    }
+
+  fprintf(fptr, "BOUNDARIES %d\n", 2*nx);
+  for (i = 0, k = 0; i < nx; i++)
+  {
+    fprintf(fptr, "%d\t%d\t%d\t%d\n", k++, i, i+1, 1);
+    fprintf(fptr, "%d\t%d\t%d\t%d\n", k++, 
+        ny*(nx+1)+i+1, ny*(nx+1)+i, 3);
+  }
+
+  fclose(fptr);
+}
+
+/*************************************************************
+* Unit test function for the mesh construction from 
+* triangles only
+*************************************************************/
+char *test_icfMesh_buildFromTris()
+{
+  int i, j;
+  int nx = 7;
+  int ny = 5;
+  const char *path = "icfMesh_test_grid.dat";
+
+  write_grid(path, nx, ny);
+
+  icfMesh *mesh      = icfMesh_create();
+  icfBdry *bdrySouth = icfBdry_create(mesh, 0, 1, "SOUTH");
+  icfBdry *bdryNorth = icfBdry_create(mesh, 0, 3, "NORTH");
+
+  icfIO_readMesh(path, mesh);
+  icfMesh_update(mesh);
+  remove(path);
+
+  /*----------------------------------------------------------
+  | Check entity numbers
+  ----------------------------------------------------------*/
+  mu_assert(mesh->nNodes == (nx+1)*(ny+1), 
+      "Wrong number of nodes.");
+  mu_assert(mesh->nTriLeafs == 2*nx*ny, 
+      "Wrong number of triangles.");
+  mu_assert(mesh->nEdgeLeafs == nx*(ny+1) + ny*(nx+1) + nx*ny, 
+      "Wrong number of edges.");
+  mu_assert(bdrySouth->nEdgeLeafs == nx, 
+      "Wrong number of southern boundary edges.");
+  mu_assert(bdryNorth->nEdgeLeafs == nx, 
+      "Wrong number of northern boundary edges.");
+
+  /*----------------------------------------------------------
+  | Check edge-triangle connectivity
+  ----------------------------------------------------------*/
+  int nBdry = 0;
+
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+  {
+    icfEdge *e = mesh->edgeLeafs[i];
+
+    mu_assert(e->t[0] != NULL, "Edge without left triangle.");
+
+    if (e->t[1] == NULL)
+      nBdry += 1;
+
+    for (j = 0; j < 2; j++)
+    {
+      icfTri *t = e->t[j];
+      if (t == NULL)
+        continue;
+      mu_assert(t->e[0] == e || t->e[1] == e || t->e[2] == e,
+          "Wrong edge-triangle connectivity.");
+    }
+  }
+
+  mu_assert(nBdry == 2*(nx+ny), "Wrong number of boundary edges.");
+
+  /*----------------------------------------------------------
+  | Check triangle neighbors
+  ----------------------------------------------------------*/
+  for (i = 0; i < mesh->nTriLeafs; i++)
+  {
+    icfTri *t = mesh->triLeafs[i];
+
+    for (j = 0; j < 3; j++)
+    {
+      icfTri  *tn = t->t[j];
+      icfEdge *e  = t->e[(j+1)%3];
+
+      mu_assert(e != NULL, "Triangle without edge.");
+
+      if (tn == NULL)
+      {
+        mu_assert(e->t[1] == NULL, "Wrong boundary neighbor.");
+      }
+      else
+      {
+        mu_assert(tn->t[0] == t || tn->t[1] == t || tn->t[2] == t,
+            "Triangle neighbors are not symmetric.");
+      }
+    }
+  }
+
+  /*----------------------------------------------------------
+  | Inconsistent orientation must be detected
+  ----------------------------------------------------------*/
+  icfIndex tris[2][3] = { {0, 1, 2}, {0, 1, 3} };
+  icfIndex nbrs[2][3];
+  mu_assert(icfMesh_pairTris(2, tris, nbrs) != 0,
+      "Misoriented triangles were not detected.");
+
+#if ICF_INDEX_BITS == 64
+  /*----------------------------------------------------------
+  | Node pairs must stay distinct beyond 32 bit indices:
+  | (1,5) and (0,2^32+5) share no edge
+  ----------------------------------------------------------*/
+  icfIndex wideTris[2][3] = { {0, 1, 5}, {0, 4294967301LL, 9} };
+  icfIndex wideNbrs[2][3];
+  mu_assert(icfMesh_pairTris(2, wideTris, wideNbrs) == 0,
+      "Failed to pair triangles with wide node indices.");
+  for (i = 0; i < 6; i++)
+    mu_assert(wideNbrs[i/3][i%3] == -1, 
+        "Distinct node pairs were paired.");
+#endif
+
+  icfMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_icfMesh_buildFromTris() */
+
+/*************************************************************
+* Unit test function for the mesh memory statistics
+*************************************************************/
+char *test_icfMesh_memoryStats()
+{
+  int i;
+  icfMemStats     memBefore, memAfter;
+  icfMeshMemStats stats;
+
+  icfMem_getStats(&memBefore);
+
+  /*----------------------------------------------------------
+  | Refine a generated mesh locally, such that it holds
+  | non-leaf entities of several tree levels
+  ----------------------------------------------------------*/
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = 4;
+  params.ny = 4;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_refineLowerLeft);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  icfMesh_memoryStats(mesh, &stats);
+  icfMem_getStats(&memAfter);
+
+  /*----------------------------------------------------------
+  | Check entity counts per tree level
+  ----------------------------------------------------------*/
+  icfIndex nEdges = 0, nTris = 0, nEdgeLeafs = 0, nTriLeafs = 0;
+
+  for (i = 0; i < stats.nLevels; i++)
+  {
+    nEdges     += stats.nEdges[i];
+    nTris      += stats.nTris[i];
+    nEdgeLeafs += stats.nEdgeLeafs[i];
+    nTriLeafs  += stats.nTriLeafs[i];
+  }
+
+  mu_assert(stats.nLevels == 4, "Wrong number of tree levels.");
+  mu_assert(stats.nTris[0] == 32 && stats.nTriLeafs[0] < 32,
+      "Wrong number of root triangles.");
+  mu_assert(nEdges == mesh->nEdges && nTris == mesh->nTris
+         && nEdgeLeafs == mesh->nEdgeLeafs 
+         && nTriLeafs == mesh->nTriLeafs
+         && stats.nNodes == mesh->nNodes,
+      "Wrong number of entities.");
+
+  /*----------------------------------------------------------
+  | The walk over the mesh must match the allocator 
+  | bookkeeping for every category
+  ----------------------------------------------------------*/
+  for (i = 0; i < ICF_MEM_NCATEGORIES; i++)
+    mu_assert(memAfter.bytes[i] - memBefore.bytes[i] == stats.bytes[i],
+        "Mesh memory does not match the allocator bookkeeping.");
+
+  int nBdryLeafs = 0;
+  icfListNode *cur;
+  for (cur = mesh->bdryStack->first; cur != NULL; cur = cur->next)
+    nBdryLeafs += ((icfBdry*)cur->value)->nEdgeLeafs;
+
+  mu_assert(stats.bytes[ICF_MEM_BDRYFACES] 
+              >= (int64_t) ICF_BDRY_FACEBYTES(nBdryLeafs),
+      "Wrong memory of boundary faces.");
+  mu_assert(stats.totalBytes == memAfter.totalBytes 
+                              - memBefore.totalBytes,
+      "Wrong total mesh memory.");
+  mu_assert(stats.peakBytes >= stats.allocatedBytes 
+         && stats.allocatedBytes >= stats.totalBytes,
+      "Wrong allocator high-water mark.");
+
+  /*----------------------------------------------------------
+  | All blocks of the mesh are returned 
+  ----------------------------------------------------------*/
+  icfFlowData_destroy(flowData);
+  icfMem_getStats(&memAfter);
+
+  for (i = 0; i < ICF_MEM_NCATEGORIES; i++)
+    mu_assert(memAfter.bytes[i]  == memBefore.bytes[i]
+           && memAfter.blocks[i] == memBefore.blocks[i],
+        "Mesh memory was not released.");
+
+  return NULL;
+
+} /* test_icfMesh_memoryStats() */
+
+/*************************************************************
+* Unit test function for the mesh consistency validator
+*************************************************************/
+char *test_icfMesh_validate()
+{
+  int i;
+  icfDouble hole[1][4] = { { 0.5, 0.5, 0.75, 0.75 } };
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 8;
+  params.ny     = 8;
+  params.jitter = 0.1;
+  params.nHoles = 1;
+  params.holes  = hole;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_coarsenRefined);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Generated mesh is not valid.");
+
+  /*----------------------------------------------------------
+  | Local refinement creates hanging tree levels and 
+  | splits boundary edges
+  ----------------------------------------------------------*/
+  for (i = 0; i < 3; i++)
+  {
+    icfMesh_refine(flowData, mesh);
+    mu_assert(icfMesh_validate(mesh) == 0, 
+        "Refined mesh is not valid.");
+  }
+
+  icfMesh_coarsen(flowData, mesh);
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Coarsened mesh is not valid.");
+
+  /*----------------------------------------------------------
+  | Corrupt the mesh and expect the validator to detect it
+  ----------------------------------------------------------*/
+  icfEdge *e = NULL;
+
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+    if (mesh->edgeLeafs[i]->t[1] != NULL)
+    {
+      e = mesh->edgeLeafs[i];
+      break;
+    }
+
+  mu_assert(e != NULL, "No interior edge found.");
+
+  int oldLevel = icfLog_levels[ICF_LOG_MESH];
+  icfLog_setLevel(ICF_LOG_MESH, ICF_LOG_OFF);
+
+  icfTri *t = e->t[1];
+  e->t[1] = NULL;
+  mu_assert(icfMesh_validate(mesh) > 0, 
+      "Missing triangle of an edge not detected.");
+  e->t[1] = t;
+
+  icfNode *n = e->n[0];
+  n->vol = -n->vol;
+  mu_assert(icfMesh_validate(mesh) > 0, 
+      "Negative dual volume not detected.");
+  n->vol = -n->vol;
+
+  t = mesh->triLeafs[0];
+  icfNode *tmp = t->n[1];
+  t->n[1] = t->n[2];
+  t->n[2] = tmp;
+  mu_assert(icfMesh_validate(mesh) > 0, 
+      "Clockwise triangle not detected.");
+  t->n[2] = t->n[1];
+  t->n[1] = tmp;
+
+  icfLog_setLevel(ICF_LOG_MESH, oldLevel);
+
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Restored mesh is not valid.");
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfMesh_validate() */
+
+/*************************************************************
+* Unit test function for the boundary face arrays
+*************************************************************/
+char *test_icfMesh_bdryFaces()
+{
+  int i, k;
+  icfDouble hole[1][4] = { { 0.25, 0.25, 0.5, 0.75 } };
+  const icfDouble tol  = 1.0e4 * ICF_REAL_EPS;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 8;
+  params.ny     = 8;
+  params.nHoles = 1;
+  params.holes  = hole;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         NULL);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  icfMesh_refine(flowData, mesh);
+  icfMesh_refine(flowData, mesh);
+
+  /*----------------------------------------------------------
+  | The outward normals of a closed boundary sum up to zero,
+  | the face lengths to the perimeter of the unit square and
+  | the hole
+  ----------------------------------------------------------*/
+  icfDouble sumNorm[2] = { 0.0, 0.0 };
+  icfDouble sumLen     = 0.0;
+  icfListNode *cur;
+
+  for (cur = mesh->bdryStack->first; cur != NULL; cur = cur->next)
+  {
+    icfBdry *bdry = (icfBdry*)cur->value;
+
+    mu_assert(bdry->nFaces == bdry->nEdgeLeafs,
+        "Wrong number of boundary faces.");
+
+    for (i = 0; i < bdry->nFaces; i++)
+    {
+      icfEdge *e = bdry->edgeLeafs[i];
+      icfTri  *t = mesh->triLeafs[bdry->faceTri[i]];
+
+      mu_assert(mesh->nodes[bdry->faceNodes[0][i]] == e->n[0]
+             && mesh->nodes[bdry->faceNodes[1][i]] == e->n[1],
+          "Wrong nodes of boundary face.");
+      mu_assert(t == e->t[0], "Wrong triangle of boundary face.");
+
+      for (k = 0; k < 2; k++)
+      {
+        sumNorm[0] += bdry->faceNorm[k][0][i];
+        sumNorm[1] += bdry->faceNorm[k][1][i];
+      }
+
+      /* The face normal points away from the inner triangle */
+      const icfDouble nx = bdry->faceNorm[0][0][i] 
+                         + bdry->faceNorm[1][0][i];
+      const icfDouble ny = bdry->faceNorm[0][1][i] 
+                         + bdry->faceNorm[1][1][i];
+
+      mu_assert(nx*(e->xy[0]-t->xy[0]) + ny*(e->xy[1]-t->xy[1]) > 0.0,
+          "Boundary face normal does not point outwards.");
+      mu_assert(fabs(sqrt(nx*nx+ny*ny) - bdry->faceLen[i]) < tol,
+          "Wrong length of boundary face.");
+
+      sumLen += bdry->faceLen[i];
+    }
+  }
+
+  mu_assert(fabs(sumNorm[0]) < tol && fabs(sumNorm[1]) < tol,
+      "Boundary normals do not sum up to zero.");
+  mu_assert(fabs(sumLen - 5.5) < tol, 
+      "Wrong boundary length.");
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfMesh_bdryFaces() */
+
+/*************************************************************
+* Unit test function for the median dual metrics, which 
+* must not change, if the mesh is updated repeatedly
+*************************************************************/
+char *test_icfMesh_dualMetrics()
+{
+  icfIndex i;
+  const icfDouble tol = 1.0e4 * ICF_REAL_EPS;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = 8;
+  params.ny = 8;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         NULL);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  icfMesh_refine(flowData, mesh);
+
+  /*----------------------------------------------------------
+  | Store the metrics of the first update
+  ----------------------------------------------------------*/
+  icfDouble  *vol  = calloc(mesh->nNodes, sizeof(icfDouble));
+  icfDouble (*norm)[2] = calloc(mesh->nEdgeLeafs, 
+                                2 * sizeof(icfDouble));
+  icfDouble   sumVol = 0.0;
+
+  for (i = 0; i < mesh->nNodes; i++)
+  {
+    vol[i]  = mesh->nodes[i]->vol;
+    sumVol += vol[i];
+  }
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+  {
+    norm[i][0] = mesh->edgeLeafs[i]->intrNorm[0];
+    norm[i][1] = mesh->edgeLeafs[i]->intrNorm[1];
+  }
+
+  mu_assert(fabs(sumVol - 1.0) < tol, 
+      "Dual volumes do not sum up to the domain area.");
+
+  /*----------------------------------------------------------
+  | A second update of the unchanged mesh must reproduce
+  | the volumes and interior normals
+  ----------------------------------------------------------*/
+  icfMesh_update(mesh);
+
+  for (i = 0; i < mesh->nNodes; i++)
+    mu_assert(fabs(mesh->nodes[i]->vol - vol[i]) < tol,
+        "Dual volume changed by repeated update.");
+
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+    mu_assert(fabs(mesh->edgeLeafs[i]->intrNorm[0]-norm[i][0]) < tol
+           && fabs(mesh->edgeLeafs[i]->intrNorm[1]-norm[i][1]) < tol,
+        "Interior normal changed by repeated update.");
+
+  free(vol);
+  free(norm);
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfMesh_dualMetrics() */
+
+/*************************************************************
+* Unit test function for the split records of the 
+* refinement forest
+*************************************************************/
+char *test_icfMesh_splitTree()
+{
+  int i, k;
+  icfListNode *cur;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = 8;
+  params.ny = 8;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_coarsenRefined);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  /*----------------------------------------------------------
+  | Every split edge owns one split, parents and children 
+  | are symmetric
+  ----------------------------------------------------------*/
+  icfIndex nSplitEdges = 0;
+
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *e = (icfEdge*)cur->value;
+
+    if (e->cold->isSplit == FALSE)
+    {
+      mu_assert(e->cold->treeSplit < 0 && icfEdge_getChild(e, 0) == NULL,
+          "Leaf edge has children.");
+      continue;
+    }
+
+    nSplitEdges += 1;
+    mu_assert(ICF_SPLIT(mesh, e->cold->treeSplit)->e == e,
+        "Split edge is not the parent of its split.");
+
+    for (k = 0; k < 4; k++)
+    {
+      icfEdge *c = icfEdge_getChild(e, k);
+      mu_assert(c == NULL || icfEdge_getParent(c) == e,
+          "Edge child does not point to its parent.");
+    }
+  }
+
+  mu_assert(nSplitEdges > 0 && nSplitEdges == mesh->nSplits,
+      "Wrong number of splits.");
+
+  for (cur = mesh->triStack->first; cur != NULL; cur = cur->next)
+  {
+    icfTri *t = (icfTri*)cur->value;
+    icfTri *p = icfTri_getParent(t);
+
+    mu_assert( p == NULL 
+            || icfTri_getChild(p, 0) == t || icfTri_getChild(p, 1) == t,
+        "Triangle is not a child of its parent.");
+
+    if (t->cold->isSplit == TRUE)
+      for (k = 0; k < 2; k++)
+        mu_assert(icfTri_getParent(icfTri_getChild(t, k)) == t,
+            "Triangle child does not point to its parent.");
+  }
+
+  /*----------------------------------------------------------
+  | Coarsening returns all splits, which are reused by 
+  | the next refinement
+  ----------------------------------------------------------*/
+  const icfIndex nSplitsAlloc = mesh->nSplitsAlloc;
+
+  for (i = 0; i < 8 && mesh->nSplits > 0; i++)
+    icfMesh_coarsen(flowData, mesh);
+
+  mu_assert(mesh->nSplits == 0, "Coarsened mesh holds splits.");
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Coarsened mesh is not valid.");
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  mu_assert(mesh->nSplits == nSplitEdges 
+         && mesh->nSplitsAlloc == nSplitsAlloc,
+      "Splits are not reused.");
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Refined mesh is not valid.");
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfMesh_splitTree() */
+
+/*************************************************************
+* Unit test function for the compaction of a mesh
+*************************************************************/
+char *test_icfMesh_compact()
+{
+  int i;
+  icfMemStats     memBefore, memAfter;
+  icfMeshMemStats stats;
+
+  icfMem_getStats(&memBefore);
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = 8;
+  params.ny = 8;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_coarsenRefined);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  /*----------------------------------------------------------
+  | Leave holes in the entity heap and the split array
+  ----------------------------------------------------------*/
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+  icfMesh_coarsen(flowData, mesh);
+
+  const icfIndex nTriLeafs  = mesh->nTriLeafs;
+  const icfIndex nEdgeLeafs = mesh->nEdgeLeafs;
+  icfReal *xyTris = calloc(2*nTriLeafs, sizeof(icfReal));
+
+  for (i = 0; i < nTriLeafs; i++)
+  {
+    xyTris[2*i]   = mesh->triLeafs[i]->xy[0];
+    xyTris[2*i+1] = mesh->triLeafs[i]->xy[1];
+  }
+
+  /*----------------------------------------------------------
+  | Leafs are stored first and in leaf order, the split 
+  | array holds no unused records
+  ----------------------------------------------------------*/
+  mu_assert(icfMesh_compact(mesh) == 0, "Failed to compact mesh.");
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Compacted mesh is not valid.");
+
+  mu_assert(mesh->nTriLeafs == nTriLeafs 
+         && mesh->nEdgeLeafs == nEdgeLeafs,
+      "Compaction changed the leafs.");
+
+  for (i = 0; i < nTriLeafs; i++)
+  {
+    mu_assert(mesh->triLeafs[i] == &mesh->triSlab[i]
+           && mesh->triLeafs[i]->cold->leafPos == i,
+        "Triangle leafs are not contiguous.");
+    mu_assert(mesh->triLeafs[i]->xy[0] == xyTris[2*i]
+           && mesh->triLeafs[i]->xy[1] == xyTris[2*i+1],
+        "Compaction changed the triangle leaf order.");
+  }
+
+  for (i = 0; i < nEdgeLeafs; i++)
+    mu_assert(mesh->edgeLeafs[i] == &mesh->edgeSlab[i],
+        "Edge leafs are not contiguous.");
+
+  for (i = 0; i < mesh->nNodes; i++)
+    mu_assert(mesh->nodes[i] == &mesh->nodeSlab[i]
+           && mesh->nodes[i]->index == i,
+        "Nodes are not contiguous.");
+
+  mu_assert(mesh->nSplitsAlloc == mesh->nSplits 
+         && mesh->splitFree == -1,
+      "Split array is not packed.");
+
+  free(xyTris);
+
+  /*----------------------------------------------------------
+  | Adaption continues with entities in- and outside of 
+  | the blocks, the memory matches the bookkeeping
+  ----------------------------------------------------------*/
+  for (i = 0; i < 2; i++)
+    icfMesh_refine(flowData, mesh);
+  icfMesh_coarsen(flowData, mesh);
+
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Adapted compacted mesh is not valid.");
+  mu_assert(icfMesh_compact(mesh) == 0, "Failed to compact mesh.");
+
+  for (i = 0; i < 8 && mesh->nSplits > 0; i++)
+    icfMesh_coarsen(flowData, mesh);
+
+  mu_assert(mesh->nSplits == 0 && icfMesh_validate(mesh) == 0, 
+      "Coarsened compacted mesh is not valid.");
+
+  icfMesh_memoryStats(mesh, &stats);
+  icfMem_getStats(&memAfter);
+
+  for (i = 0; i < ICF_MEM_NCATEGORIES; i++)
+    mu_assert(memAfter.bytes[i] - memBefore.bytes[i] == stats.bytes[i],
+        "Mesh memory does not match the allocator bookkeeping.");
+
+  /*----------------------------------------------------------
+  | All blocks of the mesh are returned 
+  ----------------------------------------------------------*/
+  icfFlowData_destroy(flowData);
+  icfMem_getStats(&memAfter);
+
+  for (i = 0; i < ICF_MEM_NCATEGORIES; i++)
+    mu_assert(memAfter.bytes[i]  == memBefore.bytes[i]
+           && memAfter.blocks[i] == memBefore.blocks[i],
+        "Mesh memory was not released.");
+
+  return NULL;
+
+} /* test_icfMesh_compact() */
+
+/*************************************************************
+* Unit test function for the orderings of the edge leafs
+*************************************************************/
+char *test_icfMesh_edgeOrder()
+{
+  int i, order;
+  icfIndex bandwidth[ICF_EDGEORDER_N];
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 12;
+  params.ny     = 12;
+  params.jitter = 0.1;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_coarsenRefined);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  for (order = 0; order < ICF_EDGEORDER_N; order++)
+  {
+    mesh->edgeOrder = order;
+    icfMesh_update(mesh);
+
+    mu_assert(icfMeshOrder_fromName(icfMeshOrder_name(order)) == order,
+        "Wrong name of the edge ordering.");
+    mu_assert(icfMesh_validate(mesh) == 0, 
+        "Reordered mesh is not valid.");
+
+    for (i = 0; i < mesh->nNodes; i++)
+      mu_assert(mesh->nodes[i]->index == i, 
+          "Nodes are not numbered in array order.");
+
+    bandwidth[order] = icfMeshOrder_bandwidth(mesh);
+
+    if (order == ICF_EDGEORDER_STACK)
+      continue;
+
+    /*--------------------------------------------------------
+    | Edge leafs are sorted by their lower, then by their 
+    | higher node index
+    --------------------------------------------------------*/
+    for (i = 1; i < mesh->nEdgeLeafs; i++)
+    {
+      const icfEdge *a = mesh->edgeLeafs[i-1];
+      const icfEdge *b = mesh->edgeLeafs[i];
+
+      icfIndex aLo = a->n[0]->index, aHi = a->n[1]->index;
+      icfIndex bLo = b->n[0]->index, bHi = b->n[1]->index;
+      icfIndex tmp;
+
+      if (aLo > aHi) { tmp = aLo; aLo = aHi; aHi = tmp; }
+      if (bLo > bHi) { tmp = bLo; bLo = bHi; bHi = tmp; }
+
+      mu_assert(aLo < bLo || (aLo == bLo && aHi <= bHi),
+          "Edge leafs are not sorted.");
+    }
+  }
+
+  mu_assert(bandwidth[ICF_EDGEORDER_RCM] < bandwidth[ICF_EDGEORDER_STACK],
+      "RCM ordering does not reduce the bandwidth.");
+
+  /*----------------------------------------------------------
+  | The ordering is kept through adaption and compaction
+  ----------------------------------------------------------*/
+  icfMesh_coarsen(flowData, mesh);
+  mu_assert(icfMesh_compact(mesh) == 0, "Failed to compact mesh.");
+  mu_assert(icfMesh_validate(mesh) == 0, 
+      "Compacted reordered mesh is not valid.");
+  mu_assert(icfMeshOrder_bandwidth(mesh) < bandwidth[ICF_EDGEORDER_STACK],
+      "Ordering is lost after coarsening.");
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfMesh_edgeOrder() */
+
+/*************************************************************
+* Returns the number of edges on the stack of a mesh, 
+* which are not found in its edge index by their nodes
+*************************************************************/
+static int edgeIndex_nMissing(icfMesh *mesh)
+{
+  int nMissing = 0;
+  icfListNode *cur;
+
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *e = (icfEdge*) cur->value;
+
+    if (icfEdgeIndex_find(mesh, e->n[0], e->n[1]) != e
+     || icfEdgeIndex_find(mesh, e->n[1], e->n[0]) != e)
+      nMissing += 1;
+  }
+
+  return nMissing;
+
+} /* edgeIndex_nMissing() */
+
+/*************************************************************
+* Unit test function for the lookup of edges by their 
+* node pairs
+*************************************************************/
+char *test_icfMesh_edgeIndex()
+{
+  int i;
+  icfListNode *cur;
+  icfMeshMemStats stats;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 12;
+  params.ny     = 12;
+  params.jitter = 0.1;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_coarsenRefined);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  mu_assert(icfEdgeIndex_find(mesh, mesh->nodes[0], mesh->nodes[1]) 
+            == NULL, "Disabled edge index returns edges.");
+
+  /*----------------------------------------------------------
+  | The index is built from the existing edges and grows
+  | with the refined edges
+  ----------------------------------------------------------*/
+  mu_assert(icfEdgeIndex_enable(mesh) == 0, 
+      "Failed to enable edge index.");
+  mu_assert(icfEdgeIndex_enable(mesh) == 0, 
+      "Failed to enable edge index twice.");
+  mu_assert(mesh->edgeIndex->nEdges == mesh->nEdges,
+      "Wrong number of indexed edges.");
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+  icfMesh_update(mesh);
+
+  mu_assert(mesh->edgeIndex->nEdges == mesh->nEdges,
+      "Wrong number of indexed refined edges.");
+  mu_assert(edgeIndex_nMissing(mesh) == 0,
+      "Refined edges are missing in the edge index.");
+  mu_assert(10 * mesh->edgeIndex->nEdges 
+            < ICF_EDGEINDEX_MAXLOAD * mesh->edgeIndex->nSlots,
+      "Edge index is overfilled.");
+
+  for (i = 0; i < mesh->nEdgeLeafs; i++)
+  {
+    icfEdge *e = mesh->edgeLeafs[i];
+    mu_assert(icfEdgeIndex_findByIndex(mesh, e->n[1]->index, 
+                                       e->n[0]->index) == e,
+        "Edge leaf is not found by its node indices.");
+  }
+
+  /*----------------------------------------------------------
+  | Node pairs without an edge
+  ----------------------------------------------------------*/
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *e = (icfEdge*) cur->value;
+    if (e->n[0] == mesh->nodes[0] || e->n[1] == mesh->nodes[0])
+      mu_assert(e->n[0] != mesh->nodes[mesh->nNodes-1]
+             && e->n[1] != mesh->nodes[mesh->nNodes-1],
+          "Test nodes must not be connected.");
+  }
+
+  mu_assert(icfEdgeIndex_findByIndex(mesh, 0, mesh->nNodes-1) == NULL,
+      "Edge index returns an edge of unconnected nodes.");
+  mu_assert(icfEdgeIndex_findByIndex(mesh, 0, mesh->nNodes) == NULL,
+      "Edge index returns an edge of an invalid node.");
+
+  /*----------------------------------------------------------
+  | Removed edges are shifted out of the probe sequences
+  | and the index follows the relocated entities
+  ----------------------------------------------------------*/
+  icfMesh_coarsen(flowData, mesh);
+  icfMesh_update(mesh);
+
+  mu_assert(mesh->edgeIndex->nEdges == mesh->nEdges,
+      "Wrong number of indexed coarsened edges.");
+  mu_assert(edgeIndex_nMissing(mesh) == 0,
+      "Edges are missing in the edge index after coarsening.");
+
+  mu_assert(icfMesh_compact(mesh) == 0, "Failed to compact mesh.");
+  mu_assert(edgeIndex_nMissing(mesh) == 0,
+      "Edges are missing in the edge index after compaction.");
+
+  icfMesh_memoryStats(mesh, &stats);
+  mu_assert(stats.bytes[ICF_MEM_EDGEINDEX] 
+            == (int64_t) (sizeof(icfEdgeIndex) 
+                        + mesh->edgeIndex->nSlots*sizeof(icfEdge*)),
+      "Wrong memory of the edge index.");
+
+  icfEdgeIndex_disable(mesh);
+  mu_assert(mesh->edgeIndex == NULL
+         && icfEdgeIndex_findByIndex(mesh, 
+              mesh->edgeLeafs[0]->n[0]->index,
+              mesh->edgeLeafs[0]->n[1]->index) == NULL,
+      "Failed to disable edge index.");
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfMesh_edgeIndex() */
@@ -0,0 +1,52 @@
+#ifndef icfMesh_tests_h
+#define icfMesh_tests_h
+
+/*************************************************************
+* Unit test function for the mesh construction from 
+* triangles only
+*************************************************************/
+char *test_icfMesh_buildFromTris();
+
+/*************************************************************
+* Unit test function for the mesh memory statistics
+*************************************************************/
+char *test_icfMesh_memoryStats();
+
+/*************************************************************
+* Unit test function for the mesh consistency validator
+*************************************************************/
+char *test_icfMesh_validate();
+
+/*************************************************************
+* Unit test function for the boundary face arrays
+*************************************************************/
+char *test_icfMesh_bdryFaces();
+
+/*************************************************************
+* Unit test function for the median dual metrics, which 
+* must not change, if the mesh is updated repeatedly
+*************************************************************/
+char *test_icfMesh_dualMetrics();
+
+/*************************************************************
+* Unit test function for the split records of the 
+* refinement forest
+*************************************************************/
+char *test_icfMesh_splitTree();
+
+/*************************************************************
+* Unit test function for the compaction of a mesh
+*************************************************************/
+char *test_icfMesh_compact();
+
+/*************************************************************
+* Unit test function for the orderings of the edge leafs
+*************************************************************/
+char *test_icfMesh_edgeOrder();
+
+/*************************************************************
+* Unit test function for the lookup of edges by node pairs
+*************************************************************/
+char *test_icfMesh_edgeIndex();
+
+#endif
@@ -0,0 +1,407 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfNode.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfBdry.h"
+#include "incomflow/icfIO.h"
+#include "incomflow/icfMeshSnapshot.h"
+#include "incomflow/icfOutput.h"
+#include "icfOutput_tests.h"
+
+/*************************************************************
+* Dummy refinement function
+*************************************************************/
+static inline icfBool refineFun(icfFlowData *flowData, 
+                                icfTri      *tri)
+{
+  if (fabs(tri->xy[0] - 0.75) < 0.2)
+    return TRUE;
+
+  return FALSE;
+}
+
+/*************************************************************
+* Creates a unit square mesh, that consists of two triangles
+*************************************************************/
+static void create_square(icfMesh *mesh)
+{
+  icfBdry *bdrySouth = icfBdry_create(mesh, 0, 1, "SOUTH");
+  icfBdry *bdryEast  = icfBdry_create(mesh, 0, 2, "EAST");
+  icfBdry *bdryNorth = icfBdry_create(mesh, 0, 3, "NORTH");
+  icfBdry *bdryWest  = icfBdry_create(mesh, 0, 4, "WEST");
+
+  icfDouble xy0[2] = {0.0,0.0};
+  icfDouble xy1[2] = {1.0,0.0};
+  icfDouble xy2[2] = {1.0,1.0};
+  icfDouble xy3[2] = {0.0,1.0};
+  icfNode  *n0     = icfNode_create(mesh, xy0);
+  icfNode  *n1     = icfNode_create(mesh, xy1);
+  icfNode  *n2     = icfNode_create(mesh, xy2);
+  icfNode  *n3     = icfNode_create(mesh, xy3);
+
+  icfEdge *e0 = icfEdge_create(mesh);
+  icfEdge_setNodes(e0, n0, n1);
+  icfBdry_addEdge(bdrySouth, e0);
+  icfBdry_addNode(bdrySouth, n0, 0);
+  icfBdry_addNode(bdrySouth, n1, 1);
+
+  icfEdge *e1 = icfEdge_create(mesh);
+  icfEdge_setNodes(e1, n1, n2);
+  icfBdry_addEdge(bdryEast, e1);
+  icfBdry_addNode(bdryEast, n1, 0);
+  icfBdry_addNode(bdryEast, n2, 1);
+
+  icfEdge *e2 = icfEdge_create(mesh);
+  icfEdge_setNodes(e2, n2, n3);
+  icfBdry_addEdge(bdryNorth, e2);
+  icfBdry_addNode(bdryNorth, n2, 0);
+  icfBdry_addNode(bdryNorth, n3, 1);
+
+  icfEdge *e3 = icfEdge_create(mesh);
+  icfEdge_setNodes(e3, n3, n0);
+  icfBdry_addEdge(bdryWest, e3);
+  icfBdry_addNode(bdryWest, n3, 0);
+  icfBdry_addNode(bdryWest, n0, 1);
+
+  icfEdge *e4 = icfEdge_create(mesh);
+  icfEdge_setNodes(e4, n0, n2);
+
+  icfTri *t0 = icfTri_create(mesh);
+  icfTri_setNodes(t0, n0, n1, n2);
+  icfTri_setEdges(t0, e0, e1, e4);
+
+  icfTri *t1 = icfTri_create(mesh);
+  icfTri_setNodes(t1, n2, n3, n0);
+  icfTri_setEdges(t1, e2, e3, e4);
+
+  icfTri_setTris(t0, NULL, t1, NULL);
+  icfTri_setTris(t1, NULL, t0, NULL);
+
+  icfEdge_setTris(e0, t0, NULL);
+  icfEdge_setTris(e1, t0, NULL);
+  icfEdge_setTris(e2, t1, NULL);
+  icfEdge_setTris(e3, t1, NULL);
+  icfEdge_setTris(e4, t1, t0);
+
+  icfMesh_update(mesh);
+}
+
+/*************************************************************
+* Unit test function for the asynchronous output writer
+*************************************************************/
+char *test_icfOutput_writer()
+{
+  int i;
+  int nSteps = 6;
+
+  /*----------------------------------------------------------
+  | Create flow data container and mesh 
+  ----------------------------------------------------------*/
+  icfFlowData *flowData = icfFlowData_create();
+
+  icfMesh *mesh       = icfMesh_create();
+  flowData->mesh      = mesh;
+  flowData->refineFun = refineFun;
+  flowData->coarseFun = refineFun;
+
+  create_square(mesh);
+
+  /*----------------------------------------------------------
+  | Write snapshots with a double-buffered writer, while 
+  | the mesh is refined
+  ----------------------------------------------------------*/
+  icfOutputWriter *writer = icfOutput_createWriter("icfOutput_test", 2);
+  mu_assert(writer != NULL, "Failed to create output writer.");
+
+  for (i = 0; i < nSteps; i++)
+  {
+    icfMesh_refine(flowData, mesh);
+    mu_assert(icfOutput_pushMesh(writer, mesh, i) == 0,
+        "Failed to push mesh to output writer.");
+  }
+
+  icfOutput_flush(writer);
+  mu_assert(writer->nWritten == nSteps, 
+      "Output writer did not write all snapshots.");
+
+  icfOutput_destroyWriter(writer);
+
+  /*----------------------------------------------------------
+  | Read the last snapshot and compare it to the mesh
+  ----------------------------------------------------------*/
+  icfMesh *meshIn = icfMesh_create();
+  icfBdry_create(meshIn, 0, 1, "SOUTH");
+  icfBdry_create(meshIn, 0, 2, "EAST");
+  icfBdry_create(meshIn, 0, 3, "NORTH");
+  icfBdry_create(meshIn, 0, 4, "WEST");
+
+  icfIO_readMesh("icfOutput_test_000005.dat", meshIn);
+  icfMesh_update(meshIn);
+
+  mu_assert(meshIn->nNodes == mesh->nNodes, 
+      "Wrong number of nodes in snapshot.");
+  mu_assert(meshIn->nTriLeafs == mesh->nTriLeafs, 
+      "Wrong number of triangles in snapshot.");
+  mu_assert(meshIn->nEdgeLeafs == mesh->nEdgeLeafs, 
+      "Wrong number of edges in snapshot.");
+
+  for (i = 0; i < mesh->nNodes; i++)
+  {
+    mu_assert(fabs(meshIn->nodes[i]->xy[0]-mesh->nodes[i]->xy[0]) < 1e-12,
+        "Wrong node coordinates in snapshot.");
+    mu_assert(fabs(meshIn->nodes[i]->xy[1]-mesh->nodes[i]->xy[1]) < 1e-12,
+        "Wrong node coordinates in snapshot.");
+  }
+
+  /*----------------------------------------------------------
+  | Clear structures
+  ----------------------------------------------------------*/
+  icfMesh_destroy(meshIn);
+  icfFlowData_destroy(flowData);
+
+  for (i = 0; i < nSteps; i++)
+  {
+    char path[64];
+    snprintf(path, 64, "icfOutput_test_%06d.dat", i);
+    remove(path);
+  }
+
+  return NULL;
+
+} /* test_icfOutput_writer() */
+
+/*************************************************************
+* Unit test function for the binary leaf mesh dump
+*************************************************************/
+char *test_icfOutput_binary()
+{
+  int i;
+  const char *path = "icfOutput_test.bin";
+
+  icfFlowData *flowData = icfFlowData_create();
+
+  icfMesh *mesh       = icfMesh_create();
+  flowData->mesh      = mesh;
+  flowData->refineFun = refineFun;
+  flowData->coarseFun = refineFun;
+
+  create_square(mesh);
+
+  for (i = 0; i < 3; i++)
+    icfMesh_refine(flowData, mesh);
+
+  /*----------------------------------------------------------
+  | Capture the mesh with an additional cell field
+  ----------------------------------------------------------*/
+  icfOutputFrame frame;
+  memset(&frame, 0, sizeof(icfOutputFrame));
+  frame.step = 42;
+
+  mu_assert(icfOutput_captureFrame(&frame, mesh) == 0,
+      "Failed to capture frame.");
+
+  icfDouble *xc = calloc(frame.nTris, sizeof(icfDouble));
+  for (i = 0; i < frame.nTris; i++)
+    xc[i] = mesh->triLeafs[i]->xy[0];
+
+  mu_assert(icfOutput_addCellField(&frame, "xc", xc) == 0,
+      "Failed to add cell field.");
+
+  /*----------------------------------------------------------
+  | A new capture of the same mesh reuses the "level" field
+  | and drops the additional field
+  ----------------------------------------------------------*/
+  icfDouble *levelField = frame.cellFields[0];
+
+  mu_assert(icfOutput_captureFrame(&frame, mesh) == 0,
+      "Failed to capture frame.");
+  mu_assert(frame.nCellFields == 1 && frame.cellFields[0] == levelField,
+      "Cell field level was not reused.");
+  mu_assert(icfOutput_addCellField(&frame, "xc", xc) == 0,
+      "Failed to add cell field.");
+
+  mu_assert(icfOutput_writeFrameBinary(&frame, path) == 0,
+      "Failed to write binary dump.");
+
+  /*----------------------------------------------------------
+  | Read the dump back
+  ----------------------------------------------------------*/
+  char     header[64];
+  char     names[3][ICF_OUTPUT_NAMELEN];
+  int32_t  hdrInt[6];
+  int64_t  hdrLong[4];
+
+  FILE *fptr = fopen(path, "rb");
+  mu_assert(fptr != NULL, "Failed to open binary dump.");
+  mu_assert(fread(header, 1, 64, fptr) == 64, 
+      "Failed to read binary header.");
+  memcpy(hdrInt,  header + 8,  sizeof(hdrInt));
+  memcpy(hdrLong, header + 32, sizeof(hdrLong));
+
+  mu_assert(strcmp(header, ICF_OUTPUT_MAGIC) == 0,
+      "Wrong magic in binary dump.");
+  mu_assert(hdrInt[0] == ICF_OUTPUT_BINVERSION 
+         && hdrInt[1] == sizeof(icfDouble)
+         && hdrInt[2] == sizeof(icfIndex)
+         && hdrInt[3] == 1 && hdrInt[4] == 2,
+      "Wrong header in binary dump.");
+  mu_assert(hdrLong[0] == 42 && hdrLong[1] == mesh->nNodes 
+         && hdrLong[2] == mesh->nTriLeafs,
+      "Wrong sizes in binary dump.");
+
+  mu_assert(fread(names, ICF_OUTPUT_NAMELEN, 3, fptr) == 3,
+      "Failed to read field names.");
+  mu_assert(strcmp(names[0], "vol") == 0 
+         && strcmp(names[1], "level") == 0 
+         && strcmp(names[2], "xc") == 0,
+      "Wrong field names in binary dump.");
+
+  const size_t nNodes = frame.nNodes;
+  const size_t nTris  = frame.nTris;
+
+  icfDouble (*xy)[2]   = calloc(nNodes, 2*sizeof(icfDouble));
+  icfIndex  (*tris)[3] = calloc(nTris,  3*sizeof(icfIndex));
+  icfIndex  (*nbrs)[3] = calloc(nTris,  3*sizeof(icfIndex));
+  icfDouble  *vol      = calloc(nNodes, sizeof(icfDouble));
+  icfDouble  *level    = calloc(nTris,  sizeof(icfDouble));
+  icfDouble  *xcIn     = calloc(nTris,  sizeof(icfDouble));
+
+  mu_assert(
+      fread(xy,    2*sizeof(icfDouble), nNodes, fptr) == nNodes
+   && fread(tris,  3*sizeof(icfIndex),  nTris,  fptr) == nTris
+   && fread(nbrs,  3*sizeof(icfIndex),  nTris,  fptr) == nTris
+   && fread(vol,   sizeof(icfDouble),   nNodes, fptr) == nNodes
+   && fread(level, sizeof(icfDouble),   nTris,  fptr) == nTris
+   && fread(xcIn,  sizeof(icfDouble),   nTris,  fptr) == nTris
+   && fgetc(fptr) == EOF,
+      "Wrong data size in binary dump.");
+
+  fclose(fptr);
+  remove(path);
+
+  for (i = 0; i < frame.nNodes; i++)
+    mu_assert(xy[i][0] == mesh->nodes[i]->xy[0] 
+           && xy[i][1] == mesh->nodes[i]->xy[1],
+        "Wrong node coordinates in binary dump.");
+
+  for (i = 0; i < frame.nTris; i++)
+  {
+    icfTri *t = mesh->triLeafs[i];
+    mu_assert(tris[i][0] == t->n[0]->index 
+           && tris[i][1] == t->n[1]->index
+           && tris[i][2] == t->n[2]->index,
+        "Wrong triangles in binary dump.");
+    mu_assert(nbrs[i][0] == frame.triNbrs[i][0],
+        "Wrong triangle neighbors in binary dump.");
+    mu_assert(level[i] == t->cold->treeLevel && xcIn[i] == xc[i],
+        "Wrong cell fields in binary dump.");
+  }
+
+  /*----------------------------------------------------------
+  | Clear structures
+  ----------------------------------------------------------*/
+  free(xy);
+  free(tris);
+  free(nbrs);
+  free(vol);
+  free(level);
+  free(xcIn);
+  free(xc);
+
+  icfOutput_clearFrame(&frame);
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfOutput_binary() */
+
+/*************************************************************
+* Unit test function for boundary edges without boundary:
+* their neighbors must differ from the neighbors on the 
+* boundary with marker 1, in captured frames, in captured
+* snapshots and in written frames
+*************************************************************/
+char *test_icfOutput_freeBdry()
+{
+  int i, j;
+  int nSouth = 0;
+  int nFree  = 0;
+  const char *path = "icfOutput_test_free.dat";
+
+  icfDouble xy[4][2] = { {0.0, 0.0}, {1.0, 0.0}, 
+                         {1.0, 1.0}, {0.0, 1.0} };
+  icfIndex  tris[2][3] = { {0, 1, 2}, {0, 2, 3} };
+  icfIndex  bdryEdges[1][3] = { {0, 1, 1} };
+
+  icfMesh *mesh = icfMesh_create();
+  icfBdry_create(mesh, 0, 1, "SOUTH");
+
+  mu_assert(icfMesh_buildFromTris(mesh, 4, xy, 2, tris, 
+                                  1, bdryEdges) == 0,
+      "Failed to create mesh.");
+  icfMesh_update(mesh);
+
+  /*----------------------------------------------------------
+  | Capture the mesh directly and from a snapshot
+  ----------------------------------------------------------*/
+  icfOutputFrame frame, frameSnap;
+  memset(&frame,     0, sizeof(icfOutputFrame));
+  memset(&frameSnap, 0, sizeof(icfOutputFrame));
+
+  icfMeshSnapshot *snap = icfMeshSnapshot_capture(mesh, NULL);
+  mu_assert(snap != NULL, "Failed to capture snapshot.");
+
+  mu_assert(icfOutput_captureFrame(&frame, mesh) == 0
+         && icfOutput_captureSnapshot(&frameSnap, snap) == 0,
+      "Failed to capture frame.");
+
+  icfMeshSnapshot_release(snap);
+
+  for (i = 0; i < frame.nTris; i++)
+    for (j = 0; j < 3; j++)
+    {
+      mu_assert(frame.triNbrs[i][j] == frameSnap.triNbrs[i][j],
+          "Snapshot and mesh frame differ.");
+
+      if (frame.triNbrs[i][j] == -1)
+        nSouth += 1;
+      else if (frame.triNbrs[i][j] == ICF_OUTPUT_NOBDRY)
+        nFree += 1;
+    }
+
+  mu_assert(nSouth == 1 && nFree == 3, 
+      "Wrong boundary neighbors in frame.");
+
+  /*----------------------------------------------------------
+  | Free edges stay free, when the frame is read again
+  ----------------------------------------------------------*/
+  mu_assert(icfOutput_writeFrame(&frame, path) == 0,
+      "Failed to write frame.");
+
+  icfMesh *meshIn = icfMesh_create();
+  icfBdry *bdryIn = icfBdry_create(meshIn, 0, 1, "SOUTH");
+
+  icfIO_readMesh(path, meshIn);
+  icfMesh_update(meshIn);
+  remove(path);
+
+  mu_assert(meshIn->nEdgeLeafs == 5 && bdryIn->nEdgeLeafs == 1,
+      "Wrong boundary edges in written frame.");
+
+  icfOutput_clearFrame(&frame);
+  icfOutput_clearFrame(&frameSnap);
+  icfMesh_destroy(meshIn);
+  icfMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_icfOutput_freeBdry() */
@@ -0,0 +1,19 @@
+#ifndef icfOutput_tests_h
+#define icfOutput_tests_h
+
+/*************************************************************
+* Unit test function for the asynchronous output writer
+*************************************************************/
+char *test_icfOutput_writer();
+
+/*************************************************************
+* Unit test function for the binary leaf mesh dump
+*************************************************************/
+char *test_icfOutput_binary();
+
+/*************************************************************
+* Unit test function for boundary edges without boundary
+*************************************************************/
+char *test_icfOutput_freeBdry();
+
+#endif
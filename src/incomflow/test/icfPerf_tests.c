@@ -0,0 +1,433 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfProf.h"
+#include "icfPerf_tests.h"
+
+/*************************************************************
+* Fixed workload: a generated mesh with 100352 triangles,
+* which is refined three levels within a disk
+*************************************************************/
+#define PERF_NX       224
+#define PERF_LEVELS   3
+#define PERF_RADIUS   0.1
+#define PERF_REPEATS  3
+
+#define PERF_MAXSTAGES  8
+#define PERF_NAMELEN    32
+
+#ifndef ICF_PERF_BASELINES
+#define ICF_PERF_BASELINES "perf_baselines.txt"
+#endif
+
+#ifndef ICF_PERF_CONFIG
+#define ICF_PERF_CONFIG "Debug"
+#endif
+
+/*************************************************************
+* Result of a workload stage: the time is normalised by
+* the time of a fixed reference kernel, such that
+* baselines carry over between machines
+*************************************************************/
+typedef struct perfStage {
+  char    name[PERF_NAMELEN];
+  double  seconds;
+  double  normTime;
+  int64_t allocs;
+} perfStage;
+
+/*************************************************************
+* Refinement criterion of the workload
+*************************************************************/
+static icfBool perf_refineDisk(icfFlowData *flowData, icfTri *tri)
+{
+  icfDouble dx = tri->xy[0] - 0.5;
+  icfDouble dy = tri->xy[1] - 0.5;
+
+  return ( tri->cold->treeLevel < PERF_LEVELS
+        && dx*dx + dy*dy < PERF_RADIUS*PERF_RADIUS );
+}
+
+/*************************************************************
+* Reference kernel: a random pointer chase through 8 MB,
+* which is bound by memory latency like the tree
+* traversals of the mesh
+*************************************************************/
+static double perf_calibrate(void)
+{
+  int      i, r;
+  int      n     = 1 << 20;
+  double   best  = 0.0;
+  uint32_t *next = malloc(n * sizeof(uint32_t));
+  uint64_t  seed = 12345;
+
+  if (next == NULL)
+    return 0.0;
+
+  /*----------------------------------------------------------
+  | Sattolo's algorithm: a single cycle through all slots
+  ----------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+    next[i] = i;
+
+  for (i = n-1; i > 0; i--)
+  {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int      j   = (int) ((seed >> 33) % (uint64_t) i);
+    uint32_t tmp = next[i];
+    next[i] = next[j];
+    next[j] = tmp;
+  }
+
+  for (r = 0; r < 5; r++)
+  {
+    volatile uint32_t sink;
+    uint32_t k  = 0;
+    int64_t  t0 = icfProf_now();
+
+    for (i = 0; i < 4*n; i++)
+      k = next[k];
+
+    sink = k;
+    (void) sink;
+
+    double dt = 1.0e-9 * (double) (icfProf_now() - t0);
+    if (r == 0 || dt < best)
+      best = dt;
+  }
+
+  free(next);
+
+  return best;
+
+} /* perf_calibrate() */
+
+/*************************************************************
+* Records the time and allocations of a stage, keeping
+* the fastest of all repetitions
+*************************************************************/
+static void perf_record(perfStage  *stages,
+                        int        *nStages,
+                        const char *name,
+                        int64_t     t0,
+                        int64_t     allocs0)
+{
+  int i;
+  double  dt     = 1.0e-9 * (double) (icfProf_now() - t0);
+  int64_t allocs = icfMem_nAllocs() - allocs0;
+
+  for (i = 0; i < *nStages; i++)
+    if (strcmp(stages[i].name, name) == 0)
+      break;
+
+  if (i == *nStages)
+  {
+    if (*nStages == PERF_MAXSTAGES)
+      return;
+
+    snprintf(stages[i].name, PERF_NAMELEN, "%s", name);
+    stages[i].seconds = dt;
+    stages[i].allocs  = allocs;
+    *nStages += 1;
+  }
+
+  if (dt < stages[i].seconds)
+    stages[i].seconds = dt;
+
+} /* perf_record() */
+
+/*************************************************************
+* Runs all stages of the workload once
+*************************************************************/
+static int perf_workload(perfStage *stages, int *nStages)
+{
+  int     i;
+  int64_t t0, a0;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = PERF_NX;
+  params.ny = PERF_NX;
+
+  icfFlowData *flowData = icfFlowData_create();
+  icfMesh     *mesh     = icfMesh_create();
+  flowData->mesh        = mesh;
+  flowData->refineFun   = perf_refineDisk;
+  flowData->coarseFun   = perf_refineDisk;
+
+  /*----------------------------------------------------------
+  | Mesh generation including the first update
+  ----------------------------------------------------------*/
+  t0 = icfProf_now();
+  a0 = icfMem_nAllocs();
+
+  check(icfMeshGen_rectangle(mesh, &params) == 0,
+      "Failed to generate mesh.");
+  icfMesh_update(mesh);
+
+  perf_record(stages, nStages, "mesh_generate", t0, a0);
+
+  /*----------------------------------------------------------
+  | Local refinement
+  ----------------------------------------------------------*/
+  t0 = icfProf_now();
+  a0 = icfMem_nAllocs();
+
+  for (i = 0; i < PERF_LEVELS; i++)
+    icfMesh_refine(flowData, mesh);
+
+  perf_record(stages, nStages, "refine_3_levels", t0, a0);
+
+  /*----------------------------------------------------------
+  | Full update and metrics pass on the refined mesh
+  ----------------------------------------------------------*/
+  t0 = icfProf_now();
+  a0 = icfMem_nAllocs();
+
+  icfMesh_update(mesh);
+
+  perf_record(stages, nStages, "update", t0, a0);
+
+  t0 = icfProf_now();
+  a0 = icfMem_nAllocs();
+
+  icfMesh_calcDualMetrics(mesh);
+
+  perf_record(stages, nStages, "dual_metrics", t0, a0);
+
+  /*----------------------------------------------------------
+  | Destruction of the whole refinement tree
+  ----------------------------------------------------------*/
+  t0 = icfProf_now();
+  a0 = icfMem_nAllocs();
+
+  icfFlowData_destroy(flowData);
+
+  perf_record(stages, nStages, "destroy", t0, a0);
+
+  return 0;
+
+error:
+  icfFlowData_destroy(flowData);
+  return -1;
+
+} /* perf_workload() */
+
+/*************************************************************
+* Reads the baseline of a stage for the current build
+* configuration
+*************************************************************/
+static int perf_readBaseline(const char *path,
+                             const char *name,
+                             double     *normTime,
+                             int64_t    *allocs)
+{
+  char  line[256];
+  char  bName[PERF_NAMELEN], bConfig[PERF_NAMELEN];
+  long long bAllocs;
+  FILE *fptr = fopen(path, "r");
+
+  if (fptr == NULL)
+    return -1;
+
+  while (fgets(line, 256, fptr) != NULL)
+  {
+    if (line[0] == '#')
+      continue;
+
+    if (sscanf(line, "%31s %31s %lf %lld",
+               bName, bConfig, normTime, &bAllocs) != 4)
+      continue;
+
+    if (strcmp(bName, name) == 0
+     && strcmp(bConfig, ICF_PERF_CONFIG) == 0)
+    {
+      *allocs = (int64_t) bAllocs;
+      fclose(fptr);
+      return 0;
+    }
+  }
+
+  fclose(fptr);
+  return -1;
+
+} /* perf_readBaseline() */
+
+/*************************************************************
+* Rewrites the baselines of the current build configuration
+* and keeps those of all other configurations
+*************************************************************/
+static int perf_writeBaselines(const char      *path,
+                               const perfStage *stages,
+                               int              nStages)
+{
+  int   i;
+  char  line[256], bName[PERF_NAMELEN], bConfig[PERF_NAMELEN];
+  char *keep    = NULL;
+  size_t nKeep  = 0;
+  FILE *fptr    = fopen(path, "r");
+
+  /*----------------------------------------------------------
+  | Collect the lines of other configurations
+  ----------------------------------------------------------*/
+  keep = calloc(1, 1);
+  check_mem(keep);
+
+  while (fptr != NULL && fgets(line, 256, fptr) != NULL)
+  {
+    if (line[0] != '#'
+     && sscanf(line, "%31s %31s", bName, bConfig) == 2
+     && strcmp(bConfig, ICF_PERF_CONFIG) == 0)
+      continue;
+
+    char *tmp = realloc(keep, nKeep + strlen(line) + 1);
+    check_mem(tmp);
+    keep = tmp;
+    strcpy(keep + nKeep, line);
+    nKeep += strlen(line);
+  }
+
+  if (fptr != NULL)
+    fclose(fptr);
+
+  /*----------------------------------------------------------
+  | Write them back together with the new baselines
+  ----------------------------------------------------------*/
+  fptr = fopen(path, "w");
+  check(fptr != NULL, "Failed to write baselines to %s.", path);
+
+  fputs(keep, fptr);
+
+  for (i = 0; i < nStages; i++)
+    fprintf(fptr, "%-18s %-16s %10.4f %10lld\n",
+        stages[i].name, ICF_PERF_CONFIG, stages[i].normTime,
+        (long long) stages[i].allocs);
+
+  fclose(fptr);
+  free(keep);
+
+  return 0;
+
+error:
+  free(keep);
+  return -1;
+
+} /* perf_writeBaselines() */
+
+/*************************************************************
+* Returns a tolerance from the environment
+*************************************************************/
+static double perf_tolerance(const char *var, double value)
+{
+  const char *str = getenv(var);
+
+  if (str != NULL && atof(str) > 0.0)
+    return atof(str);
+
+  return value;
+}
+
+/*************************************************************
+* Performance regression test of the mesh hot paths
+*----------------------------------------------------------
+* Environment:
+*   ICF_PERF_BASELINES  - baseline file
+*   ICF_PERF_UPDATE=1   - store the measured values as
+*                         baselines of this configuration
+*   ICF_PERF_TIME_TOL   - relative tolerance of the
+*                         normalised times (0.5)
+*   ICF_PERF_ALLOC_TOL  - relative tolerance of the
+*                         allocation counts (0.02)
+*************************************************************/
+char *test_icfPerf_regression()
+{
+  int       i;
+  int       nStages = 0;
+  int       nFailed = 0;
+  perfStage stages[PERF_MAXSTAGES];
+
+  const char *path = getenv("ICF_PERF_BASELINES");
+  if (path == NULL)
+    path = ICF_PERF_BASELINES;
+
+  double timeTol  = perf_tolerance("ICF_PERF_TIME_TOL",  0.5);
+  double allocTol = perf_tolerance("ICF_PERF_ALLOC_TOL", 0.02);
+
+  /*----------------------------------------------------------
+  | Sanitizers distort the timings beyond any tolerance
+  ----------------------------------------------------------*/
+  icfBool checkTime = TRUE;
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+  checkTime = FALSE;
+#endif
+
+  /*----------------------------------------------------------
+  | Run the workload
+  ----------------------------------------------------------*/
+  double tRef = perf_calibrate();
+  mu_assert(tRef > 0.0, "Failed to run the reference kernel.");
+
+  for (i = 0; i < PERF_REPEATS; i++)
+    mu_assert(perf_workload(stages, &nStages) == 0,
+        "Failed to run the performance workload.");
+
+  for (i = 0; i < nStages; i++)
+    stages[i].normTime = stages[i].seconds / tRef;
+
+  if (getenv("ICF_PERF_UPDATE") != NULL)
+  {
+    mu_assert(perf_writeBaselines(path, stages, nStages) == 0,
+        "Failed to write performance baselines.");
+    printf("Stored baselines of configuration %s in %s\n",
+        ICF_PERF_CONFIG, path);
+  }
+
+  /*----------------------------------------------------------
+  | Compare against the baselines
+  ----------------------------------------------------------*/
+  printf("\n%-18s %10s %10s %10s %12s %12s\n", "stage", "seconds",
+      "norm.time", "baseline", "allocations", "baseline");
+
+  for (i = 0; i < nStages; i++)
+  {
+    double  bTime;
+    int64_t bAllocs;
+    const char *status = "ok";
+
+    if (perf_readBaseline(path, stages[i].name, &bTime, &bAllocs) != 0)
+    {
+      printf("%-18s %10.4f %10.2f %10s %12lld %12s  no baseline\n",
+          stages[i].name, stages[i].seconds, stages[i].normTime, "-",
+          (long long) stages[i].allocs, "-");
+      continue;
+    }
+
+    if (stages[i].allocs > bAllocs + allocTol * bAllocs)
+      status = "ALLOCATION REGRESSION";
+
+    if (checkTime == TRUE
+     && stages[i].normTime > (1.0 + timeTol) * bTime)
+      status = "TIME REGRESSION";
+
+    if (strcmp(status, "ok") != 0)
+      nFailed++;
+
+    printf("%-18s %10.4f %10.2f %10.2f %12lld %12lld  %s\n",
+        stages[i].name, stages[i].seconds, stages[i].normTime, bTime,
+        (long long) stages[i].allocs, (long long) bAllocs, status);
+  }
+
+  mu_assert(nFailed == 0, "Performance regression detected.");
+
+  return NULL;
+
+} /* test_icfPerf_regression() */
@@ -0,0 +1,9 @@
+#ifndef icfPerf_tests_h
+#define icfPerf_tests_h
+
+/*************************************************************
+* Performance regression test of the mesh hot paths
+*************************************************************/
+char *test_icfPerf_regression();
+
+#endif
@@ -0,0 +1,304 @@
+#include <string.h>
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfOutput.h"
+#include "incomflow/icfProf.h"
+#include "incomflow/icfTrace.h"
+#include "icfProf_tests.h"
+
+/*************************************************************
+* Refinement / coarsening function for all triangles
+*************************************************************/
+static icfBool refineAll(icfFlowData *flowData, icfTri *tri)
+{
+  return TRUE;
+}
+
+/*************************************************************
+* Unit test function for the profiling timers and counters
+*************************************************************/
+char *test_icfProf_hooks()
+{
+  icfProfTimer refine, update, split, outer, inner, switched;
+
+  /*----------------------------------------------------------
+  | The hooks are not compiled in
+  ----------------------------------------------------------*/
+  if (!ICF_PROFILE)
+    return NULL;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = 4;
+  params.ny = 4;
+
+  icfFlowData *flowData = icfFlowData_create();
+  flowData->mesh        = icfMesh_create();
+  flowData->refineFun   = refineAll;
+  flowData->coarseFun   = refineAll;
+
+  icfMeshGen_rectangle(flowData->mesh, &params);
+  icfMesh_update(flowData->mesh);
+
+  /*----------------------------------------------------------
+  | Nothing is recorded, while profiling is disabled
+  ----------------------------------------------------------*/
+  icfProf_reset();
+  icfMesh_refine(flowData, flowData->mesh);
+
+  mu_assert(icfProf_getCounter(ICF_PROF_EDGE_SPLITS) == 0,
+      "Disabled profiling recorded counters.");
+
+  /*----------------------------------------------------------
+  | Refine and coarsen with enabled profiling
+  ----------------------------------------------------------*/
+  icfProf_enable(FALSE);
+
+  icfMesh_refine(flowData, flowData->mesh);
+  int nTris = flowData->mesh->nTriLeafs;
+  icfMesh_coarsen(flowData, flowData->mesh);
+
+  mu_assert(icfProf_getTimer("icfMesh_refine", &refine) == 0
+         && icfProf_getTimer("icfMesh_update", &update) == 0
+         && icfProf_getTimer("icfEdge_split",  &split)  == 0,
+      "Profiling timers were not registered.");
+
+  mu_assert(refine.calls == 1 && update.calls == 2,
+      "Wrong number of timer calls.");
+  mu_assert(refine.totalNs >= refine.selfNs && refine.selfNs >= 0,
+      "Wrong inclusive timer data.");
+  mu_assert(split.calls == icfProf_getCounter(ICF_PROF_EDGE_SPLITS)
+         && split.calls > 0,
+      "Wrong number of edge splits.");
+  mu_assert(icfProf_getCounter(ICF_PROF_EDGE_MERGES) > 0,
+      "Edge merges were not counted.");
+  mu_assert(icfProf_getCounter(ICF_PROF_TRIS_CREATED) > 0
+         && icfProf_getCounter(ICF_PROF_TRIS_FREED) > 0,
+      "Triangle allocations were not counted.");
+  mu_assert(icfProf_getCounter(ICF_PROF_BYTES_ALLOCATED) > 0
+         && icfProf_getCounter(ICF_PROF_BYTES_FREED) > 0,
+      "Entity bytes were not counted.");
+  mu_assert(icfProf_getCounter(ICF_PROF_TRI_LEAFS) 
+         == flowData->mesh->nTriLeafs
+         && flowData->mesh->nTriLeafs < nTris,
+      "Wrong leaf count.");
+
+  /*----------------------------------------------------------
+  | Nested timers: the self time excludes the inner timer
+  ----------------------------------------------------------*/
+  ICF_PROF_BEGIN(outer, "test_outer");
+  ICF_PROF_BEGIN(inner, "test_inner");
+  icfDouble sum = 0.0;
+  int i;
+  for (i = 0; i < 100000; i++)
+    sum += sqrt((icfDouble) i);
+  ICF_PROF_END(inner);
+  ICF_PROF_END(outer);
+
+  mu_assert(sum > 0.0, "Dummy loop failed.");
+  mu_assert(icfProf_getTimer("test_outer", &outer) == 0
+         && icfProf_getTimer("test_inner", &inner) == 0,
+      "Nested timers were not registered.");
+  mu_assert(outer.calls == 1 && inner.calls == 1
+         && outer.totalNs >= inner.totalNs
+         && outer.selfNs == outer.totalNs - inner.totalNs,
+      "Wrong nested timer data.");
+
+  /*----------------------------------------------------------
+  | Switching profiling off inside a timed scope must not
+  | leave its frame on the timer stack
+  ----------------------------------------------------------*/
+  ICF_PROF_BEGIN(switchOuter, "test_switchOuter");
+  ICF_PROF_BEGIN(switchInner, "test_switchInner");
+  icfProf_disable();
+  ICF_PROF_END(switchInner);
+  icfProf_enable(FALSE);
+  ICF_PROF_END(switchOuter);
+
+  mu_assert(icfProf_getTimer("test_switchOuter", &switched) == 0
+         && switched.calls == 1,
+      "Timer stack is unbalanced after switching profiling off.");
+
+  icfProf_disable();
+  icfProf_reset();
+
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfProf_hooks() */
+
+/*************************************************************
+* Unit test function for the Chrome trace event export
+*************************************************************/
+char *test_icfTrace_chrome()
+{
+  int i;
+  const char *path = "icfTrace_test.json";
+
+  if (!ICF_PROFILE)
+    return NULL;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx = 4;
+  params.ny = 4;
+
+  icfFlowData *flowData = icfFlowData_create();
+  flowData->mesh        = icfMesh_create();
+  flowData->refineFun   = refineAll;
+  flowData->coarseFun   = refineAll;
+
+  icfMeshGen_rectangle(flowData->mesh, &params);
+  icfMesh_update(flowData->mesh);
+
+  /*----------------------------------------------------------
+  | Tracing works without the profiling timers
+  ----------------------------------------------------------*/
+  icfTrace_start(0);
+
+  icfMesh_refine(flowData, flowData->mesh);
+
+  icfOutputWriter *writer = icfOutput_createWriter("icfTrace_test", 1);
+  icfOutput_pushMesh(writer, flowData->mesh, 0);
+  icfOutput_destroyWriter(writer);
+  remove("icfTrace_test_000000.dat");
+
+  icfTrace_stop();
+
+  icfProfTimer refine;
+  mu_assert(icfProf_getTimer("icfMesh_refine", &refine) != 0 
+         || refine.calls == 0,
+      "Tracing accumulated profiling timers.");
+
+  long nEvents = icfTrace_nEvents();
+  mu_assert(nEvents > 3 && icfTrace_nDropped() == 0,
+      "Wrong number of trace events.");
+
+  mu_assert(icfTrace_write(path) == 0, "Failed to write trace.");
+
+  /*----------------------------------------------------------
+  | Check the trace file: one thread name for the main 
+  | and one for the writer thread
+  ----------------------------------------------------------*/
+  FILE *fptr = fopen(path, "r");
+  mu_assert(fptr != NULL, "Failed to open trace file.");
+
+  char line[512];
+  int  nX = 0, nM = 0, nRefine = 0, nWrite = 0;
+
+  mu_assert(fgets(line, 512, fptr) != NULL 
+         && strstr(line, "\"traceEvents\":[") != NULL,
+      "Wrong trace file header.");
+
+  while (fgets(line, 512, fptr) != NULL)
+  {
+    if (strstr(line, "\"ph\":\"X\"") != NULL)
+      nX++;
+    if (strstr(line, "\"ph\":\"M\"") != NULL)
+      nM++;
+    if (strstr(line, "\"name\":\"icfMesh_refine\"") != NULL)
+      nRefine++;
+    if (strstr(line, "\"name\":\"icfOutput_write\"") != NULL)
+      nWrite++;
+  }
+
+  fclose(fptr);
+  remove(path);
+
+  mu_assert(nX == nEvents && nM >= 2 && nRefine == 1 && nWrite == 1,
+      "Wrong trace file content.");
+
+  /*----------------------------------------------------------
+  | Ring buffers keep the latest events
+  ----------------------------------------------------------*/
+  icfTrace_start(4);
+
+  for (i = 0; i < 10; i++)
+    icfTrace_record("test_event", icfProf_now(), i);
+
+  mu_assert(icfTrace_nEvents() == 4 && icfTrace_nDropped() == 6,
+      "Wrong ring buffer behaviour.");
+
+  icfTrace_clear();
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfTrace_chrome() */
+
+/*************************************************************
+* Unit test function for the hardware counters of the 
+* profiling timers
+*************************************************************/
+char *test_icfProf_hwCounters()
+{
+  int i, j;
+  int64_t      values[ICF_PROF_NHW];
+  icfProfTimer timer;
+
+  if (!ICF_PROFILE)
+    return NULL;
+
+  /*----------------------------------------------------------
+  | Counters may be unavailable (containers, VMs, 
+  | perf_event_paranoid), which must not be an error
+  ----------------------------------------------------------*/
+  int nAvail = icfProf_enableHW();
+  mu_assert(icfProf_readHW(values) == nAvail,
+      "Wrong number of available hardware events.");
+
+  if (nAvail < 0)
+  {
+    icfProf_disableHW();
+    return NULL;
+  }
+
+  icfProf_reset();
+  icfProf_setFlags(ICF_PROF_TIMERS, TRUE);
+
+  /*----------------------------------------------------------
+  | Touch fresh memory inside a timer
+  ----------------------------------------------------------*/
+  ICF_PROF_BEGIN(hwTest, "test_hwCounters");
+  for (i = 0; i < 8; i++)
+  {
+    char *buf = malloc(1 << 20);
+    mu_assert(buf != NULL, "Failed to allocate memory.");
+    for (j = 0; j < (1 << 20); j += 4096)
+      buf[j] = (char) j;
+    free(buf);
+  }
+  ICF_PROF_END(hwTest);
+
+  mu_assert(icfProf_getTimer("test_hwCounters", &timer) == 0,
+      "Failed to get timer.");
+
+  for (i = 0; i < ICF_PROF_NHW; i++)
+  {
+    if (values[i] < 0)
+    {
+      mu_assert(timer.hw[i] == -1, 
+          "Unavailable hardware event has a value.");
+    }
+    else
+    {
+      mu_assert(timer.hw[i] >= 0, 
+          "Available hardware event has no value.");
+    }
+  }
+
+  icfProf_disableHW();
+  icfProf_disable();
+  icfProf_reset();
+
+  return NULL;
+
+} /* test_icfProf_hwCounters() */
@@ -0,0 +1,20 @@
+#ifndef icfProf_tests_h
+#define icfProf_tests_h
+
+/*************************************************************
+* Unit test function for the profiling timers and counters
+*************************************************************/
+char *test_icfProf_hooks();
+
+/*************************************************************
+* Unit test function for the Chrome trace event export
+*************************************************************/
+char *test_icfTrace_chrome();
+
+/*************************************************************
+* Unit test function for the hardware counters of the 
+* profiling timers
+*************************************************************/
+char *test_icfProf_hwCounters();
+
+#endif
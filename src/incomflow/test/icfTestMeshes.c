@@ -0,0 +1,61 @@
+#include "incomflow/icfTypes.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshGen.h"
+#include "icfTestMeshes.h"
+
+/*************************************************************
+* Refines the triangles in the lower left corner
+*************************************************************/
+icfBool icfTestMeshes_refineLowerLeft(icfFlowData *flowData, 
+                                      icfTri      *tri)
+{
+  return (tri->xy[0] < 0.3 && tri->xy[1] < 0.3) ? TRUE : FALSE;
+}
+
+/*************************************************************
+* Refines the triangles in the upper right corner
+*************************************************************/
+icfBool icfTestMeshes_refineUpperRight(icfFlowData *flowData, 
+                                       icfTri      *tri)
+{
+  return (tri->xy[0] > 0.8 && tri->xy[1] > 0.8) ? TRUE : FALSE;
+}
+
+/*************************************************************
+* Coarsens all refined triangles
+*************************************************************/
+icfBool icfTestMeshes_coarsenRefined(icfFlowData *flowData, 
+                                     icfTri      *tri)
+{
+  return (icfTri_getParent(tri) != NULL) ? TRUE : FALSE;
+}
+
+/*************************************************************
+* Creates a flow data container with a generated and 
+* updated mesh
+*************************************************************/
+icfFlowData *icfTestMeshes_create(const icfMeshGenParams *params,
+                                  icfRefineFun            refineFun,
+                                  icfRefineFun            coarseFun)
+{
+  icfFlowData *flowData = icfFlowData_create();
+  flowData->mesh        = icfMesh_create();
+  flowData->refineFun   = refineFun;
+  flowData->coarseFun   = coarseFun;
+
+  check(icfMeshGen_rectangle(flowData->mesh, params) == 0,
+      "Failed to generate test mesh.");
+  icfMesh_update(flowData->mesh);
+
+  return flowData;
+
+error:
+  icfFlowData_destroy(flowData);
+  return NULL;
+
+} /* icfTestMeshes_create() */
@@ -0,0 +1,34 @@
+#ifndef icfTestMeshes_h
+#define icfTestMeshes_h
+
+#include "incomflow/icfTypes.h"
+#include "incomflow/icfMeshGen.h"
+
+/*************************************************************
+* Refines the triangles in the lower left corner
+*************************************************************/
+icfBool icfTestMeshes_refineLowerLeft(icfFlowData *flowData, 
+                                      icfTri      *tri);
+
+/*************************************************************
+* Refines the triangles in the upper right corner
+*************************************************************/
+icfBool icfTestMeshes_refineUpperRight(icfFlowData *flowData, 
+                                       icfTri      *tri);
+
+/*************************************************************
+* Coarsens all refined triangles
+*************************************************************/
+icfBool icfTestMeshes_coarsenRefined(icfFlowData *flowData, 
+                                     icfTri      *tri);
+
+/*************************************************************
+* Creates a flow data container with a generated and 
+* updated mesh and the given refinement and coarsening
+* functions. Returns NULL, if the mesh generation fails.
+*************************************************************/
+icfFlowData *icfTestMeshes_create(const icfMeshGenParams *params,
+                                  icfRefineFun            refineFun,
+                                  icfRefineFun            coarseFun);
+
+#endif
@@ -0,0 +1,183 @@
+#include "incomflow/icfTypes.h"
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+
+#include "incomflow/icfList.h"
+#include "incomflow/icfFlowData.h"
+#include "incomflow/icfMesh.h"
+#include "incomflow/icfEdge.h"
+#include "incomflow/icfTri.h"
+#include "incomflow/icfMeshGen.h"
+#include "incomflow/icfTree.h"
+#include "icfTestMeshes.h"
+#include "icfTree_tests.h"
+
+/*************************************************************
+* Recursive reference traversals, which write the visited
+* entities to an array
+*************************************************************/
+static void ref_triOrder(icfTri *t, icfBool pre, icfTri **seq, int *n)
+{
+  int i;
+
+  if (pre)
+    seq[(*n)++] = t;
+
+  for (i = 0; i < 2; i++)
+    if (icfTri_getChild(t, i) != NULL)
+      ref_triOrder(icfTri_getChild(t, i), pre, seq, n);
+
+  if (!pre)
+    seq[(*n)++] = t;
+}
+
+static void ref_edgeOrder(icfEdge *e, icfBool pre, icfEdge **seq, int *n)
+{
+  int i;
+
+  if (pre)
+    seq[(*n)++] = e;
+
+  for (i = 0; i < 4; i++)
+    if (icfEdge_getChild(e, i) != NULL)
+      ref_edgeOrder(icfEdge_getChild(e, i), pre, seq, n);
+
+  if (!pre)
+    seq[(*n)++] = e;
+}
+
+/*************************************************************
+* Visitors of the forest traversals
+*************************************************************/
+static void count_tri(icfTri *t, void *data)
+{
+  __atomic_fetch_add((long*) data, 1 + t->cold->treeLevel, 
+                     __ATOMIC_RELAXED);
+}
+
+static void count_edge(icfEdge *e, void *data)
+{
+  __atomic_fetch_add((long*) data, 1 + e->cold->treeLevel, 
+                     __ATOMIC_RELAXED);
+}
+
+/*************************************************************
+* Unit test function for the refinement tree iterators
+*************************************************************/
+char *test_icfTree_iterators()
+{
+  int i, n, order;
+  long sumTris = 0, sumEdges = 0, visitTris = 0, visitEdges = 0;
+  icfListNode *cur;
+  icfTreeIter  it;
+
+  icfMeshGenParams params;
+  icfMeshGen_initParams(&params);
+  params.nx     = 8;
+  params.ny     = 8;
+  params.jitter = 0.1;
+
+  icfFlowData *flowData = 
+    icfTestMeshes_create(&params, icfTestMeshes_refineLowerLeft,
+                         icfTestMeshes_refineLowerLeft);
+  mu_assert(flowData != NULL, "Failed to generate mesh.");
+  icfMesh *mesh = flowData->mesh;
+
+  for (i = 0; i < 4; i++)
+    icfMesh_refine(flowData, mesh);
+
+  icfTri  **triSeq  = calloc(mesh->nTris,  sizeof(icfTri*));
+  icfEdge **edgeSeq = calloc(mesh->nEdges, sizeof(icfEdge*));
+
+  /*----------------------------------------------------------
+  | Pre- and post-order match the recursive traversals, 
+  | level-order visits the same entities level by level
+  ----------------------------------------------------------*/
+  for (cur = mesh->triStack->first; cur != NULL; cur = cur->next)
+  {
+    icfTri *root = (icfTri*) cur->value;
+    icfTri *t;
+
+    sumTris += 1 + root->cold->treeLevel;
+
+    if (root->cold->treeParent >= 0)
+      continue;
+
+    for (order = ICF_TREE_PREORDER; order <= ICF_TREE_POSTORDER; order++)
+    {
+      n = 0;
+      ref_triOrder(root, order == ICF_TREE_PREORDER, triSeq, &n);
+
+      icfTreeIter_initTri(&it, root, order);
+      for (i = 0; (t = icfTreeIter_nextTri(&it)) != NULL; i++)
+        mu_assert(i < n && t == triSeq[i] 
+               && icfTreeIter_depth(&it) == t->cold->treeLevel,
+            "Wrong triangle tree traversal.");
+      mu_assert(i == n, "Wrong number of traversed triangles.");
+    }
+
+    icfTreeIter_initTri(&it, root, ICF_TREE_LEVELORDER);
+    for (i = 0; (t = icfTreeIter_nextTri(&it)) != NULL; i++)
+      mu_assert(icfTreeIter_depth(&it) == t->cold->treeLevel
+             && (i == 0 || t->cold->treeLevel 
+                           >= triSeq[i-1]->cold->treeLevel)
+             && (triSeq[i] = t) != NULL,
+          "Triangle levels are not ordered.");
+    mu_assert(i == n && !it.truncated, 
+        "Wrong number of triangles in level-order.");
+  }
+
+  for (cur = mesh->edgeStack->first; cur != NULL; cur = cur->next)
+  {
+    icfEdge *root = (icfEdge*) cur->value;
+    icfEdge *e;
+
+    sumEdges += 1 + root->cold->treeLevel;
+
+    if (root->cold->treeParent >= 0)
+      continue;
+
+    for (order = ICF_TREE_PREORDER; order <= ICF_TREE_POSTORDER; order++)
+    {
+      n = 0;
+      ref_edgeOrder(root, order == ICF_TREE_PREORDER, edgeSeq, &n);
+
+      icfTreeIter_initEdge(&it, root, order);
+      for (i = 0; (e = icfTreeIter_nextEdge(&it)) != NULL; i++)
+        mu_assert(i < n && e == edgeSeq[i],
+            "Wrong edge tree traversal.");
+      mu_assert(i == n, "Wrong number of traversed edges.");
+    }
+
+    icfTreeIter_initEdge(&it, root, ICF_TREE_LEVELORDER);
+    for (i = 0; (e = icfTreeIter_nextEdge(&it)) != NULL; i++)
+      mu_assert(icfTreeIter_depth(&it) == e->cold->treeLevel
+             && (i == 0 || e->cold->treeLevel 
+                           >= edgeSeq[i-1]->cold->treeLevel)
+             && (edgeSeq[i] = e) != NULL,
+          "Edge levels are not ordered.");
+    mu_assert(i == n, "Wrong number of edges in level-order.");
+  }
+
+  /*----------------------------------------------------------
+  | The forest traversals visit every entity once
+  ----------------------------------------------------------*/
+  for (order = ICF_TREE_PREORDER; order <= ICF_TREE_LEVELORDER; order++)
+  {
+    visitTris = visitEdges = 0;
+
+    mu_assert(icfTree_forEachTri(mesh, order, count_tri, &visitTris)
+              == mesh->nTris && visitTris == sumTris,
+        "Wrong triangles of the forest traversal.");
+    mu_assert(icfTree_forEachEdge(mesh, order, count_edge, &visitEdges)
+              == mesh->nEdges && visitEdges == sumEdges,
+        "Wrong edges of the forest traversal.");
+  }
+
+  free(triSeq);
+  free(edgeSeq);
+  icfFlowData_destroy(flowData);
+
+  return NULL;
+
+} /* test_icfTree_iterators() */
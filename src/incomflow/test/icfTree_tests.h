@@ -0,0 +1,9 @@
+#ifndef icfTree_tests_h
+#define icfTree_tests_h
+
+/*************************************************************
+* Unit test function for the refinement tree iterators
+*************************************************************/
+char *test_icfTree_iterators();
+
+#endif
@@ -0,0 +1,45 @@
+#include <assert.h>
+#include "incomflow/minunit.h"
+#include "incomflow/dbg.h"
+#include "incomflow/icfLog.h"
+
+#include "icfPerf_tests.h"
+
+/************************************************************
+* Run all performance test functions
+************************************************************/
+char *all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_icfPerf_regression);
+
+  return NULL;
+}
+
+  
+/************************************************************
+* Main function to run performance tests
+************************************************************/
+int main(int argc, char *argv[])
+{
+  debug("----- RUNNING %s\n", argv[0]);
+
+  icfLog_configure(getenv("ICF_LOG"));
+  
+  char *result;
+  result = all_tests();
+
+  if (result != 0)
+  {
+    debug("FAILED: %s\n", result);
+  }
+  else
+  {
+    debug("\nALL TESTS PASSED!\n");
+  }
+
+  mu_print_tests_run();
+
+  exit(result != 0);
+}
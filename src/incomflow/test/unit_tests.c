@@ -1,9 +1,18 @@
 #include <assert.h>
 #include "incomflow/minunit.h"
 #include "incomflow/dbg.h"
+#include "incomflow/icfLog.h"
 
 #include "basic_tests.h"
 #include "icfIO_tests.h"
+#include "icfOutput_tests.h"
+#include "icfMesh_tests.h"
+#include "icfMeshGen_tests.h"
+#include "icfLocator_tests.h"
+#include "icfTree_tests.h"
+#include "icfMeshSnapshot_tests.h"
+#include "icfProf_tests.h"
+#include "icfLog_tests.h"
 
 /************************************************************
 * Run all unit test functions
@@ -16,6 +25,29 @@ char *all_tests()
   * 
   **********************************************************/
   mu_run_test(test_basic_structures);
+  mu_run_test(test_basic_types);
+  mu_run_test(test_icfOutput_writer);
+  mu_run_test(test_icfOutput_binary);
+  mu_run_test(test_icfOutput_freeBdry);
+  mu_run_test(test_icfMesh_buildFromTris);
+  mu_run_test(test_icfMesh_memoryStats);
+  mu_run_test(test_icfMesh_validate);
+  mu_run_test(test_icfMesh_bdryFaces);
+  mu_run_test(test_icfMesh_dualMetrics);
+  mu_run_test(test_icfMesh_splitTree);
+  mu_run_test(test_icfMesh_compact);
+  mu_run_test(test_icfMesh_edgeOrder);
+  mu_run_test(test_icfMesh_edgeIndex);
+  mu_run_test(test_icfTree_iterators);
+  mu_run_test(test_icfMeshSnapshot_capture);
+  mu_run_test(test_icfIO_readGmsh);
+  mu_run_test(test_icfIO_parseSections);
+  mu_run_test(test_icfMeshGen_rectangle);
+  mu_run_test(test_icfLocator_locate);
+  mu_run_test(test_icfProf_hooks);
+  mu_run_test(test_icfTrace_chrome);
+  mu_run_test(test_icfProf_hwCounters);
+  mu_run_test(test_icfLog_levels);
   //mu_run_test(test_icfIO_readerFunctions);
   //mu_run_test(test_icfIO_readMesh);
 
@@ -30,6 +62,8 @@ char *all_tests()
 int main(int argc, char *argv[])
 {
   debug("----- RUNNING %s\n", argv[0]);
+
+  icfLog_configure(getenv("ICF_LOG"));
   
   char *result;
   result = all_tests();